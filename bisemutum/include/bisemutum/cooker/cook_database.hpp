@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../runtime/vfs.hpp"
+#include "../utils/crypto.hpp"
+#include "../containers/hash.hpp"
+
+namespace bi::cook {
+
+struct CookInput final {
+    // Relative to the source directory.
+    std::string path;
+    crypto::MD5 hash;
+
+    auto operator==(CookInput const& rhs) const -> bool = default;
+};
+
+struct CookRecord final {
+    // Source file followed by dependencies.
+    std::vector<CookInput> inputs;
+    // Hash of cooking settings of the entry and the cooker version.
+    crypto::MD5 settings_hash;
+    crypto::MD5 output_hash;
+};
+
+// Records of the last successful cooking of each output, keyed by output path relative to the output directory.
+struct CookDatabase final {
+    // Empty if the file is invalid or written by another version.
+    static auto load(Dyn<rt::IFile>::Ref file) -> CookDatabase;
+    auto save(Dyn<rt::IFile>::Ref file) const -> bool;
+
+    StringHashMap<CookRecord> records;
+};
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../utils/srefl.hpp"
+#include "../scene_basic/texture_asset_data.hpp"
+#include "../scene_basic/texture_compression.hpp"
+
+namespace bi::cook {
+
+// Each entry cooks `source` in the source directory to `output` in the output directory.
+// `dependencies` are other source files read when cooking, changing them also makes the entry cooked again.
+
+// Source is an image (png, jpg, tga, bmp, hdr or exr) or a texture asset.
+struct TextureCookEntry final {
+    std::string source;
+    std::string output;
+    std::vector<std::string> dependencies;
+    TextureSemantic semantic = TextureSemantic::albedo;
+    bool srgb = false;
+    bool mipmaps = true;
+    // Block-compress the texture, it implies `mipmaps` for 2D textures.
+    bool compress = true;
+    // Alpha test cutoff that coverage of mipmaps is preserved with, 0 if the texture is not alpha tested.
+    float alpha_cutoff = 0.0f;
+    // Missing fields of a given sampler are default values of `rhi::SamplerDesc`.
+    rhi::SamplerDesc sampler{
+        .mag_filter = rhi::SamplerFilterMode::linear,
+        .min_filter = rhi::SamplerFilterMode::linear,
+        .mipmap_mode = rhi::SamplerMipmapMode::linear,
+    };
+};
+BI_SREFL(
+    type(TextureCookEntry),
+    field(source),
+    field(output),
+    field(dependencies),
+    field(semantic),
+    field(srgb),
+    field(mipmaps),
+    field(compress),
+    field(alpha_cutoff),
+    field(sampler),
+);
+
+// Source is a static mesh asset, e.g. one imported by the editor.
+struct MeshCookEntry final {
+    std::string source;
+    std::string output;
+    std::vector<std::string> dependencies;
+    bool optimize = true;
+    bool quantize = true;
+    bool meshlets = true;
+};
+BI_SREFL(
+    type(MeshCookEntry),
+    field(source),
+    field(output),
+    field(dependencies),
+    field(optimize),
+    field(quantize),
+    field(meshlets),
+);
+
+// Source is copied as is, e.g. scenes, materials and asset metadata.
+struct FileCookEntry final {
+    std::string source;
+    std::string output;
+    std::vector<std::string> dependencies;
+};
+BI_SREFL(
+    type(FileCookEntry),
+    field(source),
+    field(output),
+    field(dependencies),
+);
+
+// Stored as TOML. Directories and the database are relative to the manifest.
+struct CookManifest final {
+    std::string source_dir = ".";
+    std::string output_dir = "cooked";
+    std::string database = "cook_database.bidb";
+    std::vector<TextureCookEntry> textures;
+    std::vector<MeshCookEntry> meshes;
+    std::vector<FileCookEntry> files;
+};
+BI_SREFL(
+    type(CookManifest),
+    field(source_dir),
+    field(output_dir),
+    field(database),
+    field(textures),
+    field(meshes),
+    field(files),
+);
+
+}
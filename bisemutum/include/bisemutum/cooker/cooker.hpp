@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+
+#include "cook_manifest.hpp"
+#include "../prelude/option.hpp"
+
+namespace bi::cook {
+
+// Bump it when cooked data of the same source and settings changes, so that all entries are cooked again.
+inline constexpr uint32_t cooker_version = 1;
+
+struct CookSettings final {
+    // Cook all entries even if their inputs, settings and outputs are not changed.
+    bool force = false;
+    // Number of worker threads, (number of hardware threads - 1) if it's 0.
+    uint32_t num_threads = 0;
+};
+
+struct CookStatistics final {
+    uint32_t num_cooked = 0;
+    uint32_t num_up_to_date = 0;
+    uint32_t num_failed = 0;
+};
+
+// Cook entries of the manifest that are changed since the last cooking recorded in the cook database,
+// in parallel. It doesn't need the engine or a graphics device.
+// Return nothing if the manifest can't be read.
+auto cook(std::filesystem::path const& manifest_path, CookSettings const& settings = {}) -> Option<CookStatistics>;
+
+}
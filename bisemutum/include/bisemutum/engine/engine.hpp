@@ -31,7 +31,8 @@ struct MenuManager;
 struct Engine final : PImpl<Engine> {
     struct Impl;
 
-    Engine();
+    // Headless engine has no platform window and swapchain, it only renders to camera targets.
+    Engine(bool headless = false);
 
     auto initialize(int argc, char** argv) -> bool;
     auto finalize() -> bool;
@@ -39,6 +40,7 @@ struct Engine final : PImpl<Engine> {
     auto execute() -> void;
 
     auto is_editor_mode() const -> bool;
+    auto is_headless() const -> bool;
 
     auto window() -> Ref<Window>;
     auto window_manager() -> Ref<WindowManager>;
@@ -54,6 +56,7 @@ struct Engine final : PImpl<Engine> {
     auto logger_manager() -> Ref<rt::LoggerManager>;
     auto component_manager() -> Ref<rt::ComponentManager>;
     auto asset_manager() -> Ref<rt::AssetManager>;
+    auto thread_pool() -> Ref<rt::ThreadPool>;
 
     auto reflection_manager() -> Ref<drefl::ReflectionManager>;
 
@@ -41,6 +41,9 @@ struct Camera final {
     // Order is: front, back, top, down, left, right.
     auto get_frustum_planes() const -> std::array<float4, 6>;
 
+    // Half height of the view volume of orthographic cameras, which is derived from `yfov`.
+    auto ortho_half_height() const -> float;
+
     auto add_history_buffer(std::string key, BufferHandle handle) const -> void;
     auto add_history_texture(std::string key, TextureHandle handle) const -> void;
     auto get_history_buffer(std::string_view key) const -> BufferHandle;
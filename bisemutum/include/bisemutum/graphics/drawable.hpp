@@ -32,6 +32,8 @@ BI_SHADER_PARAMETERS_BEGIN(DrawableShaderData)
     BI_SHADER_PARAMETER(float4x4, matrix_object_to_world)
     BI_SHADER_PARAMETER(float4x4, matrix_world_to_object_transposed)
     BI_SHADER_PARAMETER(float4x4, history_matrix_object_to_world)
+    BI_SHADER_PARAMETER(float4, position_dequantization_offset)
+    BI_SHADER_PARAMETER(float4, position_dequantization_scale)
 BI_SHADER_PARAMETERS_END()
 
 }
@@ -6,6 +6,7 @@
 #include "renderer.hpp"
 #include "displayer.hpp"
 #include "mipmap_mode.hpp"
+#include "texture_streaming.hpp"
 #include "../prelude/idiom.hpp"
 #include "../prelude/move_only_function.hpp"
 #include "../rhi/pipeline.hpp"
@@ -24,13 +25,15 @@ struct GraphicsSettings final {
     bool enable_validation = false;
     uint8_t num_swapchain_textures = 3;
     bool swapchain_srgb = true;
+    TextureStreamingSettings texture_streaming;
 };
 BI_SREFL(
     type(GraphicsSettings),
     field(backend),
     field(enable_validation),
     field(num_swapchain_textures),
-    field(swapchain_srgb)
+    field(swapchain_srgb),
+    field(texture_streaming)
 )
 
 struct Buffer;
@@ -54,6 +57,7 @@ struct Camera;
 struct Material;
 struct Drawable;
 struct MeshData;
+struct DrawIndexRange;
 
 struct GpuSceneData;
 struct GpuSceneSystem;
@@ -75,10 +79,21 @@ struct GraphicsManager final : PImpl<GraphicsManager> {
 
     auto initialize(GraphicsSettings const& settings, std::string_view pipeline_cache_file) -> void;
 
+    // Create pipelines recorded in the manifest by previous runs, with their shaders compiled on worker threads,
+    // so that passes don't need to create them in the first frames. Pipelines created later are recorded and the manifest is saved on exit.
+    // Ray tracing pipelines are not recorded since they depend on the scene.
+    auto warm_up_pipelines(std::string_view pipeline_manifest_file) -> void;
+    // Number of graphics and compute pipelines created when passes require them, excluding warmed up ones.
+    auto num_created_pipelines() const -> uint64_t;
+
     auto wait_idle() -> void;
 
     auto new_frame() -> void;
 
+    // Shaders depending on changed files are compiled again, see `ShaderCompiler::invalidate_changed_files()`.
+    // If they fail to compile, errors are logged and pipelines keep using the old shaders until files change again.
+    auto reload_shaders(CSpan<std::string> changed_paths) -> void;
+
     template <typename Renderer>
     auto register_renderer() -> void {
         register_renderer(std::string{Renderer::renderer_type_name}, []() -> Dyn<IRenderer>::Box { return Renderer{}; });
@@ -99,6 +114,9 @@ struct GraphicsManager final : PImpl<GraphicsManager> {
     auto execute_in_this_frame(std::function<auto(Ref<rhi::CommandEncoder>) -> void> func) -> void;
     auto execute_immediately(std::function<auto(Ref<rhi::CommandEncoder>) -> void> func) -> void;
 
+    // Copy a 2D texture in `sampled_texture_read` state to CPU memory with tightly packed rows, wait for the GPU.
+    auto read_back_texture_2d(Ref<Texture> texture, uint32_t mip_level = 0) -> std::vector<std::byte>;
+
     auto blit_texture_2d(
         Ref<rhi::CommandEncoder> cmd_encoder,
         Ref<Texture> src, uint32_t src_mip_level, uint32_t src_array_layer,
@@ -138,6 +156,8 @@ struct GraphicsManager final : PImpl<GraphicsManager> {
     auto num_frames_in_flight() const -> uint32_t;
     auto curr_frame_index() const -> uint32_t;
 
+    auto texture_streaming_settings() const -> TextureStreamingSettings const&;
+
     auto get_gpu_descriptor_for(
         std::vector<rhi::DescriptorHandle> const& cpu_descriptors,
         rhi::BindGroupLayout const& layout
@@ -163,11 +183,18 @@ private:
     auto add_material_sampler(Ref<Sampler> sampler) -> size_t;
     auto remove_material_sampler(size_t index) -> void;
 
+    friend StreamedTexture;
+    auto add_streamed_texture(StreamedTextureDesc&& desc) -> StreamedTextureHandle;
+    auto remove_streamed_texture(StreamedTextureHandle handle) -> void;
+
     friend GpuSceneSystem;
     auto fill_gpu_scene_data(Ref<GpuSceneData> gpu_scene_data) -> void;
 
     friend RenderGraph;
     auto update_mesh_buffers(CRef<MeshData> mesh) -> void;
+    auto record_texture_usage(CRef<Camera> camera, CRef<Drawable> drawable) -> void;
+    // Meshlets of all meshes share one buffer, the number is the index of the first meshlet of the mesh in it.
+    auto meshlets_buffer(CRef<MeshData> mesh) -> std::pair<Ref<Buffer>, uint32_t>;
     auto require_blas_build_desc(CRef<Drawable> drawable)
         -> std::pair<Option<rhi::AccelerationStructureGeometryBuildInput>, Ref<GeometryAccelerationStructure>>;
 
@@ -175,8 +202,9 @@ private:
     auto bind_mesh_buffers(
         Ref<rhi::GraphicsCommandEncoder> cmd_encoder, CRef<MeshData> mesh
     ) -> void;
+    // Draw only `index_ranges` of the submesh if it's not empty.
     auto draw_drawable(
-        Ref<rhi::GraphicsCommandEncoder> cmd_encoder, Ref<Drawable> drawable
+        Ref<rhi::GraphicsCommandEncoder> cmd_encoder, Ref<Drawable> drawable, CSpan<DrawIndexRange> index_ranges = {}
     ) -> void;
     auto compile_pipeline_for_drawable(
         GraphicsPassContext const* graphics_context, CRef<Camera> camera, Ref<Drawable> drawable, CRef<FragmentShader> fs
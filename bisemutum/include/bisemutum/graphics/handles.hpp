@@ -26,4 +26,8 @@ enum class RenderedObjectListHandle : size_t {
     invalid = static_cast<size_t>(-1),
 };
 
+enum class StreamedTextureHandle : size_t {
+    invalid = static_cast<size_t>(-1),
+};
+
 }
@@ -44,7 +44,7 @@ struct Material final {
     auto modify_compiler_environment(ShaderCompilationEnvironment& compilation_environment) -> void;
     auto modify_compiler_environment_for_gpu_scene(ShaderCompilationEnvironment& compilation_environment) -> void;
 
-    auto get_shader_identifier() const -> std::string;
+    auto get_shader_hash() const -> uint64_t;
 
     SurfaceModel surface_model = SurfaceModel::lit;
     BlendMode blend_mode = BlendMode::opaque;
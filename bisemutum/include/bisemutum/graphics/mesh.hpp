@@ -1,8 +1,12 @@
 #pragma once
 
+#include <atomic>
+
 #include "shader_source.hpp"
 #include "shader_param.hpp"
 #include "shader_compilation_environment.hpp"
+#include "vertex_quantization.hpp"
+#include "meshlet.hpp"
 #include "../prelude/poly.hpp"
 #include "../prelude/byte_stream.hpp"
 #include "../math/bbox.hpp"
@@ -61,14 +65,45 @@ struct MeshData final {
 
     auto bounding_box() const -> BoundingBox const&;
     auto submesh_bounding_box(uint32_t index) const -> BoundingBox const&;
-
+    // Square root of texcoord area over object space area of triangles, 0 if there is no texcoord.
+    auto submesh_texcoord_density(uint32_t index) const -> float;
+
+    // If it's set, vertex buffers on GPU and saved data are quantized, see 'vertex_quantization.hpp'.
+    // Data here are always not quantized.
+    auto is_quantized() const -> bool { return quantized_; }
+    auto set_quantized(bool quantized) -> void;
+    // Positions are quantized relative to the bounding box of their submesh,
+    // or that of the whole mesh if vertices of submeshes overlap.
+    auto submesh_position_quantization(uint32_t index) const -> PositionQuantization const&;
+    auto quantized_positions() const -> std::vector<uint2>;
+    auto quantized_normals() const -> std::vector<uint32_t>;
+    auto quantized_tangents() const -> std::vector<uint2>;
+    auto quantized_texcoords() const -> std::vector<uint32_t>;
+    auto quantized_texcoords2() const -> std::vector<uint32_t>;
+
+    // Meshlets are cleared when positions, indices or submeshes are changed, see 'meshlet.hpp'.
+    auto has_meshlets() const -> bool { return !meshlets_.empty(); }
+    auto meshlets() const -> std::vector<Meshlet> const& { return meshlets_; }
+    // Index of the first meshlet of the submesh in `meshlets()`.
+    auto submesh_meshlet_offset(uint32_t index) const -> uint32_t;
+    auto submesh_meshlets(uint32_t index) const -> CSpan<Meshlet>;
+    // `submesh_meshlet_offsets` has one more element than the number of submeshes.
+    auto set_meshlets(std::vector<Meshlet> meshlets, std::vector<uint32_t> submesh_meshlet_offsets) -> void;
+
+    // 0: original, 1: add quantization flag, 2: add meshlets.
+    static constexpr uint32_t latest_data_version = 2;
     auto save_to_byte_stream(WriteByteStream& bs) const -> void;
-    auto load_from_byte_stream(ReadByteStream& bs) -> void;
+    auto load_from_byte_stream(ReadByteStream& bs, uint32_t data_version = latest_data_version) -> void;
 
 private:
     auto set_buffer_dirty() -> void;
     auto set_geometry_dirty() -> void;
     auto set_submesh_dirty(uint32_t index) -> void;
+    auto clear_meshlets() -> void;
+
+    auto update_position_quantizations() const -> void;
+    // Index to `position_quantizations_` of each vertex.
+    auto vertex_position_quantization_indices() const -> std::vector<uint32_t>;
 
     auto get_submesh_version(uint32_t index) const -> uint64_t;
 
@@ -85,10 +120,32 @@ private:
 
     mutable BoundingBox bbox_;
     mutable std::vector<BoundingBox> submesh_bboxes_;
+    // Negative if it needs to be computed.
+    mutable std::vector<float> submesh_texcoord_densities_;
+
+    bool quantized_ = false;
+    // One for each submesh, followed by the one for vertices not used by any submesh. Empty if it needs to be computed.
+    mutable std::vector<PositionQuantization> position_quantizations_;
+
+    std::vector<Meshlet> meshlets_;
+    std::vector<uint32_t> submesh_meshlet_offsets_;
 
     friend GraphicsManager;
-    static uint64_t curr_id_;
-    const uint64_t id_;
+    // Meshes are loaded and imported on worker threads.
+    static std::atomic<uint64_t> curr_id_;
+    // GPU resources of a mesh are cached by its id. Copied and moved-from meshes get new ids,
+    // and ids of destroyed meshes are queued so that `GraphicsManager` can release their resources.
+    struct Id final {
+        Id();
+        Id(Id const& rhs);
+        Id(Id&& rhs) noexcept;
+        ~Id();
+        auto operator=(Id const& rhs) -> Id& = delete;
+
+        uint64_t value;
+    };
+    static auto take_destroyed_ids() -> std::vector<uint64_t>;
+    Id id_;
     uint64_t buffer_version_ = 1;
     uint64_t geometry_version_ = 1;
     std::vector<uint64_t> submesh_versions_;
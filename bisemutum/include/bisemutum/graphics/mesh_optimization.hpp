@@ -0,0 +1,30 @@
+#pragma once
+
+#include "mesh.hpp"
+
+namespace bi::gfx {
+
+struct MeshOptimizationSettings final {
+    // Number of entries of the simulated FIFO post-transform vertex cache.
+    uint32_t vertex_cache_size = 16;
+    // A cluster can be split when its ACMR is not worse than the ACMR of the whole cluster times this.
+    float overdraw_threshold = 1.05f;
+};
+
+struct MeshOptimizationStatistics final {
+    uint32_t num_vertices_before = 0;
+    uint32_t num_vertices_after = 0;
+    // Average number of vertex cache misses per triangle.
+    float acmr_before = 0.0f;
+    float acmr_after = 0.0f;
+    // Number of shaded pixels over number of covered pixels, measured from 6 axis-aligned views.
+    float overdraw_before = 0.0f;
+    float overdraw_after = 0.0f;
+};
+
+// Deduplicate vertices of each submesh, reorder triangles of triangle list submeshes for vertex cache (Tipsify)
+// and then for overdraw (by sorting clusters), and finally reorder vertices by their first uses.
+// Vertices not referenced by any submesh are removed. Meshes without index data are not changed.
+auto optimize_mesh(MeshData& mesh, MeshOptimizationSettings const& settings = {}) -> MeshOptimizationStatistics;
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../math/math.hpp"
+#include "../prelude/span.hpp"
+
+namespace bi::gfx {
+
+struct MeshData;
+
+// Same layout as `Meshlet` in 'meshlet_culling.hlsl'.
+struct Meshlet final {
+    // Center is xyz and radius is w, in object space.
+    float4 bounding_sphere{0.0f};
+    // Axis is xyz and cutoff is w, in object space. Cutoff is 1 if the cone is too wide to be culled.
+    float4 normal_cone{0.0f, 0.0f, 1.0f, 1.0f};
+    // Relative to `index_offset` of the submesh.
+    uint32_t index_offset = 0;
+    uint32_t num_indices = 0;
+    uint32_t num_vertices = 0;
+    uint32_t _pad = 0;
+};
+
+struct MeshletBuildSettings final {
+    uint32_t max_num_vertices = 64;
+    uint32_t max_num_triangles = 124;
+};
+
+// Reorder triangles of each triangle list submesh so that each meshlet is a contiguous range of its indices,
+// and compute bounds of meshlets. Submeshes of other topologies and meshes without index data get no meshlets.
+auto build_meshlets(MeshData& mesh, MeshletBuildSettings const& settings = {}) -> void;
+
+struct MeshletCullingParams final {
+    // In world space, see `Camera::get_frustum_planes()`.
+    CSpan<float4> frustum_planes;
+    float4x4 matrix_object_to_world{1.0f};
+    // Used to scale radius of bounding spheres.
+    float max_scaling = 1.0f;
+    // In object space, the former is used by perspective views and the latter by orthographic views.
+    float3 view_position{0.0f};
+    float3 view_direction{0.0f, 0.0f, 1.0f};
+    bool orthographic = false;
+    // 1 if back faces are culled, -1 if front faces are culled, or 0 to skip normal cone test.
+    // It should be flipped when the transform mirrors triangles.
+    float back_face_sign = 0.0f;
+};
+
+// Reference of the culling done in 'meshlet_culling.hlsl'.
+auto is_meshlet_visible(Meshlet const& meshlet, MeshletCullingParams const& params) -> bool;
+
+}
@@ -92,6 +92,8 @@ struct GraphicsPassBuilder final {
     auto read(BufferHandle handle) -> BufferHandle;
     auto read(TextureHandle handle) -> TextureHandle;
     auto read(AccelerationStructureHandle handle) -> AccelerationStructureHandle;
+    // Read buffers of the list generated on GPU, if there are any.
+    auto read(RenderedObjectListHandle handle) -> RenderedObjectListHandle;
 
     auto write(BufferHandle handle) -> BufferHandle;
     auto write(TextureHandle handle) -> TextureHandle;
@@ -17,6 +17,15 @@ enum class RendererObjectSortingMode : uint8_t {
     from_front_to_back,
     from_back_to_front,
 };
+enum class MeshletCullingMode : uint8_t {
+    // Submeshes are always drawn entirely.
+    none,
+    // Visible meshlets are collected on CPU and drawn as compacted index ranges.
+    cpu,
+    // Visible meshlets are collected by a compute pass into indirect draw arguments.
+    // Graphics passes rendering the list should read it by `GraphicsPassBuilder::read()`.
+    gpu,
+};
 struct RenderedObjectListDesc final {
     CRef<Camera> camera;
     CRef<FragmentShader> fragment_shader;
@@ -25,17 +34,44 @@ struct RenderedObjectListDesc final {
     Span<Ref<Drawable>> candidate_drawables;
     bool do_frustum_culling = true;
     RendererObjectSortingMode sorting_mode = RendererObjectSortingMode::from_front_to_back;
+    // Opt-in since culling on CPU costs time for each drawable every frame.
+    // Only works when `do_frustum_culling` is set. Drawables without meshlets are not affected.
+    MeshletCullingMode meshlet_culling_mode = MeshletCullingMode::none;
+};
+
+// Relative to `index_offset` of the submesh.
+struct DrawIndexRange final {
+    uint32_t index_offset;
+    uint32_t num_indices;
 };
 
 // Drawables those can use the same pipline state and vertex buffer.
 struct RenderedObjectListItem final {
     std::vector<Ref<Drawable>> drawables;
+    // Empty, or one for each drawable if meshlets are culled on CPU. Empty ranges of a drawable means it's drawn entirely.
+    std::vector<std::vector<DrawIndexRange>> index_ranges;
+    // Empty, or one for each drawable if meshlets are culled on GPU. `~0u` means the drawable is drawn entirely,
+    // otherwise it's an index to `RenderedObjectList::meshlet_culling_jobs`.
+    std::vector<uint32_t> meshlet_culling_jobs;
+};
+
+struct MeshletCullingJob final {
+    // Number of meshlets and offset of draw arguments in `RenderedObjectList::indirect_args`.
+    uint32_t num_meshlets;
+    uint32_t args_offset;
 };
 
 struct RenderedObjectList final {
     CRef<Camera> camera;
     CRef<FragmentShader> fragment_shader;
     std::vector<RenderedObjectListItem> items;
+
+    // Only used when meshlets are culled on GPU.
+    std::vector<MeshletCullingJob> meshlet_culling_jobs;
+    // `rhi::DrawIndexedIndirectCommand`s.
+    BufferHandle indirect_args = BufferHandle::invalid;
+    // Number of draws of each job.
+    BufferHandle indirect_counts = BufferHandle::invalid;
 };
 
 }
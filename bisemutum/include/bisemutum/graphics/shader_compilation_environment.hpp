@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../containers/hash.hpp"
+#include "../utils/crypto.hpp"
 
 namespace bi::gfx {
 
@@ -19,10 +20,17 @@ struct ShaderCompilationEnvironment final {
 
     auto reset_replace_arg(std::string_view key) -> void;
 
-    auto get_config_identifier() const -> std::string;
+    // Hash of all defines and replace args, it's updated when they are changed and doesn't depend on their order.
+    // It's FNV-1a based since it's a part of shader keys saved by the shader compiler.
+    auto config_hash() const -> uint64_t { return crypto::fnv1a_64(replace_args_hash_, defines_hash_); }
 
+    // Modified only through functions above, so that hashes are kept up to date.
     StringHashMap<std::string> defines{};
     StringHashMap<std::string> replace_args{};
+
+private:
+    uint64_t defines_hash_ = 0;
+    uint64_t replace_args_hash_ = 0;
 };
 
 }
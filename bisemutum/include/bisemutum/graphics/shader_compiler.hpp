@@ -1,8 +1,12 @@
 #pragma once
 
+#include <future>
+
 #include "shader_compilation_environment.hpp"
+#include "../prelude/box.hpp"
 #include "../prelude/idiom.hpp"
 #include "../prelude/expected.hpp"
+#include "../prelude/span.hpp"
 #include "../rhi/shader.hpp"
 
 namespace bi::rhi {
@@ -13,6 +17,16 @@ struct Device;
 
 namespace bi::gfx {
 
+struct ShaderCompilationRequest final {
+    std::string source_path;
+    std::string entry;
+    rhi::ShaderStage shader_stage;
+    ShaderCompilationEnvironment environment;
+};
+
+using ShaderCompilationResult = Expected<Ref<rhi::ShaderModule>, std::string>;
+
+// It's thread-safe, shaders can be compiled from any thread.
 struct ShaderCompiler final : PImpl<ShaderCompiler> {
     struct Impl;
 
@@ -25,7 +39,19 @@ struct ShaderCompiler final : PImpl<ShaderCompiler> {
         std::string_view entry,
         rhi::ShaderStage shader_stage,
         ShaderCompilationEnvironment const& environment
-    ) -> Expected<Ref<rhi::ShaderModule>, std::string>;
+    ) -> ShaderCompilationResult;
+
+    // Compile shaders in parallel on worker threads, results are in the same order as requests.
+    auto compile_shader_async(
+        std::vector<ShaderCompilationRequest> requests
+    ) -> std::future<std::vector<ShaderCompilationResult>>;
+
+    // Requests compiled successfully so far, each of them is listed once.
+    auto compiled_requests() -> std::vector<ShaderCompilationRequest>;
+
+    // Drop cached modules whose source or included headers are changed, so that they are compiled again.
+    // Dropped modules are returned, callers should keep them alive until pipelines using them are destroyed.
+    auto invalidate_changed_files(CSpan<std::string> changed_paths) -> std::vector<Box<rhi::ShaderModule>>;
 };
 
 }
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+
+#include "handles.hpp"
+#include "../prelude/ref.hpp"
+#include "../rhi/resource.hpp"
+#include "../utils/srefl.hpp"
+
+namespace bi::gfx {
+
+struct Texture;
+
+struct TextureStreamingSettings final {
+    bool enabled = true;
+    // Total size of resident levels of all streamed textures.
+    uint64_t memory_budget = 2048ull << 20;
+    // Levels whose width and height are not larger than this are always resident.
+    uint32_t tail_size = 128;
+    // Size of levels uploaded in one frame, including levels uploaded again when dropping top levels.
+    // At least one texture is updated per frame.
+    uint64_t max_upload_size_per_frame = 32ull << 20;
+    // Textures not rendered for this many frames go back to their tail levels.
+    uint32_t num_unused_frames_to_evict = 300;
+};
+BI_SREFL(
+    type(TextureStreamingSettings),
+    field(enabled),
+    field(memory_budget),
+    field(tail_size),
+    field(max_upload_size_per_frame),
+    field(num_unused_frames_to_evict),
+)
+
+struct StreamedTextureDesc final {
+    // The texture contains levels from `first_level` of the full mip chain.
+    Ref<Texture> texture;
+    uint32_t width = 1;
+    uint32_t height = 1;
+    // Size of each level of the full mip chain.
+    std::vector<uint64_t> level_sizes;
+    // Called to recreate `texture` with levels from `first_level`. It returns false if data of these levels is not
+    // ready yet, and is called again in later frames. Tail levels must be ready when the texture is added.
+    std::function<auto(uint32_t first_level) -> bool> update_levels;
+};
+
+// First level of the tail levels, which are always resident. It's 0 if streaming is disabled.
+auto streamed_texture_tail_level(
+    TextureStreamingSettings const& settings, uint32_t width, uint32_t height, uint32_t num_levels
+) -> uint32_t;
+
+// Keeps a texture registered in texture streaming. It starts with tail levels, `update_levels` is called at once.
+// Resident levels are estimated from drawables collected by `RenderGraph::add_rendered_object_list()`.
+struct StreamedTexture final {
+    StreamedTexture() = default;
+    StreamedTexture(StreamedTextureDesc desc);
+    ~StreamedTexture();
+
+    StreamedTexture(StreamedTexture&& rhs) noexcept;
+    auto operator=(StreamedTexture&& rhs) noexcept -> StreamedTexture&;
+
+    auto has_value() const -> bool { return handle_ != StreamedTextureHandle::invalid; }
+    auto reset() -> void;
+
+private:
+    StreamedTextureHandle handle_ = StreamedTextureHandle::invalid;
+};
+
+}
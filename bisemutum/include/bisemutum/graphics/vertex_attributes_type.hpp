@@ -13,6 +13,8 @@ enum class VertexAttributesType : uint8_t {
     color = 0x10,
     texcoord = 0x20,
     texcoord2 = 0x40,
+    // Input attributes are quantized, see 'vertex_quantization.hpp'.
+    quantized = 0x80,
     position_only = position,
     position_texcoord = position | texcoord,
     full = position | history_position | normal | tangent | color | texcoord,
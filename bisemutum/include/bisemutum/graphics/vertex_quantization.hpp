@@ -0,0 +1,31 @@
+#pragma once
+
+#include "../math/bbox.hpp"
+
+namespace bi::gfx {
+
+// Quantized vertex attributes are stored in formats that vertex input can read directly:
+// - position: `rgba16_unorm`, dequantized by `offset + scale * xyz`, w is unused.
+// - normal: `rg16_snorm`, octahedral encoded.
+// - tangent: `rgba16_snorm`, octahedral encoded in xy, handedness in z, w is unused.
+// - texcoord: `rg16_sfloat`.
+
+struct PositionQuantization final {
+    float3 offset{0.0f};
+    float3 scale{1.0f};
+};
+auto position_quantization_of(BoundingBox const& bbox) -> PositionQuantization;
+
+auto quantize_position(float3 const& position, PositionQuantization const& quantization) -> uint2;
+auto dequantize_position(uint2 quantized, PositionQuantization const& quantization) -> float3;
+
+auto quantize_normal(float3 const& normal) -> uint32_t;
+auto dequantize_normal(uint32_t quantized) -> float3;
+
+auto quantize_tangent(float4 const& tangent) -> uint2;
+auto dequantize_tangent(uint2 quantized) -> float4;
+
+auto quantize_texcoord(float2 const& texcoord) -> uint32_t;
+auto dequantize_texcoord(uint32_t quantized) -> float2;
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "bbox.hpp"
+
+namespace bi {
+
+// Static bounding volume hierarchy over a set of boxes, rebuilt as a whole when the boxes change.
+struct AabbTree final {
+    auto build(CSpan<BoundingBox> boxes) -> void;
+    auto clear() -> void;
+
+    auto empty() const -> bool { return nodes_.empty(); }
+
+    // Call `func(box_index)` for each box that contains `point`.
+    template <typename Func>
+    auto for_each_containing(float3 const& point, Func&& func) const -> void {
+        if (nodes_.empty()) { return; }
+
+        uint32_t stack[max_depth];
+        uint32_t stack_size = 0;
+        stack[stack_size++] = 0;
+        while (stack_size > 0) {
+            auto& node = nodes_[stack[--stack_size]];
+            if (!contains(node.bbox, point)) { continue; }
+            if (node.count > 0) {
+                for (uint32_t i = 0; i < node.count; i++) {
+                    auto box_index = indices_[node.first + i];
+                    if (contains(boxes_[box_index], point)) {
+                        func(box_index);
+                    }
+                }
+            } else {
+                stack[stack_size++] = node.first;
+                stack[stack_size++] = node.first + 1;
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t max_leaf_size = 4;
+    static constexpr uint32_t max_depth = 64;
+
+    struct Node final {
+        BoundingBox bbox;
+        // Index of left child (right child is next to it) for interior node, or offset into indices for leaf.
+        uint32_t first = 0;
+        // Number of boxes in leaf, 0 for interior node.
+        uint32_t count = 0;
+    };
+
+    static auto contains(BoundingBox const& bbox, float3 const& point) -> bool {
+        return math::all(math::greaterThanEqual(point, bbox.p_min) & math::lessThanEqual(point, bbox.p_max));
+    }
+
+    auto build_node(uint32_t node_index, uint32_t begin, uint32_t end, uint32_t depth) -> void;
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> indices_;
+    std::vector<BoundingBox> boxes_;
+};
+
+}
@@ -3,11 +3,38 @@
 #include <cstddef>
 #include <vector>
 #include <string>
+#include <functional>
 
 #include "span.hpp"
+#include "poly.hpp"
+#include "option.hpp"
 
 namespace bi {
 
+enum class CompressionCodec : uint32_t {
+    none,
+    // Only used by old assets, kept for reading them.
+    miniz,
+    zstd,
+    lz4,
+};
+
+// Compressed parts are split into chunks of this size, which are compressed and decompressed in parallel.
+inline constexpr uint64_t compression_chunk_size = 1ull << 20;
+
+// Window size of streaming `ReadByteStream`s.
+inline constexpr uint64_t byte_stream_window_size = 4 * compression_chunk_size;
+
+// Call `func(index)` for each index in [0, count) and return after all of them finish, e.g. on a thread pool.
+// Chunks are compressed and decompressed one by one if it is empty.
+using ParallelFor = std::function<auto(size_t count, std::function<auto(size_t) -> void> func) -> void>;
+
+// Supply data of a streaming `ReadByteStream` in order.
+// Return the number of bytes written to `dst`, which is 0 only at the end of data.
+BI_TRAIT_BEGIN(IByteStreamSource, move)
+    BI_TRAIT_METHOD(read_some, (&self, Span<std::byte> dst) requires (self.read_some(dst)) -> size_t)
+BI_TRAIT_END(IByteStreamSource)
+
 template <typename T>
 inline constexpr bool can_be_used_for_byte_stream = std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>;
 
@@ -15,10 +42,14 @@ struct ReadByteStream final {
     ReadByteStream() = default;
     ReadByteStream(CSpan<std::byte> data) : data_(data) {}
     ReadByteStream(std::vector<std::byte> data) : owned_data_(std::move(data)), data_(owned_data_) {}
+    // Streaming stream of `size` bytes, data is pulled from `source` through a fixed-size window.
+    // Only forward seeking is supported.
+    ReadByteStream(Dyn<IByteStreamSource>::Box source, size_t size, size_t window_size = byte_stream_window_size);
 
-    auto size() const -> size_t { return data_.size(); }
+    auto size() const -> size_t { return source_ ? size_ : data_.size(); }
+    auto is_streaming() const -> bool { return source_.has_value(); }
 
-    auto curr_offset() const -> size_t { return curr_offset_; }
+    auto curr_offset() const -> size_t { return window_offset_ + curr_offset_; }
     auto set_offset(size_t offset) -> void;
 
     auto read_raw(std::byte* dst, size_t size) -> ReadByteStream&;
@@ -43,12 +74,33 @@ struct ReadByteStream final {
         return *this;
     }
 
-    auto read_compressed_part(ReadByteStream& uncompressed_bs) -> ReadByteStream&;
+    // `uncompressed_bs` is empty if the data is corrupted.
+    auto read_compressed_part(ReadByteStream& uncompressed_bs, ParallelFor parallel_for = {}) -> ReadByteStream&;
+    // Same as `read_compressed_part()`, but `uncompressed_bs` is a streaming stream which decompresses chunks
+    // when they are read, so that the whole uncompressed data never exists in memory.
+    // Data of this stream must outlive `uncompressed_bs` if this stream is not streaming,
+    // and `parallel_for` is kept in `uncompressed_bs`.
+    auto read_compressed_part_streaming(
+        ReadByteStream& uncompressed_bs, ParallelFor parallel_for = {}
+    ) -> ReadByteStream&;
 
 private:
+    auto refill() -> bool;
+    auto read_compressed_part_impl(
+        ReadByteStream& uncompressed_bs, bool streaming, ParallelFor&& parallel_for
+    ) -> ReadByteStream&;
+    // Return a view of the data without copying if it's not streaming, otherwise read the data into `storage`.
+    auto read_or_view(size_t size, std::vector<std::byte>& storage) -> CSpan<std::byte>;
+
     std::vector<std::byte> owned_data_;
+    // The whole data, or the current window if it's streaming.
     CSpan<std::byte> data_;
     size_t curr_offset_ = 0;
+
+    Option<Dyn<IByteStreamSource>::Box> source_;
+    size_t size_ = 0;
+    // Offset of the current window in the whole stream.
+    size_t window_offset_ = 0;
 };
 
 struct WriteByteStream final {
@@ -82,7 +134,10 @@ struct WriteByteStream final {
         return *this;
     }
 
-    auto compress_data(size_t from = 0) -> WriteByteStream&;
+    // Compress data from `from` to the current offset in place.
+    auto compress_data(
+        size_t from = 0, CompressionCodec codec = CompressionCodec::zstd, ParallelFor const& parallel_for = {}
+    ) -> WriteByteStream&;
 
 private:
     std::vector<std::byte> data_;
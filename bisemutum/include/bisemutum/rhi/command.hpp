@@ -117,6 +117,15 @@ struct Scissor final {
     uint32_t height;
 };
 
+// Same layout as 'VkDrawIndexedIndirectCommand' and 'D3D12_DRAW_INDEXED_ARGUMENTS'.
+struct DrawIndexedIndirectCommand final {
+    uint32_t num_indices;
+    uint32_t num_instance;
+    uint32_t first_index;
+    int32_t vertex_offset;
+    uint32_t first_instance;
+};
+
 struct CommandEncoder;
 struct GraphicsCommandEncoder;
 struct ComputeCommandEncoder;
@@ -231,6 +240,13 @@ struct GraphicsCommandEncoder : public CommandEncoderBase {
         uint32_t vertex_offset = 0,
         uint32_t first_instance = 0
     ) -> void = 0;
+    // Number of draws is the minimum of `max_num_draws` and the `uint32_t` at `count_offset` of `count_buffer`.
+    // Only valid if `DeviceProperties::draw_indirect_count` is set.
+    virtual auto draw_indexed_indirect_count(
+        Ref<Buffer> buffer, uint64_t offset,
+        Ref<Buffer> count_buffer, uint64_t count_offset,
+        uint32_t max_num_draws, uint32_t stride = sizeof(DrawIndexedIndirectCommand)
+    ) -> void = 0;
 };
 
 struct ComputeCommandEncoder : public CommandEncoderBase {
@@ -7,6 +7,8 @@ namespace bi::rhi {
 enum class Backend : uint8_t {
     vulkan,
     d3d12,
+    // No GPU work, commands are recorded and counted only.
+    null,
 };
 
 struct Extent3D final {
@@ -170,5 +172,7 @@ inline auto is_compressed_format(ResourceFormat format) -> bool {
 }
 
 auto format_texel_size(ResourceFormat format) -> uint32_t;
+// Size of a 4x4 block of block-compressed formats, 0 for other formats.
+auto format_block_size(ResourceFormat format) -> uint32_t;
 
 }
@@ -23,6 +23,7 @@ struct DeviceProperties final {
     bool descriptor_heap_suballocation : 1 = true;
     bool meshlet_pipeline : 1 = false;
     bool raytracing_pipeline : 1 = false;
+    bool draw_indirect_count : 1 = false;
 };
 
 struct Device {
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "device.hpp"
+
+namespace bi::rhi {
+
+// Counters of a device created with `Backend::null`.
+// Command counters are accumulated when command buffers are submitted, others when the device is called.
+struct NullDeviceStatistics final {
+    uint64_t submitted_command_buffers = 0;
+    uint64_t recorded_command_bytes = 0;
+
+    uint64_t render_passes = 0;
+    uint64_t compute_passes = 0;
+    uint64_t raytracing_passes = 0;
+    uint64_t draws = 0;
+    uint64_t draw_indexed = 0;
+    uint64_t draw_indexed_indirect = 0;
+    uint64_t dispatches = 0;
+    uint64_t dispatch_rays = 0;
+    uint64_t pipeline_binds = 0;
+    uint64_t descriptor_binds = 0;
+    uint64_t push_constant_bytes = 0;
+
+    uint64_t buffer_barriers = 0;
+    uint64_t texture_barriers = 0;
+
+    // Bytes copied from `cpu_to_gpu` buffers.
+    uint64_t bytes_uploaded = 0;
+    // Bytes copied by all copy commands, including uploads.
+    uint64_t bytes_copied = 0;
+    uint64_t acceleration_structure_builds = 0;
+
+    uint64_t descriptor_writes = 0;
+    uint64_t descriptor_copies = 0;
+
+    uint64_t buffers_created = 0;
+    uint64_t textures_created = 0;
+    uint64_t pipelines_created = 0;
+};
+
+// Return empty if `device` is not a null device.
+auto null_device_statistics(CRef<Device> device) -> Option<NullDeviceStatistics>;
+auto reset_null_device_statistics(Ref<Device> device) -> void;
+
+// Binary data that `shader_module` is created from, it must be created by `device`.
+auto null_shader_module_binary(CRef<Device> device, CRef<ShaderModule> shader_module) -> Option<CSpan<std::byte>>;
+
+}
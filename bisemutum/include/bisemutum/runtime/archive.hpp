@@ -0,0 +1,108 @@
+#pragma once
+
+#include "vfs.hpp"
+
+namespace bi::rt {
+
+inline constexpr std::string_view archive_extension = ".bipack";
+
+// Layout of a pack file:
+//   `ArchiveHeader`, file chunks, `ArchiveEntry` array sorted by path hash, string pool of paths.
+// Stored (uncompressed) chunks are aligned to `archive_page_alignment` so that they can be used directly
+// from the mapped pack.
+inline constexpr uint32_t archive_magic_number = 0x4b504942; // 'BIPK'
+inline constexpr uint32_t archive_version = 1;
+inline constexpr uint64_t archive_page_alignment = 4096;
+inline constexpr uint64_t archive_chunk_alignment = 16;
+
+struct ArchiveHeader final {
+    uint32_t magic_number = archive_magic_number;
+    uint32_t version = archive_version;
+    uint64_t num_entries = 0;
+    uint64_t entries_offset = 0;
+    uint64_t string_pool_offset = 0;
+    uint64_t string_pool_size = 0;
+};
+
+enum class ArchiveChunkType : uint32_t {
+    stored,
+    // Deflate stream of miniz.
+    compressed,
+};
+
+struct ArchiveEntry final {
+    uint64_t path_hash;
+    uint64_t path_offset;
+    uint32_t path_length;
+    ArchiveChunkType chunk_type;
+    uint64_t chunk_offset;
+    uint64_t chunk_size;
+    uint64_t size;
+};
+
+// Hash of a normalized path relative to the pack root, stable across platforms.
+auto archive_path_hash(std::string_view path) -> uint64_t;
+
+struct ArchiveBuildSettings final {
+    // Chunks are compressed only if it saves at least this ratio of the original size.
+    float min_compression_saving = 0.1f;
+    bool compress = true;
+};
+
+// Pack all regular files under `src_dir` recursively.
+auto build_archive(
+    std::filesystem::path const& src_dir, std::filesystem::path const& dst_path, ArchiveBuildSettings const& settings
+) -> bool;
+
+
+struct ArchiveSubFileSystem;
+
+struct ArchiveFile final {
+    auto is_writable() const -> bool { return false; }
+    auto filename() const -> std::string;
+    auto extension() const -> std::string;
+
+    auto read_string_data() -> std::string;
+    auto read_binary_data() -> std::vector<std::byte>;
+    // Stored chunks are returned without copying, compressed ones are decompressed once and kept in the file.
+    auto map_binary_data() -> CSpan<std::byte>;
+    auto size() const -> uint64_t { return entry_.size; }
+
+    auto write_string_data(std::string_view data) -> bool { return false; }
+    auto write_binary_data(CSpan<std::byte> data) -> bool { return false; }
+
+private:
+    friend ArchiveSubFileSystem;
+    ArchiveFile(PhysicalFile pack, ArchiveEntry const& entry, std::string path);
+
+    auto chunk_data() -> CSpan<std::byte>;
+    auto decompress() -> std::vector<std::byte>;
+
+    // Keeps the pack mapped while the file is alive.
+    PhysicalFile pack_;
+    ArchiveEntry entry_;
+    std::string path_;
+    std::vector<std::byte> decompressed_data_;
+    bool decompressed_ = false;
+};
+
+// Read-only sub file system backed by a single mapped pack file.
+struct ArchiveSubFileSystem final : PImpl<ArchiveSubFileSystem> {
+    struct Impl;
+
+    ArchiveSubFileSystem(std::filesystem::path pack_path);
+
+    auto is_valid() const -> bool;
+
+    auto is_writable() const -> bool { return false; }
+
+    auto has_file(std::string_view path) const -> bool;
+    auto get_file(std::string_view path) const -> Option<Dyn<IFile>::Box>;
+
+    auto create_file(std::string_view path) -> Option<Dyn<IFile>::Box> { return {}; }
+    auto remove_file(std::string_view path) -> bool { return false; }
+
+    auto get_physical_path() const -> std::filesystem::path { return {}; }
+};
+
+}
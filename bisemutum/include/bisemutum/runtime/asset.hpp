@@ -2,6 +2,7 @@
 
 #include "vfs.hpp"
 #include "../utils/serde.hpp"
+#include "../prelude/byte_stream.hpp"
 #include "../prelude/ref.hpp"
 
 namespace bi::rt {
@@ -29,11 +30,21 @@ enum class AssetState : uint8_t {
     not_found,
 };
 
+// Assets whose `load()` only reads and decodes data, so that it can be called on worker threads.
+// `finalize_load()` is then called on the main thread to create GPU resources or resolve dependencies,
+// it returns `loading` if it needs to be called again after dependencies are loaded.
+template <typename T>
+concept TAsyncAsset = TAsset<T> && requires (T v) {
+    { v.finalize_load() } -> std::same_as<AssetState>;
+};
+
 struct AssetPtr final {
     static auto from_path(std::string_view asset_path) -> AssetPtr;
 
     auto state() const -> AssetState;
     auto load() const -> AssetAny*;
+    // Start loading if it's not loaded and return the current state.
+    auto load_async() const -> AssetState;
 
     auto edit(std::string_view type) -> bool;
 
@@ -64,6 +75,14 @@ struct TAssetPtr final {
     auto load() const -> void {
         asset_ = aa::any_cast<Asset>(asset_ptr_.load());
     }
+    // `asset()` is valid once it returns `loaded`, call it again in later frames while it's `loading`.
+    auto load_async() const -> AssetState {
+        auto state = asset_ptr_.load_async();
+        if (state == AssetState::loaded && !asset_) {
+            load();
+        }
+        return state;
+    }
 
     auto asset_id() const -> AssetId {
         return asset_ptr_.asset_id;
@@ -80,6 +99,14 @@ struct TAssetPtr final {
         o.asset_ptr_.asset_id = static_cast<AssetId>(v["asset_id"].get<serde::Value::Integer>());
     }
 
+    static auto to_byte_stream(WriteByteStream& bs, rt::TAssetPtr<Asset> const& o) -> void {
+        bs.write(o.asset_ptr_.asset_id);
+    }
+    static auto from_byte_stream(ReadByteStream& bs, rt::TAssetPtr<Asset>& o) -> void {
+        o.asset_ = nullptr;
+        bs.read(o.asset_ptr_.asset_id);
+    }
+
     auto edit() -> bool { return asset_ptr_.edit(Asset::asset_type_name); }
 
 private:
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <functional>
 
 #include "asset.hpp"
@@ -10,6 +11,9 @@ namespace bi::rt {
 
 using AssetLoader = auto(Dyn<IFile>::Ref) -> AssetAny;
 using AssetSaver = auto(Dyn<IFile>::Ref, AssetAny const&) -> void;
+using AssetFinalizer = auto(AssetAny&) -> AssetState;
+using AssetReplacer = auto(AssetAny&, AssetAny&&) -> void;
+using AssetLoadCallback = auto(AssetAny*) -> void;
 
 struct AssetMetadata final {
     uint64_t id;
@@ -18,6 +22,8 @@ struct AssetMetadata final {
 };
 BI_SREFL(type(AssetMetadata), field(id), field(type), field(path));
 
+auto asset_metadata_index_path(std::string_view metadata_path) -> std::string;
+
 struct AssetManager final : PImpl<AssetManager> {
     struct Impl;
 
@@ -26,9 +32,15 @@ struct AssetManager final : PImpl<AssetManager> {
     struct AssetFunctions final {
         std::function<AssetLoader> loader;
         std::function<AssetSaver> saver;
+        // Only set for `TAsyncAsset`, others are always loaded synchronously.
+        std::function<AssetFinalizer> finalizer;
+        // Replace the value in place, so that pointers to the old one stay valid.
+        std::function<AssetReplacer> replacer;
     };
 
-    auto initialize(Dyn<IFile>::Ref metadata_file) -> bool;
+    // Metadata is read from the binary index next to the TOML file (see `asset_metadata_index_path()`),
+    // it's imported from the TOML file if the index doesn't exist or the TOML file is changed after it's written.
+    auto initialize(std::string_view metadata_path) -> bool;
 
     template <TAsset Asset>
     auto register_asset() -> void {
@@ -37,12 +49,45 @@ struct AssetManager final : PImpl<AssetManager> {
             .saver = [](Dyn<IFile>::Ref file, AssetAny const& value) {
                 aa::any_cast<Asset const&>(value).save(file);
             },
+            .replacer = [](AssetAny& dst, AssetAny&& src) {
+                auto& dst_asset = aa::any_cast<Asset&>(dst);
+                auto& src_asset = aa::any_cast<Asset&>(src);
+                if constexpr (std::is_move_assignable_v<Asset>) {
+                    dst_asset = std::move(src_asset);
+                } else {
+                    std::destroy_at(&dst_asset);
+                    std::construct_at(&dst_asset, std::move(src_asset));
+                }
+            },
         };
+        if constexpr (TAsyncAsset<Asset>) {
+            functions.finalizer = [](AssetAny& value) {
+                return aa::any_cast<Asset&>(value).finalize_load();
+            };
+        }
         register_asset(Asset::asset_type_name, std::move(functions));
     }
 
     auto state_of(AssetId asset_id) -> AssetState;
 
+    // Read and decode the asset on worker threads, it is finalized in `update()`.
+    // `callback` is called on the main thread after it's loaded (with nullptr if it fails to load).
+    // Assets that are not `TAsyncAsset` are loaded immediately.
+    auto load_async(AssetId asset_id, std::function<AssetLoadCallback> callback = {}) -> AssetState;
+
+    // Finalize decoded assets, called once per frame on the main thread.
+    auto update() -> void;
+
+    // Release the loaded value of the asset, it's loaded again when it's required next time.
+    // Pointers to the value (e.g. cached by `TAssetPtr`) must not be used anymore. Assets that are not loaded yet
+    // or have unsaved changes are kept. The released value is returned (empty if it's kept),
+    // so that callers can delay destroying it, e.g. until GPU resources of it are not used.
+    auto unload_asset(AssetId asset_id) -> AssetAny;
+
+    // Reload loaded assets of changed files in place, so that `AssetId`s and `TAssetPtr`s stay valid.
+    // Assets with unsaved changes and files just written by `save_all_assets()` are skipped.
+    auto reload_changed_assets(CSpan<std::string> changed_paths) -> void;
+
     auto metadata_of(AssetId asset_id) const -> CPtr<AssetMetadata>;
     auto all_metadata_of_type(std::string_view type) const -> std::vector<CRef<AssetMetadata>>;
 
@@ -62,7 +107,9 @@ struct AssetManager final : PImpl<AssetManager> {
         return {id, Ptr<Asset>{aa::any_cast<Asset>(asset_ptr)}.value()};
     }
 
-    auto save_all_assets(Dyn<IFile>::Ref metadata_file, bool force) -> void;
+    // Metadata of new assets is appended to the index. When `force` is true, the index is written again and
+    // metadata is also exported to the TOML file.
+    auto save_all_assets(std::string_view metadata_path, bool force) -> void;
 
 private:
     auto register_asset(std::string_view type, AssetFunctions&& functions) -> void;
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "vfs.hpp"
+#include "../utils/crypto.hpp"
+
+namespace bi::rt {
+
+inline constexpr std::string_view asset_metadata_index_extension = ".bidx";
+
+// Layout of an asset metadata index file:
+//   `AssetMetadataIndexHeader`, `AssetMetadataIndexEntry` array sorted by id, `AssetMetadataIndexType` array,
+//   string pool of type names, string pool of paths, records appended after the file is written.
+// An appended record is an id (u64), the type length (u32) and the path length (u32) followed by the type and path.
+// Each append ends with a source hash record, whose type length is `~0u` and path is the new source hash.
+inline constexpr uint32_t asset_metadata_index_magic_number = 0x58444942; // 'BIDX'
+// 1: original, 2: add source hash records.
+inline constexpr uint32_t asset_metadata_index_version = 2;
+
+struct AssetMetadataIndexHeader final {
+    uint32_t magic_number = asset_metadata_index_magic_number;
+    uint32_t version = asset_metadata_index_version;
+    uint64_t num_entries = 0;
+    uint64_t num_types = 0;
+    uint64_t type_pool_size = 0;
+    uint64_t path_pool_size = 0;
+    // Hash of the TOML metadata file that the index is imported from or exported with.
+    crypto::MD5 source_hash{};
+};
+
+struct AssetMetadataIndexEntry final {
+    uint64_t id;
+    uint64_t path_offset;
+    uint32_t path_length;
+    uint32_t type_index;
+};
+
+struct AssetMetadataIndexType final {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct AssetMetadataView final {
+    uint64_t id;
+    std::string_view type;
+    std::string_view path;
+};
+
+// Index of a mapped file, returned views are valid while the index is alive.
+struct AssetMetadataIndex final {
+    // Return nothing if it's not a valid index.
+    static auto load(Dyn<IFile>::Box file) -> Option<AssetMetadataIndex>;
+
+    static auto write(
+        Dyn<IFile>::Ref file, std::vector<AssetMetadataView> metadata, crypto::MD5 const& source_hash
+    ) -> bool;
+    // Sorted entries are not changed, so it's cheap to add a few assets to a large index.
+    // `source_hash` replaces the one in the header, it is the hash of the last exported TOML file.
+    static auto append(
+        Dyn<IFile>::Ref file, CSpan<AssetMetadataView> metadata, crypto::MD5 const& source_hash
+    ) -> bool;
+
+    // Hash in the header, or the one of the last append if there is any.
+    auto source_hash() const -> crypto::MD5 const& { return source_hash_; }
+
+    auto num_sorted() const -> size_t { return entries_.size(); }
+    auto num_appended() const -> size_t { return appended_.size(); }
+    auto size() const -> size_t { return num_sorted() + num_appended(); }
+
+    // Sorted entries come first, followed by appended ones.
+    auto operator[](size_t index) const -> AssetMetadataView;
+    auto find(uint64_t id) const -> Option<AssetMetadataView>;
+
+private:
+    AssetMetadataIndex(Dyn<IFile>::Box file) : file_(std::move(file)) {}
+
+    auto view_of(AssetMetadataIndexEntry const& entry) const -> AssetMetadataView;
+
+    Dyn<IFile>::Box file_;
+    AssetMetadataIndexHeader header_;
+    crypto::MD5 source_hash_{};
+    CSpan<AssetMetadataIndexEntry> entries_;
+    CSpan<AssetMetadataIndexType> types_;
+    std::string_view type_pool_;
+    std::string_view path_pool_;
+    std::vector<AssetMetadataView> appended_;
+};
+
+}
@@ -5,6 +5,8 @@
 #include "component.hpp"
 #include "scene_object.hpp"
 #include "../prelude/idiom.hpp"
+#include "../prelude/byte_stream.hpp"
+#include "../utils/serde_binary.hpp"
 #include "../editor/component_editor.hpp"
 
 namespace bi::rt {
@@ -14,6 +16,8 @@ using ComponentSerializer = auto(serde::Value&, void const*) -> void;
 using ComponentEditor = auto(Ref<SceneObject>, void*) -> bool;
 using ComponentAttach = auto(Ref<SceneObject>) -> void;
 using ComponentClone = auto(Ref<SceneObject>, void const*) -> void;
+using ComponentBulkSerializer = auto(WriteByteStream&, CSpan<void const*>) -> void;
+using ComponentBulkDeserializer = auto(ReadByteStream&, CSpan<Ref<SceneObject>>) -> void;
 
 struct ComponentManager final : PImpl<ComponentManager> {
     struct Impl;
@@ -27,6 +31,8 @@ struct ComponentManager final : PImpl<ComponentManager> {
         std::function<ComponentEditor> editor;
         std::function<ComponentAttach> attach;
         std::function<ComponentClone> clone_to;
+        std::function<ComponentBulkSerializer> bulk_serializer;
+        std::function<ComponentBulkDeserializer> bulk_deserializer;
     };
 
     template <TComponent Component>
@@ -49,6 +55,31 @@ struct ComponentManager final : PImpl<ComponentManager> {
                 auto component = *reinterpret_cast<Component const*>(component_value);
                 object->attach_component(std::move(component));
             },
+            .bulk_serializer = [](WriteByteStream& bs, CSpan<void const*> component_values) {
+                for (auto component_value : component_values) {
+                    auto& component = *reinterpret_cast<Component const*>(component_value);
+                    if constexpr (serde::byte_serializable<Component>) {
+                        serde::to_byte_stream(bs, component);
+                    } else {
+                        serde::Value serde_value{};
+                        serde::to_value(serde_value, component);
+                        bs.write(serde_value.to_json());
+                    }
+                }
+            },
+            .bulk_deserializer = [](ReadByteStream& bs, CSpan<Ref<SceneObject>> objects) {
+                std::vector<Component> components(objects.size());
+                for (auto& component : components) {
+                    if constexpr (serde::byte_serializable<Component>) {
+                        serde::from_byte_stream(bs, component);
+                    } else {
+                        std::string component_json;
+                        bs.read(component_json);
+                        serde::from_value(serde::Value::from_json(component_json), component);
+                    }
+                }
+                SceneObject::attach_components(objects, std::move(components));
+            },
         };
         register_component(Component::component_type_name, std::move(metadata));
     }
@@ -59,6 +90,8 @@ struct ComponentManager final : PImpl<ComponentManager> {
     auto get_deserializer(std::string_view type) const -> std::function<ComponentDeserializer> const&;
     auto get_serializer(std::string_view type) const -> std::function<ComponentSerializer> const&;
     auto get_editor(std::string_view type) const -> std::function<ComponentEditor> const&;
+    auto get_bulk_serializer(std::string_view type) const -> std::function<ComponentBulkSerializer> const&;
+    auto get_bulk_deserializer(std::string_view type) const -> std::function<ComponentBulkDeserializer> const&;
 
 private:
     auto register_component(
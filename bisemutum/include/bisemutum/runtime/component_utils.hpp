@@ -5,18 +5,18 @@
 #include "../runtime/world.hpp"
 #include "../runtime/scene.hpp"
 #include "../runtime/scene_object.hpp"
+#include "../runtime/system_manager.hpp"
+#include "../runtime/volume_index_system.hpp"
 
 namespace bi::rt {
 
-template <typename T>
-concept TVolumeComponent = requires (const T v) {
-    TComponent<T>;
-    { v.global } -> std::same_as<bool const&>;
-    { v.priority } -> std::same_as<float const&>;
-};
-
 template <TVolumeComponent Component>
 auto find_volume_component_for(Ref<Scene> scene, float3 position) -> Component const* {
+    if (auto index = g_engine->system_manager()->get_system_for<VolumeIndexSystem<Component>>(scene); index) {
+        return index->find_volume_for(position);
+    }
+
+    // Fallback when the volume index system of this component type is not registered.
     auto view = scene->ecs_registry().view<Component>();
     Component const* volume = nullptr;
     for (auto entity : view) {
@@ -13,6 +13,10 @@ struct FrameTimer final {
     auto start() -> void;
     auto stop() -> void;
 
+    // Advance by a fixed step in each tick instead of wall-clock time, pass 0 to use wall-clock time again.
+    auto set_fixed_delta_time(double fixed_delta_time) -> void;
+    auto fixed_delta_time() const -> double { return fixed_delta_time_; }
+
 private:
     std::chrono::time_point<std::chrono::high_resolution_clock> base_time_;
     std::chrono::time_point<std::chrono::high_resolution_clock> prev_time_;
@@ -20,6 +24,7 @@ private:
 
     double delta_time_;
     double paused_time_;
+    double fixed_delta_time_ = 0.0;
 
     bool stopped_ = true;
 };
@@ -1,14 +1,18 @@
 #pragma once
 
 #include "logger_manager.hpp"
-#include "../engine/engine.hpp"
 
 namespace bi::log {
 
+// Logs go to the default spdlog logger when there is no engine, e.g. in headless tools.
 #define DEFINE_LOG_METHOD(level) \
     template <typename... Args> \
     auto level(std::string_view logger, spdlog::format_string_t<Args...> fmt, Args&&... args) -> void { \
-        g_engine->logger_manager()->level(logger, fmt, std::forward<Args>(args)...); \
+        if (rt::g_logger_manager) { \
+            rt::g_logger_manager->level(logger, fmt, std::forward<Args>(args)...); \
+        } else { \
+            spdlog::level(fmt, std::forward<Args>(args)...); \
+        } \
     }
 
 DEFINE_LOG_METHOD(trace)
@@ -47,4 +47,7 @@ private:
     std::unordered_map<std::string_view, Logger> logger_map_;
 };
 
+// Set by the engine, null in tools running without it.
+extern LoggerManager* g_logger_manager;
+
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 #include "asset.hpp"
 #include "scene_object.hpp"
 
@@ -8,16 +10,23 @@ namespace bi::rt {
 struct Prefab final {
     static constexpr std::string_view asset_type_name = "Prefab";
 
+    // The file is parsed on worker threads, objects of the prefab are created in `finalize_load()`.
     static auto load(Dyn<rt::IFile>::Ref file) -> rt::AssetAny;
+    auto finalize_load() -> AssetState;
 
     static auto create_from(CRef<SceneObject> object, std::string_view dst_path) -> void;
 
     auto save(Dyn<rt::IFile>::Ref file) const -> void;
 
-    auto instantiate() -> void;
+    // Clone objects of the prefab into the current scene.
+    auto instantiate() -> Ref<SceneObject>;
+    // Load the prefab asynchronously and instantiate it on the main thread when it's loaded,
+    // `callback` gets nullptr if it fails to load.
+    static auto instantiate_async(AssetId prefab_id, std::function<auto(Ptr<SceneObject>) -> void> callback = {}) -> void;
 
 private:
     Ptr<SceneObject> object_;
+    serde::Value value_;
 };
 
 }
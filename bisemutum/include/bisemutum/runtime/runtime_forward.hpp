@@ -10,5 +10,6 @@ struct FileSystem;
 struct LoggerManager;
 struct ComponentManager;
 struct AssetManager;
+struct ThreadPool;
 
 }
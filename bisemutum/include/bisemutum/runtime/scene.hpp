@@ -7,6 +7,7 @@
 #include <entt/entity/registry.hpp>
 
 #include "../prelude/ref.hpp"
+#include "../prelude/byte_stream.hpp"
 #include "../utils/serde.hpp"
 #include "../math/transform.hpp"
 
@@ -15,6 +16,9 @@ namespace bi::rt {
 struct SceneObject;
 struct Prefab;
 
+inline constexpr uint32_t scene_magic_number = 0x0b15ce7eu;
+inline constexpr uint32_t scene_binary_version = 1u;
+
 struct Scene final {
     auto ecs_registry() -> entt::registry&;
     auto ecs_registry() const -> entt::registry const&;
@@ -38,6 +42,12 @@ struct Scene final {
     auto load_from_value(serde::Value &&value) -> void;
     auto save_to_value(serde::Value& value) const -> void;
 
+    // Return root objects created from the byte stream.
+    auto load_from_byte_stream(ReadByteStream& bs) -> std::vector<Ref<SceneObject>>;
+    auto save_to_byte_stream(WriteByteStream& bs) const -> void;
+    // Save only the given root objects and their children.
+    auto save_to_byte_stream(WriteByteStream& bs, CSpan<CRef<SceneObject>> root_objects) const -> void;
+
 private:
     friend SceneObject;
     friend Prefab;
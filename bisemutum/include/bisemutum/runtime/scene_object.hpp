@@ -8,6 +8,7 @@
 #include "component.hpp"
 #include "../math/transform.hpp"
 #include "../prelude/ref.hpp"
+#include "../prelude/span.hpp"
 
 namespace bi::rt {
 
@@ -74,6 +75,21 @@ struct SceneObject final {
     }
     auto attach_component_by_type_name(std::string_view component_type_name) -> void;
 
+    // Attach one component to each object with a single storage insertion, objects must be in the same scene.
+    template <TComponent Component>
+    static auto attach_components(CSpan<Ref<SceneObject>> objects, std::vector<Component>&& components) -> void {
+        if (objects.empty()) { return; }
+        auto& ecs_registry = *objects[0]->ecs_registry_;
+        std::vector<entt::entity> entities(objects.size());
+        for (size_t i = 0; i < objects.size(); i++) {
+            entities[i] = objects[i]->ecs_entity_;
+        }
+        ecs_registry.insert<Component>(entities.begin(), entities.end(), std::make_move_iterator(components.begin()));
+        for (auto object : objects) {
+            object->components_[Component::component_type_name] = &ecs_registry.get<Component>(object->ecs_entity_);
+        }
+    }
+
     template <TComponent Component>
     auto has_component() const -> bool { return ecs_registry_->all_of<Component>(ecs_entity_); }
     template <TComponent... Components>
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <future>
+#include <functional>
+
+#include "../prelude/idiom.hpp"
+
+namespace bi::rt {
+
+struct ThreadPool final : PImpl<ThreadPool> {
+    struct Impl;
+
+    // Use (number of hardware threads - 1) workers when `num_threads` is 0.
+    ThreadPool(uint32_t num_threads = 0);
+
+    auto num_threads() const -> uint32_t;
+
+    auto submit(std::function<auto() -> void> task) -> void;
+
+    template <typename Func>
+    auto async(Func&& func) -> std::future<std::invoke_result_t<std::decay_t<Func>>> {
+        using Result = std::invoke_result_t<std::decay_t<Func>>;
+        auto task = std::make_shared<std::packaged_task<auto() -> Result>>(std::forward<Func>(func));
+        auto future = task->get_future();
+        submit([task]() { (*task)(); });
+        return future;
+    }
+
+    // Call `func(index)` for each index in [0, count) on worker threads and the calling thread,
+    // return after all of them finish. It is safe to call this from a worker thread.
+    auto parallel_for(size_t count, std::function<auto(size_t) -> void> func) -> void;
+    // `parallel_for()` on this pool as a function object, e.g. for compressing byte streams.
+    auto parallel_for_fn() -> std::function<auto(size_t, std::function<auto(size_t) -> void>) -> void>;
+};
+
+// Pool of the engine, null in tools running without it.
+extern ThreadPool* g_thread_pool;
+
+}
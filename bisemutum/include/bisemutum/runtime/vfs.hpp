@@ -2,6 +2,8 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <functional>
 #include <filesystem>
 
 #include "../prelude/span.hpp"
@@ -11,17 +13,64 @@
 
 namespace bi::rt {
 
+// Read `dst.size()` bytes from `offset` of a file, return false if the file is shorter.
+using FileRangeReader = std::function<auto(uint64_t offset, Span<std::byte> dst) -> bool>;
+
 BI_TRAIT_BEGIN(IFile, move)
+    template <typename T>
+    static auto helper_append_binary_data(T& self, CSpan<std::byte> data) -> bool {
+        auto file_data = self.read_binary_data();
+        file_data.insert(file_data.end(), data.begin(), data.end());
+        return self.write_binary_data(file_data);
+    }
+    template <typename T> requires requires (T v, CSpan<std::byte> data) { v.append_binary_data(data); }
+    static auto helper_append_binary_data(T& self, CSpan<std::byte> data) -> bool {
+        return self.append_binary_data(data);
+    }
+    template <typename T>
+    static auto helper_size(T& self) -> uint64_t {
+        return self.map_binary_data().size();
+    }
+    template <typename T> requires requires (T v) { v.size(); }
+    static auto helper_size(T& self) -> uint64_t {
+        return self.size();
+    }
+    template <typename T>
+    static auto helper_range_reader(T& self) -> FileRangeReader { return {}; }
+    template <typename T> requires requires (T v) { v.range_reader(); }
+    static auto helper_range_reader(T& self) -> FileRangeReader {
+        return self.range_reader();
+    }
+
     BI_TRAIT_METHOD(is_writable, (const& self) requires (self.is_writable()) -> bool)
     BI_TRAIT_METHOD(filename, (const& self) requires (self.filename()) -> std::string)
     BI_TRAIT_METHOD(extension, (const& self) requires (self.extension()) -> std::string)
     BI_TRAIT_METHOD(read_string_data, (&self) requires (self.read_string_data()) -> std::string)
     BI_TRAIT_METHOD(read_binary_data, (&self) requires (self.read_binary_data()) -> std::vector<std::byte>)
+    // Read-only view of the whole file without copying, valid until the file object is destroyed, written or mapped
+    // again. Writes through other objects of the same file may also invalidate it for physical files.
+    BI_TRAIT_METHOD(map_binary_data, (&self) requires (self.map_binary_data()) -> CSpan<std::byte>)
+    // Size in bytes, files that can't tell it cheaply are mapped.
+    BI_TRAIT_METHOD(size, (&self) requires (helper_size(self)) -> uint64_t)
+    // Reader of parts of the file which is still valid after the file object is destroyed and can be called on any
+    // thread, e.g. to stream parts of an asset later. It's empty if the file doesn't support it.
+    BI_TRAIT_METHOD(range_reader, (&self) requires (helper_range_reader(self)) -> FileRangeReader)
     BI_TRAIT_METHOD(write_string_data, (&self, std::string_view data) requires (self.write_string_data(data)) -> bool)
     BI_TRAIT_METHOD(write_binary_data, (&self, CSpan<std::byte> data) requires (self.write_binary_data(data)) -> bool)
+    // Files that can't append in place are read and written as a whole.
+    BI_TRAIT_METHOD(append_binary_data,
+        (&self, CSpan<std::byte> data) requires (helper_append_binary_data(self, data)) -> bool
+    )
 BI_TRAIT_END(IFile)
 
 BI_TRAIT_BEGIN(ISubFileSystem, move)
+    template <typename T>
+    static auto helper_poll_changed_files(T& self) -> std::vector<std::string> { return {}; }
+    template <typename T> requires requires (T v) { v.poll_changed_files(); }
+    static auto helper_poll_changed_files(T& self) -> std::vector<std::string> {
+        return self.poll_changed_files();
+    }
+
     BI_TRAIT_METHOD(is_writable, (const& self) requires (self.is_writable()) -> bool)
     BI_TRAIT_METHOD(has_file, (const& self, std::string_view path) requires (self.has_file(path)) -> bool)
     BI_TRAIT_METHOD(get_file,
@@ -32,8 +81,23 @@ BI_TRAIT_BEGIN(ISubFileSystem, move)
     )
     BI_TRAIT_METHOD(remove_file, (&self, std::string_view path) requires (self.remove_file(path)) -> bool)
     BI_TRAIT_METHOD(get_physical_path, (const& self) requires (self.get_physical_path()) -> std::filesystem::path)
+    // Relative paths of files changed since the last call, empty if changes are not watched.
+    BI_TRAIT_METHOD(poll_changed_files,
+        (&self) requires (helper_poll_changed_files(self)) -> std::vector<std::string>
+    )
 BI_TRAIT_END(ISubFileSystem)
 
+struct PathCacheStatistics final {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // Number of entries dropped by mount, umount, create and remove, or when too many missing paths are cached.
+    uint64_t invalidated_entries = 0;
+
+    auto hit_rate() const -> double {
+        return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses);
+    }
+};
+
 struct FileSystem final : PImpl<FileSystem> {
     struct Impl;
 
@@ -48,6 +112,14 @@ struct FileSystem final : PImpl<FileSystem> {
     auto remove_file(std::string_view path) -> bool;
 
     auto try_convert_physical_path_to_vfs_path(std::filesystem::path const& path) -> std::string;
+
+    // Resolved (and missing) paths are cached, call this if files are created or removed outside of the file system.
+    auto invalidate_path_cache() -> void;
+    auto path_cache_statistics() const -> PathCacheStatistics;
+
+    // Paths of files created, modified or removed since the last call, in all mounted sub file systems that watch
+    // changes. Cached entries of them are invalidated.
+    auto poll_changed_files() -> std::vector<std::string>;
 };
 
 
@@ -60,17 +132,25 @@ struct PhysicalFile final {
 
     auto read_string_data() -> std::string;
     auto read_binary_data() -> std::vector<std::byte>;
+    auto map_binary_data() -> CSpan<std::byte>;
+    auto size() const -> uint64_t;
+    auto range_reader() const -> FileRangeReader;
 
     auto write_string_data(std::string_view data) -> bool;
     auto write_binary_data(CSpan<std::byte> data) -> bool;
+    auto append_binary_data(CSpan<std::byte> data) -> bool;
 
 private:
     std::filesystem::path path_;
     bool writable_;
+    // Unmapped when the last copy of the file is destroyed.
+    std::shared_ptr<std::byte const> mapping_;
+    CSpan<std::byte> mapped_data_;
 };
 
 struct PhysicalSubFileSystem final {
-    PhysicalSubFileSystem(std::filesystem::path root_path, bool writable = true);
+    // Changes of files are watched with inotify on Linux and not watched on other platforms.
+    PhysicalSubFileSystem(std::filesystem::path root_path, bool writable = true, bool watch_changes = false);
 
     auto is_writable() const -> bool { return writable_; }
 
@@ -82,9 +162,14 @@ struct PhysicalSubFileSystem final {
 
     auto get_physical_path() const -> std::filesystem::path { return root_path_; }
 
+    auto poll_changed_files() -> std::vector<std::string>;
+
 private:
+    struct Watcher;
+
     std::filesystem::path root_path_;
     bool writable_;
+    std::shared_ptr<Watcher> watcher_;
 };
 
 
@@ -99,6 +184,10 @@ struct MemoryFile final : PImpl<MemoryFile>  {
 
     auto read_string_data() -> std::string;
     auto read_binary_data() -> std::vector<std::byte>;
+    auto map_binary_data() -> CSpan<std::byte>;
+    auto size() const -> uint64_t;
+    // Data is captured when the reader is created, later writes are not seen by it.
+    auto range_reader() const -> FileRangeReader;
 
     auto write_string_data(std::string_view data) -> bool;
     auto write_binary_data(CSpan<std::byte> data) -> bool;
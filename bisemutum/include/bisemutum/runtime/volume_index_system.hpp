@@ -0,0 +1,100 @@
+#pragma once
+
+#include "component.hpp"
+#include "scene.hpp"
+#include "scene_object.hpp"
+#include "../math/aabb_tree.hpp"
+
+namespace bi::rt {
+
+template <typename T>
+concept TVolumeComponent = requires (const T v) {
+    TComponent<T>;
+    { v.global } -> std::same_as<bool const&>;
+    { v.priority } -> std::same_as<float const&>;
+};
+
+// Keeps non-global volumes of one component type in an AABB tree together with their inverse world transforms,
+// so that finding the volume at a position doesn't need to visit every volume.
+// The index is rebuilt lazily when a volume or the transform of a volume (or of an object with children) changes.
+template <TVolumeComponent Component>
+struct VolumeIndexSystem final {
+    auto init_on(Ref<Scene> scene) -> void {
+        scene_ = scene;
+        auto& ecs_registry = scene_->ecs_registry();
+        ecs_registry.template on_construct<Component>().template connect<&VolumeIndexSystem::on_volume_update>(this);
+        ecs_registry.template on_update<Component>().template connect<&VolumeIndexSystem::on_volume_update>(this);
+        ecs_registry.template on_destroy<Component>().template connect<&VolumeIndexSystem::on_volume_update>(this);
+        ecs_registry.template on_update<Transform>().template connect<&VolumeIndexSystem::on_transform_update>(this);
+    }
+
+    auto find_volume_for(float3 position) -> Component const* {
+        if (dirty_) {
+            rebuild();
+        }
+
+        auto& ecs_registry = scene_->ecs_registry();
+        Component const* volume = nullptr;
+        for (auto entity : global_volumes_) {
+            auto& data = ecs_registry.template get<Component>(entity);
+            if (!volume || data.priority > volume->priority) {
+                volume = &data;
+            }
+        }
+        local_volumes_tree_.for_each_containing(position, [&](uint32_t index) {
+            auto p = local_volumes_inv_transform_[index].transform_position(position);
+            auto inside = math::all(math::greaterThanEqual(p, float3(-1.0f)) & math::lessThanEqual(p, float3(1.0f)));
+            if (!inside) { return; }
+            auto& data = ecs_registry.template get<Component>(local_volumes_[index]);
+            if (!volume || data.priority > volume->priority) {
+                volume = &data;
+            }
+        });
+        return volume;
+    }
+
+private:
+    auto on_volume_update(entt::registry& ecs_registry, entt::entity entity) -> void {
+        dirty_ = true;
+    }
+    auto on_transform_update(entt::registry& ecs_registry, entt::entity entity) -> void {
+        if (dirty_) { return; }
+        if (ecs_registry.all_of<Component>(entity) || scene_->object_of(entity)->first_child()) {
+            dirty_ = true;
+        }
+    }
+
+    auto rebuild() -> void {
+        global_volumes_.clear();
+        local_volumes_.clear();
+        local_volumes_inv_transform_.clear();
+        std::vector<BoundingBox> local_volumes_bbox{};
+
+        auto unit_cube = BoundingBox{.p_min = float3(-1.0f), .p_max = float3(1.0f)};
+        auto view = scene_->ecs_registry().template view<Component>();
+        for (auto entity : view) {
+            auto& data = view.template get<Component>(entity);
+            if (data.global) {
+                global_volumes_.push_back(entity);
+            } else {
+                auto& transform = scene_->object_of(entity)->world_transform();
+                local_volumes_.push_back(entity);
+                local_volumes_inv_transform_.push_back(transform.inverse());
+                local_volumes_bbox.push_back(transform.transform_bounding_box(unit_cube));
+            }
+        }
+        local_volumes_tree_.build(local_volumes_bbox);
+
+        dirty_ = false;
+    }
+
+    Ptr<Scene> scene_;
+    bool dirty_ = true;
+
+    std::vector<entt::entity> global_volumes_;
+    std::vector<entt::entity> local_volumes_;
+    std::vector<Transform> local_volumes_inv_transform_;
+    AabbTree local_volumes_tree_;
+};
+
+}
@@ -9,6 +9,8 @@ namespace bi::rt {
 struct Scene;
 struct SceneObject;
 
+inline constexpr std::string_view scene_binary_extension = ".biscene";
+
 struct World final : PImpl<World> {
     struct Impl;
 
@@ -21,7 +23,15 @@ struct World final : PImpl<World> {
     auto destroy_scene(Ref<Scene> scene) -> void;
 
     auto load_scene(std::string_view scene_file_str) -> bool;
+    auto load_scene_binary(CSpan<std::byte> scene_file_data) -> bool;
+    // Load TOML or binary scene according to the file extension.
+    auto load_scene_file(Dyn<IFile>::Ref scene_file) -> bool;
+    // Same as above, and also load partitioned scene whose chunk files are relative to the manifest.
+    auto load_scene_from_path(std::string_view scene_file_path) -> bool;
     auto save_currnet_scene(Dyn<IFile>::Ref scene_file) const -> void;
+
+    // Convert between TOML and binary scene files, format of each side is decided by its extension.
+    auto convert_scene_file(Dyn<IFile>::Ref src_scene_file, Dyn<IFile>::Ref dst_scene_file) -> bool;
 };
 
 }
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "vfs.hpp"
+#include "../math/math.hpp"
+#include "../prelude/idiom.hpp"
+#include "../prelude/ref.hpp"
+#include "../utils/srefl.hpp"
+
+namespace bi::rt {
+
+struct Scene;
+
+// Manifest of a partitioned scene, stored as TOML.
+inline constexpr std::string_view world_partition_extension = ".biworld";
+
+struct WorldPartitionSettings final {
+    float cell_size = 64.0f;
+    // Cells whose bounds are within this distance to any camera are streamed in.
+    float streaming_range = 128.0f;
+    // Loaded cells are kept until they are farther than `streaming_range * unload_range_scale`.
+    float unload_range_scale = 1.25f;
+    // Estimated bytes of all loaded cells (chunk sizes plus sizes of their dependent asset files,
+    // assets shared by several cells are counted once).
+    uint64_t memory_budget = 512ull << 20;
+    uint32_t max_cells_committed_per_frame = 2;
+    // Root objects with any of these components in their hierarchy are streamed, others stay in the persistent chunk.
+    std::vector<std::string> streamed_component_types{
+        "StaticMeshComponent", "PointLightComponent", "RectLightComponent",
+    };
+};
+BI_SREFL(
+    type(WorldPartitionSettings),
+    field(cell_size),
+    field(streaming_range),
+    field(unload_range_scale),
+    field(memory_budget),
+    field(max_cells_committed_per_frame),
+    field(streamed_component_types),
+);
+
+struct WorldPartitionCell final {
+    int3 coord;
+    // Binary scene chunk containing root objects of this cell, relative to the manifest.
+    std::string chunk_file;
+    // Size of the chunk only, sizes of dependent assets are listed in `WorldPartitionDesc::assets`.
+    uint64_t memory_size = 0;
+    std::vector<uint64_t> asset_dependencies;
+};
+BI_SREFL(
+    type(WorldPartitionCell),
+    field(coord),
+    field(chunk_file),
+    field(memory_size),
+    field(asset_dependencies),
+);
+
+struct WorldPartitionAsset final {
+    uint64_t id = 0;
+    uint64_t memory_size = 0;
+};
+BI_SREFL(
+    type(WorldPartitionAsset),
+    field(id),
+    field(memory_size),
+);
+
+struct WorldPartitionDesc final {
+    WorldPartitionSettings settings;
+    std::string persistent_chunk_file;
+    std::vector<WorldPartitionCell> cells;
+    // Assets that cells depend on.
+    std::vector<WorldPartitionAsset> assets;
+};
+BI_SREFL(
+    type(WorldPartitionDesc),
+    field(settings),
+    field(persistent_chunk_file),
+    field(cells),
+    field(assets),
+);
+
+// Split root objects of `scene` into cells by their world positions and write the manifest to `manifest_path`,
+// chunk files are written next to it.
+auto build_world_partition(
+    CRef<Scene> scene, WorldPartitionSettings const& settings, std::string_view manifest_path
+) -> bool;
+// Load a TOML or binary scene file and partition it.
+auto build_world_partition(
+    Dyn<IFile>::Ref src_scene_file, WorldPartitionSettings const& settings, std::string_view manifest_path
+) -> bool;
+
+// Streams cells of a partitioned scene around cameras. Chunk files are read on worker threads,
+// and ready chunks are instantiated (or unloaded) on the main thread in `update()`.
+// Assets first loaded by cells are unloaded once no resident cell depends on them, except those used by persistent
+// objects, so objects created by other code must not share assets with streamed cells.
+struct WorldPartitionSystem final : PImpl<WorldPartitionSystem> {
+    struct Impl;
+
+    WorldPartitionSystem();
+
+    auto init_on(Ref<Scene> scene) -> void;
+    auto update() -> void;
+
+    // Load the persistent chunk synchronously and start streaming cells.
+    // `base_dir` is the VFS directory of the manifest (with trailing '/').
+    auto open(WorldPartitionDesc desc, std::string_view base_dir) -> bool;
+    // Wait for pending reads and destroy all loaded cells. Their assets are kept loaded.
+    auto close() -> void;
+
+    auto is_opened() const -> bool;
+    auto is_cell_loaded(int3 coord) const -> bool;
+    auto num_loaded_cells() const -> size_t;
+    auto loaded_memory_size() const -> uint64_t;
+};
+
+}
@@ -9,6 +9,8 @@ struct MaterialAsset final {
     static constexpr std::string_view asset_type_name = "Material";
 
     static auto load(Dyn<rt::IFile>::Ref file) -> rt::AssetAny;
+    // Wait for referenced material and textures.
+    auto finalize_load() -> rt::AssetState;
 
     auto save(Dyn<rt::IFile>::Ref file) const -> void;
 
@@ -5,14 +5,17 @@
 #include "../runtime/asset.hpp"
 #include "../graphics/shader_param.hpp"
 #include "../graphics/drawable.hpp"
+#include "static_mesh_data.hpp"
 
 namespace bi {
 
 struct StaticMesh final {
-    static constexpr std::string_view asset_type_name = "StaticMesh";
+    static constexpr std::string_view asset_type_name = static_mesh_asset_type_name;
 
     // -- For TAsset --
     static auto load(Dyn<rt::IFile>::Ref file) -> rt::AssetAny;
+    // GPU buffers are created when the mesh is drawn for the first time.
+    auto finalize_load() -> rt::AssetState { return rt::AssetState::loaded; }
 
     auto save(Dyn<rt::IFile>::Ref file) const -> void;
 
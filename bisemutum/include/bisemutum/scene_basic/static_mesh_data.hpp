@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string_view>
+
+#include "../runtime/vfs.hpp"
+#include "../prelude/byte_stream.hpp"
+#include "../graphics/mesh.hpp"
+
+namespace bi {
+
+inline constexpr std::string_view static_mesh_asset_type_name = "StaticMesh";
+
+// File format of `StaticMesh`, usable by tools running without the engine.
+// Files of all versions are read as the latest one, return false if the file is invalid.
+auto read_static_mesh_data(
+    Dyn<rt::IFile>::Ref file, gfx::MeshData& mesh, ParallelFor const& parallel_for = {}
+) -> bool;
+
+auto write_static_mesh_data(
+    Dyn<rt::IFile>::Ref file, gfx::MeshData const& mesh, ParallelFor const& parallel_for = {}
+) -> bool;
+
+}
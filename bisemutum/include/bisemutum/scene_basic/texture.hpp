@@ -1,26 +1,68 @@
 #pragma once
 
+#include <future>
 #include <string_view>
 
 #include "../runtime/asset.hpp"
 #include "../graphics/resource.hpp"
 #include "../graphics/sampler.hpp"
+#include "../graphics/texture_streaming.hpp"
+#include "texture_compression.hpp"
+#include "texture_asset_data.hpp"
 
 namespace bi {
 
 struct TextureAsset final {
-    static constexpr std::string_view asset_type_name = "Texture";
+    static constexpr std::string_view asset_type_name = texture_asset_type_name;
 
     static auto load(Dyn<rt::IFile>::Ref file) -> rt::AssetAny;
+    auto finalize_load() -> rt::AssetState;
 
     auto save(Dyn<rt::IFile>::Ref file) const -> void;
 
     auto update_gpu_data() -> void;
     auto update_cpu_data() -> void;
 
+    // Fill all levels of `texture_data` from level 0.
+    auto generate_mipmaps(MipmapSettings const& settings = {}) -> bool;
+    // Replace data with block-compressed levels and recreate the GPU texture, `update_gpu_data()` uploads them.
+    // Mipmaps are generated with default settings first if they are not stored.
+    auto compress(TextureSemantic semantic) -> bool;
+
+    // First level of the full mip chain in `texture`, it's larger than 0 if the texture is streamed.
+    auto resident_level() const -> uint32_t { return resident_level_; }
+
+    // Levels from 0 to `level_offsets.size() - 1`. Remaining levels are generated on GPU.
+    // Textures streamed from files don't keep levels above resident ones, they are read from the file when needed.
     std::vector<std::byte> texture_data;
+    std::vector<uint64_t> level_offsets = {0};
+    // Loaded 2D textures with all levels stored are streamed, only levels from `resident_level()` are in it.
     gfx::Texture texture;
     Ptr<gfx::Sampler> sampler;
+
+private:
+    auto full_texture_desc() const -> rhi::TextureDesc const&;
+    auto update_resident_levels(uint32_t first_level) -> bool;
+    auto upload_levels(rhi::TextureDesc const& full_desc, uint32_t first_level) -> void;
+    // Return true if levels from `first_level` are in `texture_data`, otherwise they are read on a worker thread.
+    auto read_levels_async(uint32_t first_level) -> bool;
+    // Read levels dropped from `texture_data`, so that it contains all levels again.
+    auto read_all_levels() -> bool;
+
+    // Read by `load()`, GPU resources are created from them in `finalize_load()`.
+    TextureAssetHeader loaded_header_;
+
+    uint32_t resident_level_ = 0;
+    // First level in `texture_data`, levels before it are read from the file by `level_reader_`.
+    uint32_t data_first_level_ = 0;
+    rt::FileRangeReader level_reader_;
+    // Levels in [pending_first_level_, pending_last_level_) being read, they are only used if `data_first_level_` is
+    // still `pending_last_level_` when they are ready.
+    std::future<Option<std::vector<std::byte>>> pending_levels_;
+    uint32_t pending_first_level_ = 0;
+    uint32_t pending_last_level_ = 0;
+    // It refers to this asset, so it is only created when the asset is finalized in place.
+    gfx::StreamedTexture streamed_texture_;
 };
 
 }
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string_view>
+
+#include "../runtime/vfs.hpp"
+#include "../prelude/byte_stream.hpp"
+#include "../rhi/sampler.hpp"
+#include "../utils/srefl.hpp"
+#include "texture_mipmap.hpp"
+
+namespace bi {
+
+namespace rhi {
+
+BI_SREFL(
+    type(SamplerDesc),
+    field(mag_filter),
+    field(min_filter),
+    field(mipmap_mode),
+    field(address_mode_u),
+    field(address_mode_v),
+    field(address_mode_w),
+    field(border_color),
+    field(compare_enabled),
+    field(compare_op),
+    field(anisotropy),
+    field(lod_bias),
+    field(lod_min),
+    field(lod_max)
+)
+
+} // namespace rhi
+
+inline constexpr std::string_view texture_asset_type_name = "Texture";
+
+// Content of a texture asset file. Reading and writing it don't need graphics, so that it can be used by tools
+// running without the engine.
+struct TextureAssetData final {
+    rhi::SamplerDesc sampler;
+    TextureLevels levels;
+};
+
+// Everything before the data of levels.
+struct TextureAssetHeader final {
+    rhi::SamplerDesc sampler;
+    rhi::TextureDesc desc;
+    // Same as `TextureLevels::level_offsets`.
+    std::vector<uint64_t> level_offsets;
+    uint64_t data_size = 0;
+    // File offsets of stored levels with the end of the last one, so that each level can be read separately.
+    // It's empty in files before version 5, whose levels are compressed together.
+    std::vector<uint64_t> level_file_offsets;
+};
+
+// Files of all versions are read as the latest one.
+// `parallel_for` is used to decompress and compress data in chunks.
+auto read_texture_asset_data(
+    Dyn<rt::IFile>::Ref file, ParallelFor const& parallel_for = {}
+) -> Option<TextureAssetData>;
+
+auto read_texture_asset_header(Dyn<rt::IFile>::Ref file) -> Option<TextureAssetHeader>;
+// Read stored levels in [first_level, last_level) from a file with `level_file_offsets`, only these levels are read.
+// They are packed as in `TextureLevels::data`, with offsets relative to `first_level`.
+auto read_texture_asset_levels(
+    rt::FileRangeReader const& reader, TextureAssetHeader const& header, uint32_t first_level, uint32_t last_level,
+    ParallelFor const& parallel_for = {}
+) -> Option<std::vector<std::byte>>;
+
+auto write_texture_asset_data(
+    Dyn<rt::IFile>::Ref file, rhi::SamplerDesc const& sampler, rhi::TextureDesc const& desc,
+    CSpan<uint64_t> level_offsets, CSpan<std::byte> data, ParallelFor const& parallel_for = {}
+) -> bool;
+inline auto write_texture_asset_data(
+    Dyn<rt::IFile>::Ref file, TextureAssetData const& data, ParallelFor const& parallel_for = {}
+) -> bool {
+    return write_texture_asset_data(
+        file, data.sampler, data.levels.desc, data.levels.level_offsets, data.levels.data, parallel_for
+    );
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "texture_mipmap.hpp"
+
+namespace bi {
+
+// Decides which block-compressed format a texture is stored as.
+enum class TextureSemantic : uint8_t {
+    // Color with alpha, stored as BC7.
+    albedo,
+    // Tangent space normal with XY in RG, stored as BC5. Z is reconstructed in shader.
+    normal,
+    // Single channel data like occlusion, stored as BC4.
+    mask,
+    // Floating point color, stored as BC6H. Negative values are clamped to 0.
+    hdr,
+};
+
+auto block_compressed_format(TextureSemantic semantic, bool srgb) -> rhi::ResourceFormat;
+
+// Compress stored levels of an uncompressed texture with 8-bit unorm/srgb or floating point channels.
+// Levels that are not stored are dropped since block-compressed textures can't be written on GPU.
+// Blocks are encoded in parallel on the engine thread pool.
+auto compress_texture(
+    rhi::TextureDesc const& desc, CSpan<std::byte> data, CSpan<uint64_t> level_offsets, TextureSemantic semantic
+) -> Option<TextureLevels>;
+
+}
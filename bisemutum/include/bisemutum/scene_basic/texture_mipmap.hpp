@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "../prelude/span.hpp"
+#include "../prelude/option.hpp"
+#include "../rhi/resource.hpp"
+
+namespace bi {
+
+// Stored levels start at multiples of this, which meets placement alignment of buffer-texture copies.
+inline constexpr uint64_t texture_level_alignment = 512;
+
+auto texture_level_extent(rhi::TextureDesc const& desc, uint32_t level) -> rhi::Extent3D;
+// Size of a mip level in bytes, including all layers. Blocks are tightly packed for compressed formats.
+auto texture_level_size(rhi::TextureDesc const& desc, uint32_t level) -> uint64_t;
+
+struct TextureLevels final {
+    rhi::TextureDesc desc;
+    // Levels from 0 to `level_offsets.size() - 1`. Each level contains all layers.
+    std::vector<std::byte> data;
+    std::vector<uint64_t> level_offsets;
+};
+
+// Allocate storage of the first `num_levels` levels.
+auto allocate_texture_levels(rhi::TextureDesc const& desc, uint32_t num_levels) -> TextureLevels;
+
+struct MipmapSettings final {
+    // Filter color channels in linear space. It is always done for sRGB formats.
+    bool srgb_encoded = false;
+    // Scale alpha of lower levels so that the same ratio of texels passes the alpha test.
+    Option<float> alpha_cutoff = {};
+};
+
+// Generate all levels of `desc` from level 0 in `data` with a box filter.
+// Every level is filtered from level 0 directly, so levels and layers are processed in parallel.
+auto generate_mipmaps(
+    rhi::TextureDesc const& desc, CSpan<std::byte> data, MipmapSettings const& settings = {}
+) -> Option<TextureLevels>;
+
+}
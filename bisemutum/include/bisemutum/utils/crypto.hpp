@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "../prelude/span.hpp"
 
@@ -22,6 +23,14 @@ struct SHA256 final {
 };
 auto sha256(CSpan<std::byte> in_data) -> SHA256;
 
+// 64-bit FNV-1a. Unlike `std::hash`, results are the same on all platforms and builds, so it's used for saved hashes.
+// Pass a previous result as `hash` to continue hashing more data.
+constexpr uint64_t fnv1a_64_offset_basis = 0xcbf29ce484222325ull;
+auto fnv1a_64(CSpan<std::byte> in_data, uint64_t hash = fnv1a_64_offset_basis) -> uint64_t;
+auto fnv1a_64(std::string_view in_data, uint64_t hash = fnv1a_64_offset_basis) -> uint64_t;
+// Bytes of `value` are hashed in little-endian order.
+auto fnv1a_64(uint64_t value, uint64_t hash = fnv1a_64_offset_basis) -> uint64_t;
+
 }
 
 template <>
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "serde.hpp"
+#include "../prelude/byte_stream.hpp"
+
+// Binary counterpart of `to_value` / `from_value`, driven by the same static reflection data.
+namespace bi::serde {
+
+template <typename T>
+struct IsStdVector final { static constexpr bool value = false; };
+template <typename T>
+struct IsStdVector<std::vector<T>> final { static constexpr bool value = true; };
+
+template <typename T>
+struct IsStdArray final { static constexpr bool value = false; };
+template <typename T, size_t N>
+struct IsStdArray<std::array<T, N>> final { static constexpr bool value = true; };
+
+// A type can be written to a byte stream if it provides its own `to_byte_stream`/`from_byte_stream`,
+// or it is a string/vector/array of such types, or all of its reflected fields can be written,
+// or it is a plain trivially copyable type without custom serde functions.
+template <typename T>
+consteval auto is_byte_serializable() -> bool {
+    if constexpr (
+        requires (WriteByteStream& bs, T const& o) { T::to_byte_stream(bs, o); }
+        && requires (ReadByteStream& bs, T& o) { T::from_byte_stream(bs, o); }
+    ) {
+        return true;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return true;
+    } else if constexpr (IsStdVector<T>::value || IsStdArray<T>::value) {
+        return is_byte_serializable<typename T::value_type>();
+    } else if constexpr (srefl::is_reflectable<T>) {
+        bool result = true;
+        srefl::for_each(srefl::refl<T>().members, [&result](auto member) {
+            using FieldType = std::remove_const_t<typename decltype(member)::FieldType>;
+            result = result && is_byte_serializable<FieldType>();
+        });
+        return result;
+    } else if constexpr (
+        requires (Value& v, T const& o) { T::to_value(v, o); }
+        || requires (Value const& v, T& o) { T::from_value(v, o); }
+    ) {
+        return false;
+    } else {
+        return can_be_used_for_byte_stream<T>;
+    }
+}
+
+template <typename T>
+inline constexpr bool byte_serializable = is_byte_serializable<T>();
+
+template <typename T> requires byte_serializable<T>
+auto to_byte_stream(WriteByteStream& bs, T const& o) -> void {
+    if constexpr (requires { T::to_byte_stream(bs, o); }) {
+        T::to_byte_stream(bs, o);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        bs.write(o);
+    } else if constexpr (IsStdVector<T>::value) {
+        bs.write(static_cast<uint64_t>(o.size()));
+        for (auto const& elem : o) { to_byte_stream(bs, elem); }
+    } else if constexpr (IsStdArray<T>::value) {
+        for (auto const& elem : o) { to_byte_stream(bs, elem); }
+    } else if constexpr (srefl::is_reflectable<T>) {
+        constexpr auto type = srefl::refl<T>();
+        srefl::for_each(type.members, [&bs, &o](auto member) {
+            if constexpr (!decltype(member)::is_const) {
+                to_byte_stream(bs, member(o));
+            }
+        });
+    } else {
+        bs.write(o);
+    }
+}
+
+template <typename T> requires byte_serializable<T>
+auto from_byte_stream(ReadByteStream& bs, T& o) -> void {
+    if constexpr (requires { T::from_byte_stream(bs, o); }) {
+        T::from_byte_stream(bs, o);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        bs.read(o);
+    } else if constexpr (IsStdVector<T>::value) {
+        uint64_t length = 0;
+        bs.read(length);
+        o.resize(length);
+        for (auto& elem : o) { from_byte_stream(bs, elem); }
+    } else if constexpr (IsStdArray<T>::value) {
+        for (auto& elem : o) { from_byte_stream(bs, elem); }
+    } else if constexpr (srefl::is_reflectable<T>) {
+        constexpr auto type = srefl::refl<T>();
+        srefl::for_each(type.members, [&bs, &o](auto member) {
+            if constexpr (!decltype(member)::is_const) {
+                from_byte_stream(bs, member(o));
+            }
+        });
+    } else {
+        bs.read(o);
+    }
+}
+
+}
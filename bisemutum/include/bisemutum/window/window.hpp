@@ -18,7 +18,10 @@ namespace bi {
 struct Window final : PImpl<Window> {
     struct Impl;
 
-    Window(uint32_t width, uint32_t height, std::string_view title);
+    // A headless window doesn't create any platform window, it only provides size and frame count.
+    Window(uint32_t width, uint32_t height, std::string_view title, bool headless = false);
+
+    auto is_headless() const -> bool;
 
     auto frame_size() const -> WindowSize;
     auto logic_size() const -> WindowSize;
@@ -29,6 +32,8 @@ struct Window final : PImpl<Window> {
     auto frame_count() const -> uint64_t;
 
     auto main_loop(std::function<auto() -> void> const& func) -> void;
+    // Run exactly `num_frames` frames, used when there is no platform window to close.
+    auto run_frames(uint64_t num_frames, std::function<auto() -> void> const& func) -> void;
 
     auto raw_glfw_window() const -> GLFWwindow*;
 
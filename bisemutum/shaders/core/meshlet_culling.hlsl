@@ -0,0 +1,97 @@
+// Same as `Meshlet` in 'meshlet.hpp'.
+struct Meshlet {
+    float4 bounding_sphere;
+    float4 normal_cone;
+    uint index_offset;
+    uint num_indices;
+    uint num_vertices;
+    uint _pad;
+};
+
+// Same as `MeshletCullingJobData` in 'render_graph.cpp'.
+struct MeshletCullingJobData {
+    float4x4 matrix_object_to_world;
+    // Object space view position for perspective views, or view direction for orthographic views.
+    float4 view_position_or_direction;
+    uint meshlet_offset;
+    uint num_meshlets;
+    uint first_index;
+    int base_vertex;
+    uint args_offset;
+    float max_scaling;
+    float back_face_sign;
+    uint orthographic;
+};
+
+#include <bisemutum/shaders/core/shader_params/compute.hlsl>
+
+#define MESHLET_CULLING_GROUP_SIZE 64
+#define MESHLET_CULLING_MAX_NUM_GROUPS_X 65535
+
+groupshared uint gs_num_draws;
+
+// Same as `is_meshlet_visible()` in 'meshlet.cpp'.
+bool is_meshlet_visible(Meshlet meshlet, MeshletCullingJobData job) {
+    float3 center = meshlet.bounding_sphere.xyz;
+    float radius = meshlet.bounding_sphere.w;
+
+    float3 world_center = mul(job.matrix_object_to_world, float4(center, 1.0)).xyz;
+    float world_radius = radius * job.max_scaling;
+    for (uint i = 0; i < 6; i++) {
+        if (dot(frustum_planes[i].xyz, world_center) + frustum_planes[i].w < -world_radius) {
+            return false;
+        }
+    }
+
+    float cutoff = meshlet.normal_cone.w;
+    if (job.back_face_sign != 0.0 && cutoff < 1.0) {
+        float3 axis = meshlet.normal_cone.xyz * job.back_face_sign;
+        if (job.orthographic != 0) {
+            if (dot(job.view_position_or_direction.xyz, axis) >= cutoff) {
+                return false;
+            }
+        } else {
+            float3 view_to_center = center - job.view_position_or_direction.xyz;
+            if (dot(view_to_center, axis) >= cutoff * length(view_to_center) + radius) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+[numthreads(MESHLET_CULLING_GROUP_SIZE, 1, 1)]
+void meshlet_culling_cs(uint3 group_id : SV_GroupID, uint thread_index : SV_GroupIndex) {
+    uint job_index = group_id.y * MESHLET_CULLING_MAX_NUM_GROUPS_X + group_id.x;
+    if (job_index >= num_jobs) { return; }
+    MeshletCullingJobData job = jobs[job_index];
+
+    if (thread_index == 0) {
+        gs_num_draws = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    for (uint base = 0; base < job.num_meshlets; base += MESHLET_CULLING_GROUP_SIZE) {
+        uint meshlet_index = base + thread_index;
+        if (meshlet_index >= job.num_meshlets) { break; }
+
+        Meshlet meshlet = meshlets[job.meshlet_offset + meshlet_index];
+        if (is_meshlet_visible(meshlet, job)) {
+            uint draw_index;
+            InterlockedAdd(gs_num_draws, 1, draw_index);
+            // Same layout as `DrawIndexedIndirectCommand` in 'command.hpp'.
+            uint args_index = (job.args_offset + draw_index) * 5;
+            indirect_args[args_index] = meshlet.num_indices;
+            indirect_args[args_index + 1] = 1;
+            indirect_args[args_index + 2] = job.first_index + meshlet.index_offset;
+            indirect_args[args_index + 3] = asuint(job.base_vertex);
+            indirect_args[args_index + 4] = 0;
+        }
+    }
+
+    GroupMemoryBarrierWithGroupSync();
+    if (thread_index == 0) {
+        indirect_counts[job_index] = gs_num_draws;
+    }
+}
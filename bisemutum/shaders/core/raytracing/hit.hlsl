@@ -5,6 +5,8 @@
 #include "../vertex_attributes.hlsl"
 
 struct DrawableSbtData {
+    float4 position_dequantization_offset;
+    float4 position_dequantization_scale;
     uint drawable_index;
     uint position_offset;
     uint normal_offset;
@@ -24,6 +26,91 @@ $RAYTRACING_MATERIAL_STRUCT
 
 $RAYTRACING_SCENE_SHADER_PARAMS
 
+// Buffers are declared as float buffers, quantized data are read by `asuint()`.
+float2 unpack_snorm16x2(uint packed) {
+    int2 value = int2(int(packed << 16) >> 16, int(packed) >> 16);
+    return max(float2(value) / 32767.0, -1.0);
+}
+
+float3 load_position(uint vertex) {
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_QUANTIZED) != 0
+    uint base = drawable_sbt_record.position_offset + 2 * vertex;
+    uint xy = asuint(positions_buffer[NonUniformResourceIndex(base)]);
+    uint z = asuint(positions_buffer[NonUniformResourceIndex(base + 1)]);
+    float3 unorm = float3(xy & 0xffff, xy >> 16, z & 0xffff) / 65535.0;
+    return drawable_sbt_record.position_dequantization_offset.xyz
+        + drawable_sbt_record.position_dequantization_scale.xyz * unorm;
+#else
+    uint base = drawable_sbt_record.position_offset + 3 * vertex;
+    return float3(
+        positions_buffer[NonUniformResourceIndex(base)],
+        positions_buffer[NonUniformResourceIndex(base + 1)],
+        positions_buffer[NonUniformResourceIndex(base + 2)]
+    );
+#endif
+}
+float3 load_normal(uint vertex) {
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_QUANTIZED) != 0
+    uint base = drawable_sbt_record.normal_offset + vertex;
+    return oct_decode(unpack_snorm16x2(asuint(normals_buffer[NonUniformResourceIndex(base)])));
+#else
+    uint base = drawable_sbt_record.normal_offset + 3 * vertex;
+    return float3(
+        normals_buffer[NonUniformResourceIndex(base)],
+        normals_buffer[NonUniformResourceIndex(base + 1)],
+        normals_buffer[NonUniformResourceIndex(base + 2)]
+    );
+#endif
+}
+float4 load_tangent(uint vertex) {
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_QUANTIZED) != 0
+    uint base = drawable_sbt_record.tangent_offset + 2 * vertex;
+    float2 encoded = unpack_snorm16x2(asuint(tangents_buffer[NonUniformResourceIndex(base)]));
+    float handedness = unpack_snorm16x2(asuint(tangents_buffer[NonUniformResourceIndex(base + 1)])).x;
+    return float4(oct_decode(encoded), handedness < 0.0 ? -1.0 : 1.0);
+#else
+    uint base = drawable_sbt_record.tangent_offset + 4 * vertex;
+    return float4(
+        tangents_buffer[NonUniformResourceIndex(base)],
+        tangents_buffer[NonUniformResourceIndex(base + 1)],
+        tangents_buffer[NonUniformResourceIndex(base + 2)],
+        tangents_buffer[NonUniformResourceIndex(base + 3)]
+    );
+#endif
+}
+float3 load_color(uint vertex) {
+    uint base = drawable_sbt_record.color_offset + 3 * vertex;
+    return float3(
+        colors_buffer[NonUniformResourceIndex(base)],
+        colors_buffer[NonUniformResourceIndex(base + 1)],
+        colors_buffer[NonUniformResourceIndex(base + 2)]
+    );
+}
+float2 load_texcoord(uint vertex) {
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_QUANTIZED) != 0
+    uint packed = asuint(texcoords_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord_offset + vertex)]);
+    return f16tof32(uint2(packed & 0xffff, packed >> 16));
+#else
+    uint base = drawable_sbt_record.texcoord_offset + 2 * vertex;
+    return float2(
+        texcoords_buffer[NonUniformResourceIndex(base)],
+        texcoords_buffer[NonUniformResourceIndex(base + 1)]
+    );
+#endif
+}
+float2 load_texcoord2(uint vertex) {
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_QUANTIZED) != 0
+    uint packed = asuint(texcoords2_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord2_offset + vertex)]);
+    return f16tof32(uint2(packed & 0xffff, packed >> 16));
+#else
+    uint base = drawable_sbt_record.texcoord2_offset + 2 * vertex;
+    return float2(
+        texcoords2_buffer[NonUniformResourceIndex(base)],
+        texcoords2_buffer[NonUniformResourceIndex(base + 1)]
+    );
+#endif
+}
+
 VertexAttributesOutput fetch_vertex_attributes(float2 bary) {
     uint3 index = uint3(
         indices_buffer[NonUniformResourceIndex(drawable_sbt_record.index_offset + 3 * PrimitiveIndex())],
@@ -33,118 +120,49 @@ VertexAttributesOutput fetch_vertex_attributes(float2 bary) {
 
     float3 position = 0.0;
 #if (VERTEX_ATTRIBUTES_IN & VA_TYPE_POSITION) != 0
-    float3 position0 = float3(
-        positions_buffer[NonUniformResourceIndex(drawable_sbt_record.position_offset + 3 * index.x)],
-        positions_buffer[NonUniformResourceIndex(drawable_sbt_record.position_offset + 3 * index.x + 1)],
-        positions_buffer[NonUniformResourceIndex(drawable_sbt_record.position_offset + 3 * index.x + 2)]
-    );
-    float3 position1 = float3(
-        positions_buffer[NonUniformResourceIndex(drawable_sbt_record.position_offset + 3 * index.y)],
-        positions_buffer[NonUniformResourceIndex(drawable_sbt_record.position_offset + 3 * index.y + 1)],
-        positions_buffer[NonUniformResourceIndex(drawable_sbt_record.position_offset + 3 * index.y + 2)]
-    );
-    float3 position2 = float3(
-        positions_buffer[NonUniformResourceIndex(drawable_sbt_record.position_offset + 3 * index.z)],
-        positions_buffer[NonUniformResourceIndex(drawable_sbt_record.position_offset + 3 * index.z + 1)],
-        positions_buffer[NonUniformResourceIndex(drawable_sbt_record.position_offset + 3 * index.z + 2)]
-    );
+    float3 position0 = load_position(index.x);
+    float3 position1 = load_position(index.y);
+    float3 position2 = load_position(index.z);
     position = position0 + (position1 - position0) * bary.x + (position2 - position0) * bary.y;
 #endif
 
     float3 normal = float3(0.0, 0.0, 1.0);
 #if (VERTEX_ATTRIBUTES_IN & VA_TYPE_NORMAL) != 0
-    float3 normal0 = float3(
-        normals_buffer[NonUniformResourceIndex(drawable_sbt_record.normal_offset + 3 * index.x)],
-        normals_buffer[NonUniformResourceIndex(drawable_sbt_record.normal_offset + 3 * index.x + 1)],
-        normals_buffer[NonUniformResourceIndex(drawable_sbt_record.normal_offset + 3 * index.x + 2)]
-    );
-    float3 normal1 = float3(
-        normals_buffer[NonUniformResourceIndex(drawable_sbt_record.normal_offset + 3 * index.y)],
-        normals_buffer[NonUniformResourceIndex(drawable_sbt_record.normal_offset + 3 * index.y + 1)],
-        normals_buffer[NonUniformResourceIndex(drawable_sbt_record.normal_offset + 3 * index.y + 2)]
-    );
-    float3 normal2 = float3(
-        normals_buffer[NonUniformResourceIndex(drawable_sbt_record.normal_offset + 3 * index.z)],
-        normals_buffer[NonUniformResourceIndex(drawable_sbt_record.normal_offset + 3 * index.z + 1)],
-        normals_buffer[NonUniformResourceIndex(drawable_sbt_record.normal_offset + 3 * index.z + 2)]
-    );
+    float3 normal0 = load_normal(index.x);
+    float3 normal1 = load_normal(index.y);
+    float3 normal2 = load_normal(index.z);
     normal = normal0 + (normal1 - normal0) * bary.x + (normal2 - normal0) * bary.y;
 #endif
 
     float4 tangent = float4(1.0, 0.0, 0.0, 1.0);
 #if (VERTEX_ATTRIBUTES_IN & VA_TYPE_TANGENT) != 0
-    float4 tangent0 = float4(
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.x)],
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.x + 1)],
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.x + 2)],
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.x + 3)]
-    );
-    float4 tangent1 = float4(
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.y)],
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.y + 1)],
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.y + 2)],
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.y + 3)]
-    );
-    float4 tangent2 = float4(
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.z)],
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.z + 1)],
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.z + 2)],
-        tangents_buffer[NonUniformResourceIndex(drawable_sbt_record.tangent_offset + 4 * index.z + 3)]
-    );
+    float4 tangent0 = load_tangent(index.x);
+    float4 tangent1 = load_tangent(index.y);
+    float4 tangent2 = load_tangent(index.z);
     tangent = tangent0 + (tangent1 - tangent0) * bary.x + (tangent2 - tangent0) * bary.y;
 #endif
 
     float3 color = 0.0;
 #if (VERTEX_ATTRIBUTES_IN & VA_TYPE_COLOR) != 0
-    float3 color0 = float3(
-        colors_buffer[NonUniformResourceIndex(drawable_sbt_record.color_offset + 3 * index.x)],
-        colors_buffer[NonUniformResourceIndex(drawable_sbt_record.color_offset + 3 * index.x + 1)],
-        colors_buffer[NonUniformResourceIndex(drawable_sbt_record.color_offset + 3 * index.x + 2)]
-    );
-    float3 color1 = float3(
-        colors_buffer[NonUniformResourceIndex(drawable_sbt_record.color_offset + 3 * index.y)],
-        colors_buffer[NonUniformResourceIndex(drawable_sbt_record.color_offset + 3 * index.y + 1)],
-        colors_buffer[NonUniformResourceIndex(drawable_sbt_record.color_offset + 3 * index.y + 2)]
-    );
-    float3 color2 = float3(
-        colors_buffer[NonUniformResourceIndex(drawable_sbt_record.color_offset + 3 * index.x)],
-        colors_buffer[NonUniformResourceIndex(drawable_sbt_record.color_offset + 3 * index.x + 1)],
-        colors_buffer[NonUniformResourceIndex(drawable_sbt_record.color_offset + 3 * index.x + 2)]
-    );
+    float3 color0 = load_color(index.x);
+    float3 color1 = load_color(index.y);
+    float3 color2 = load_color(index.z);
     color = color0 + (color1 - color0) * bary.x + (color2 - color0) * bary.y;
 #endif
 
     float2 texcoord = 0.0;
 #if (VERTEX_ATTRIBUTES_IN & VA_TYPE_TEXCOORD) != 0
-    float2 texcoord_0 = float2(
-        texcoords_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord_offset + 2 * index.x)],
-        texcoords_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord_offset + 2 * index.x + 1)]
-    );
-    float2 texcoord_1 = float2(
-        texcoords_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord_offset + 2 * index.y)],
-        texcoords_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord_offset + 2 * index.y + 1)]
-    );
-    float2 texcoord_2 = float2(
-        texcoords_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord_offset + 2 * index.z)],
-        texcoords_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord_offset + 2 * index.z + 1)]
-    );
+    float2 texcoord_0 = load_texcoord(index.x);
+    float2 texcoord_1 = load_texcoord(index.y);
+    float2 texcoord_2 = load_texcoord(index.z);
     texcoord = texcoord_0 + (texcoord_1 - texcoord_0) * bary.x + (texcoord_2 - texcoord_0) * bary.y;
 #endif
 
     float2 texcoord2 = 0.0;
 #if (VERTEX_ATTRIBUTES_IN & VA_TYPE_TEXCOORD2) != 0
-    float2 texcoord2_0 = float2(
-        texcoords2_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord2_offset + 2 * index.x)],
-        texcoords2_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord2_offset + 2 * index.x + 1)]
-    );
-    float2 texcoord2_1 = float2(
-        texcoords2_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord2_offset + 2 * index.y)],
-        texcoords2_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord2_offset + 2 * index.y + 1)]
-    );
-    float2 texcoord2_2 = float2(
-        texcoords2_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord2_offset + 2 * index.z)],
-        texcoords2_buffer[NonUniformResourceIndex(drawable_sbt_record.texcoord2_offset + 2 * index.z + 1)]
-    );
+    float2 texcoord2_0 = load_texcoord2(index.x);
+    float2 texcoord2_1 = load_texcoord2(index.y);
+    float2 texcoord2_2 = load_texcoord2(index.z);
     texcoord2 = texcoord2_0 + (texcoord2_1 - texcoord2_0) * bary.x + (texcoord2_2 - texcoord2_0) * bary.y;
 #endif
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vertex_attributes_defines.hlsl"
+#include "utils/pack.hlsl"
 
 #define VA_TYPE_NONE 0
 #define VA_TYPE_POSITION 0x1
@@ -10,6 +11,7 @@
 #define VA_TYPE_COLOR 0x10
 #define VA_TYPE_TEXCOORD 0x20
 #define VA_TYPE_TEXCOORD2 0x40
+#define VA_TYPE_QUANTIZED 0x80
 
 #ifndef VERTEX_ATTRIBUTES_IN
 #define VERTEX_ATTRIBUTES_IN VA_TYPE_NONE
@@ -19,12 +21,21 @@
 #define VERTEX_ATTRIBUTES_OUT VA_TYPE_NONE
 #endif
 
+// See 'vertex_quantization.hpp' for the quantized formats, texcoords are converted from half by vertex input.
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_QUANTIZED) != 0
+#define VA_POSITION_TYPE float4
+#define VA_NORMAL_TYPE float2
+#else
+#define VA_POSITION_TYPE float3
+#define VA_NORMAL_TYPE float3
+#endif
+
 struct VertexAttributes {
 #if (VERTEX_ATTRIBUTES_IN & VA_TYPE_POSITION) != 0
-    INPUT_VERTEX_POSITION(float3 position);
+    INPUT_VERTEX_POSITION(VA_POSITION_TYPE position);
 #endif
 #if (VERTEX_ATTRIBUTES_IN & VA_TYPE_NORMAL) != 0
-    INPUT_VERTEX_NORMAL(float3 normal);
+    INPUT_VERTEX_NORMAL(VA_NORMAL_TYPE normal);
 #endif
 #if (VERTEX_ATTRIBUTES_IN & VA_TYPE_TANGENT) != 0
     INPUT_VERTEX_TANGENT(float4 tangent);
@@ -40,6 +51,64 @@ struct VertexAttributes {
 #endif
 };
 
+struct DecodedVertexAttributes {
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_POSITION) != 0
+    float3 position;
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_NORMAL) != 0
+    float3 normal;
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_TANGENT) != 0
+    float4 tangent;
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_COLOR) != 0
+    float3 color;
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_TEXCOORD) != 0
+    float2 texcoord;
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_TEXCOORD2) != 0
+    float2 texcoord2;
+#endif
+};
+
+DecodedVertexAttributes decode_vertex_attributes(
+    VertexAttributes vin, float3 position_dequantization_offset, float3 position_dequantization_scale
+) {
+    DecodedVertexAttributes decoded;
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_QUANTIZED) != 0
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_POSITION) != 0
+    decoded.position = position_dequantization_offset + position_dequantization_scale * vin.position.xyz;
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_NORMAL) != 0
+    decoded.normal = oct_decode(vin.normal);
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_TANGENT) != 0
+    decoded.tangent = float4(oct_decode(vin.tangent.xy), vin.tangent.z < 0.0 ? -1.0 : 1.0);
+#endif
+#else
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_POSITION) != 0
+    decoded.position = vin.position;
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_NORMAL) != 0
+    decoded.normal = vin.normal;
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_TANGENT) != 0
+    decoded.tangent = vin.tangent;
+#endif
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_COLOR) != 0
+    decoded.color = vin.color;
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_TEXCOORD) != 0
+    decoded.texcoord = vin.texcoord;
+#endif
+#if (VERTEX_ATTRIBUTES_IN & VA_TYPE_TEXCOORD2) != 0
+    decoded.texcoord2 = vin.texcoord2;
+#endif
+    return decoded;
+}
+
 struct VertexAttributesOutput {
     float4 sv_position : SV_Position;
 #if (VERTEX_ATTRIBUTES_OUT & VA_TYPE_POSITION) != 0
@@ -3,7 +3,10 @@
 #include <bisemutum/shaders/core/shader_params/camera.hlsl>
 #include <bisemutum/shaders/core/shader_params/mesh.hlsl>
 
-VertexAttributesOutput static_mesh_vs(VertexAttributes vin) {
+VertexAttributesOutput static_mesh_vs(VertexAttributes vin_raw) {
+    DecodedVertexAttributes vin = decode_vertex_attributes(
+        vin_raw, position_dequantization_offset.xyz, position_dequantization_scale.xyz
+    );
     VertexAttributesOutput vout;
 
     float3 position_world = mul(matrix_object_to_world, float4(vin.position, 1.0)).xyz;
@@ -0,0 +1,71 @@
+#include <bisemutum/cooker/cook_database.hpp>
+
+#include <algorithm>
+
+#include <bisemutum/prelude/byte_stream.hpp>
+#include <bisemutum/runtime/logger.hpp>
+
+namespace bi::cook {
+
+namespace {
+
+constexpr uint32_t cook_database_magic_number = 0xc00cdb00u;
+constexpr uint32_t cook_database_version = 1;
+
+} // namespace
+
+auto CookDatabase::load(Dyn<rt::IFile>::Ref file) -> CookDatabase {
+    auto binary_data = file.map_binary_data();
+    ReadByteStream bs{binary_data};
+
+    CookDatabase database{};
+    uint32_t magic_number = 0;
+    uint32_t version = 0;
+    if (bs.size() < sizeof(magic_number) + sizeof(version)) { return database; }
+    bs.read(magic_number).read(version);
+    if (magic_number != cook_database_magic_number || version != cook_database_version) {
+        log::warn("general", "Cook database '{}' is invalid or outdated, all entries will be cooked.", file.filename());
+        return database;
+    }
+
+    uint64_t num_records = 0;
+    bs.read(num_records);
+    database.records.reserve(num_records);
+    for (uint64_t i = 0; i < num_records; i++) {
+        std::string output;
+        CookRecord record{};
+        bs.read(output).read(record.settings_hash).read(record.output_hash);
+        uint64_t num_inputs = 0;
+        bs.read(num_inputs);
+        record.inputs.resize(num_inputs);
+        for (auto& input : record.inputs) {
+            bs.read(input.path).read(input.hash);
+        }
+        database.records.insert({std::move(output), std::move(record)});
+    }
+    return database;
+}
+
+auto CookDatabase::save(Dyn<rt::IFile>::Ref file) const -> bool {
+    // Sort records so that the database doesn't change if records don't change.
+    std::vector<std::pair<std::string_view, CookRecord const*>> sorted_records;
+    sorted_records.reserve(records.size());
+    for (auto const& [output, record] : records) {
+        sorted_records.emplace_back(output, &record);
+    }
+    std::sort(sorted_records.begin(), sorted_records.end());
+
+    WriteByteStream bs{};
+    bs.write(cook_database_magic_number).write(cook_database_version);
+    bs.write(static_cast<uint64_t>(sorted_records.size()));
+    for (auto [output, record] : sorted_records) {
+        bs.write(output).write(record->settings_hash).write(record->output_hash);
+        bs.write(static_cast<uint64_t>(record->inputs.size()));
+        for (auto const& input : record->inputs) {
+            bs.write(input.path).write(input.hash);
+        }
+    }
+    return file.write_binary_data(bs.data());
+}
+
+}
@@ -0,0 +1,146 @@
+#include "cook_steps.hpp"
+
+#include <bit>
+#include <cstring>
+
+#include <bisemutum/runtime/logger.hpp>
+#include <bisemutum/graphics/mesh_optimization.hpp>
+#include <bisemutum/graphics/meshlet.hpp>
+#include <bisemutum/scene_basic/static_mesh_data.hpp>
+#include <tinyexr.h>
+#include <stb_image.h>
+
+namespace bi::cook {
+
+namespace {
+
+// Decode level 0 of an image as RGBA8 or RGBA32 float.
+auto decode_image(CSpan<std::byte> encoded, std::string_view extension, bool srgb) -> Option<TextureLevels> {
+    auto encoded_bytes = reinterpret_cast<stbi_uc const*>(encoded.data());
+    int width = 0;
+    int height = 0;
+    std::vector<std::byte> data;
+    auto format = srgb ? rhi::ResourceFormat::rgba8_srgb : rhi::ResourceFormat::rgba8_unorm;
+    if (extension == ".exr") {
+        float* image_data = nullptr;
+        char const* err = nullptr;
+        if (LoadEXRFromMemory(&image_data, &width, &height, encoded_bytes, encoded.size(), &err) != TINYEXR_SUCCESS) {
+            log::error("general", "Failed to decode EXR image: {}", err ? err : "unknown error");
+            FreeEXRErrorMessage(err);
+            return {};
+        }
+        data.resize(width * height * 4 * sizeof(float));
+        std::memcpy(data.data(), image_data, data.size());
+        free(image_data);
+        format = rhi::ResourceFormat::rgba32_sfloat;
+    } else if (stbi_is_hdr_from_memory(encoded_bytes, encoded.size())) {
+        int temp_comp = 0;
+        auto image_data = stbi_loadf_from_memory(encoded_bytes, encoded.size(), &width, &height, &temp_comp, 4);
+        if (image_data == nullptr) {
+            log::error("general", "Failed to decode HDR image: {}", stbi_failure_reason());
+            return {};
+        }
+        data.resize(width * height * 4 * sizeof(float));
+        std::memcpy(data.data(), image_data, data.size());
+        stbi_image_free(image_data);
+        format = rhi::ResourceFormat::rgba32_sfloat;
+    } else {
+        int temp_comp = 0;
+        auto image_data = stbi_load_from_memory(encoded_bytes, encoded.size(), &width, &height, &temp_comp, 4);
+        if (image_data == nullptr) {
+            log::error("general", "Failed to decode image: {}", stbi_failure_reason());
+            return {};
+        }
+        data.resize(width * height * 4);
+        std::memcpy(data.data(), image_data, data.size());
+        stbi_image_free(image_data);
+    }
+
+    auto extent = rhi::Extent3D{static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
+    return TextureLevels{
+        .desc = rhi::TextureDesc{
+            .extent = extent,
+            .levels = static_cast<uint32_t>(std::bit_width(std::max(extent.width, extent.height))),
+            .format = format,
+            .dim = rhi::TextureDimension::d2,
+            .usages = {rhi::TextureUsage::sampled},
+        },
+        .data = std::move(data),
+        .level_offsets = {0},
+    };
+}
+
+} // namespace
+
+auto cook_texture(TextureCookEntry const& entry, Dyn<rt::IFile>::Ref src, Dyn<rt::IFile>::Ref dst) -> bool {
+    Option<TextureLevels> levels;
+    if (src.extension() == ".biasset") {
+        if (auto texture = read_texture_asset_data(src); texture) {
+            levels = std::move(texture.value().levels);
+        }
+    } else {
+        levels = decode_image(src.map_binary_data(), src.extension(), entry.srgb);
+    }
+    if (!levels) {
+        log::error("general", "Failed to read texture '{}'.", entry.source);
+        return false;
+    }
+    auto& texture = levels.value();
+
+    auto need_mipmaps = entry.mipmaps || entry.compress;
+    if (
+        need_mipmaps && texture.desc.dim != rhi::TextureDimension::d3
+        && !rhi::is_compressed_format(texture.desc.format) && texture.level_offsets.size() < texture.desc.levels
+    ) {
+        auto mipmapped = generate_mipmaps(texture.desc, texture.data, MipmapSettings{
+            .srgb_encoded = entry.srgb,
+            .alpha_cutoff = entry.alpha_cutoff > 0.0f ? Option<float>{entry.alpha_cutoff} : Option<float>{},
+        });
+        if (!mipmapped) {
+            log::error("general", "Failed to generate mipmaps of texture '{}'.", entry.source);
+            return false;
+        }
+        texture = std::move(mipmapped).value();
+    } else if (!need_mipmaps && texture.level_offsets.size() < texture.desc.levels) {
+        // Otherwise remaining levels are generated on GPU.
+        texture.desc.levels = static_cast<uint32_t>(texture.level_offsets.size());
+    }
+
+    if (entry.compress && !rhi::is_compressed_format(texture.desc.format)) {
+        auto compressed = compress_texture(texture.desc, texture.data, texture.level_offsets, entry.semantic);
+        if (!compressed) {
+            log::error("general", "Failed to compress texture '{}'.", entry.source);
+            return false;
+        }
+        texture = std::move(compressed).value();
+        // Block-compressed textures can't be written by shaders.
+        texture.desc.usages = {rhi::TextureUsage::sampled};
+    }
+
+    return write_texture_asset_data(dst, entry.sampler, texture.desc, texture.level_offsets, texture.data);
+}
+
+auto cook_mesh(MeshCookEntry const& entry, Dyn<rt::IFile>::Ref src, Dyn<rt::IFile>::Ref dst) -> bool {
+    gfx::MeshData mesh_data{};
+    if (!read_static_mesh_data(src, mesh_data)) {
+        log::error("general", "Failed to read static mesh '{}'.", entry.source);
+        return false;
+    }
+
+    if (entry.optimize) {
+        gfx::optimize_mesh(mesh_data);
+    }
+    mesh_data.set_quantized(entry.quantize);
+    // Meshlets are built last, since they reorder triangles and their bounds account for quantization.
+    if (entry.meshlets) {
+        gfx::build_meshlets(mesh_data);
+    }
+
+    return write_static_mesh_data(dst, mesh_data);
+}
+
+auto cook_file(FileCookEntry const& entry, Dyn<rt::IFile>::Ref src, Dyn<rt::IFile>::Ref dst) -> bool {
+    return dst.write_binary_data(src.map_binary_data());
+}
+
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <bisemutum/cooker/cook_manifest.hpp>
+#include <bisemutum/runtime/vfs.hpp>
+
+namespace bi::cook {
+
+// They only touch CPU data and the given files, so that entries can be cooked in parallel.
+
+auto cook_texture(TextureCookEntry const& entry, Dyn<rt::IFile>::Ref src, Dyn<rt::IFile>::Ref dst) -> bool;
+
+auto cook_mesh(MeshCookEntry const& entry, Dyn<rt::IFile>::Ref src, Dyn<rt::IFile>::Ref dst) -> bool;
+
+auto cook_file(FileCookEntry const& entry, Dyn<rt::IFile>::Ref src, Dyn<rt::IFile>::Ref dst) -> bool;
+
+}
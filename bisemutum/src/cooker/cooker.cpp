@@ -0,0 +1,200 @@
+#include <bisemutum/cooker/cooker.hpp>
+
+#include <atomic>
+#include <functional>
+
+#include <bisemutum/cooker/cook_database.hpp>
+#include <bisemutum/runtime/logger.hpp>
+#include <bisemutum/runtime/thread_pool.hpp>
+#include <bisemutum/utils/serde.hpp>
+
+#include "cook_steps.hpp"
+
+namespace bi::cook {
+
+namespace {
+
+constexpr std::string_view source_root = "/source/";
+constexpr std::string_view output_root = "/output/";
+
+using CookFunc = std::function<auto(Dyn<rt::IFile>::Ref src, Dyn<rt::IFile>::Ref dst) -> bool>;
+
+struct CookJob final {
+    std::string_view source;
+    std::string_view output;
+    CSpan<std::string> dependencies;
+    crypto::MD5 settings_hash;
+    CookFunc cook;
+
+    // Empty if any input is missing.
+    Option<std::vector<CookInput>> inputs;
+    bool dirty = true;
+    Option<Dyn<rt::IFile>::Box> output_file;
+    Option<crypto::MD5> output_hash;
+};
+
+auto hash_string(std::string_view str) -> crypto::MD5 {
+    return crypto::md5({reinterpret_cast<std::byte const*>(str.data()), str.size()});
+}
+
+auto hash_file(rt::FileSystem const& fs, std::string_view root, std::string_view path) -> Option<crypto::MD5> {
+    auto file = fs.get_file(fmt::format("{}{}", root, path));
+    if (!file) { return {}; }
+    return crypto::md5(file.value().map_binary_data());
+}
+
+template <typename Entry>
+auto add_cook_jobs(
+    std::vector<CookJob>& jobs, std::string_view type_name, std::vector<Entry> const& entries,
+    auto (*cook_func)(Entry const&, Dyn<rt::IFile>::Ref, Dyn<rt::IFile>::Ref) -> bool
+) -> void {
+    for (auto const& entry : entries) {
+        serde::Value value{};
+        serde::to_value(value, entry);
+        jobs.push_back(CookJob{
+            .source = entry.source,
+            .output = entry.output,
+            .dependencies = entry.dependencies,
+            .settings_hash = hash_string(fmt::format("{} {} {}", type_name, cooker_version, value.to_json())),
+            .cook = [&entry, cook_func](Dyn<rt::IFile>::Ref src, Dyn<rt::IFile>::Ref dst) {
+                return cook_func(entry, src, dst);
+            },
+        });
+    }
+}
+
+auto collect_inputs(rt::FileSystem const& fs, CookJob const& job) -> Option<std::vector<CookInput>> {
+    std::vector<CookInput> inputs{};
+    inputs.reserve(job.dependencies.size() + 1);
+    auto add_input = [&](std::string_view path) {
+        auto hash = hash_file(fs, source_root, path);
+        if (!hash) {
+            log::error("general", "Input '{}' of '{}' not found.", path, job.output);
+            return false;
+        }
+        inputs.push_back(CookInput{.path = std::string{path}, .hash = hash.value()});
+        return true;
+    };
+    if (!add_input(job.source)) { return {}; }
+    for (auto const& dependency : job.dependencies) {
+        if (!add_input(dependency)) { return {}; }
+    }
+    return inputs;
+}
+
+auto is_up_to_date(rt::FileSystem const& fs, CookJob const& job, CookDatabase const& database) -> bool {
+    auto it = database.records.find(job.output);
+    if (it == database.records.end()) { return false; }
+    auto const& record = it->second;
+    if (record.settings_hash != job.settings_hash || record.inputs != job.inputs.value()) { return false; }
+    // Outputs modified or removed after cooking are cooked again.
+    auto output_hash = hash_file(fs, output_root, job.output);
+    return output_hash && output_hash.value() == record.output_hash;
+}
+
+} // namespace
+
+auto cook(std::filesystem::path const& manifest_path, CookSettings const& settings) -> Option<CookStatistics> {
+    CookManifest manifest{};
+    try {
+        rt::PhysicalFile manifest_file{manifest_path, false};
+        manifest = serde::Value::from_toml(manifest_file.read_string_data()).get<CookManifest>();
+    } catch (std::exception const& e) {
+        log::error("general", "Cook manifest '{}' is invalid: {}", manifest_path.string(), e.what());
+        return {};
+    }
+
+    auto base_dir = manifest_path.parent_path();
+    rt::FileSystem fs{};
+    fs.mount(source_root, rt::PhysicalSubFileSystem{base_dir / manifest.source_dir, false});
+    fs.mount(output_root, rt::PhysicalSubFileSystem{base_dir / manifest.output_dir, true});
+
+    auto database_path = base_dir / manifest.database;
+    CookDatabase database{};
+    if (!settings.force && std::filesystem::is_regular_file(database_path)) {
+        rt::PhysicalFile database_file{database_path, false};
+        database = CookDatabase::load(database_file);
+    }
+
+    std::vector<CookJob> jobs{};
+    jobs.reserve(manifest.textures.size() + manifest.meshes.size() + manifest.files.size());
+    add_cook_jobs(jobs, "texture", manifest.textures, cook_texture);
+    add_cook_jobs(jobs, "mesh", manifest.meshes, cook_mesh);
+    add_cook_jobs(jobs, "file", manifest.files, cook_file);
+
+    rt::ThreadPool thread_pool{settings.num_threads};
+
+    // Hashing inputs and outputs reads all of them, so it's done in parallel as well.
+    thread_pool.parallel_for(jobs.size(), [&fs, &jobs, &database](size_t index) {
+        auto& job = jobs[index];
+        job.inputs = collect_inputs(fs, job);
+        job.dirty = job.inputs && !is_up_to_date(fs, job, database);
+    });
+
+    CookStatistics statistics{};
+    std::vector<size_t> dirty_jobs{};
+    for (size_t i = 0; i < jobs.size(); i++) {
+        auto& job = jobs[i];
+        if (!job.inputs) {
+            ++statistics.num_failed;
+        } else if (!job.dirty) {
+            ++statistics.num_up_to_date;
+        } else if (auto file = fs.create_file(fmt::format("{}{}", output_root, job.output)); file) {
+            // Files are created serially since directories may be created.
+            job.output_file = std::move(file);
+            dirty_jobs.push_back(i);
+        } else {
+            log::error("general", "Failed to create output '{}'.", job.output);
+            ++statistics.num_failed;
+        }
+    }
+
+    thread_pool.parallel_for(dirty_jobs.size(), [&fs, &jobs, &dirty_jobs](size_t index) {
+        auto& job = jobs[dirty_jobs[index]];
+        auto src_file = fs.get_file(fmt::format("{}{}", source_root, job.source));
+        if (!src_file || !job.cook(*&src_file.value(), *&job.output_file.value())) { return; }
+        // Release the written file before reading it back.
+        job.output_file.reset();
+        job.output_hash = hash_file(fs, output_root, job.output);
+    });
+
+    for (auto index : dirty_jobs) {
+        auto& job = jobs[index];
+        if (job.output_hash) {
+            log::info("general", "Cooked '{}'.", job.output);
+            ++statistics.num_cooked;
+            database.records.insert_or_assign(std::string{job.output}, CookRecord{
+                .inputs = std::move(job.inputs).value(),
+                .settings_hash = job.settings_hash,
+                .output_hash = job.output_hash.value(),
+            });
+        } else {
+            log::error("general", "Failed to cook '{}'.", job.output);
+            ++statistics.num_failed;
+            job.output_file.reset();
+            fs.remove_file(fmt::format("{}{}", output_root, job.output));
+            database.records.erase(std::string{job.output});
+        }
+    }
+
+    // Drop records of outputs removed from the manifest.
+    StringHashSet outputs{};
+    for (auto const& job : jobs) {
+        outputs.insert(std::string{job.output});
+    }
+    std::erase_if(database.records, [&outputs](auto const& record) { return !outputs.contains(record.first); });
+
+    std::filesystem::create_directories(std::filesystem::absolute(database_path).parent_path());
+    rt::PhysicalFile database_file{database_path, true};
+    if (!database.save(database_file)) {
+        log::error("general", "Failed to write cook database '{}'.", database_path.string());
+    }
+
+    log::info(
+        "general", "Cooking finished: {} cooked, {} up to date, {} failed.",
+        statistics.num_cooked, statistics.num_up_to_date, statistics.num_failed
+    );
+    return statistics;
+}
+
+}
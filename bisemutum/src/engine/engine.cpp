@@ -1,6 +1,7 @@
 #include <bisemutum/engine/engine.hpp>
 
 #include <fstream>
+#include <chrono>
 
 #include <bisemutum/window/window.hpp>
 #include <bisemutum/window/window_manager.hpp>
@@ -13,15 +14,18 @@
 #include <bisemutum/runtime/module.hpp>
 #include <bisemutum/runtime/system_manager.hpp>
 #include <bisemutum/runtime/vfs.hpp>
+#include <bisemutum/runtime/archive.hpp>
 #include <bisemutum/runtime/logger.hpp>
 #include <bisemutum/runtime/component_manager.hpp>
 #include <bisemutum/runtime/asset_manager.hpp>
+#include <bisemutum/runtime/thread_pool.hpp>
 #include <bisemutum/utils/drefl.hpp>
 #include <bisemutum/editor/menu_manager.hpp>
 #include <bisemutum/platform/exe_dir.hpp>
 
 #include "register.hpp"
 #include "ui.hpp"
+#include "headless.hpp"
 
 namespace bi {
 
@@ -58,6 +62,10 @@ struct ExecutableOptions final {
     char const* graphics_api = nullptr;
     char const* project_file = nullptr;
     bool editor = false;
+    bool headless = false;
+    // Always enabled in editor mode.
+    bool hot_reload = false;
+    HeadlessOptions headless_options;
 };
 
 auto parse_options(int argc, char** argv) -> ExecutableOptions {
@@ -76,6 +84,35 @@ auto parse_options(int argc, char** argv) -> ExecutableOptions {
             }
         } else if (strcmp(argv[i], "-editor") == 0) {
             opt.editor = true;
+        } else if (strcmp(argv[i], "-headless") == 0) {
+            opt.headless = true;
+        } else if (strcmp(argv[i], "-hot-reload") == 0) {
+            opt.hot_reload = true;
+        } else if (strcmp(argv[i], "-frames") == 0) {
+            if (i + 1 < argc) {
+                ++i;
+                opt.headless_options.num_frames = std::strtoull(argv[i], nullptr, 10);
+            }
+        } else if (strcmp(argv[i], "-fixed-dt") == 0) {
+            if (i + 1 < argc) {
+                ++i;
+                opt.headless_options.fixed_delta_time = std::strtod(argv[i], nullptr);
+            }
+        } else if (strcmp(argv[i], "-report") == 0) {
+            if (i + 1 < argc) {
+                ++i;
+                opt.headless_options.report_file = argv[i];
+            }
+        } else if (strcmp(argv[i], "-dump-images") == 0) {
+            if (i + 1 < argc) {
+                ++i;
+                opt.headless_options.dump_images_dir = argv[i];
+            }
+        } else if (strcmp(argv[i], "-dump-interval") == 0) {
+            if (i + 1 < argc) {
+                ++i;
+                opt.headless_options.dump_interval = std::strtoull(argv[i], nullptr, 10);
+            }
         } else {
             log::warn("general", "Unknown comman line option '{}'", argv[i]);
         }
@@ -84,31 +121,49 @@ auto parse_options(int argc, char** argv) -> ExecutableOptions {
     return opt;
 }
 
+auto has_headless_option(int argc, char** argv) -> bool {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-headless") == 0) { return true; }
+    }
+    return false;
+}
+
+auto elapsed_ms(std::chrono::steady_clock::time_point& last_time) -> double {
+    auto curr_time = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = curr_time - last_time;
+    last_time = curr_time;
+    return elapsed.count();
+}
+
 } // namespace
 
 Engine* g_engine = nullptr;
 
 struct Engine::Impl final {
-    Impl() : window(1600, 900, "Bisemutum Engine") {
+    Impl(bool headless) : window(1600, 900, "Bisemutum Engine", headless) {
+        rt::g_logger_manager = &logger_manager;
+        rt::g_thread_pool = &thread_pool;
         register_loggers(logger_manager);
     }
 
     auto initialize(int argc, char** argv) -> bool {
-        if (!mount_engine_path()) { return false; }
-
         auto opt = parse_options(argc, argv);
-        is_editor_mode = opt.editor;
+        is_headless = window.is_headless();
+        is_editor_mode = opt.editor && !is_headless;
+        // Headless runs should be reproducible.
+        is_hot_reload_enabled = (is_editor_mode || opt.hot_reload) && !is_headless;
+        headless_options = std::move(opt.headless_options);
+
+        if (!mount_engine_path()) { return false; }
 
         do_register();
 
         if (opt.project_file) {
-            auto project_info_opt = read_project_file(opt.project_file);
+            auto project_file_path = mount_project(opt.project_file);
+            if (!project_file_path) { return false; }
+            auto project_info_opt = read_project_file(project_file_path.value());
             if (!project_info_opt) { return false; }
             project_info = std::move(project_info_opt).value();
-            file_system.mount(
-                "/project/",
-                rt::PhysicalSubFileSystem{std::filesystem::path{opt.project_file}.parent_path()}
-            );
         } else {
             project_info.name = "In Memory Empty Project";
             project_info.renderer = "BasicRenderer";
@@ -137,8 +192,7 @@ struct Engine::Impl final {
             }
         }
 
-        auto asset_metadata_file = file_system.get_file(project_info.asset_metadata_file).value();
-        if (!asset_manager.initialize(*&asset_metadata_file)) {
+        if (!asset_manager.initialize(project_info.asset_metadata_file)) {
             return false;
         }
 
@@ -146,24 +200,28 @@ struct Engine::Impl final {
         auto pipeline_cahce_file = fmt::format("/project/binaries/gfx-{}/pipeline_cache", graphics_backend_str);
         graphics_manager.initialize(project_info.settings.graphics, pipeline_cahce_file);
         graphics_manager.set_renderer(project_info.renderer);
+        // Before the scene is loaded, so that pipelines are created before the first frame.
+        graphics_manager.warm_up_pipelines(
+            fmt::format("/project/binaries/gfx-{}/pipeline_manifest", graphics_backend_str)
+        );
 
-        imgui_renderer.initialize(window, graphics_manager);
-
-        if (opt.editor) {
+        if (is_editor_mode) {
             ui = create_editor_ui();
         } else {
             ui = create_empty_ui();
         }
-        graphics_manager.set_displayer(ui.displayer());
+        if (!is_headless) {
+            imgui_renderer.initialize(window, graphics_manager);
+            graphics_manager.set_displayer(ui.displayer());
+        }
 
         if (!module_manager.initialize()) { return false; }
 
-        auto scene_file_opt = file_system.get_file(project_info.scene_file);
-        if (!scene_file_opt) {
+        if (!file_system.has_file(project_info.scene_file)) {
             log::critical("general", "Scene file '{}' not found.", project_info.scene_file);
             return false;
         }
-        if (!world.load_scene(scene_file_opt.value().read_string_data())) { return false; }
+        if (!world.load_scene_from_path(project_info.scene_file)) { return false; }
 
         return true;
     }
@@ -183,7 +241,7 @@ struct Engine::Impl final {
             log::critical("general", "File bisemutum_path.txt is broken.");
             return false;
         }
-        file_system.mount("/bisemutum/", rt::PhysicalSubFileSystem{engine_path, false});
+        file_system.mount("/bisemutum/", rt::PhysicalSubFileSystem{engine_path, false, is_hot_reload_enabled});
         return true;
     }
     auto do_register() -> void {
@@ -194,19 +252,38 @@ struct Engine::Impl final {
         register_reflections(reflection_manager);
         register_menu_actions(menu_manager);
     }
-    auto read_project_file(char const* project_file_path) -> Option<ProjectInfo> {
-        std::string project_file_str{};
-        {
-            std::ifstream fin(project_file_path);
-            if (!fin) {
-                log::critical("general", "Project file not found.");
-                return {};
-            }
-            project_file_str = read_all_from_file(fin);
+    // Mount the project directory, or a packed project (`project.toml` at the root of the pack) read-only with
+    // files written by the engine going to a '<pack name>_binaries' directory next to it.
+    // Return the VFS path of the project file.
+    auto mount_project(std::filesystem::path const& project_path) -> Option<std::string> {
+        if (project_path.extension() != rt::archive_extension) {
+            file_system.mount(
+                "/project/", rt::PhysicalSubFileSystem{project_path.parent_path(), true, is_hot_reload_enabled}
+            );
+            return "/project/" + project_path.filename().string();
+        }
+
+        rt::ArchiveSubFileSystem archive{project_path};
+        if (!archive.is_valid()) {
+            log::critical("general", "Project pack '{}' is invalid.", project_path.string());
+            return {};
+        }
+        file_system.mount("/project/", std::move(archive));
+        auto binaries_path = project_path.parent_path() / (project_path.stem().string() + "_binaries");
+        std::error_code ec{};
+        std::filesystem::create_directories(binaries_path, ec);
+        file_system.mount("/project/binaries/", rt::PhysicalSubFileSystem{binaries_path, true, false});
+        return std::string{"/project/project.toml"};
+    }
+    auto read_project_file(std::string const& project_file_path) -> Option<ProjectInfo> {
+        auto project_file = file_system.get_file(project_file_path);
+        if (!project_file) {
+            log::critical("general", "Project file not found.");
+            return {};
         }
 
         try {
-            auto value = serde::Value::from_toml(project_file_str);
+            auto value = serde::Value::from_toml(project_file.value().read_string_data());
             return value.get<ProjectInfo>();
         } catch (std::exception const& e) {
             log::critical("general", "Project file is invalid: {}", e.what());
@@ -216,30 +293,110 @@ struct Engine::Impl final {
 
     auto finalize() -> bool {
         graphics_manager.wait_idle();
-        imgui_renderer.finalize();
+        if (!is_headless) {
+            imgui_renderer.finalize();
+        }
         return module_manager.finalize();
     }
 
     auto execute() -> void {
+        if (is_headless) {
+            execute_headless();
+            return;
+        }
+
         frame_timer.reset();
         window.main_loop([this]() {
             window_manager.new_frame();
             graphics_manager.new_frame();
             frame_timer.tick();
+            if (is_hot_reload_enabled) {
+                reload_changed_files();
+            }
+            asset_manager.update();
+            system_manager.tick_update();
+            graphics_manager.render_frame();
+            system_manager.tick_post_update();
+            ui.execute();
+            world.current_scene()->do_destroy_scene_objects();
+        });
+    }
+
+    auto reload_changed_files() -> void {
+        auto changed_paths = file_system.poll_changed_files();
+        if (changed_paths.empty()) { return; }
+        graphics_manager.reload_shaders(changed_paths);
+        asset_manager.reload_changed_assets(changed_paths);
+    }
+
+    // Same steps as `execute()` but for a fixed number of frames, with timings of each step recorded.
+    auto execute_headless() -> void {
+        auto const& opt = headless_options;
+        HeadlessReport report{
+            .project = project_info.name,
+            .scene_file = project_info.scene_file,
+            .renderer = project_info.renderer,
+            .backend = std::string{magic_enum::enum_name(project_info.settings.graphics.backend)},
+            .num_frames = opt.num_frames,
+            .fixed_delta_time = opt.fixed_delta_time,
+        };
+        report.frames.reserve(opt.num_frames);
+
+        frame_timer.set_fixed_delta_time(opt.fixed_delta_time);
+        frame_timer.reset();
+        window.run_frames(opt.num_frames, [this, &opt, &report]() {
+            auto& timing = report.frames.emplace_back();
+            timing.frame = window.frame_count();
+
+            auto num_created_pipelines = graphics_manager.num_created_pipelines();
+            auto frame_start_time = std::chrono::steady_clock::now();
+            auto last_time = frame_start_time;
+            window_manager.new_frame();
+            graphics_manager.new_frame();
+            frame_timer.tick();
+            asset_manager.update();
+            timing.new_frame_ms = elapsed_ms(last_time);
             system_manager.tick_update();
+            timing.update_ms = elapsed_ms(last_time);
             graphics_manager.render_frame();
+            timing.render_ms = elapsed_ms(last_time);
             system_manager.tick_post_update();
             ui.execute();
             world.current_scene()->do_destroy_scene_objects();
+            timing.post_update_ms = elapsed_ms(last_time);
+            timing.total_ms = elapsed_ms(frame_start_time);
+            timing.num_created_pipelines = graphics_manager.num_created_pipelines() - num_created_pipelines;
+
+            if (!opt.dump_images_dir.empty()) {
+                auto is_last_frame = timing.frame + 1 == opt.num_frames;
+                auto should_dump = opt.dump_interval > 0
+                    ? (timing.frame + 1) % opt.dump_interval == 0 || is_last_frame
+                    : is_last_frame;
+                if (should_dump) {
+                    timing.images = dump_camera_images(opt.dump_images_dir, timing.frame);
+                }
+            }
         });
+        graphics_manager.wait_idle();
+
+        auto path_cache_statistics = file_system.path_cache_statistics();
+        report.path_cache_hits = path_cache_statistics.hits;
+        report.path_cache_misses = path_cache_statistics.misses;
+        report.path_cache_hit_rate = path_cache_statistics.hit_rate();
+
+        if (write_headless_report(report, opt.report_file)) {
+            log::info(
+                "general", "Headless run of {} frames finished, average frame time {:.3f} ms, report is written to '{}'.",
+                opt.num_frames, report.summary.avg_total_ms, opt.report_file.string()
+            );
+        }
     }
 
     auto save_all(bool force) -> void {
         auto current_scene_file = file_system.create_file(project_info.scene_file).value();
         world.save_currnet_scene(*&current_scene_file);
 
-        auto asset_metadata_file = file_system.create_file(project_info.asset_metadata_file).value();
-        asset_manager.save_all_assets(*&asset_metadata_file, force);
+        asset_manager.save_all_assets(project_info.asset_metadata_file, force);
     }
 
     rt::LoggerManager logger_manager;
@@ -251,6 +408,7 @@ struct Engine::Impl final {
     rt::FrameTimer frame_timer;
     rt::ModuleManager module_manager;
     rt::FileSystem file_system;
+    rt::ThreadPool thread_pool;
 
     gfx::GraphicsManager graphics_manager;
     ImGuiRenderer imgui_renderer;
@@ -266,9 +424,12 @@ struct Engine::Impl final {
     ProjectInfo project_info;
 
     bool is_editor_mode = false;
+    bool is_headless = false;
+    bool is_hot_reload_enabled = false;
+    HeadlessOptions headless_options;
 };
 
-Engine::Engine() = default;
+Engine::Engine(bool headless) : PImpl(headless) {}
 
 auto Engine::initialize(int argc, char** argv) -> bool { return impl()->initialize(argc, argv); }
 auto Engine::finalize() -> bool { return impl()->finalize(); }
@@ -280,6 +441,9 @@ auto Engine::execute() -> void {
 auto Engine::is_editor_mode() const -> bool {
     return impl()->is_editor_mode;
 }
+auto Engine::is_headless() const -> bool {
+    return impl()->is_headless;
+}
 
 auto Engine::window() -> Ref<Window> {
     return impl()->window;
@@ -319,6 +483,9 @@ auto Engine::component_manager() -> Ref<rt::ComponentManager> {
 auto Engine::asset_manager() -> Ref<rt::AssetManager> {
     return impl()->asset_manager;
 }
+auto Engine::thread_pool() -> Ref<rt::ThreadPool> {
+    return impl()->thread_pool;
+}
 auto Engine::reflection_manager() -> Ref<drefl::ReflectionManager> {
     return impl()->reflection_manager;
 }
@@ -334,18 +501,23 @@ auto Engine::save_all(bool force) -> void {
 auto initialize_engine(int argc, char** argv) -> bool {
     if (g_engine) { return true; }
 
-    g_engine = new Engine{};
+    g_engine = new Engine{has_headless_option(argc, argv)};
     if (g_engine->initialize(argc, argv)) {
         return true;
     }
     delete g_engine;
     g_engine = nullptr;
+    rt::g_logger_manager = nullptr;
+    rt::g_thread_pool = nullptr;
     return false;
 }
 auto finalize_engine() -> bool {
     if (!g_engine) { return true; }
     auto ret = g_engine->finalize();
     delete g_engine;
+    g_engine = nullptr;
+    rt::g_logger_manager = nullptr;
+    rt::g_thread_pool = nullptr;
     return ret;
 }
 
@@ -0,0 +1,128 @@
+#include "headless.hpp"
+
+#include <fstream>
+#include <algorithm>
+
+#include <stb_image_write.h>
+#include <bisemutum/engine/engine.hpp>
+#include <bisemutum/runtime/logger.hpp>
+#include <bisemutum/runtime/system_manager.hpp>
+#include <bisemutum/graphics/graphics_manager.hpp>
+#include <bisemutum/graphics/gpu_scene_system.hpp>
+#include <bisemutum/graphics/camera.hpp>
+#include <bisemutum/graphics/resource.hpp>
+#include <glm/gtc/packing.hpp>
+
+namespace bi {
+
+namespace {
+
+auto write_image(
+    std::filesystem::path const& path, rhi::ResourceFormat format, uint32_t width, uint32_t height,
+    std::vector<std::byte>& data
+) -> bool {
+    auto w = static_cast<int>(width);
+    auto h = static_cast<int>(height);
+    switch (format) {
+        case rhi::ResourceFormat::bgra8_unorm:
+        case rhi::ResourceFormat::bgra8_srgb:
+            for (size_t i = 0; i + 3 < data.size(); i += 4) {
+                std::swap(data[i], data[i + 2]);
+            }
+            [[fallthrough]];
+        case rhi::ResourceFormat::rgba8_unorm:
+        case rhi::ResourceFormat::rgba8_srgb:
+            return stbi_write_png(path.string().c_str(), w, h, 4, data.data(), w * 4) != 0;
+        case rhi::ResourceFormat::rgba16_sfloat: {
+            std::vector<float> pixels(data.size() / sizeof(uint16_t));
+            auto half_data = reinterpret_cast<uint16_t const*>(data.data());
+            for (size_t i = 0; i < pixels.size(); i++) {
+                pixels[i] = glm::unpackHalf1x16(half_data[i]);
+            }
+            return stbi_write_hdr(path.string().c_str(), w, h, 4, pixels.data()) != 0;
+        }
+        case rhi::ResourceFormat::rgba32_sfloat:
+            return stbi_write_hdr(path.string().c_str(), w, h, 4, reinterpret_cast<float const*>(data.data())) != 0;
+        default:
+            return false;
+    }
+}
+
+auto is_hdr_format(rhi::ResourceFormat format) -> bool {
+    return format == rhi::ResourceFormat::rgba16_sfloat || format == rhi::ResourceFormat::rgba32_sfloat;
+}
+
+auto percentile(std::vector<double> const& sorted_values, double p) -> double {
+    if (sorted_values.empty()) { return 0.0; }
+    auto index = static_cast<size_t>(p * (sorted_values.size() - 1) + 0.5);
+    return sorted_values[std::min(index, sorted_values.size() - 1)];
+}
+
+} // namespace
+
+auto dump_camera_images(std::filesystem::path const& dir, uint64_t frame) -> std::vector<std::string> {
+    std::vector<std::string> images{};
+    std::error_code ec{};
+    std::filesystem::create_directories(dir, ec);
+
+    auto gfx_mgr = g_engine->graphics_manager();
+    auto gpu_scene = g_engine->system_manager()->get_system_for_current_scene<gfx::GpuSceneSystem>();
+    uint32_t camera_index = 0;
+    gpu_scene->for_each_camera([&](gfx::Camera& camera) {
+        if (!camera.enabled) { return; }
+        auto index = camera_index++;
+
+        auto& texture = camera.target_texture();
+        if (!texture.has_value()) { return; }
+        auto const& desc = texture.desc();
+        auto filename = fmt::format(
+            "frame{:06}_camera{}.{}", frame, index, is_hdr_format(desc.format) ? "hdr" : "png"
+        );
+        auto data = gfx_mgr->read_back_texture_2d(texture);
+        if (!write_image(dir / filename, desc.format, desc.extent.width, desc.extent.height, data)) {
+            log::warn(
+                "general", "Failed to dump camera {} with format '{}'.", index, magic_enum::enum_name(desc.format)
+            );
+            return;
+        }
+        images.push_back(std::move(filename));
+    });
+    return images;
+}
+
+auto write_headless_report(HeadlessReport& report, std::filesystem::path const& path) -> bool {
+    auto& summary = report.summary;
+    summary = {};
+    if (!report.frames.empty()) {
+        std::vector<double> total_ms{};
+        total_ms.reserve(report.frames.size());
+        for (auto const& frame : report.frames) {
+            total_ms.push_back(frame.total_ms);
+            summary.avg_total_ms += frame.total_ms;
+            summary.avg_update_ms += frame.update_ms;
+            summary.avg_render_ms += frame.render_ms;
+            summary.num_created_pipelines += frame.num_created_pipelines;
+        }
+        auto num_frames = static_cast<double>(report.frames.size());
+        summary.avg_total_ms /= num_frames;
+        summary.avg_update_ms /= num_frames;
+        summary.avg_render_ms /= num_frames;
+        std::sort(total_ms.begin(), total_ms.end());
+        summary.min_total_ms = total_ms.front();
+        summary.max_total_ms = total_ms.back();
+        summary.p50_total_ms = percentile(total_ms, 0.5);
+        summary.p95_total_ms = percentile(total_ms, 0.95);
+    }
+
+    serde::Value value{};
+    serde::to_value(value, report);
+    std::ofstream fout(path);
+    if (!fout) {
+        log::error("general", "Failed to write headless report to '{}'.", path.string());
+        return false;
+    }
+    fout << value.to_json(2);
+    return true;
+}
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <filesystem>
+
+#include <bisemutum/utils/srefl.hpp>
+
+namespace bi {
+
+struct HeadlessOptions final {
+    uint64_t num_frames = 100;
+    // Use wall-clock time when it is 0.
+    double fixed_delta_time = 1.0 / 60.0;
+    std::filesystem::path report_file = "headless_report.json";
+    // Camera targets are not dumped when it is empty.
+    std::filesystem::path dump_images_dir;
+    // Dump camera targets every `dump_interval` frames, 0 to dump only the last frame.
+    uint64_t dump_interval = 0;
+};
+
+struct HeadlessFrameTiming final {
+    uint64_t frame = 0;
+    // Including waiting for the frame in flight and finalizing loaded assets.
+    double new_frame_ms = 0.0;
+    double update_ms = 0.0;
+    // Render graph building, command recording and submission.
+    double render_ms = 0.0;
+    double post_update_ms = 0.0;
+    double total_ms = 0.0;
+    // Graphics and compute pipelines created when passes require them, it should be 0 once they are warmed up.
+    uint64_t num_created_pipelines = 0;
+    std::vector<std::string> images;
+};
+BI_SREFL(
+    type(HeadlessFrameTiming),
+    field(frame),
+    field(new_frame_ms),
+    field(update_ms),
+    field(render_ms),
+    field(post_update_ms),
+    field(total_ms),
+    field(num_created_pipelines),
+    field(images),
+)
+
+struct HeadlessSummary final {
+    double avg_total_ms = 0.0;
+    double min_total_ms = 0.0;
+    double max_total_ms = 0.0;
+    double p50_total_ms = 0.0;
+    double p95_total_ms = 0.0;
+    double avg_update_ms = 0.0;
+    double avg_render_ms = 0.0;
+    uint64_t num_created_pipelines = 0;
+};
+BI_SREFL(
+    type(HeadlessSummary),
+    field(avg_total_ms),
+    field(min_total_ms),
+    field(max_total_ms),
+    field(p50_total_ms),
+    field(p95_total_ms),
+    field(avg_update_ms),
+    field(avg_render_ms),
+    field(num_created_pipelines),
+)
+
+struct HeadlessReport final {
+    std::string project;
+    std::string scene_file;
+    std::string renderer;
+    std::string backend;
+    uint64_t num_frames = 0;
+    double fixed_delta_time = 0.0;
+    HeadlessSummary summary;
+    // Of `FileSystem` lookups during the whole run, including initialization.
+    uint64_t path_cache_hits = 0;
+    uint64_t path_cache_misses = 0;
+    double path_cache_hit_rate = 0.0;
+    std::vector<HeadlessFrameTiming> frames;
+};
+BI_SREFL(
+    type(HeadlessReport),
+    field(project),
+    field(scene_file),
+    field(renderer),
+    field(backend),
+    field(num_frames),
+    field(fixed_delta_time),
+    field(summary),
+    field(path_cache_hits),
+    field(path_cache_misses),
+    field(path_cache_hit_rate),
+    field(frames),
+)
+
+// Write target textures of all enabled cameras of the current scene to `dir`, return the written file names.
+auto dump_camera_images(std::filesystem::path const& dir, uint64_t frame) -> std::vector<std::string>;
+
+// Fill the summary from per-frame timings and write the report as JSON.
+auto write_headless_report(HeadlessReport& report, std::filesystem::path const& path) -> bool;
+
+}
@@ -4,6 +4,8 @@
 
 #include <bisemutum/runtime/transform_system.hpp>
 #include <bisemutum/runtime/prefab_manager.hpp>
+#include <bisemutum/runtime/volume_index_system.hpp>
+#include <bisemutum/runtime/world_partition.hpp>
 
 #include <bisemutum/graphics/gpu_scene_system.hpp>
 
@@ -11,17 +13,26 @@
 #include <bisemutum/scene_basic/static_mesh_render_system.hpp>
 #include <bisemutum/scene_basic/skybox.hpp>
 
+#include <bisemutum/renderer/basic.hpp>
+#include <bisemutum/renderer/ddgi_volume.hpp>
+#include <bisemutum/renderer/post_process_volume.hpp>
+
 namespace bi {
 
 auto register_systems(Ref<rt::SystemManager> mgr) -> void {
     mgr->register_system<rt::TransformSystem>();
     mgr->register_global_system<rt::PrefabManager>();
+    mgr->register_system<rt::WorldPartitionSystem>();
 
     mgr->register_system<gfx::GpuSceneSystem>();
 
     mgr->register_system<CameraSystem>();
     mgr->register_system<StaticMeshRenderSystem>();
     mgr->register_system<SkyboxSystem>();
+
+    mgr->register_system<rt::VolumeIndexSystem<BasicRendererOverrideVolume>>();
+    mgr->register_system<rt::VolumeIndexSystem<DdgiVolumeComponent>>();
+    mgr->register_system<rt::VolumeIndexSystem<PostProcessVolumeComponent>>();
 }
 
 }
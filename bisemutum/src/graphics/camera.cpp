@@ -97,7 +97,7 @@ auto Camera::update_shader_params() -> void {
     if (projection_type == ProjectionType::perspective) {
         uniform_data->camera.matrix_proj = math::perspective_reverse_z(math::radians(yfov), aspect, near_z, far_z);
     } else {
-        auto ortho_height = std::tan(math::radians(yfov * 0.5f));
+        auto ortho_height = ortho_half_height();
         auto ortho_width = ortho_height * aspect;
         uniform_data->camera.matrix_proj = math::ortho_reverse_z(
             -ortho_width, ortho_width, -ortho_height, ortho_height, near_z, far_z
@@ -158,7 +158,7 @@ auto Camera::get_frustum_planes() const -> std::array<float4, 6> {
         planes[5] = float4(hori_rot_mat_right * float4(front, 0.0f));
         planes[5].w = -math::dot(position, float3(planes[5]));
     } else {
-        auto ortho_height = std::tan(math::radians(yfov * 0.5f));
+        auto ortho_height = ortho_half_height();
         auto ortho_width = ortho_height * aspect;
 
         auto pos_dot_up = math::dot(position, up);
@@ -173,6 +173,10 @@ auto Camera::get_frustum_planes() const -> std::array<float4, 6> {
     return planes;
 }
 
+auto Camera::ortho_half_height() const -> float {
+    return std::tan(math::radians(yfov * 0.5f));
+}
+
 auto Camera::add_history_buffer(std::string key, BufferHandle handle) const -> void {
     auto& rg = g_engine->graphics_manager()->render_graph();
     history_buffers_[history_index_].insert({std::move(key), rg.take_buffer(handle)});
@@ -1,5 +1,6 @@
 #include "command_helpers.hpp"
 
+#include <bisemutum/engine/engine.hpp>
 #include <bisemutum/graphics/graphics_manager.hpp>
 #include <bisemutum/graphics/shader_param.hpp>
 #include <bisemutum/runtime/logger.hpp>
@@ -1,10 +1,13 @@
 #pragma once
 
-#include <cstdint>
+#include <bisemutum/math/math.hpp>
 
 namespace bi::gfx {
 
 struct DrawableSbtData final {
+    // Put these first to keep the same layout as HLSL.
+    float4 position_dequantization_offset;
+    float4 position_dequantization_scale;
     uint32_t drawable_index;
     uint32_t position_offset;
     uint32_t normal_offset;
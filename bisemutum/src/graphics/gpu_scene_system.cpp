@@ -86,7 +86,7 @@ struct GpuSceneSystem::Impl final {
             for (auto const& drawable : drawables) {
                 drawables_hash = hash_combine(
                     drawables_hash,
-                    hash(drawable.mesh->mesh_type_name(), drawable.material ? drawable.material->get_shader_identifier() : "")
+                    hash(drawable.mesh->mesh_type_name(), drawable.material ? drawable.material->get_shader_hash() : 0)
                 );
             }
             drawables_hash_frame_count = frame_count;
@@ -124,10 +124,16 @@ struct GpuSceneSystem::Impl final {
         if (auto history_it = history_transforms.find(drawable.handle()); history_it != history_transforms.end()) {
             history_matrix_object_to_world = history_it->second;
         }
+        PositionQuantization position_quantization{};
+        if (auto& mesh_data = drawable.mesh->get_mesh_data(); mesh_data.is_quantized()) {
+            position_quantization = mesh_data.submesh_position_quantization(drawable.submesh_index);
+        }
         return DrawableShaderData{
             .matrix_object_to_world = drawable.transform.matrix(),
             .matrix_world_to_object_transposed = drawable.transform.matrix_transposed_inverse(),
             .history_matrix_object_to_world = history_matrix_object_to_world,
+            .position_dequantization_offset = float4{position_quantization.offset, 0.0f},
+            .position_dequantization_scale = float4{position_quantization.scale, 1.0f},
         };
     }
 
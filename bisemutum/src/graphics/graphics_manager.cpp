@@ -1,7 +1,11 @@
 #include <bisemutum/graphics/graphics_manager.hpp>
 
+#include <algorithm>
+#include <unordered_set>
+
 #include <bisemutum/engine/engine.hpp>
 #include <bisemutum/runtime/logger.hpp>
+#include <bisemutum/runtime/thread_pool.hpp>
 #include <bisemutum/runtime/system_manager.hpp>
 #include <bisemutum/window/window.hpp>
 #include <bisemutum/rhi/device.hpp>
@@ -15,6 +19,7 @@
 #include <bisemutum/containers/slotmap.hpp>
 #include <bisemutum/prelude/math.hpp>
 #include <bisemutum/prelude/misc.hpp>
+#include <bisemutum/utils/crypto.hpp>
 #include <fmt/format.h>
 
 #include "descriptor_allocator.hpp"
@@ -22,6 +27,8 @@
 #include "drawable_stb_data.hpp"
 #include "command_helpers.hpp"
 #include "gpu_scene_data.hpp"
+#include "texture_streamer.hpp"
+#include "pipeline_manifest.hpp"
 
 namespace bi::gfx {
 
@@ -36,9 +43,26 @@ constexpr uint32_t gpu_resource_desc_heap_chunk_size = 16384;
 constexpr uint32_t gpu_sampler_desc_heap_chunk_size = 512;
 
 constexpr uint32_t max_num_mesh_total_vertices = 4 * 1024 * 1024;
+constexpr uint32_t max_num_mesh_total_meshlets = max_num_mesh_total_vertices / 16;
 
 constexpr uint32_t max_material_params_buffer_size = 16 * 1024 * 1024;
 
+// Keys of graphics and compute pipelines and their shaders are saved in the pipeline manifest,
+// so they are hashed by FNV-1a to be the same in all builds.
+auto key_combine(uint64_t key, std::string_view value) -> uint64_t {
+    return crypto::fnv1a_64(value, crypto::fnv1a_64(value.size(), key));
+}
+template <typename T> requires std::is_integral_v<T> || std::is_enum_v<T>
+auto key_combine(uint64_t key, T value) -> uint64_t {
+    return crypto::fnv1a_64(static_cast<uint64_t>(value), key);
+}
+template <typename... Ts>
+auto persistent_key(Ts const&... values) -> uint64_t {
+    auto key = crypto::fnv1a_64_offset_basis;
+    ((key = key_combine(key, values)), ...);
+    return key;
+}
+
 auto separate_samplers_from_bind_groups(
     std::vector<rhi::BindGroupLayout>& bind_groups_layouts,
     uint32_t samplers_set,
@@ -78,6 +102,8 @@ struct GraphicsManager::Impl final {
 
         // It is needed to manually reset renderer since it may add delayed destroys.
         renderer.reset();
+
+        save_pipeline_manifest();
     }
 
     auto initialize(GraphicsSettings const& settings, std::string_view pipeline_cache_file) -> void {
@@ -92,20 +118,24 @@ struct GraphicsManager::Impl final {
 
         shader_compiler.initialize(device.ref());
         command_helpers.initialize(device.ref(), shader_compiler);
+        texture_streamer.initialize(settings.texture_streaming);
 
+        // Headless rendering only renders to camera targets, there is no swapchain to display on.
         auto window = g_engine->window();
-        swapchain = device->create_swapchain(rhi::SwapchainDesc{
-            .queue = graphics_queue.value(),
-            .width = window->frame_size().width,
-            .height = window->frame_size().height,
-            .window_handle = window->platform_handle(),
-        });
-        swapchain_resize_callback = window->register_resize_callback(
-            [this](Window const& window, WindowSize frame_size, WindowSize logic_size) {
-                graphics_queue->wait_idle();
-                swapchain->resize(frame_size.width, frame_size.height);
-            }
-        );
+        if (!window->is_headless()) {
+            swapchain = device->create_swapchain(rhi::SwapchainDesc{
+                .queue = graphics_queue.value(),
+                .width = window->frame_size().width,
+                .height = window->frame_size().height,
+                .window_handle = window->platform_handle(),
+            });
+            swapchain_resize_callback = window->register_resize_callback(
+                [this](Window const& window, WindowSize frame_size, WindowSize logic_size) {
+                    graphics_queue->wait_idle();
+                    swapchain->resize(frame_size.width, frame_size.height);
+                }
+            );
+        }
 
         cpu_resource_descriptor_allocator = Box<CpuDescriptorAllocator>::make(
             device.ref(), rhi::DescriptorHeapType::resource, cpu_resource_desc_heap_size
@@ -253,6 +283,11 @@ struct GraphicsManager::Impl final {
                 rhi::BufferUsage::acceleration_structure_build,
             },
         });
+        // All allocations are multiples of `sizeof(Meshlet)`, so offsets are always aligned to it.
+        mesh_buffer_allocator.meshlets_buffer = BufferSuballocator(rhi::BufferDesc{
+            .size = max_num_mesh_total_meshlets * sizeof(Meshlet),
+            .usages = {rhi::BufferUsage::storage_read},
+        });
     }
     auto initialize_material_resources() -> void {
         material_resources.params_buffers = BufferSuballocator(rhi::BufferDesc{
@@ -361,7 +396,9 @@ struct GraphicsManager::Impl final {
         frame_index = frame_index + 1 == frame_data.size() ? 0 : frame_index + 1;
         auto& fd = curr_frame_data();
 
-        swapchain->acquire_next_texture(fd.acquire_semaphore.ref());
+        if (swapchain) {
+            swapchain->acquire_next_texture(fd.acquire_semaphore.ref());
+        }
         fd.fence->wait();
         fd.graphics_cmd_pool->reset();
         fd.cached_descriptors.clear();
@@ -372,10 +409,12 @@ struct GraphicsManager::Impl final {
             destroy();
         }
         delayed_destroys[curr_frame_index()].clear();
+
+        release_destroyed_meshes();
     }
 
     auto render_frame() -> void {
-        if (!renderer.has_value() || !displayer.has_value()) { return; }
+        if (!renderer.has_value() || (swapchain && !displayer.has_value())) { return; }
 
         auto gpu_scene = g_engine->system_manager()->get_system_for_current_scene<GpuSceneSystem>();
 
@@ -384,6 +423,9 @@ struct GraphicsManager::Impl final {
         set_descriptor_heaps(cmd_encoder);
         curr_cmd_encoder = cmd_encoder.ref();
 
+        // Levels are uploaded in this frame, before textures are bound by renderer.
+        texture_streamer.update();
+
         renderer.prepare_renderer_per_frame_data();
 
         gpu_scene->update_shader_params();
@@ -426,6 +468,12 @@ struct GraphicsManager::Impl final {
             ++camera_index;
         });
 
+        if (!swapchain) {
+            curr_cmd_encoder = nullptr;
+            graphics_queue->submit_command_buffer({cmd_encoder->finish()}, {}, {}, fd.fence.ref());
+            return;
+        }
+
         // Display camera target texture draw and UI
         {
             auto swapchain_rhi_texture = swapchain->current_texture();
@@ -485,6 +533,57 @@ struct GraphicsManager::Impl final {
         graphics_queue->wait_idle();
     }
 
+    auto read_back_texture_2d(Ref<Texture> texture, uint32_t mip_level) -> std::vector<std::byte> {
+        auto const& desc = texture->desc();
+        auto width = std::max(desc.extent.width >> mip_level, 1u);
+        auto height = std::max(desc.extent.height >> mip_level, 1u);
+        auto texel_size = rhi::format_texel_size(desc.format);
+        auto row_size = width * texel_size;
+        // Some backends require 256 bytes aligned row pitch for texture copy.
+        auto aligned_row_size = aligned_size<uint32_t>(row_size, 256);
+        if (aligned_row_size % texel_size != 0) {
+            aligned_row_size = row_size;
+        }
+
+        Buffer readback_buffer(rhi::BufferDesc{
+            .size = static_cast<uint64_t>(aligned_row_size) * height,
+            .memory_property = rhi::BufferMemoryProperty::gpu_to_cpu,
+        }, false);
+        execute_immediately([&](Ref<rhi::CommandEncoder> cmd_encoder) {
+            cmd_encoder->resource_barriers({}, {
+                rhi::TextureBarrier{
+                    .texture = texture->rhi_texture(),
+                    .src_access_type = rhi::ResourceAccessType::sampled_texture_read,
+                    .dst_access_type = rhi::ResourceAccessType::transfer_read,
+                },
+            });
+            cmd_encoder->copy_texture_to_buffer(
+                texture->rhi_texture(), readback_buffer.rhi_buffer(),
+                rhi::BufferTextureCopyDesc{
+                    .buffer_pixels_per_row = aligned_row_size / texel_size,
+                    .buffer_rows_per_texture = height,
+                    .texture_extent = {width, height, 1},
+                    .texture_level = mip_level,
+                }
+            );
+            cmd_encoder->resource_barriers({}, {
+                rhi::TextureBarrier{
+                    .texture = texture->rhi_texture(),
+                    .src_access_type = rhi::ResourceAccessType::transfer_read,
+                    .dst_access_type = rhi::ResourceAccessType::sampled_texture_read,
+                },
+            });
+        });
+
+        std::vector<std::byte> data(static_cast<size_t>(row_size) * height);
+        auto mapped = readback_buffer.rhi_buffer()->typed_map<std::byte>();
+        for (uint32_t y = 0; y < height; y++) {
+            std::memcpy(data.data() + y * row_size, mapped + static_cast<size_t>(y) * aligned_row_size, row_size);
+        }
+        readback_buffer.rhi_buffer()->unmap();
+        return data;
+    }
+
     auto set_descriptor_heaps(Box<rhi::CommandEncoder>& cmd_encoder) -> void {
         cmd_encoder->set_descriptor_heaps({
             gpu_resource_descriptor_allocator->heap(),
@@ -585,29 +684,91 @@ struct GraphicsManager::Impl final {
             );
         }
     };
+    // Meshes are destroyed e.g. when assets are reloaded. Their resources may be used by commands in flight,
+    // so they are released later.
+    auto release_destroyed_meshes() -> void {
+        auto destroyed_ids = MeshData::take_destroyed_ids();
+        if (destroyed_ids.empty()) { return; }
+        for (auto id : destroyed_ids) {
+            auto it = meshes_buffers.find(id);
+            if (it == meshes_buffers.end()) { continue; }
+            add_delayed_destroy([mesh_buffers = it->second]() {
+                auto free = [](SuballocatedBuffer const& buffer) {
+                    if (buffer.allocator()) { buffer.allocator()->free(buffer); }
+                };
+                free(mesh_buffers.positions_buffer);
+                free(mesh_buffers.normals_buffer);
+                free(mesh_buffers.tangents_buffer);
+                free(mesh_buffers.colors_buffer);
+                free(mesh_buffers.texcoords_buffer);
+                free(mesh_buffers.texcoords2_buffer);
+                free(mesh_buffers.indices_buffer);
+                free(mesh_buffers.meshlets_buffer);
+            });
+            meshes_buffers.erase(it);
+        }
+        if (meshes_blas.empty()) { return; }
+        std::unordered_set<uint64_t> destroyed_ids_set{destroyed_ids.begin(), destroyed_ids.end()};
+        for (auto it = meshes_blas.begin(); it != meshes_blas.end();) {
+            if (destroyed_ids_set.contains(it->first.first)) {
+                add_delayed_destroy([blas = std::move(it->second)]() {});
+                it = meshes_blas.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
     auto update_mesh_geometry_buffers(CRef<MeshData> mesh) -> void {
-        auto& mesh_buffers = meshes_buffers.try_emplace(mesh->id_).first->second;
+        auto& mesh_buffers = meshes_buffers.try_emplace(mesh->id_.value).first->second;
         if (mesh_buffers.geometry_version < mesh->geometry_version_) {
-            update_mesh_buffer(mesh_buffer_allocator.positions_buffer, mesh_buffers.positions_buffer, mesh->positions_);
+            if (mesh->is_quantized()) {
+                update_mesh_buffer(
+                    mesh_buffer_allocator.positions_buffer, mesh_buffers.positions_buffer, mesh->quantized_positions()
+                );
+            } else {
+                update_mesh_buffer(mesh_buffer_allocator.positions_buffer, mesh_buffers.positions_buffer, mesh->positions_);
+            }
 
             update_mesh_buffer(
                 mesh_buffer_allocator.indices_buffer, mesh_buffers.indices_buffer, mesh->indices_,
                 rhi::ResourceAccessType::index_buffer_read
             );
+            update_mesh_buffer(
+                mesh_buffer_allocator.meshlets_buffer, mesh_buffers.meshlets_buffer, mesh->meshlets_,
+                rhi::ResourceAccessType::storage_resource_read
+            );
 
-            mesh_buffers.geometry_version = mesh->buffer_version_;
+            mesh_buffers.geometry_version = mesh->geometry_version_;
         }
     }
     auto update_mesh_buffers(CRef<MeshData> mesh) -> void {
         update_mesh_geometry_buffers(mesh);
 
-        auto& mesh_buffers = meshes_buffers.try_emplace(mesh->id_).first->second;
+        auto& mesh_buffers = meshes_buffers.try_emplace(mesh->id_.value).first->second;
         if (mesh_buffers.version < mesh->buffer_version_) {
-            update_mesh_buffer(mesh_buffer_allocator.normals_buffer, mesh_buffers.normals_buffer, mesh->normals_);
-            update_mesh_buffer(mesh_buffer_allocator.tangents_buffer, mesh_buffers.tangents_buffer, mesh->tangents_);
+            if (mesh->is_quantized()) {
+                update_mesh_buffer(
+                    mesh_buffer_allocator.normals_buffer, mesh_buffers.normals_buffer, mesh->quantized_normals()
+                );
+                update_mesh_buffer(
+                    mesh_buffer_allocator.tangents_buffer, mesh_buffers.tangents_buffer, mesh->quantized_tangents()
+                );
+                update_mesh_buffer(
+                    mesh_buffer_allocator.texcoords_buffer, mesh_buffers.texcoords_buffer, mesh->quantized_texcoords()
+                );
+                update_mesh_buffer(
+                    mesh_buffer_allocator.texcoords2_buffer, mesh_buffers.texcoords2_buffer, mesh->quantized_texcoords2()
+                );
+            } else {
+                update_mesh_buffer(mesh_buffer_allocator.normals_buffer, mesh_buffers.normals_buffer, mesh->normals_);
+                update_mesh_buffer(mesh_buffer_allocator.tangents_buffer, mesh_buffers.tangents_buffer, mesh->tangents_);
+                update_mesh_buffer(mesh_buffer_allocator.texcoords_buffer, mesh_buffers.texcoords_buffer, mesh->texcoords_);
+                update_mesh_buffer(
+                    mesh_buffer_allocator.texcoords2_buffer, mesh_buffers.texcoords2_buffer, mesh->texcoords2_
+                );
+            }
             update_mesh_buffer(mesh_buffer_allocator.colors_buffer, mesh_buffers.colors_buffer, mesh->colors_);
-            update_mesh_buffer(mesh_buffer_allocator.texcoords_buffer, mesh_buffers.texcoords_buffer, mesh->texcoords_);
-            update_mesh_buffer(mesh_buffer_allocator.texcoords2_buffer, mesh_buffers.texcoords2_buffer, mesh->texcoords2_);
 
             mesh_buffers.version = mesh->buffer_version_;
         }
@@ -619,13 +780,27 @@ struct GraphicsManager::Impl final {
         auto& mesh_data = drawable->mesh->get_mesh_data();
         update_mesh_geometry_buffers(mesh_data);
 
-        auto& mesh_blas = meshes_blas.try_emplace(std::make_pair(mesh_data.id_, drawable->submesh_index)).first->second;
+        auto& mesh_blas = meshes_blas.try_emplace(std::make_pair(mesh_data.id_.value, drawable->submesh_index)).first->second;
         auto submesh_version = mesh_data.get_submesh_version(drawable->submesh_index);
         if (mesh_blas.submesh_version < submesh_version) {
             mesh_blas.submesh_version = submesh_version;
-            auto& mesh_buffers = meshes_buffers.at(mesh_data.id_);
+            auto& mesh_buffers = meshes_buffers.at(mesh_data.id_.value);
 
             auto& submesh_desc = drawable->submesh_desc();
+            auto vertex_buffer = mesh_buffers.positions_buffer.allocator()->base_buffer().rhi_buffer();
+            auto vertex_buffer_offset = mesh_buffers.positions_buffer.offset();
+            if (mesh_data.is_quantized()) {
+                // Build from full precision positions in a temporary buffer.
+                // Its destruction is delayed, so it is still alive when the BLAS is built.
+                Buffer positions_buffer{rhi::BufferDesc{
+                    .size = mesh_data.positions_.size() * sizeof(float3),
+                    .usages = rhi::BufferUsage::acceleration_structure_build,
+                    .memory_property = rhi::BufferMemoryProperty::cpu_to_gpu,
+                }};
+                positions_buffer.set_data(mesh_data.positions_.data(), mesh_data.positions_.size());
+                vertex_buffer = positions_buffer.rhi_buffer();
+                vertex_buffer_offset = 0;
+            }
             rhi::AccelerationStructureGeometryDesc geo_desc{
                 .geometry = rhi::AccelerationStructureTriangleDesc{
                     .vertex_format = rhi::ResourceFormat::rgb32_sfloat,
@@ -633,9 +808,9 @@ struct GraphicsManager::Impl final {
                     .num_vertices = mesh_data.num_vertices(),
                     .num_triangles = std::min(submesh_desc.num_indices, mesh_data.num_indices()) / 3,
                     .vertex_stride = sizeof(float3),
-                    .vertex_buffer = mesh_buffers.positions_buffer.allocator()->base_buffer().rhi_buffer(),
+                    .vertex_buffer = vertex_buffer,
                     .index_buffer = mesh_buffers.indices_buffer.allocator()->base_buffer().rhi_buffer(),
-                    .vertex_buffer_offset = mesh_buffers.positions_buffer.offset() + submesh_desc.base_vertex * sizeof(float3),
+                    .vertex_buffer_offset = vertex_buffer_offset + submesh_desc.base_vertex * sizeof(float3),
                     .index_buffer_offset = mesh_buffers.indices_buffer.offset() + submesh_desc.index_offset * sizeof(uint32_t),
                 },
             };
@@ -677,7 +852,7 @@ struct GraphicsManager::Impl final {
     auto bind_mesh_buffers(
         Ref<rhi::GraphicsCommandEncoder> cmd_encoder, CRef<MeshData> mesh
     ) -> void {
-        auto& mesh_buffers = meshes_buffers.at(mesh->id_);
+        auto& mesh_buffers = meshes_buffers.at(mesh->id_.value);
 
         std::vector<Ref<rhi::Buffer>> vertex_buffers;
         std::vector<uint64_t> vertex_buffers_offset;
@@ -717,12 +892,29 @@ struct GraphicsManager::Impl final {
             );
         }
     }
+    auto meshlets_buffer(CRef<MeshData> mesh) -> std::pair<Ref<Buffer>, uint32_t> {
+        auto& mesh_buffers = meshes_buffers.at(mesh->id_.value);
+        return {
+            mesh_buffer_allocator.meshlets_buffer.base_buffer(),
+            static_cast<uint32_t>(mesh_buffers.meshlets_buffer.offset() / sizeof(Meshlet)),
+        };
+    }
+
     auto draw_drawable(
-        Ref<rhi::GraphicsCommandEncoder> cmd_encoder, Ref<Drawable> drawable
+        Ref<rhi::GraphicsCommandEncoder> cmd_encoder, Ref<Drawable> drawable, CSpan<DrawIndexRange> index_ranges
     ) -> void {
         auto& mesh_data = drawable->mesh->get_mesh_data();
         auto& submesh = drawable->submesh_desc();
 
+        if (!index_ranges.empty() && !mesh_data.indices_.empty()) {
+            for (auto const& range : index_ranges) {
+                cmd_encoder->draw_indexed(
+                    range.num_indices, 1, submesh.index_offset + range.index_offset, submesh.base_vertex, 0
+                );
+            }
+            return;
+        }
+
         auto num_indices = submesh.num_indices;
         if (submesh.num_indices == ~0u) {
             num_indices = mesh_data.indices_.size() - submesh.index_offset;
@@ -746,24 +938,28 @@ struct GraphicsManager::Impl final {
             shader_env.set_replace_arg("MATERIAL_FUNCTION", "");
         }
         fs->modify_compiler_environment(shader_env);
-        auto shader_env_id = shader_env.get_config_identifier();
+        auto shader_env_hash = shader_env.config_hash();
 
         std::vector<rhi::VertexInputBufferDesc> vertex_input_desc{};
-        std::string vertex_attributes_id{};
+        // Formats of attributes only depend on which attributes are present and whether they are quantized.
+        uint64_t vertex_layout_hash = 0;
         {
             BitFlags<VertexAttributesType> input_vertex_attributes{};
-            vertex_attributes_id += "VA-";
             auto& mesh_data = drawable->mesh->get_mesh_data();
-            auto add_vertex_attribute = [&vertex_input_desc, &vertex_attributes_id, &input_vertex_attributes](
+            auto add_vertex_attribute = [&vertex_input_desc, &input_vertex_attributes, &mesh_data](
                 auto const& attribute_data,
                 rhi::VertexSemantics semantics,
                 VertexAttributesType attrib_type,
-                std::string_view attribute_id
+                rhi::ResourceFormat quantized_format
             ) {
                 if (!attribute_data.empty()) {
                     using attribute_type = typename std::remove_reference_t<decltype(attribute_data)>::value_type;
                     rhi::ResourceFormat format;
-                    if constexpr (std::is_same_v<attribute_type, float2>) {
+                    uint32_t stride = sizeof(attribute_type);
+                    if (mesh_data.is_quantized() && quantized_format != rhi::ResourceFormat::undefined) {
+                        format = quantized_format;
+                        stride = rhi::format_texel_size(quantized_format);
+                    } else if constexpr (std::is_same_v<attribute_type, float2>) {
                         format = rhi::ResourceFormat::rg32_sfloat;
                     } else if constexpr (std::is_same_v<attribute_type, float3>) {
                         format = rhi::ResourceFormat::rgb32_sfloat;
@@ -773,7 +969,7 @@ struct GraphicsManager::Impl final {
                         static_assert(traits::AlwaysFalse<attribute_type>, "Invalid vertex attribute type");
                     }
                     vertex_input_desc.push_back(rhi::VertexInputBufferDesc{
-                        .stride = sizeof(attribute_type),
+                        .stride = stride,
                         .attributes = {
                             rhi::VertexInputAttribute{
                                 .semantics = semantics,
@@ -781,16 +977,37 @@ struct GraphicsManager::Impl final {
                             }
                         },
                     });
-                    vertex_attributes_id += attribute_id;
                     input_vertex_attributes.set(attrib_type);
                 }
             };
-            add_vertex_attribute(mesh_data.positions_, rhi::VertexSemantics::position, VertexAttributesType::position, "P");
-            add_vertex_attribute(mesh_data.normals_, rhi::VertexSemantics::normal, VertexAttributesType::normal, "N");
-            add_vertex_attribute(mesh_data.tangents_, rhi::VertexSemantics::tangent, VertexAttributesType::tangent, "T");
-            add_vertex_attribute(mesh_data.colors_, rhi::VertexSemantics::color, VertexAttributesType::color, "C");
-            add_vertex_attribute(mesh_data.texcoords_, rhi::VertexSemantics::texcoord0, VertexAttributesType::texcoord, "U1");
-            add_vertex_attribute(mesh_data.texcoords2_, rhi::VertexSemantics::texcoord0, VertexAttributesType::texcoord2, "U2");
+            add_vertex_attribute(
+                mesh_data.positions_, rhi::VertexSemantics::position, VertexAttributesType::position,
+                rhi::ResourceFormat::rgba16_unorm
+            );
+            add_vertex_attribute(
+                mesh_data.normals_, rhi::VertexSemantics::normal, VertexAttributesType::normal,
+                rhi::ResourceFormat::rg16_snorm
+            );
+            add_vertex_attribute(
+                mesh_data.tangents_, rhi::VertexSemantics::tangent, VertexAttributesType::tangent,
+                rhi::ResourceFormat::rgba16_snorm
+            );
+            add_vertex_attribute(
+                mesh_data.colors_, rhi::VertexSemantics::color, VertexAttributesType::color,
+                rhi::ResourceFormat::undefined
+            );
+            add_vertex_attribute(
+                mesh_data.texcoords_, rhi::VertexSemantics::texcoord0, VertexAttributesType::texcoord,
+                rhi::ResourceFormat::rg16_sfloat
+            );
+            add_vertex_attribute(
+                mesh_data.texcoords2_, rhi::VertexSemantics::texcoord0, VertexAttributesType::texcoord2,
+                rhi::ResourceFormat::rg16_sfloat
+            );
+            if (mesh_data.is_quantized()) {
+                input_vertex_attributes.set(VertexAttributesType::quantized);
+            }
+            vertex_layout_hash = persistent_key(input_vertex_attributes.raw_value());
 
             shader_env.set_define(
                 "VERTEX_ATTRIBUTES_IN",
@@ -798,42 +1015,31 @@ struct GraphicsManager::Impl final {
             );
         }
 
-        auto mesh_shaders_id = fmt::format(
-            "MESH {} {} {} ",
-            drawable->mesh->mesh_type_name(),
-            vertex_attributes_id,
-            shader_env_id
-        );
-        auto fs_id = fmt::format(
-            "FS '{}' {} {} {}",
-            fs->source.path,
-            fs->source.entry,
-            drawable->material ? drawable->material->get_shader_identifier() : "X",
-            shader_env_id
-        );
-        std::string format_id = "FORMAT";
+        // Material functions and blend modes are part of the environment.
+        auto mesh_shaders_key = persistent_key(drawable->mesh->mesh_type_name(), vertex_layout_hash, shader_env_hash);
+        auto fs_key = persistent_key(fs->source.path, fs->source.entry, shader_env_hash);
+        auto formats_hash = persistent_key(graphics_context->depth_stencil_format);
         for (auto format : graphics_context->color_targets_format) {
-            format_id = fmt::format("{}-{:x}", format_id, static_cast<uint32_t>(format));
-        }
-        if (auto format = graphics_context->depth_stencil_format; format != rhi::ResourceFormat::undefined) {
-            format_id = fmt::format("{}={:x}", format_id, static_cast<uint32_t>(format));
-        }
-        auto fs_pipeline_id = fmt::format(
-            "BLEND {} DEPTH {} {} {} STENCIL {} {} {} {}",
-            fs->override_blend_mode ? magic_enum::enum_name(fs->override_blend_mode.value()) : "X",
-            fs->depth_write ? "1" : "0",
-            fs->depth_test ? "1" : "0",
-            magic_enum::enum_name(fs->depth_compare_op),
-            fs->stencil_test ? "1" : "0",
-            std::to_string(fs->stencil_compare_mask),
-            std::to_string(fs->stencil_write_mask),
-            std::to_string(fs->stencil_reference)
+            formats_hash = key_combine(formats_hash, format);
+        }
+        auto render_state_hash = persistent_key(
+            fs->override_blend_mode ? static_cast<int>(fs->override_blend_mode.value()) : -1,
+            fs->depth_write,
+            fs->depth_test,
+            fs->depth_compare_op,
+            fs->stencil_test,
+            fs->stencil_compare_mask,
+            fs->stencil_write_mask,
+            fs->stencil_reference
         );
-        auto pipeline_id = fmt::format("{} {} {} {}", mesh_shaders_id, fs_id, format_id, fs_pipeline_id);
-        auto pipeline_it = graphics_pipelines.find(pipeline_id);
+        auto pipeline_key = persistent_key(mesh_shaders_key, fs_key, formats_hash, render_state_hash);
+        auto pipeline_it = graphics_pipelines.find(pipeline_key);
         if (pipeline_it != graphics_pipelines.end()) {
             return pipeline_it->second.ref();
         }
+        if (failed_pipeline_keys.contains(pipeline_key)) {
+            return fallback_graphics_pipelines.at(pipeline_key).ref();
+        }
 
         auto& mesh_shader_params = drawable->mesh->shader_params_metadata(drawable->submesh_index);
         auto& camera_shader_params = camera->shader_params_metadata();
@@ -858,63 +1064,55 @@ struct GraphicsManager::Impl final {
                 : ""
         );
 
-        auto vs_id = mesh_shaders_id + "vs";
-        auto vs_it = cached_shaders.find(vs_id);
+        auto vs_key = persistent_key(mesh_shaders_key, rhi::ShaderStage::vertex);
         auto vs_source = drawable->mesh->source(rhi::ShaderStage::vertex);
-        if (vs_it == cached_shaders.end()) {
-            auto vs = shader_compiler.compile_shader(
-                vs_source.path,
-                vs_source.entry,
-                rhi::ShaderStage::vertex,
-                shader_env
-            );
-            BI_ASSERT_MSG(vs.has_value(), vs.error());
-            vs_it = cached_shaders.insert({std::move(vs_id), vs.value()}).first;
+        auto vs = get_shader(vs_key, vs_source.path, vs_source.entry, rhi::ShaderStage::vertex, shader_env);
+        if (!vs) {
+            return use_fallback_pipeline(fallback_graphics_pipelines, pipeline_key, vs.error()).ref();
         }
-        rhi::PipelineShader pipeline_vs{vs_it->second, vs_source.entry};
+        rhi::PipelineShader pipeline_vs{vs.value(), vs_source.entry};
+        std::vector<PipelineManifestShader> manifest_shaders{
+            {vs_key, vs_source.path, vs_source.entry, rhi::ShaderStage::vertex},
+        };
 
         std::list<std::string> owned_entries;
-        auto compile_mesh_opt_shader = [this, &mesh_shaders_id, &shader_env, &drawable, &owned_entries](
+        std::string shader_error;
+        auto compile_mesh_opt_shader = [
+            this, mesh_shaders_key, &shader_env, &drawable, &owned_entries, &manifest_shaders, &shader_error
+        ](
             rhi::ShaderStage stage,
-            char const* id_suffix,
             Option<rhi::PipelineShader>& pipeline_shader
         ) {
             if (auto entry = drawable->mesh->source(stage).entry; !entry.empty()) {
-                auto id = mesh_shaders_id + id_suffix;
-                auto it = cached_shaders.find(id);
-                if (it == cached_shaders.end()) {
-                    auto shader = shader_compiler.compile_shader(
-                        drawable->mesh->source(stage).path,
-                        entry,
-                        stage,
-                        shader_env
-                    );
-                    BI_ASSERT_MSG(shader.has_value(), shader.error());
-                    it = cached_shaders.insert({std::move(id), shader.value()}).first;
+                auto key = persistent_key(mesh_shaders_key, stage);
+                auto shader = get_shader(key, drawable->mesh->source(stage).path, entry, stage, shader_env);
+                if (!shader) {
+                    shader_error = shader.error();
+                    return false;
                 }
+                manifest_shaders.push_back({key, drawable->mesh->source(stage).path, entry, stage});
                 owned_entries.push_back(entry);
-                pipeline_shader = rhi::PipelineShader{it->second, owned_entries.back()};
+                pipeline_shader = rhi::PipelineShader{shader.value(), owned_entries.back()};
             }
+            return true;
         };
         Option<rhi::PipelineShader> pipeline_tcs;
-        compile_mesh_opt_shader(rhi::ShaderStage::tessellation_control, "tcs", pipeline_tcs);
         Option<rhi::PipelineShader> pipeline_tes;
-        compile_mesh_opt_shader(rhi::ShaderStage::tessellation_evaluation, "tes", pipeline_tes);
         Option<rhi::PipelineShader> pipeline_gs;
-        compile_mesh_opt_shader(rhi::ShaderStage::geometry, "gs", pipeline_gs);
-
-        auto fs_it = cached_shaders.find(fs_id);
-        if (fs_it == cached_shaders.end()) {
-            auto shader = shader_compiler.compile_shader(
-                fs->source.path,
-                fs->source.entry,
-                rhi::ShaderStage::fragment,
-                shader_env
-            );
-            BI_ASSERT_MSG(shader.has_value(), shader.error());
-            fs_it = cached_shaders.insert({std::move(fs_id), shader.value()}).first;
+        if (
+            !compile_mesh_opt_shader(rhi::ShaderStage::tessellation_control, pipeline_tcs)
+            || !compile_mesh_opt_shader(rhi::ShaderStage::tessellation_evaluation, pipeline_tes)
+            || !compile_mesh_opt_shader(rhi::ShaderStage::geometry, pipeline_gs)
+        ) {
+            return use_fallback_pipeline(fallback_graphics_pipelines, pipeline_key, shader_error).ref();
+        }
+
+        auto fs_shader = get_shader(fs_key, fs->source.path, fs->source.entry, rhi::ShaderStage::fragment, shader_env);
+        if (!fs_shader) {
+            return use_fallback_pipeline(fallback_graphics_pipelines, pipeline_key, fs_shader.error()).ref();
         }
-        rhi::PipelineShader pipeline_fs{fs_it->second, fs->source.entry};
+        rhi::PipelineShader pipeline_fs{fs_shader.value(), fs->source.entry};
+        manifest_shaders.push_back({fs_key, fs->source.path, fs->source.entry, rhi::ShaderStage::fragment});
 
         rhi::GraphicsPipelineDesc pipeline_desc{
             .vertex_input_buffers = std::move(vertex_input_desc),
@@ -1021,28 +1219,42 @@ struct GraphicsManager::Impl final {
             );
         }
 
-        pipeline_it = graphics_pipelines.insert(
-            {std::move(pipeline_id), device->create_graphics_pipeline(pipeline_desc)}
-        ).first;
+        name_pipeline_key(pipeline_key, [&]() {
+            return fmt::format(
+                "MESH {} '{}' FS '{}' {}",
+                drawable->mesh->mesh_type_name(), vs_source.path, fs->source.path, fs->source.entry
+            );
+        });
+        record_pipeline(pipeline_key, [&]() {
+            return PipelineManifestRecord{
+                .type = PipelineManifestRecordType::graphics,
+                .environment = shader_env,
+                .shaders = std::move(manifest_shaders),
+                .bind_groups_layout = pipeline_desc.bind_groups_layout,
+                .vertex_input_buffers = pipeline_desc.vertex_input_buffers,
+                .tessellation_state = pipeline_desc.tessellation_state,
+                .rasterization_state = pipeline_desc.rasterization_state,
+                .depth_stencil_state = pipeline_desc.depth_stencil_state,
+                .color_target_state = pipeline_desc.color_target_state,
+            };
+        });
+        pipeline_it = graphics_pipelines.insert({pipeline_key, device->create_graphics_pipeline(pipeline_desc)}).first;
+        release_fallback_pipeline(fallback_graphics_pipelines, pipeline_key);
         return pipeline_it->second.ref();
     }
 
     auto compile_pipeline_compute(CPtr<Camera> camera, CRef<ComputeShader> cs) -> Ref<rhi::ComputePipeline> {
         ShaderCompilationEnvironment shader_env;
         cs->modify_compiler_environment(shader_env);
-        auto shader_env_id = shader_env.get_config_identifier();
-
-        auto pipeline_id = fmt::format(
-            "CS '{}' {} {} CAM {}",
-            cs->source.path,
-            cs->source.entry,
-            shader_env_id,
-            camera ? 1 : 0
-        );
-        auto pipeline_it = compute_pipelines.find(pipeline_id);
+
+        auto pipeline_key = persistent_key(cs->source.path, cs->source.entry, shader_env.config_hash(), camera.has_value());
+        auto pipeline_it = compute_pipelines.find(pipeline_key);
         if (pipeline_it != compute_pipelines.end()) {
             return pipeline_it->second.ref();
         }
+        if (failed_pipeline_keys.contains(pipeline_key)) {
+            return fallback_compute_pipelines.at(pipeline_key).ref();
+        }
 
         shader_env.set_replace_arg(
             "COMPUTE_SHADER_PARAMS",
@@ -1055,21 +1267,14 @@ struct GraphicsManager::Impl final {
                 : "#define NO_CAMERA_SHADER_PARAMS"
         );
 
-        auto cs_id = pipeline_id + "cs";
-        auto cs_it = cached_shaders.find(cs_id);
-        if (cs_it == cached_shaders.end()) {
-            auto shader = shader_compiler.compile_shader(
-                cs->source.path,
-                cs->source.entry,
-                rhi::ShaderStage::compute,
-                shader_env
-            );
-            BI_ASSERT_MSG(shader.has_value(), shader.error());
-            cs_it = cached_shaders.insert({std::move(cs_id), shader.value()}).first;
+        auto cs_key = persistent_key(pipeline_key, rhi::ShaderStage::compute);
+        auto cs_shader = get_shader(cs_key, cs->source.path, cs->source.entry, rhi::ShaderStage::compute, shader_env);
+        if (!cs_shader) {
+            return use_fallback_pipeline(fallback_compute_pipelines, pipeline_key, cs_shader.error()).ref();
         }
 
         rhi::ComputePipelineDesc pipeline_desc{
-            .compute = {cs_it->second, cs->source.entry},
+            .compute = {cs_shader.value(), cs->source.entry},
         };
         pipeline_desc.bind_groups_layout.push_back(
             cs->shader_params_metadata.bind_group_layout(compute_set_normal, rhi::ShaderStage::compute)
@@ -1089,9 +1294,19 @@ struct GraphicsManager::Impl final {
             );
         }
 
-        pipeline_it = compute_pipelines.insert(
-            {std::move(pipeline_id), device->create_compute_pipeline(pipeline_desc)}
-        ).first;
+        name_pipeline_key(pipeline_key, [&]() {
+            return fmt::format("CS '{}' {}", cs->source.path, cs->source.entry);
+        });
+        record_pipeline(pipeline_key, [&]() {
+            return PipelineManifestRecord{
+                .type = PipelineManifestRecordType::compute,
+                .environment = shader_env,
+                .shaders = {{cs_key, cs->source.path, cs->source.entry, rhi::ShaderStage::compute}},
+                .bind_groups_layout = pipeline_desc.bind_groups_layout,
+            };
+        });
+        pipeline_it = compute_pipelines.insert({pipeline_key, device->create_compute_pipeline(pipeline_desc)}).first;
+        release_fallback_pipeline(fallback_compute_pipelines, pipeline_key);
         return pipeline_it->second.ref();
     }
 
@@ -1105,17 +1320,34 @@ struct GraphicsManager::Impl final {
 
         ShaderCompilationEnvironment shader_env;
         shaders->modify_compiler_environment(shader_env);
-        auto shader_env_id = shader_env.get_config_identifier();
-
-        auto raygen_id = fmt::format("RG '{}' {}", shaders->raygen_source.path, shaders->raygen_source.entry);
-        auto closest_hit_id = fmt::format("CH '{}' {}", shaders->closest_hit_source.path, shaders->closest_hit_source.entry);
-        auto any_hit_id = fmt::format("AH '{}' {}", shaders->any_hit_source.path, shaders->any_hit_source.entry);
-        auto miss_id = fmt::format("MS '{}' {}", shaders->miss_source.path, shaders->miss_source.entry);
-        auto pipeline_id = fmt::format(
-            "{} {} {} {}",
-            raygen_id, closest_hit_id, any_hit_id, miss_id
+        auto shader_env_hash = shader_env.config_hash();
+
+        auto raygen_key = hash(
+            shaders->raygen_source.path, shaders->raygen_source.entry, rhi::ShaderStage::ray_generation, shader_env_hash
+        );
+        auto closest_hit_key = hash(
+            shaders->closest_hit_source.path, shaders->closest_hit_source.entry, rhi::ShaderStage::ray_closest_hit
         );
-        auto [pipeline_it, need_to_create] = scene_raytracing_pipelines.try_emplace(pipeline_id);
+        auto any_hit_key = hash(shaders->any_hit_source.path, shaders->any_hit_source.entry, rhi::ShaderStage::ray_any_hit);
+        auto miss_key = hash(
+            shaders->miss_source.path, shaders->miss_source.entry, rhi::ShaderStage::ray_miss, shader_env_hash
+        );
+        auto pipeline_key = hash(raygen_key, closest_hit_key, any_hit_key, miss_key);
+        if (failed_pipeline_keys.contains(pipeline_key)) {
+            auto& fallbacks = fallback_raytracing_pipelines[gpu_scene];
+            auto it = fallbacks.find(pipeline_key);
+            if (it != fallbacks.end() && it->second.drawables_hash == drawables_hash) {
+                return {it->second.pipeline.ref(), it->second.sbt};
+            }
+        }
+        auto [pipeline_it, need_to_create] = scene_raytracing_pipelines.try_emplace(pipeline_key);
+        // Fallback pipelines can't be used if drawables are changed, since hit groups are different.
+        auto use_fallback = [&](std::string const& error) -> std::pair<Ref<rhi::RaytracingPipeline>, rhi::RaytracingShaderBindingTableBuffers> {
+            if (need_to_create) { scene_raytracing_pipelines.erase(pipeline_it); }
+            auto& fallback = use_fallback_pipeline(fallback_raytracing_pipelines[gpu_scene], pipeline_key, error);
+            BI_ASSERT_MSG(fallback.drawables_hash == drawables_hash, error);
+            return {fallback.pipeline.ref(), fallback.sbt};
+        };
         if (need_to_create || pipeline_it->second.drawables_hash != drawables_hash) {
             shader_env.set_replace_arg(
                 "RAYTRACING_SHADER_PARAMS",
@@ -1129,41 +1361,30 @@ struct GraphicsManager::Impl final {
                 "RAYTRACING_SCENE_SHADER_PARAMS",
                 gpu_scene->shader_params_metadata().generated_shader_definition(raytracing_set_scene, raytracing_set_samplers)
             );
-            auto raygen_it = cached_shaders.find(raygen_id);
-            if (raygen_it == cached_shaders.end()) {
-                auto shader = shader_compiler.compile_shader(
-                    shaders->raygen_source.path,
-                    shaders->raygen_source.entry,
-                    rhi::ShaderStage::ray_generation,
-                    shader_env
-                );
-                BI_ASSERT_MSG(shader.has_value(), shader.error());
-                raygen_it = cached_shaders.insert({std::move(raygen_id), shader.value()}).first;
-            }
+            auto raygen_shader = get_shader(
+                raygen_key, shaders->raygen_source.path, shaders->raygen_source.entry, rhi::ShaderStage::ray_generation,
+                shader_env
+            );
+            if (!raygen_shader) { return use_fallback(raygen_shader.error()); }
             rhi::RaytracingPipelineDesc pipeline_desc{
                 .shaders = {
                     .raygen = {
-                        .shader = {raygen_it->second, shaders->raygen_source.entry},
+                        .shader = {raygen_shader.value(), shaders->raygen_source.entry},
                     },
                 },
             };
             if (!shaders->miss_source.path.empty()) {
-                auto miss_it = cached_shaders.find(miss_id);
-                if (miss_it == cached_shaders.end()) {
-                    auto shader = shader_compiler.compile_shader(
-                        shaders->miss_source.path,
-                        shaders->miss_source.entry,
-                        rhi::ShaderStage::ray_miss,
-                        shader_env
-                    );
-                    BI_ASSERT_MSG(shader.has_value(), shader.error());
-                    miss_it = cached_shaders.insert({std::move(miss_id), shader.value()}).first;
-                }
+                auto miss_shader = get_shader(
+                    miss_key, shaders->miss_source.path, shaders->miss_source.entry, rhi::ShaderStage::ray_miss,
+                    shader_env
+                );
+                if (!miss_shader) { return use_fallback(miss_shader.error()); }
                 pipeline_desc.shaders.miss = {{
-                    .shader = {miss_it->second, shaders->miss_source.entry},
+                    .shader = {miss_shader.value(), shaders->miss_source.entry},
                 }};
             }
             std::vector<std::string> owned_shader_entries;
+            std::string shader_error;
             const auto num_drawables = gpu_scene->num_drawables();
             const auto has_hit_groups = !shaders->closest_hit_source.path.empty() || !shaders->any_hit_source.path.empty();
             if (has_hit_groups) {
@@ -1180,6 +1401,7 @@ struct GraphicsManager::Impl final {
                     if (drawable.mesh->get_mesh_data().has_color()) { input_vertex_attributes.set(VertexAttributesType::color); }
                     if (drawable.mesh->get_mesh_data().has_texcoord()) { input_vertex_attributes.set(VertexAttributesType::texcoord); }
                     if (drawable.mesh->get_mesh_data().has_texcoord2()) { input_vertex_attributes.set(VertexAttributesType::texcoord2); }
+                    if (drawable.mesh->get_mesh_data().is_quantized()) { input_vertex_attributes.set(VertexAttributesType::quantized); }
                     hit_shader_env.set_define("VERTEX_ATTRIBUTES_IN", std::to_string(input_vertex_attributes.raw_value()));
                     hit_shader_env.set_define("VERTEX_ATTRIBUTES_OUT", std::to_string(0xff));
                     if (drawable.material) {
@@ -1188,62 +1410,57 @@ struct GraphicsManager::Impl final {
                         hit_shader_env.set_replace_arg("MATERIAL_FUNCTION", "");
                         hit_shader_env.set_replace_arg("RAYTRACING_MATERIAL_STRUCT", "");
                     }
+                    // Hit shaders of remaining drawables are skipped after an error.
+                    if (!shader_error.empty()) { return; }
                     if (!shaders->closest_hit_source.path.empty()) {
-                        auto chit_id = fmt::format("{}-{}", closest_hit_id, hit_shader_env.get_config_identifier());
-                        auto chit_it = cached_shaders.find(chit_id);
-                        if (chit_it == cached_shaders.end()) {
-                            auto shader = shader_compiler.compile_shader(
-                                shaders->closest_hit_source.path,
-                                shaders->closest_hit_source.entry,
-                                rhi::ShaderStage::ray_closest_hit,
-                                hit_shader_env
-                            );
-                            BI_ASSERT_MSG(shader.has_value(), shader.error());
-                            chit_it = cached_shaders.insert({std::move(chit_id), shader.value()}).first;
+                        auto chit_key = hash(closest_hit_key, hit_shader_env.config_hash());
+                        auto chit_shader = get_shader(
+                            chit_key, shaders->closest_hit_source.path, shaders->closest_hit_source.entry,
+                            rhi::ShaderStage::ray_closest_hit, hit_shader_env
+                        );
+                        if (!chit_shader) {
+                            shader_error = chit_shader.error();
+                            return;
                         }
                         hit_group.closest_hit = rhi::PipelineShader{
-                            chit_it->second, shaders->closest_hit_source.entry,
+                            chit_shader.value(), shaders->closest_hit_source.entry,
                         };
                     }
                     if (!shaders->any_hit_source.path.empty()) {
-                        auto ahit_id = fmt::format("{}-{}", any_hit_id, hit_shader_env.get_config_identifier());
-                        auto ahit_it = cached_shaders.find(ahit_id);
-                        if (ahit_it == cached_shaders.end()) {
-                            auto shader = shader_compiler.compile_shader(
-                                shaders->any_hit_source.path,
-                                shaders->any_hit_source.entry,
-                                rhi::ShaderStage::ray_any_hit,
-                                hit_shader_env
-                            );
-                            BI_ASSERT_MSG(shader.has_value(), shader.error());
-                            ahit_it = cached_shaders.insert({std::move(ahit_id), shader.value()}).first;
+                        auto ahit_key = hash(any_hit_key, hit_shader_env.config_hash());
+                        auto ahit_shader = get_shader(
+                            ahit_key, shaders->any_hit_source.path, shaders->any_hit_source.entry,
+                            rhi::ShaderStage::ray_any_hit, hit_shader_env
+                        );
+                        if (!ahit_shader) {
+                            shader_error = ahit_shader.error();
+                            return;
                         }
                         hit_group.any_hit = rhi::PipelineShader{
-                            ahit_it->second, shaders->any_hit_source.entry,
+                            ahit_shader.value(), shaders->any_hit_source.entry,
                         };
                     }
-                    auto rint_shader = drawable.mesh->source(rhi::ShaderStage::ray_intersection);
-                    if (!rint_shader.path.empty()) {
-                        auto rint_id = fmt::format(
-                            "IS '{}' {}-{}", rint_shader.path, rint_shader.entry, hit_shader_env.get_config_identifier()
+                    auto rint_source = drawable.mesh->source(rhi::ShaderStage::ray_intersection);
+                    if (!rint_source.path.empty()) {
+                        auto rint_key = hash(
+                            rint_source.path, rint_source.entry, rhi::ShaderStage::ray_intersection,
+                            hit_shader_env.config_hash()
                         );
-                        auto rint_it = cached_shaders.find(rint_id);
-                        if (rint_it == cached_shaders.end()) {
-                            auto shader = shader_compiler.compile_shader(
-                                rint_shader.path,
-                                rint_shader.entry,
-                                rhi::ShaderStage::ray_intersection,
-                                hit_shader_env
-                            );
-                            BI_ASSERT_MSG(shader.has_value(), shader.error());
-                            rint_it = cached_shaders.insert({std::move(rint_id), shader.value()}).first;
+                        auto rint_shader = get_shader(
+                            rint_key, rint_source.path, rint_source.entry, rhi::ShaderStage::ray_intersection,
+                            hit_shader_env
+                        );
+                        if (!rint_shader) {
+                            shader_error = rint_shader.error();
+                            return;
                         }
-                        owned_shader_entries.push_back(rint_shader.entry);
+                        owned_shader_entries.push_back(rint_source.entry);
                         hit_group.intersection = rhi::PipelineShader{
-                            rint_it->second, owned_shader_entries.back(),
+                            rint_shader.value(), owned_shader_entries.back(),
                         };
                     }
                 });
+                if (!shader_error.empty()) { return use_fallback(shader_error); }
                 pipeline_desc.shader_record_sizes.hit_group = sizeof(DrawableSbtData);
             }
 
@@ -1264,6 +1481,9 @@ struct GraphicsManager::Impl final {
                 );
             }
 
+            name_pipeline_key(pipeline_key, [&]() {
+                return fmt::format("RG '{}' {}", shaders->raygen_source.path, shaders->raygen_source.entry);
+            });
             pipeline_it->second.pipeline = device->create_raytracing_pipeline(pipeline_desc);
 
             auto sbt_req = device->raytracing_shader_binding_table_requirements();
@@ -1318,13 +1538,29 @@ struct GraphicsManager::Impl final {
                     auto sbt_data = new (p_drawable_sbt_data + sbt_req.handle_size) DrawableSbtData{};
                     sbt_data->drawable_index = static_cast<uint32_t>(drawable.handle());
                     const auto submesh_base_vertex = drawable.submesh_desc().base_vertex;
-                    auto& mesh_buffers = meshes_buffers.at(drawable.mesh->get_mesh_data().id_);
-                    sbt_data->position_offset = (mesh_buffers.positions_buffer.offset()) / sizeof(float) + submesh_base_vertex * 3;
-                    sbt_data->normal_offset = (mesh_buffers.normals_buffer.offset()) / sizeof(float) + submesh_base_vertex * 3;
-                    sbt_data->tangent_offset = (mesh_buffers.tangents_buffer.offset()) / sizeof(float) + submesh_base_vertex * 4;
+                    auto& mesh_data = drawable.mesh->get_mesh_data();
+                    auto& mesh_buffers = meshes_buffers.at(mesh_data.id_.value);
+                    // Quantized attributes take 2, 1, 2, 1 and 1 uint for position, normal, tangent and texcoords.
+                    const auto quantized = mesh_data.is_quantized();
+                    sbt_data->position_offset = (mesh_buffers.positions_buffer.offset()) / sizeof(float)
+                        + submesh_base_vertex * (quantized ? 2 : 3);
+                    sbt_data->normal_offset = (mesh_buffers.normals_buffer.offset()) / sizeof(float)
+                        + submesh_base_vertex * (quantized ? 1 : 3);
+                    sbt_data->tangent_offset = (mesh_buffers.tangents_buffer.offset()) / sizeof(float)
+                        + submesh_base_vertex * (quantized ? 2 : 4);
                     sbt_data->color_offset = (mesh_buffers.colors_buffer.offset()) / sizeof(float) + submesh_base_vertex * 3;
-                    sbt_data->texcoord_offset = (mesh_buffers.texcoords_buffer.offset()) / sizeof(float) + submesh_base_vertex * 2;
-                    sbt_data->texcoord2_offset = (mesh_buffers.texcoords2_buffer.offset()) / sizeof(float) + submesh_base_vertex * 2;
+                    sbt_data->texcoord_offset = (mesh_buffers.texcoords_buffer.offset()) / sizeof(float)
+                        + submesh_base_vertex * (quantized ? 1 : 2);
+                    sbt_data->texcoord2_offset = (mesh_buffers.texcoords2_buffer.offset()) / sizeof(float)
+                        + submesh_base_vertex * (quantized ? 1 : 2);
+                    if (quantized) {
+                        auto& position_quantization = mesh_data.submesh_position_quantization(drawable.submesh_index);
+                        sbt_data->position_dequantization_offset = float4{position_quantization.offset, 0.0f};
+                        sbt_data->position_dequantization_scale = float4{position_quantization.scale, 1.0f};
+                    } else {
+                        sbt_data->position_dequantization_offset = float4{0.0f};
+                        sbt_data->position_dequantization_scale = float4{1.0f};
+                    }
                     sbt_data->index_offset = (mesh_buffers.indices_buffer.offset()) / sizeof(uint32_t) + drawable.submesh_desc().index_offset;
                     sbt_data->material_offset = drawable.material ? drawable.material->gpu_scene_struct_buffer_.offset() : 0;
                 });
@@ -1332,6 +1568,9 @@ struct GraphicsManager::Impl final {
             pipeline_it->second.sbt_buffer.set_data_immediately(sbt_data.data(), sbt_buffer_size);
 
             pipeline_it->second.drawables_hash = drawables_hash;
+            if (auto it = fallback_raytracing_pipelines.find(gpu_scene); it != fallback_raytracing_pipelines.end()) {
+                release_fallback_pipeline(it->second, pipeline_key);
+            }
         }
         return {pipeline_it->second.pipeline.ref(), pipeline_it->second.sbt};
     }
@@ -1362,6 +1601,245 @@ struct GraphicsManager::Impl final {
         delayed_destroys[curr_frame_index()].push_back(std::move(destroy));
     }
 
+    // Names are only kept in debug builds, so that release builds never format them.
+    template <typename F>
+    auto name_pipeline_key(uint64_t key, F&& make_name) -> void {
+#ifndef NDEBUG
+        pipeline_key_names.try_emplace(key, make_name());
+#endif
+    }
+    auto pipeline_key_name(uint64_t key) const -> std::string {
+#ifndef NDEBUG
+        if (auto it = pipeline_key_names.find(key); it != pipeline_key_names.end()) {
+            return it->second;
+        }
+#endif
+        return fmt::format("{:016x}", key);
+    }
+
+    // Get a cached shader or compile it, errors are returned so that pipelines can fall back to old ones.
+    auto get_shader(
+        uint64_t key, std::string_view path, std::string_view entry, rhi::ShaderStage stage,
+        ShaderCompilationEnvironment const& env
+    ) -> ShaderCompilationResult {
+        if (auto it = cached_shaders.find(key); it != cached_shaders.end()) { return it->second; }
+        auto shader = shader_compiler.compile_shader(path, entry, stage, env);
+        if (shader) { cached_shaders.insert({key, shader.value()}); }
+        return shader;
+    }
+
+    // Shaders failing to compile are only tolerated if the pipeline is retired by `reload_shaders()`.
+    // The old pipeline is used until shader files change again.
+    template <typename Pipelines>
+    auto use_fallback_pipeline(
+        Pipelines& fallback_pipelines, uint64_t key, std::string const& error
+    ) -> typename Pipelines::mapped_type& {
+        auto it = fallback_pipelines.find(key);
+        BI_ASSERT_MSG(it != fallback_pipelines.end(), error);
+        log::error(
+            "general", "Failed to compile shaders of pipeline '{}', the old one is used.\n{}",
+            pipeline_key_name(key), error
+        );
+        failed_pipeline_keys.insert(key);
+        return it->second;
+    }
+    template <typename Pipelines>
+    auto release_fallback_pipeline(Pipelines& fallback_pipelines, uint64_t key) -> void {
+        auto it = fallback_pipelines.find(key);
+        if (it == fallback_pipelines.end()) { return; }
+        add_delayed_destroy([pipeline = std::move(it->second)]() {});
+        fallback_pipelines.erase(it);
+        auto has_fallbacks = !fallback_graphics_pipelines.empty() || !fallback_compute_pipelines.empty()
+            || std::any_of(
+                fallback_raytracing_pipelines.begin(), fallback_raytracing_pipelines.end(),
+                [](auto const& entry) { return !entry.second.empty(); }
+            );
+        if (!has_fallbacks) {
+            // Destroyed after the fallback pipelines using them.
+            add_delayed_destroy([modules = std::move(fallback_shader_modules)]() {});
+            fallback_shader_modules.clear();
+        }
+    }
+
+    template <typename F>
+    auto record_pipeline(uint64_t key, F&& make_record) -> void {
+        ++num_created_pipelines;
+        if (pipeline_manifest_file.empty()) { return; }
+        pipeline_manifest.insert_or_assign(key, make_record());
+        is_pipeline_manifest_dirty = true;
+    }
+
+    auto warm_up_pipelines(std::string_view manifest_file) -> void {
+        pipeline_manifest_file = manifest_file;
+        if (auto file = g_engine->file_system()->get_file(pipeline_manifest_file); file) {
+            pipeline_manifest = read_pipeline_manifest(*&file.value());
+        }
+        if (pipeline_manifest.empty()) { return; }
+
+        // Shaders shared by pipelines are compiled only once.
+        std::vector<ShaderCompilationRequest> requests{};
+        std::vector<uint64_t> request_keys{};
+        std::unordered_set<uint64_t> requested_keys{};
+        for (auto const& [key, record] : pipeline_manifest) {
+            for (auto const& shader : record.shaders) {
+                if (cached_shaders.contains(shader.key) || !requested_keys.insert(shader.key).second) { continue; }
+                requests.push_back(ShaderCompilationRequest{
+                    .source_path = shader.source_path,
+                    .entry = shader.entry,
+                    .shader_stage = shader.stage,
+                    .environment = record.environment,
+                });
+                request_keys.push_back(shader.key);
+            }
+        }
+        auto results = shader_compiler.compile_shader_async(std::move(requests)).get();
+        for (size_t i = 0; i < results.size(); i++) {
+            if (results[i].has_value()) {
+                cached_shaders.insert({request_keys[i], results[i].value()});
+            } else {
+                log::warn("general", "Failed to compile shader of recorded pipeline: {}", results[i].error());
+            }
+        }
+
+        // Records whose shaders are removed or broken are dropped from the manifest.
+        auto num_dropped = std::erase_if(pipeline_manifest, [this](auto const& entry) {
+            auto const& shaders = entry.second.shaders;
+            return shaders.empty() || std::any_of(shaders.begin(), shaders.end(), [this](auto const& shader) {
+                return !cached_shaders.contains(shader.key);
+            });
+        });
+        is_pipeline_manifest_dirty |= num_dropped > 0;
+
+        // Shader compilation is the most costly part and is done in parallel above. Pipelines are created here on the
+        // calling thread, since device caches used by pipeline creation (e.g. descriptor set layouts of Vulkan and
+        // the pipeline library of D3D12) are not thread-safe.
+        for (auto const& [key, record] : pipeline_manifest) {
+            name_pipeline_key(key, [&record]() {
+                auto const& shader = record.shaders.back();
+                return fmt::format("RECORDED '{}' {}", shader.source_path, shader.entry);
+            });
+            if (record.type == PipelineManifestRecordType::graphics) {
+                graphics_pipelines.insert({key, device->create_graphics_pipeline(graphics_pipeline_desc_of(record))});
+            } else {
+                compute_pipelines.insert({key, device->create_compute_pipeline(compute_pipeline_desc_of(record))});
+            }
+        }
+        log::info("general", "{} pipelines are warmed up from '{}'.", pipeline_manifest.size(), pipeline_manifest_file);
+    }
+
+    // Shader modules of the record must be in cached shaders, the desc refers to strings of the record.
+    auto pipeline_shader_of(PipelineManifestShader const& shader) const -> rhi::PipelineShader {
+        return rhi::PipelineShader{cached_shaders.at(shader.key), shader.entry};
+    }
+    auto graphics_pipeline_desc_of(PipelineManifestRecord const& record) const -> rhi::GraphicsPipelineDesc {
+        // Vertex shader is recorded first and fragment shader is recorded last.
+        rhi::GraphicsPipelineDesc pipeline_desc{
+            .bind_groups_layout = record.bind_groups_layout,
+            .vertex_input_buffers = record.vertex_input_buffers,
+            .tessellation_state = record.tessellation_state,
+            .rasterization_state = record.rasterization_state,
+            .depth_stencil_state = record.depth_stencil_state,
+            .color_target_state = record.color_target_state,
+            .shaders = {
+                .vertex = pipeline_shader_of(record.shaders.front()),
+                .fragment = pipeline_shader_of(record.shaders.back()),
+            },
+        };
+        for (auto const& shader : record.shaders) {
+            if (shader.stage == rhi::ShaderStage::tessellation_control) {
+                pipeline_desc.shaders.tessellation_control = pipeline_shader_of(shader);
+            } else if (shader.stage == rhi::ShaderStage::tessellation_evaluation) {
+                pipeline_desc.shaders.tessellation_evaluation = pipeline_shader_of(shader);
+            } else if (shader.stage == rhi::ShaderStage::geometry) {
+                pipeline_desc.shaders.geometry = pipeline_shader_of(shader);
+            }
+        }
+        return pipeline_desc;
+    }
+    auto compute_pipeline_desc_of(PipelineManifestRecord const& record) const -> rhi::ComputePipelineDesc {
+        return rhi::ComputePipelineDesc{
+            .bind_groups_layout = record.bind_groups_layout,
+            .compute = pipeline_shader_of(record.shaders.front()),
+        };
+    }
+
+    auto save_pipeline_manifest() -> void {
+        if (!is_pipeline_manifest_dirty) { return; }
+        auto file = g_engine->file_system()->create_file(pipeline_manifest_file);
+        if (!file || !write_pipeline_manifest(*&file.value(), pipeline_manifest)) {
+            log::error("general", "Failed to write pipeline manifest '{}'.", pipeline_manifest_file);
+        }
+    }
+
+    auto reload_shaders(CSpan<std::string> changed_paths) -> void {
+        // Pipelines whose shaders failed are compiled again, in case the changes fix them.
+        failed_pipeline_keys.clear();
+        auto invalidated_modules = shader_compiler.invalidate_changed_files(changed_paths);
+        if (invalidated_modules.empty()) { return; }
+        std::unordered_set<rhi::ShaderModule const*> modules{};
+        for (auto const& module : invalidated_modules) {
+            modules.insert(module.get());
+        }
+        auto uses = [&modules](rhi::PipelineShader const& shader) {
+            return modules.contains(shader.shader_module.get());
+        };
+        auto uses_opt = [&uses](Option<rhi::PipelineShader> const& shader) {
+            return shader.has_value() && uses(shader.value());
+        };
+
+        std::erase_if(cached_shaders, [&modules](auto const& entry) { return modules.contains(entry.second.get()); });
+
+        // Pipelines are created again when required. Retired ones are kept as fallbacks in case the new shaders
+        // fail to compile, the older one is kept if there is already a fallback.
+        size_t num_pipelines = 0;
+        auto retire_if = [this, &num_pipelines](auto& pipelines, auto& fallback_pipelines, auto&& pred) {
+            for (auto it = pipelines.begin(); it != pipelines.end();) {
+                if (pred(it->second)) {
+                    log::debug("general", "Pipeline '{}' is retired.", pipeline_key_name(it->first));
+                    if (!fallback_pipelines.try_emplace(it->first, std::move(it->second)).second) {
+                        // Pipelines may be used by commands in flight, so they are destroyed later.
+                        add_delayed_destroy([pipeline = std::move(it->second)]() {});
+                    }
+                    it = pipelines.erase(it);
+                    ++num_pipelines;
+                } else {
+                    ++it;
+                }
+            }
+        };
+        retire_if(graphics_pipelines, fallback_graphics_pipelines, [&](Box<rhi::GraphicsPipeline> const& pipeline) {
+            auto const& shaders = pipeline->desc().shaders;
+            return uses(shaders.vertex) || uses_opt(shaders.tessellation_control)
+                || uses_opt(shaders.tessellation_evaluation) || uses_opt(shaders.geometry) || uses(shaders.fragment);
+        });
+        retire_if(compute_pipelines, fallback_compute_pipelines, [&](Box<rhi::ComputePipeline> const& pipeline) {
+            return uses(pipeline->desc().compute);
+        });
+        for (auto& [gpu_scene, scene_pipelines] : raytracing_pipelines) {
+            retire_if(scene_pipelines, fallback_raytracing_pipelines[gpu_scene], [&](RaytracingPipeline const& pipeline) {
+                auto const& shaders = pipeline.pipeline->desc().shaders;
+                auto uses_general = [&uses](rhi::RaytracingShaderGeneralGroup const& group) {
+                    return uses(group.shader);
+                };
+                auto uses_hit = [&uses_opt](rhi::RaytracingShaderHitGroup const& group) {
+                    return uses_opt(group.closest_hit) || uses_opt(group.any_hit) || uses_opt(group.intersection);
+                };
+                return uses(shaders.raygen.shader)
+                    || std::any_of(shaders.miss.begin(), shaders.miss.end(), uses_general)
+                    || std::any_of(shaders.hit_group.begin(), shaders.hit_group.end(), uses_hit)
+                    || std::any_of(shaders.callable.begin(), shaders.callable.end(), uses_general);
+            });
+        }
+        log::info(
+            "general", "Shader files changed, {} shaders and {} pipelines will be recompiled.",
+            invalidated_modules.size(), num_pipelines
+        );
+        // Kept until fallback pipelines using them are released.
+        for (auto& module : invalidated_modules) {
+            fallback_shader_modules.push_back(std::move(module));
+        }
+    }
+
     auto curr_frame_index() const -> uint32_t {
         return frame_index;
     }
@@ -1382,6 +1860,7 @@ struct GraphicsManager::Impl final {
 
     ShaderCompiler shader_compiler;
     CommandHelpers command_helpers;
+    TextureStreamer texture_streamer;
 
     Box<rhi::Swapchain> swapchain;
     Window::ResizeCallbackHandle swapchain_resize_callback;
@@ -1415,9 +1894,19 @@ struct GraphicsManager::Impl final {
     std::array<Texture, num_default_textures> default_textures;
     std::unordered_map<std::pair<rhi::ResourceFormat, rhi::TextureViewType>, Texture> dummy_textures;
 
-    StringHashMap<Ref<rhi::ShaderModule>> cached_shaders;
-    StringHashMap<Box<rhi::GraphicsPipeline>> graphics_pipelines;
-    StringHashMap<Box<rhi::ComputePipeline>> compute_pipelines;
+    // Keys are hashes of everything that affects the compiled shader or pipeline.
+    std::unordered_map<uint64_t, Ref<rhi::ShaderModule>> cached_shaders;
+    std::unordered_map<uint64_t, Box<rhi::GraphicsPipeline>> graphics_pipelines;
+    std::unordered_map<uint64_t, Box<rhi::ComputePipeline>> compute_pipelines;
+#ifndef NDEBUG
+    std::unordered_map<uint64_t, std::string> pipeline_key_names;
+#endif
+    uint64_t num_created_pipelines = 0;
+
+    // Pipelines are recorded only when the manifest file is set by `warm_up_pipelines()`.
+    std::string pipeline_manifest_file;
+    PipelineManifest pipeline_manifest;
+    bool is_pipeline_manifest_dirty = false;
 
     struct RaytracingPipeline final {
         size_t drawables_hash = 0;
@@ -1425,7 +1914,16 @@ struct GraphicsManager::Impl final {
         Buffer sbt_buffer;
         rhi::RaytracingShaderBindingTableBuffers sbt;
     };
-    std::unordered_map<Ref<GpuSceneSystem>, StringHashMap<RaytracingPipeline>> raytracing_pipelines;
+    std::unordered_map<Ref<GpuSceneSystem>, std::unordered_map<uint64_t, RaytracingPipeline>> raytracing_pipelines;
+
+    // Pipelines retired by `reload_shaders()` and shader modules used by them, kept until pipelines of the same keys
+    // are created again.
+    std::unordered_map<uint64_t, Box<rhi::GraphicsPipeline>> fallback_graphics_pipelines;
+    std::unordered_map<uint64_t, Box<rhi::ComputePipeline>> fallback_compute_pipelines;
+    std::unordered_map<Ref<GpuSceneSystem>, std::unordered_map<uint64_t, RaytracingPipeline>> fallback_raytracing_pipelines;
+    std::vector<Box<rhi::ShaderModule>> fallback_shader_modules;
+    // Keys of pipelines using fallbacks since their shaders failed to compile.
+    std::unordered_set<uint64_t> failed_pipeline_keys;
 
     struct MeshBuffersSuballocator final {
         BufferSuballocator positions_buffer;
@@ -1435,6 +1933,7 @@ struct GraphicsManager::Impl final {
         BufferSuballocator texcoords_buffer;
         BufferSuballocator texcoords2_buffer;
         BufferSuballocator indices_buffer;
+        BufferSuballocator meshlets_buffer;
     } mesh_buffer_allocator;
 
     struct MeshBuffers final {
@@ -1447,6 +1946,7 @@ struct GraphicsManager::Impl final {
         SuballocatedBuffer texcoords_buffer;
         SuballocatedBuffer texcoords2_buffer;
         SuballocatedBuffer indices_buffer;
+        SuballocatedBuffer meshlets_buffer;
     };
     std::unordered_map<uint64_t, MeshBuffers> meshes_buffers;
 
@@ -1470,10 +1970,22 @@ auto GraphicsManager::initialize(GraphicsSettings const& settings, std::string_v
     impl()->initialize(settings, pipeline_cache_file);
 }
 
+auto GraphicsManager::warm_up_pipelines(std::string_view pipeline_manifest_file) -> void {
+    impl()->warm_up_pipelines(pipeline_manifest_file);
+}
+
+auto GraphicsManager::num_created_pipelines() const -> uint64_t {
+    return impl()->num_created_pipelines;
+}
+
 auto GraphicsManager::wait_idle() -> void {
     impl()->wait_idle();
 }
 
+auto GraphicsManager::reload_shaders(CSpan<std::string> changed_paths) -> void {
+    impl()->reload_shaders(changed_paths);
+}
+
 auto GraphicsManager::new_frame() -> void {
     impl()->new_frame();
 }
@@ -1509,6 +2021,10 @@ auto GraphicsManager::execute_immediately(std::function<auto(Ref<rhi::CommandEnc
     impl()->execute_immediately(std::move(func));
 }
 
+auto GraphicsManager::read_back_texture_2d(Ref<Texture> texture, uint32_t mip_level) -> std::vector<std::byte> {
+    return impl()->read_back_texture_2d(texture, mip_level);
+}
+
 auto GraphicsManager::blit_texture_2d(
     Ref<rhi::CommandEncoder> cmd_encoder,
     Ref<Texture> src, uint32_t src_mip_level, uint32_t src_array_layer,
@@ -1559,7 +2075,7 @@ auto GraphicsManager::dummy_texture(rhi::ResourceFormat format, rhi::TextureView
 }
 
 auto GraphicsManager::swapchain_format() const -> rhi::ResourceFormat {
-    return impl()->swapchain->format();
+    return impl()->swapchain ? impl()->swapchain->format() : rhi::ResourceFormat::rgba8_unorm;
 }
 
 auto GraphicsManager::num_frames_in_flight() const -> uint32_t {
@@ -1598,9 +2114,26 @@ auto GraphicsManager::add_material_sampler(Ref<Sampler> sampler) -> size_t {
 }
 auto GraphicsManager::remove_material_sampler(size_t index) -> void {}
 
+auto GraphicsManager::texture_streaming_settings() const -> TextureStreamingSettings const& {
+    return impl()->texture_streamer.settings();
+}
+auto GraphicsManager::add_streamed_texture(StreamedTextureDesc&& desc) -> StreamedTextureHandle {
+    return impl()->texture_streamer.add(std::move(desc));
+}
+auto GraphicsManager::remove_streamed_texture(StreamedTextureHandle handle) -> void {
+    impl()->texture_streamer.remove(handle);
+}
+
 auto GraphicsManager::update_mesh_buffers(CRef<MeshData> mesh) -> void {
     impl()->update_mesh_buffers(mesh);
 }
+auto GraphicsManager::record_texture_usage(CRef<Camera> camera, CRef<Drawable> drawable) -> void {
+    impl()->texture_streamer.record_usage(camera, drawable);
+}
+
+auto GraphicsManager::meshlets_buffer(CRef<MeshData> mesh) -> std::pair<Ref<Buffer>, uint32_t> {
+    return impl()->meshlets_buffer(mesh);
+}
 
 auto GraphicsManager::require_blas_build_desc(CRef<Drawable> drawable)
     -> std::pair<Option<rhi::AccelerationStructureGeometryBuildInput>, Ref<GeometryAccelerationStructure>>
@@ -1618,9 +2151,9 @@ auto GraphicsManager::bind_mesh_buffers(
     impl()->bind_mesh_buffers(cmd_encoder, mesh);
 }
 auto GraphicsManager::draw_drawable(
-    Ref<rhi::GraphicsCommandEncoder> cmd_encoder, Ref<Drawable> drawable
+    Ref<rhi::GraphicsCommandEncoder> cmd_encoder, Ref<Drawable> drawable, CSpan<DrawIndexRange> index_ranges
 ) -> void {
-    impl()->draw_drawable(cmd_encoder, drawable);
+    impl()->draw_drawable(cmd_encoder, drawable, index_ranges);
 }
 
 auto GraphicsManager::compile_pipeline_for_drawable(
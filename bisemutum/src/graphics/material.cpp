@@ -388,8 +388,8 @@ auto Material::modify_compiler_environment_common(ShaderCompilationEnvironment&
     }
 }
 
-auto Material::get_shader_identifier() const -> std::string {
-    return fmt::format("{:x}", std::hash<std::string>{}(base_material()->material_function));
+auto Material::get_shader_hash() const -> uint64_t {
+    return std::hash<std::string>{}(base_material()->material_function);
 }
 
 }
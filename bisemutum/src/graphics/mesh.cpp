@@ -1,16 +1,56 @@
 #include <bisemutum/graphics/mesh.hpp>
 
+#include <mutex>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
 namespace bi::gfx {
 
-uint64_t MeshData::curr_id_ = 0;
+namespace {
+
+std::mutex destroyed_ids_mutex;
+std::vector<uint64_t> destroyed_ids;
+
+template <typename F>
+auto for_each_submesh_vertex(
+    std::vector<uint32_t> const& indices, uint32_t num_vertices, SubmeshDesc const& submesh, F&& func
+) -> void {
+    auto submesh_num_indices = submesh.num_indices;
+    if (submesh.num_indices == ~0u) {
+        submesh_num_indices = indices.empty()
+            ? num_vertices - submesh.base_vertex : static_cast<uint32_t>(indices.size()) - submesh.index_offset;
+    }
+    for (uint32_t i = 0; i < submesh_num_indices; i++) {
+        func(submesh.base_vertex + (indices.empty() ? i : indices[submesh.index_offset + i]));
+    }
+}
+
+} // namespace
+
+std::atomic<uint64_t> MeshData::curr_id_ = 0;
+
+MeshData::Id::Id() : value(curr_id_++) {}
+MeshData::Id::Id(Id const&) : Id() {}
+MeshData::Id::Id(Id&& rhs) noexcept : value(std::exchange(rhs.value, curr_id_++)) {}
+MeshData::Id::~Id() {
+    std::lock_guard lock{destroyed_ids_mutex};
+    destroyed_ids.push_back(value);
+}
 
-MeshData::MeshData() : id_(curr_id_++) {
+auto MeshData::take_destroyed_ids() -> std::vector<uint64_t> {
+    std::lock_guard lock{destroyed_ids_mutex};
+    return std::exchange(destroyed_ids, {});
+}
+
+MeshData::MeshData() {
     submeshes_.push_back({.num_indices = ~0u});
 }
 
 auto MeshData::mutable_positions() -> std::vector<float3>& {
     set_buffer_dirty();
     set_geometry_dirty();
+    clear_meshlets();
     return positions_;
 }
 
@@ -31,6 +71,7 @@ auto MeshData::mutable_colors() -> std::vector<float3>& {
 
 auto MeshData::mutable_texcoords() -> std::vector<float2>& {
     set_buffer_dirty();
+    submesh_texcoord_densities_.clear();
     return texcoords_;
 }
 
@@ -42,12 +83,15 @@ auto MeshData::mutable_texcoords2() -> std::vector<float2>& {
 auto MeshData::mutable_indices() -> std::vector<uint32_t>& {
     set_buffer_dirty();
     set_geometry_dirty();
+    clear_meshlets();
     return indices_;
 }
 
 auto MeshData::set_submehes(std::vector<SubmeshDesc> submeshes) -> void {
     submeshes_ = std::move(submeshes);
     submesh_versions_.resize(submeshes_.size());
+    position_quantizations_.clear();
+    clear_meshlets();
     for (uint32_t i = 0; i < static_cast<uint32_t>(submeshes_.size()); i++) {
         set_submesh_dirty(i);
     }
@@ -60,6 +104,7 @@ auto MeshData::set_submesh(uint32_t index, SubmeshDesc const& submeh) -> void {
     }
     submeshes_[index] = submeh;
     set_submesh_dirty(index);
+    clear_meshlets();
 }
 
 auto MeshData::bounding_box() const -> BoundingBox const& {
@@ -100,12 +145,150 @@ auto MeshData::submesh_bounding_box(uint32_t index) const -> BoundingBox const&
     return bbox_;
 }
 
+auto MeshData::submesh_texcoord_density(uint32_t index) const -> float {
+    if (index >= submeshes_.size() || texcoords_.empty()) {
+        return 0.0f;
+    }
+    if (index >= submesh_texcoord_densities_.size()) {
+        submesh_texcoord_densities_.resize(index + 1, -1.0f);
+    }
+    auto& density = submesh_texcoord_densities_[index];
+    if (density < 0.0f) {
+        auto& submesh = submeshes_[index];
+        auto submesh_num_indices = submesh.num_indices;
+        if (submesh.num_indices == ~0u) {
+            submesh_num_indices = indices_.empty()
+                ? num_vertices() - submesh.base_vertex : num_indices() - submesh.index_offset;
+        }
+        auto vertex_index = [&](uint32_t i) {
+            return submesh.base_vertex + (indices_.empty() ? i : indices_[submesh.index_offset + i]);
+        };
+        double texcoord_area = 0.0;
+        double area = 0.0;
+        if (submesh.topology == rhi::PrimitiveTopology::triangle_list) {
+            for (uint32_t i = 0; i + 2 < submesh_num_indices; i += 3) {
+                auto v0 = vertex_index(i);
+                auto v1 = vertex_index(i + 1);
+                auto v2 = vertex_index(i + 2);
+                auto e1 = texcoords_[v1] - texcoords_[v0];
+                auto e2 = texcoords_[v2] - texcoords_[v0];
+                texcoord_area += std::abs(e1.x * e2.y - e1.y * e2.x);
+                area += math::length(math::cross(positions_[v1] - positions_[v0], positions_[v2] - positions_[v0]));
+            }
+        }
+        density = area > 0.0 ? static_cast<float>(std::sqrt(texcoord_area / area)) : 0.0f;
+    }
+    return density;
+}
+
+auto MeshData::set_quantized(bool quantized) -> void {
+    if (quantized_ != quantized) {
+        quantized_ = quantized;
+        set_buffer_dirty();
+        set_geometry_dirty();
+    }
+}
+
+auto MeshData::submesh_position_quantization(uint32_t index) const -> PositionQuantization const& {
+    update_position_quantizations();
+    return position_quantizations_[std::min<size_t>(index, position_quantizations_.size() - 1)];
+}
+
+auto MeshData::update_position_quantizations() const -> void {
+    if (!position_quantizations_.empty()) { return; }
+
+    auto mesh_quantization = position_quantization_of(bounding_box());
+    position_quantizations_.resize(submeshes_.size() + 1, mesh_quantization);
+
+    // Each vertex can only be dequantized in one way, so fallback to the whole mesh if submeshes share vertices.
+    std::vector<uint32_t> vertex_submesh(positions_.size(), ~0u);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(submeshes_.size()); i++) {
+        auto shared = false;
+        for_each_submesh_vertex(indices_, num_vertices(), submeshes_[i], [&](uint32_t vertex) {
+            if (vertex_submesh[vertex] != ~0u && vertex_submesh[vertex] != i) { shared = true; }
+            vertex_submesh[vertex] = i;
+        });
+        if (shared) { return; }
+    }
+    for (uint32_t i = 0; i < static_cast<uint32_t>(submeshes_.size()); i++) {
+        position_quantizations_[i] = position_quantization_of(submesh_bounding_box(i));
+    }
+}
+
+auto MeshData::vertex_position_quantization_indices() const -> std::vector<uint32_t> {
+    update_position_quantizations();
+    auto num_submeshes = static_cast<uint32_t>(submeshes_.size());
+    std::vector<uint32_t> vertex_quantization_indices(positions_.size(), num_submeshes);
+    for (uint32_t i = 0; i < num_submeshes; i++) {
+        for_each_submesh_vertex(indices_, num_vertices(), submeshes_[i], [&](uint32_t vertex) {
+            vertex_quantization_indices[vertex] = i;
+        });
+    }
+    return vertex_quantization_indices;
+}
+
+auto MeshData::quantized_positions() const -> std::vector<uint2> {
+    auto vertex_quantization_indices = vertex_position_quantization_indices();
+    std::vector<uint2> quantized(positions_.size());
+    for (size_t i = 0; i < positions_.size(); i++) {
+        quantized[i] = quantize_position(positions_[i], position_quantizations_[vertex_quantization_indices[i]]);
+    }
+    return quantized;
+}
+auto MeshData::quantized_normals() const -> std::vector<uint32_t> {
+    std::vector<uint32_t> quantized(normals_.size());
+    for (size_t i = 0; i < normals_.size(); i++) {
+        quantized[i] = quantize_normal(normals_[i]);
+    }
+    return quantized;
+}
+auto MeshData::quantized_tangents() const -> std::vector<uint2> {
+    std::vector<uint2> quantized(tangents_.size());
+    for (size_t i = 0; i < tangents_.size(); i++) {
+        quantized[i] = quantize_tangent(tangents_[i]);
+    }
+    return quantized;
+}
+auto MeshData::quantized_texcoords() const -> std::vector<uint32_t> {
+    std::vector<uint32_t> quantized(texcoords_.size());
+    for (size_t i = 0; i < texcoords_.size(); i++) {
+        quantized[i] = quantize_texcoord(texcoords_[i]);
+    }
+    return quantized;
+}
+auto MeshData::quantized_texcoords2() const -> std::vector<uint32_t> {
+    std::vector<uint32_t> quantized(texcoords2_.size());
+    for (size_t i = 0; i < texcoords2_.size(); i++) {
+        quantized[i] = quantize_texcoord(texcoords2_[i]);
+    }
+    return quantized;
+}
+
+auto MeshData::submesh_meshlet_offset(uint32_t index) const -> uint32_t {
+    return index < submesh_meshlet_offsets_.size() ? submesh_meshlet_offsets_[index] : 0;
+}
+auto MeshData::submesh_meshlets(uint32_t index) const -> CSpan<Meshlet> {
+    if (index + 1 >= submesh_meshlet_offsets_.size()) { return {}; }
+    return CSpan<Meshlet>{
+        meshlets_.data() + submesh_meshlet_offsets_[index], meshlets_.data() + submesh_meshlet_offsets_[index + 1]
+    };
+}
+auto MeshData::set_meshlets(std::vector<Meshlet> meshlets, std::vector<uint32_t> submesh_meshlet_offsets) -> void {
+    meshlets_ = std::move(meshlets);
+    submesh_meshlet_offsets_ = std::move(submesh_meshlet_offsets);
+    // Meshlets are uploaded with geometry buffers.
+    ++geometry_version_;
+}
+
 auto MeshData::set_buffer_dirty() -> void {
     ++buffer_version_;
 }
 auto MeshData::set_geometry_dirty() -> void {
     ++geometry_version_;
     bbox_.reset();
+    submesh_bboxes_.clear();
+    submesh_texcoord_densities_.clear();
+    position_quantizations_.clear();
 }
 auto MeshData::set_submesh_dirty(uint32_t index) -> void {
     if (index < submesh_versions_.size()) {
@@ -114,6 +297,15 @@ auto MeshData::set_submesh_dirty(uint32_t index) -> void {
     if (index < submesh_bboxes_.size()) {
         submesh_bboxes_[index].reset();
     }
+    if (index < submesh_texcoord_densities_.size()) {
+        submesh_texcoord_densities_[index] = -1.0f;
+    }
+    position_quantizations_.clear();
+}
+
+auto MeshData::clear_meshlets() -> void {
+    meshlets_.clear();
+    submesh_meshlet_offsets_.clear();
 }
 
 auto MeshData::get_submesh_version(uint32_t index) const -> uint64_t {
@@ -125,24 +317,100 @@ auto MeshData::get_submesh_version(uint32_t index) const -> uint64_t {
 }
 
 auto MeshData::save_to_byte_stream(WriteByteStream& bs) const -> void {
-    bs.write(positions_);
-    bs.write(normals_);
-    bs.write(tangents_);
-    bs.write(colors_);
-    bs.write(texcoords_);
-    bs.write(texcoords2_);
-    bs.write(indices_);
-    bs.write(submeshes_);
-}
-auto MeshData::load_from_byte_stream(ReadByteStream& bs) -> void {
-    bs.read(positions_);
-    bs.read(normals_);
-    bs.read(tangents_);
-    bs.read(colors_);
-    bs.read(texcoords_);
-    bs.read(texcoords2_);
-    bs.read(indices_);
-    bs.read(submeshes_);
+    bs.write(quantized_);
+    if (quantized_) {
+        bs.write(indices_);
+        bs.write(submeshes_);
+        update_position_quantizations();
+        bs.write(position_quantizations_);
+        bs.write(quantized_positions());
+        bs.write(quantized_normals());
+        bs.write(quantized_tangents());
+        bs.write(colors_);
+        bs.write(quantized_texcoords());
+        bs.write(quantized_texcoords2());
+    } else {
+        bs.write(positions_);
+        bs.write(normals_);
+        bs.write(tangents_);
+        bs.write(colors_);
+        bs.write(texcoords_);
+        bs.write(texcoords2_);
+        bs.write(indices_);
+        bs.write(submeshes_);
+    }
+    bs.write(meshlets_);
+    bs.write(submesh_meshlet_offsets_);
+}
+auto MeshData::load_from_byte_stream(ReadByteStream& bs, uint32_t data_version) -> void {
+    quantized_ = false;
+    if (data_version >= 1) {
+        bs.read(quantized_);
+    }
+    if (quantized_) {
+        bs.read(indices_);
+        bs.read(submeshes_);
+        std::vector<PositionQuantization> position_quantizations;
+        bs.read(position_quantizations);
+
+        std::vector<uint2> quantized_positions;
+        bs.read(quantized_positions);
+        std::vector<uint32_t> quantized_normals;
+        bs.read(quantized_normals);
+        std::vector<uint2> quantized_tangents;
+        bs.read(quantized_tangents);
+        bs.read(colors_);
+        std::vector<uint32_t> quantized_texcoords;
+        bs.read(quantized_texcoords);
+        std::vector<uint32_t> quantized_texcoords2;
+        bs.read(quantized_texcoords2);
+
+        // Set positions with the whole mesh quantization first, they are dequantized again after knowing
+        // which quantization each vertex uses.
+        positions_.resize(quantized_positions.size());
+        position_quantizations_ = position_quantizations;
+        auto vertex_quantization_indices = vertex_position_quantization_indices();
+        for (size_t i = 0; i < positions_.size(); i++) {
+            auto quantization_index = std::min<size_t>(vertex_quantization_indices[i], position_quantizations.size() - 1);
+            positions_[i] = dequantize_position(quantized_positions[i], position_quantizations[quantization_index]);
+        }
+        // Reuse saved quantizations so that saving again doesn't accumulate error.
+        bbox_.reset();
+        submesh_bboxes_.clear();
+        position_quantizations_ = std::move(position_quantizations);
+
+        normals_.resize(quantized_normals.size());
+        for (size_t i = 0; i < normals_.size(); i++) {
+            normals_[i] = dequantize_normal(quantized_normals[i]);
+        }
+        tangents_.resize(quantized_tangents.size());
+        for (size_t i = 0; i < tangents_.size(); i++) {
+            tangents_[i] = dequantize_tangent(quantized_tangents[i]);
+        }
+        texcoords_.resize(quantized_texcoords.size());
+        for (size_t i = 0; i < texcoords_.size(); i++) {
+            texcoords_[i] = dequantize_texcoord(quantized_texcoords[i]);
+        }
+        texcoords2_.resize(quantized_texcoords2.size());
+        for (size_t i = 0; i < texcoords2_.size(); i++) {
+            texcoords2_[i] = dequantize_texcoord(quantized_texcoords2[i]);
+        }
+    } else {
+        bs.read(positions_);
+        bs.read(normals_);
+        bs.read(tangents_);
+        bs.read(colors_);
+        bs.read(texcoords_);
+        bs.read(texcoords2_);
+        bs.read(indices_);
+        bs.read(submeshes_);
+    }
+
+    clear_meshlets();
+    if (data_version >= 2) {
+        bs.read(meshlets_);
+        bs.read(submesh_meshlet_offsets_);
+    }
 }
 
 }
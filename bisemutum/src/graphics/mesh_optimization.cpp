@@ -0,0 +1,422 @@
+#include <bisemutum/graphics/mesh_optimization.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+
+#include <bisemutum/prelude/hash.hpp>
+
+namespace bi::gfx {
+
+namespace {
+
+constexpr uint32_t overdraw_resolution = 256;
+
+auto submesh_num_indices(MeshData const& mesh, SubmeshDesc const& submesh) -> uint32_t {
+    return submesh.num_indices == ~0u ? mesh.num_indices() - submesh.index_offset : submesh.num_indices;
+}
+
+auto is_optimizable_triangle_list(MeshData const& mesh, SubmeshDesc const& submesh) -> bool {
+    return submesh.topology == rhi::PrimitiveTopology::triangle_list && submesh_num_indices(mesh, submesh) % 3 == 0;
+}
+
+// FIFO post-transform vertex cache.
+struct VertexCache final {
+    VertexCache(uint32_t num_vertices, uint32_t cache_size)
+        : timestamps(num_vertices, 0), time(cache_size + 1), cache_size(cache_size) {}
+
+    auto is_cached(uint32_t vertex) const -> bool { return time - timestamps[vertex] <= cache_size; }
+    // Return true if it is a cache miss.
+    auto access(uint32_t vertex) -> bool {
+        if (is_cached(vertex)) { return false; }
+        timestamps[vertex] = time++;
+        return true;
+    }
+    auto access_triangle(CSpan<uint32_t> indices, size_t triangle) -> uint32_t {
+        return access(indices[3 * triangle]) + access(indices[3 * triangle + 1]) + access(indices[3 * triangle + 2]);
+    }
+    auto reset() -> void { time += cache_size + 1; }
+
+    std::vector<uint32_t> timestamps;
+    uint32_t time;
+    uint32_t cache_size;
+};
+
+auto analyze_vertex_cache(MeshData const& mesh, uint32_t cache_size) -> float {
+    VertexCache cache{mesh.num_vertices(), cache_size};
+    std::vector<uint32_t> indices;
+    uint64_t num_misses = 0;
+    uint64_t num_triangles = 0;
+    for (uint32_t i = 0; i < mesh.num_submehes(); i++) {
+        auto const& submesh = mesh.get_submesh(i);
+        if (!is_optimizable_triangle_list(mesh, submesh)) { continue; }
+        auto num_indices = submesh_num_indices(mesh, submesh);
+        indices.resize(num_indices);
+        for (uint32_t j = 0; j < num_indices; j++) {
+            indices[j] = submesh.base_vertex + mesh.indices()[submesh.index_offset + j];
+        }
+        cache.reset();
+        for (uint32_t t = 0; t < num_indices / 3; t++) {
+            num_misses += cache.access_triangle(indices, t);
+        }
+        num_triangles += num_indices / 3;
+    }
+    return num_triangles > 0 ? static_cast<float>(num_misses) / num_triangles : 0.0f;
+}
+
+// Rasterize triangles in the drawing order from 6 axis-aligned orthographic views with back face culling.
+auto analyze_overdraw(MeshData const& mesh) -> float {
+    std::vector<float3> positions;
+    BoundingBox bbox{};
+    for (uint32_t i = 0; i < mesh.num_submehes(); i++) {
+        auto const& submesh = mesh.get_submesh(i);
+        if (!is_optimizable_triangle_list(mesh, submesh)) { continue; }
+        auto num_indices = submesh_num_indices(mesh, submesh);
+        for (uint32_t j = 0; j < num_indices; j++) {
+            auto const& position = mesh.positions()[submesh.base_vertex + mesh.indices()[submesh.index_offset + j]];
+            positions.push_back(position);
+            bbox.add(position);
+        }
+    }
+    if (positions.empty()) { return 0.0f; }
+
+    auto extent = bbox.extent();
+    auto scale = (overdraw_resolution - 1) / std::max({extent.x, extent.y, extent.z, 1e-6f});
+    std::vector<float> depth(overdraw_resolution * overdraw_resolution);
+    uint64_t num_shaded = 0;
+    uint64_t num_covered = 0;
+    for (uint32_t axis = 0; axis < 3; axis++) {
+        for (float sign : {1.0f, -1.0f}) {
+            std::fill(depth.begin(), depth.end(), std::numeric_limits<float>::max());
+            for (size_t t = 0; t < positions.size(); t += 3) {
+                float3 v[3];
+                for (uint32_t c = 0; c < 3; c++) {
+                    auto p = (positions[t + c] - bbox.p_min) * scale;
+                    v[c] = float3{p[(axis + 1) % 3], p[(axis + 2) % 3], p[axis] * sign};
+                }
+                // It equals to the normal component along the view axis.
+                auto area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+                if (area * sign >= 0.0f) { continue; }
+
+                auto edge = [](float3 const& a, float3 const& b, float x, float y) {
+                    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+                };
+                auto min_x = static_cast<uint32_t>(std::max(std::floor(std::min({v[0].x, v[1].x, v[2].x})), 0.0f));
+                auto min_y = static_cast<uint32_t>(std::max(std::floor(std::min({v[0].y, v[1].y, v[2].y})), 0.0f));
+                auto max_x = std::min(static_cast<uint32_t>(std::max({v[0].x, v[1].x, v[2].x})), overdraw_resolution - 1);
+                auto max_y = std::min(static_cast<uint32_t>(std::max({v[0].y, v[1].y, v[2].y})), overdraw_resolution - 1);
+                for (auto y = min_y; y <= max_y; y++) {
+                    for (auto x = min_x; x <= max_x; x++) {
+                        auto px = x + 0.5f;
+                        auto py = y + 0.5f;
+                        auto w0 = edge(v[1], v[2], px, py);
+                        auto w1 = edge(v[2], v[0], px, py);
+                        auto w2 = edge(v[0], v[1], px, py);
+                        if (w0 * area < 0.0f || w1 * area < 0.0f || w2 * area < 0.0f) { continue; }
+                        auto z = (w0 * v[0].z + w1 * v[1].z + w2 * v[2].z) / area;
+                        auto& d = depth[y * overdraw_resolution + x];
+                        if (z < d) {
+                            d = z;
+                            ++num_shaded;
+                        }
+                    }
+                }
+            }
+            num_covered += std::count_if(depth.begin(), depth.end(), [](float d) {
+                return d < std::numeric_limits<float>::max();
+            });
+        }
+    }
+    return num_covered > 0 ? static_cast<float>(num_shaded) / num_covered : 0.0f;
+}
+
+struct TipsifyResult final {
+    std::vector<uint32_t> indices;
+    // First triangles of clusters that start with a cold cache.
+    std::vector<uint32_t> cluster_starts;
+};
+
+// 'Fast Triangle Reordering for Vertex Locality and Reduced Overdraw', Sander et al. 2007
+auto tipsify(CSpan<uint32_t> indices, uint32_t num_vertices, uint32_t cache_size) -> TipsifyResult {
+    auto num_triangles = static_cast<uint32_t>(indices.size() / 3);
+
+    std::vector<uint32_t> num_live_triangles(num_vertices, 0);
+    for (auto index : indices) { ++num_live_triangles[index]; }
+    std::vector<uint32_t> adjacency_offsets(num_vertices + 1, 0);
+    for (uint32_t v = 0; v < num_vertices; v++) {
+        adjacency_offsets[v + 1] = adjacency_offsets[v] + num_live_triangles[v];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> adjacency_fill{adjacency_offsets.begin(), adjacency_offsets.end() - 1};
+        for (uint32_t i = 0; i < indices.size(); i++) {
+            adjacency[adjacency_fill[indices[i]]++] = i / 3;
+        }
+    }
+
+    TipsifyResult result{};
+    result.indices.reserve(indices.size());
+    VertexCache cache{num_vertices, cache_size};
+    std::vector<bool> emitted(num_triangles, false);
+    std::vector<uint32_t> dead_end_stack;
+    std::vector<uint32_t> candidates;
+    uint32_t next_scanned_vertex = 0;
+    auto scan_live_vertex = [&]() -> uint32_t {
+        while (next_scanned_vertex < num_vertices && num_live_triangles[next_scanned_vertex] == 0) {
+            ++next_scanned_vertex;
+        }
+        if (next_scanned_vertex == num_vertices) { return ~0u; }
+        result.cluster_starts.push_back(static_cast<uint32_t>(result.indices.size() / 3));
+        return next_scanned_vertex;
+    };
+
+    auto fanning_vertex = scan_live_vertex();
+    while (fanning_vertex != ~0u) {
+        candidates.clear();
+        for (auto i = adjacency_offsets[fanning_vertex]; i < adjacency_offsets[fanning_vertex + 1]; i++) {
+            auto triangle = adjacency[i];
+            if (emitted[triangle]) { continue; }
+            emitted[triangle] = true;
+            for (uint32_t c = 0; c < 3; c++) {
+                auto v = indices[3 * triangle + c];
+                result.indices.push_back(v);
+                dead_end_stack.push_back(v);
+                candidates.push_back(v);
+                --num_live_triangles[v];
+                cache.access(v);
+            }
+        }
+
+        // Prefer vertices that stay in cache after emitting all their triangles, and the older ones among them.
+        fanning_vertex = ~0u;
+        int64_t best_priority = -1;
+        for (auto v : candidates) {
+            if (num_live_triangles[v] == 0) { continue; }
+            int64_t priority = 0;
+            auto age = cache.time - cache.timestamps[v];
+            if (age + 2 * num_live_triangles[v] <= cache_size) { priority = age; }
+            if (priority > best_priority) {
+                best_priority = priority;
+                fanning_vertex = v;
+            }
+        }
+        while (fanning_vertex == ~0u && !dead_end_stack.empty()) {
+            auto v = dead_end_stack.back();
+            dead_end_stack.pop_back();
+            if (num_live_triangles[v] > 0) { fanning_vertex = v; }
+        }
+        if (fanning_vertex == ~0u) {
+            fanning_vertex = scan_live_vertex();
+        }
+    }
+    return result;
+}
+
+// Split clusters where the cache is warm enough and draw the clusters facing outwards first.
+auto reorder_for_overdraw(
+    CSpan<uint32_t> indices, CSpan<uint32_t> hard_cluster_starts, CSpan<float3> positions,
+    MeshOptimizationSettings const& settings
+) -> std::vector<uint32_t> {
+    auto num_triangles = static_cast<uint32_t>(indices.size() / 3);
+    VertexCache cache{static_cast<uint32_t>(positions.size()), settings.vertex_cache_size};
+    std::vector<uint32_t> cluster_starts;
+    for (size_t h = 0; h < hard_cluster_starts.size(); h++) {
+        auto begin = hard_cluster_starts[h];
+        auto end = h + 1 < hard_cluster_starts.size() ? hard_cluster_starts[h + 1] : num_triangles;
+        cache.reset();
+        uint32_t num_misses = 0;
+        for (auto t = begin; t < end; t++) { num_misses += cache.access_triangle(indices, t); }
+        auto cluster_acmr = static_cast<float>(num_misses) / (end - begin);
+
+        cache.reset();
+        cluster_starts.push_back(begin);
+        auto start = begin;
+        num_misses = 0;
+        for (auto t = begin; t < end; t++) {
+            num_misses += cache.access_triangle(indices, t);
+            if (t + 1 < end && num_misses <= settings.overdraw_threshold * cluster_acmr * (t - start + 1)) {
+                start = t + 1;
+                cluster_starts.push_back(start);
+                num_misses = 0;
+                cache.reset();
+            }
+        }
+    }
+
+    struct ClusterInfo final {
+        float3 centroid{0.0f};
+        float3 normal{0.0f};
+        float area = 0.0f;
+    };
+    std::vector<ClusterInfo> clusters(cluster_starts.size());
+    float3 mesh_centroid{0.0f};
+    float mesh_area = 0.0f;
+    for (size_t c = 0; c < cluster_starts.size(); c++) {
+        auto end = c + 1 < cluster_starts.size() ? cluster_starts[c + 1] : num_triangles;
+        auto& cluster = clusters[c];
+        for (auto t = cluster_starts[c]; t < end; t++) {
+            auto const& p0 = positions[indices[3 * t]];
+            auto const& p1 = positions[indices[3 * t + 1]];
+            auto const& p2 = positions[indices[3 * t + 2]];
+            auto normal = math::cross(p1 - p0, p2 - p0);
+            auto area = math::length(normal);
+            cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+            cluster.normal += normal;
+            cluster.area += area;
+        }
+        mesh_centroid += cluster.centroid;
+        mesh_area += cluster.area;
+        if (cluster.area > 0.0f) { cluster.centroid /= cluster.area; }
+    }
+    if (mesh_area > 0.0f) { mesh_centroid /= mesh_area; }
+
+    std::vector<float> sort_keys(clusters.size(), 0.0f);
+    for (size_t c = 0; c < clusters.size(); c++) {
+        auto normal_length = math::length(clusters[c].normal);
+        if (normal_length > 0.0f) {
+            sort_keys[c] = math::dot(clusters[c].centroid - mesh_centroid, clusters[c].normal) / normal_length;
+        }
+    }
+    std::vector<uint32_t> cluster_order(clusters.size());
+    for (uint32_t c = 0; c < cluster_order.size(); c++) { cluster_order[c] = c; }
+    std::stable_sort(cluster_order.begin(), cluster_order.end(), [&sort_keys](uint32_t a, uint32_t b) {
+        return sort_keys[a] > sort_keys[b];
+    });
+
+    std::vector<uint32_t> reordered_indices;
+    reordered_indices.reserve(indices.size());
+    for (auto c : cluster_order) {
+        auto end = c + 1 < cluster_starts.size() ? cluster_starts[c + 1] : num_triangles;
+        reordered_indices.insert(
+            reordered_indices.end(), indices.begin() + 3 * cluster_starts[c], indices.begin() + 3 * end
+        );
+    }
+    return reordered_indices;
+}
+
+template <typename T>
+auto hash_attribute(size_t seed, std::vector<T> const& attribute, uint32_t vertex) -> size_t {
+    return attribute.empty() ? seed : hash_combine(seed, hash_by_byte(attribute[vertex]));
+}
+
+template <typename T>
+auto is_attribute_same(std::vector<T> const& attribute, uint32_t a, uint32_t b) -> bool {
+    return attribute.empty() || std::memcmp(&attribute[a], &attribute[b], sizeof(T)) == 0;
+}
+
+template <typename T>
+auto append_attribute(std::vector<T>& dst, std::vector<T> const& src, uint32_t vertex) -> void {
+    if (!src.empty()) { dst.push_back(src[vertex]); }
+}
+
+} // namespace
+
+auto optimize_mesh(MeshData& mesh, MeshOptimizationSettings const& settings) -> MeshOptimizationStatistics {
+    MeshOptimizationStatistics statistics{
+        .num_vertices_before = mesh.num_vertices(),
+        .num_vertices_after = mesh.num_vertices(),
+    };
+    if (mesh.num_indices() == 0 || !mesh.has_position()) { return statistics; }
+    statistics.acmr_before = analyze_vertex_cache(mesh, settings.vertex_cache_size);
+    statistics.overdraw_before = analyze_overdraw(mesh);
+
+    auto vertex_hash = [&mesh](uint32_t v) {
+        size_t hash = 0;
+        hash = hash_attribute(hash, mesh.positions(), v);
+        hash = hash_attribute(hash, mesh.normals(), v);
+        hash = hash_attribute(hash, mesh.tangents(), v);
+        hash = hash_attribute(hash, mesh.colors(), v);
+        hash = hash_attribute(hash, mesh.texcoords(), v);
+        hash = hash_attribute(hash, mesh.texcoords2(), v);
+        return hash;
+    };
+    auto vertex_equal = [&mesh](uint32_t a, uint32_t b) {
+        return is_attribute_same(mesh.positions(), a, b)
+            && is_attribute_same(mesh.normals(), a, b)
+            && is_attribute_same(mesh.tangents(), a, b)
+            && is_attribute_same(mesh.colors(), a, b)
+            && is_attribute_same(mesh.texcoords(), a, b)
+            && is_attribute_same(mesh.texcoords2(), a, b);
+    };
+    std::unordered_map<uint32_t, uint32_t, decltype(vertex_hash), decltype(vertex_equal)> unique_vertices{
+        0, vertex_hash, vertex_equal
+    };
+
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<float4> tangents;
+    std::vector<float3> colors;
+    std::vector<float2> texcoords;
+    std::vector<float2> texcoords2;
+    std::vector<uint32_t> indices;
+    std::vector<SubmeshDesc> submeshes;
+    indices.reserve(mesh.num_indices());
+    submeshes.reserve(mesh.num_submehes());
+
+    std::vector<uint32_t> local_to_mesh_vertices;
+    std::vector<uint32_t> local_indices;
+    std::vector<float3> local_positions;
+    std::vector<uint32_t> local_to_new_vertices;
+    for (uint32_t i = 0; i < mesh.num_submehes(); i++) {
+        auto const& submesh = mesh.get_submesh(i);
+        auto num_indices = submesh_num_indices(mesh, submesh);
+
+        unique_vertices.clear();
+        local_to_mesh_vertices.clear();
+        local_indices.resize(num_indices);
+        for (uint32_t j = 0; j < num_indices; j++) {
+            auto vertex = submesh.base_vertex + mesh.indices()[submesh.index_offset + j];
+            auto [it, inserted] = unique_vertices.try_emplace(vertex, static_cast<uint32_t>(local_to_mesh_vertices.size()));
+            if (inserted) { local_to_mesh_vertices.push_back(vertex); }
+            local_indices[j] = it->second;
+        }
+        auto num_local_vertices = static_cast<uint32_t>(local_to_mesh_vertices.size());
+
+        if (is_optimizable_triangle_list(mesh, submesh)) {
+            auto tipsified = tipsify(local_indices, num_local_vertices, settings.vertex_cache_size);
+            local_positions.resize(num_local_vertices);
+            for (uint32_t v = 0; v < num_local_vertices; v++) {
+                local_positions[v] = mesh.positions()[local_to_mesh_vertices[v]];
+            }
+            local_indices = reorder_for_overdraw(tipsified.indices, tipsified.cluster_starts, local_positions, settings);
+        }
+
+        auto& new_submesh = submeshes.emplace_back(submesh);
+        new_submesh.base_vertex = static_cast<uint32_t>(positions.size());
+        new_submesh.index_offset = static_cast<uint32_t>(indices.size());
+        new_submesh.num_indices = num_indices;
+        local_to_new_vertices.assign(num_local_vertices, ~0u);
+        uint32_t num_new_vertices = 0;
+        for (auto index : local_indices) {
+            if (local_to_new_vertices[index] == ~0u) {
+                local_to_new_vertices[index] = num_new_vertices++;
+                auto vertex = local_to_mesh_vertices[index];
+                append_attribute(positions, mesh.positions(), vertex);
+                append_attribute(normals, mesh.normals(), vertex);
+                append_attribute(tangents, mesh.tangents(), vertex);
+                append_attribute(colors, mesh.colors(), vertex);
+                append_attribute(texcoords, mesh.texcoords(), vertex);
+                append_attribute(texcoords2, mesh.texcoords2(), vertex);
+            }
+            indices.push_back(local_to_new_vertices[index]);
+        }
+    }
+
+    mesh.mutable_positions() = std::move(positions);
+    if (mesh.has_normal()) { mesh.mutable_normals() = std::move(normals); }
+    if (mesh.has_tangent()) { mesh.mutable_tangents() = std::move(tangents); }
+    if (mesh.has_color()) { mesh.mutable_colors() = std::move(colors); }
+    if (mesh.has_texcoord()) { mesh.mutable_texcoords() = std::move(texcoords); }
+    if (mesh.has_texcoord2()) { mesh.mutable_texcoords2() = std::move(texcoords2); }
+    mesh.mutable_indices() = std::move(indices);
+    mesh.set_submehes(std::move(submeshes));
+
+    statistics.num_vertices_after = mesh.num_vertices();
+    statistics.acmr_after = analyze_vertex_cache(mesh, settings.vertex_cache_size);
+    statistics.overdraw_after = analyze_overdraw(mesh);
+    return statistics;
+}
+
+}
@@ -0,0 +1,243 @@
+#include <bisemutum/graphics/meshlet.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <bisemutum/graphics/mesh.hpp>
+
+namespace bi::gfx {
+
+namespace {
+
+// Normal cones whose all normals are within this of the axis are too wide to be culled.
+constexpr float min_normal_cone_dot = 0.1f;
+
+auto compute_meshlet_bounds(
+    Meshlet& meshlet, CSpan<uint32_t> meshlet_indices, CSpan<uint32_t> meshlet_vertices,
+    std::vector<float3> const& positions, uint32_t base_vertex, float radius_padding
+) -> void {
+    BoundingBox bbox{};
+    for (auto v : meshlet_vertices) {
+        bbox.add(positions[base_vertex + v]);
+    }
+    auto center = bbox.center();
+    float radius = 0.0f;
+    for (auto v : meshlet_vertices) {
+        radius = std::max(radius, math::distance(center, positions[base_vertex + v]));
+    }
+    meshlet.bounding_sphere = float4{center, radius + radius_padding};
+
+    std::vector<float3> normals;
+    normals.reserve(meshlet_indices.size() / 3);
+    float3 axis{0.0f};
+    for (size_t i = 0; i + 2 < meshlet_indices.size(); i += 3) {
+        auto p0 = positions[base_vertex + meshlet_indices[i]];
+        auto p1 = positions[base_vertex + meshlet_indices[i + 1]];
+        auto p2 = positions[base_vertex + meshlet_indices[i + 2]];
+        auto normal = math::cross(p1 - p0, p2 - p0);
+        auto length = math::length(normal);
+        // Degenerate triangles are never rasterized.
+        if (length == 0.0f || !std::isfinite(length)) { continue; }
+        normals.push_back(normal / length);
+        axis += normals.back();
+    }
+
+    auto axis_length = math::length(axis);
+    if (normals.empty() || axis_length == 0.0f) {
+        meshlet.normal_cone = float4{0.0f, 0.0f, 1.0f, 1.0f};
+        return;
+    }
+    axis /= axis_length;
+    auto min_dot = 1.0f;
+    for (auto const& normal : normals) {
+        min_dot = std::min(min_dot, math::dot(normal, axis));
+    }
+    // All triangles are back facing when the view direction is within 90 degrees minus the cone angle of the axis,
+    // so cutoff is sine of the cone angle.
+    auto cutoff = min_dot <= min_normal_cone_dot ? 1.0f : std::sqrt(1.0f - min_dot * min_dot);
+    meshlet.normal_cone = float4{axis, cutoff};
+}
+
+auto build_submesh_meshlets(
+    Span<uint32_t> indices, std::vector<float3> const& positions, uint32_t base_vertex, float radius_padding,
+    MeshletBuildSettings const& settings, std::vector<Meshlet>& meshlets
+) -> void {
+    auto num_triangles = static_cast<uint32_t>(indices.size() / 3);
+    if (num_triangles == 0) { return; }
+
+    uint32_t num_local_vertices = 0;
+    for (auto v : indices) {
+        num_local_vertices = std::max(num_local_vertices, v + 1);
+    }
+    std::vector<uint32_t> adjacency_offsets(num_local_vertices + 1, 0);
+    for (uint32_t i = 0; i < num_triangles * 3; i++) {
+        ++adjacency_offsets[indices[i] + 1];
+    }
+    for (uint32_t v = 0; v < num_local_vertices; v++) {
+        adjacency_offsets[v + 1] += adjacency_offsets[v];
+    }
+    std::vector<uint32_t> adjacency(num_triangles * 3);
+    {
+        auto adjacency_fill = adjacency_offsets;
+        for (uint32_t i = 0; i < num_triangles * 3; i++) {
+            adjacency[adjacency_fill[indices[i]]++] = i / 3;
+        }
+    }
+
+    auto max_num_vertices = std::max(settings.max_num_vertices, 3u);
+    auto max_num_triangles = std::max(settings.max_num_triangles, 1u);
+
+    std::vector<bool> emitted(num_triangles, false);
+    // Number of not emitted triangles using the vertex.
+    std::vector<uint32_t> live_counts(num_local_vertices);
+    for (uint32_t v = 0; v < num_local_vertices; v++) {
+        live_counts[v] = adjacency_offsets[v + 1] - adjacency_offsets[v];
+    }
+    // Index of the meshlet which the vertex was last added to.
+    std::vector<uint32_t> vertex_meshlets(num_local_vertices, ~0u);
+    std::vector<uint32_t> new_indices;
+    new_indices.reserve(num_triangles * 3);
+    std::vector<uint32_t> meshlet_vertices;
+    std::vector<uint32_t> meshlet_triangles;
+    uint32_t curr_meshlet = 0;
+
+    auto num_new_vertices = [&](uint32_t tri) {
+        uint32_t count = 0;
+        for (uint32_t k = 0; k < 3; k++) {
+            count += vertex_meshlets[indices[tri * 3 + k]] != curr_meshlet ? 1 : 0;
+        }
+        return count;
+    };
+    auto flush = [&]() {
+        if (meshlet_triangles.empty()) { return; }
+        Meshlet meshlet{
+            .index_offset = static_cast<uint32_t>(new_indices.size()),
+            .num_indices = static_cast<uint32_t>(meshlet_triangles.size() * 3),
+            .num_vertices = static_cast<uint32_t>(meshlet_vertices.size()),
+        };
+        for (auto tri : meshlet_triangles) {
+            new_indices.insert(new_indices.end(), indices.begin() + tri * 3, indices.begin() + tri * 3 + 3);
+        }
+        compute_meshlet_bounds(
+            meshlet, CSpan<uint32_t>{new_indices.data() + meshlet.index_offset, meshlet.num_indices},
+            meshlet_vertices, positions, base_vertex, radius_padding
+        );
+        meshlets.push_back(meshlet);
+        meshlet_vertices.clear();
+        meshlet_triangles.clear();
+        ++curr_meshlet;
+    };
+
+    uint32_t next_seed = 0;
+    while (true) {
+        // Prefer the adjacent triangle that adds the fewest new vertices, and then the one whose vertices have
+        // the fewest remaining triangles, so that meshlets grow compactly.
+        auto best_tri = ~0u;
+        auto best_score = 4u;
+        auto best_live_count = ~0u;
+        for (auto v : meshlet_vertices) {
+            for (auto i = adjacency_offsets[v]; i < adjacency_offsets[v + 1]; i++) {
+                auto tri = adjacency[i];
+                if (emitted[tri]) { continue; }
+                auto score = num_new_vertices(tri);
+                auto live_count = live_counts[indices[tri * 3]] + live_counts[indices[tri * 3 + 1]]
+                    + live_counts[indices[tri * 3 + 2]];
+                if (
+                    score < best_score
+                    || (score == best_score && (live_count < best_live_count
+                        || (live_count == best_live_count && tri < best_tri)))
+                ) {
+                    best_tri = tri;
+                    best_score = score;
+                    best_live_count = live_count;
+                }
+            }
+        }
+        if (best_tri == ~0u) {
+            // Input order is already optimized for vertex cache, so continue from the first remaining triangle.
+            while (next_seed < num_triangles && emitted[next_seed]) { ++next_seed; }
+            if (next_seed == num_triangles) { break; }
+            best_tri = next_seed;
+            best_score = num_new_vertices(best_tri);
+        }
+
+        if (
+            meshlet_vertices.size() + best_score > max_num_vertices
+            || meshlet_triangles.size() + 1 > max_num_triangles
+        ) {
+            flush();
+            continue;
+        }
+
+        emitted[best_tri] = true;
+        meshlet_triangles.push_back(best_tri);
+        for (uint32_t k = 0; k < 3; k++) {
+            auto v = indices[best_tri * 3 + k];
+            --live_counts[v];
+            if (vertex_meshlets[v] != curr_meshlet) {
+                vertex_meshlets[v] = curr_meshlet;
+                meshlet_vertices.push_back(v);
+            }
+        }
+    }
+    flush();
+
+    std::copy(new_indices.begin(), new_indices.end(), indices.begin());
+}
+
+} // namespace
+
+auto build_meshlets(MeshData& mesh, MeshletBuildSettings const& settings) -> void {
+    if (mesh.indices().empty()) { return; }
+
+    auto indices = mesh.indices();
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> submesh_meshlet_offsets;
+    submesh_meshlet_offsets.reserve(mesh.num_submehes() + 1);
+    for (uint32_t i = 0; i < mesh.num_submehes(); i++) {
+        submesh_meshlet_offsets.push_back(static_cast<uint32_t>(meshlets.size()));
+
+        auto const& submesh = mesh.get_submesh(i);
+        if (submesh.topology != rhi::PrimitiveTopology::triangle_list || submesh.index_offset >= indices.size()) {
+            continue;
+        }
+        auto num_indices = std::min<size_t>(submesh.num_indices, indices.size() - submesh.index_offset);
+        // Saved positions are quantized, pad spheres so that they still bound dequantized positions.
+        auto radius_padding = mesh.is_quantized()
+            ? math::length(mesh.submesh_position_quantization(i).scale) / 65535.0f : 0.0f;
+        build_submesh_meshlets(
+            Span<uint32_t>{indices.data() + submesh.index_offset, num_indices / 3 * 3},
+            mesh.positions(), submesh.base_vertex, radius_padding, settings, meshlets
+        );
+    }
+    submesh_meshlet_offsets.push_back(static_cast<uint32_t>(meshlets.size()));
+
+    mesh.mutable_indices() = std::move(indices);
+    mesh.set_meshlets(std::move(meshlets), std::move(submesh_meshlet_offsets));
+}
+
+auto is_meshlet_visible(Meshlet const& meshlet, MeshletCullingParams const& params) -> bool {
+    float3 center{meshlet.bounding_sphere};
+    auto radius = meshlet.bounding_sphere.w;
+
+    float3 world_center{params.matrix_object_to_world * float4{center, 1.0f}};
+    auto world_radius = radius * params.max_scaling;
+    for (auto const& plane : params.frustum_planes) {
+        if (math::dot(float3{plane}, world_center) + plane.w < -world_radius) { return false; }
+    }
+
+    auto cutoff = meshlet.normal_cone.w;
+    if (params.back_face_sign != 0.0f && cutoff < 1.0f) {
+        auto axis = float3{meshlet.normal_cone} * params.back_face_sign;
+        if (params.orthographic) {
+            if (math::dot(params.view_direction, axis) >= cutoff) { return false; }
+        } else {
+            auto view_to_center = center - params.view_position;
+            if (math::dot(view_to_center, axis) >= cutoff * math::length(view_to_center) + radius) { return false; }
+        }
+    }
+
+    return true;
+}
+
+}
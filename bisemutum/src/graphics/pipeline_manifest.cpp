@@ -0,0 +1,105 @@
+#include "pipeline_manifest.hpp"
+
+#include <bisemutum/prelude/byte_stream.hpp>
+
+namespace bi::gfx {
+
+namespace {
+
+constexpr uint32_t pipeline_manifest_magic_number = 0x4d50495b;
+// 2: keys are FNV-1a.
+constexpr uint32_t pipeline_manifest_version = 2;
+
+auto write_string_map(WriteByteStream& bs, StringHashMap<std::string> const& map, size_t key_prefix_size) -> void {
+    bs.write(static_cast<uint64_t>(map.size()));
+    for (auto const& [key, value] : map) {
+        bs.write(std::string_view{key}.substr(key_prefix_size)).write(value);
+    }
+}
+
+auto write_environment(WriteByteStream& bs, ShaderCompilationEnvironment const& environment) -> void {
+    write_string_map(bs, environment.defines, 0);
+    // Keys of replace args are prefixed with '$', which is added again by `set_replace_arg()`.
+    write_string_map(bs, environment.replace_args, 1);
+}
+
+auto read_environment(ReadByteStream& bs, ShaderCompilationEnvironment& environment) -> void {
+    std::string key{};
+    std::string value{};
+    uint64_t num_defines = 0;
+    bs.read(num_defines);
+    for (uint64_t i = 0; i < num_defines && bs.curr_offset() < bs.size(); i++) {
+        bs.read(key).read(value);
+        environment.set_define(key, std::move(value));
+    }
+    uint64_t num_replace_args = 0;
+    bs.read(num_replace_args);
+    for (uint64_t i = 0; i < num_replace_args && bs.curr_offset() < bs.size(); i++) {
+        bs.read(key).read(value);
+        environment.set_replace_arg(key, std::move(value));
+    }
+}
+
+} // namespace
+
+auto read_pipeline_manifest(Dyn<rt::IFile>::Ref file) -> PipelineManifest {
+    ReadByteStream bs{file.read_binary_data()};
+    uint32_t magic_number = 0;
+    uint32_t version = 0;
+    uint64_t num_records = 0;
+    bs.read(magic_number).read(version).read(num_records);
+    if (magic_number != pipeline_manifest_magic_number || version != pipeline_manifest_version) {
+        return {};
+    }
+
+    PipelineManifest manifest{};
+    for (uint64_t i = 0; i < num_records && bs.curr_offset() < bs.size(); i++) {
+        uint64_t key = 0;
+        PipelineManifestRecord record{};
+        bs.read(key).read(record.type);
+        read_environment(bs, record.environment);
+        uint64_t num_shaders = 0;
+        bs.read(num_shaders);
+        record.shaders.resize(num_shaders);
+        for (auto& shader : record.shaders) {
+            bs.read(shader.key).read(shader.source_path).read(shader.entry).read(shader.stage);
+        }
+        bs.read(record.bind_groups_layout);
+        uint64_t num_vertex_input_buffers = 0;
+        bs.read(num_vertex_input_buffers);
+        record.vertex_input_buffers.resize(num_vertex_input_buffers);
+        for (auto& buffer : record.vertex_input_buffers) {
+            bs.read(buffer.stride).read(buffer.per_instance).read(buffer.attributes);
+        }
+        bs.read(record.tessellation_state).read(record.rasterization_state).read(record.depth_stencil_state);
+        bs.read(record.color_target_state.attachments).read(record.color_target_state.blend_constants);
+        if (bs.curr_offset() > bs.size()) { break; }
+        manifest.insert_or_assign(key, std::move(record));
+    }
+    return manifest;
+}
+
+auto write_pipeline_manifest(Dyn<rt::IFile>::Ref file, PipelineManifest const& manifest) -> bool {
+    WriteByteStream bs{};
+    bs.write(pipeline_manifest_magic_number)
+        .write(pipeline_manifest_version)
+        .write(static_cast<uint64_t>(manifest.size()));
+    for (auto const& [key, record] : manifest) {
+        bs.write(key).write(record.type);
+        write_environment(bs, record.environment);
+        bs.write(static_cast<uint64_t>(record.shaders.size()));
+        for (auto const& shader : record.shaders) {
+            bs.write(shader.key).write(shader.source_path).write(shader.entry).write(shader.stage);
+        }
+        bs.write(record.bind_groups_layout);
+        bs.write(static_cast<uint64_t>(record.vertex_input_buffers.size()));
+        for (auto const& buffer : record.vertex_input_buffers) {
+            bs.write(buffer.stride).write(buffer.per_instance).write(buffer.attributes);
+        }
+        bs.write(record.tessellation_state).write(record.rasterization_state).write(record.depth_stencil_state);
+        bs.write(record.color_target_state.attachments).write(record.color_target_state.blend_constants);
+    }
+    return file.write_binary_data(bs.data());
+}
+
+}
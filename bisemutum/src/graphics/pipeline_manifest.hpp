@@ -0,0 +1,47 @@
+#pragma once
+
+#include <unordered_map>
+
+#include <bisemutum/graphics/shader_compilation_environment.hpp>
+#include <bisemutum/runtime/vfs.hpp>
+#include <bisemutum/rhi/pipeline.hpp>
+
+namespace bi::gfx {
+
+enum class PipelineManifestRecordType : uint8_t {
+    graphics,
+    compute,
+};
+
+struct PipelineManifestShader final {
+    // Key of the shader module in cached shaders of `GraphicsManager`.
+    uint64_t key = 0;
+    std::string source_path;
+    std::string entry;
+    rhi::ShaderStage stage = rhi::ShaderStage::vertex;
+};
+
+// Everything needed to create a pipeline again without the pass, mesh and material that required it.
+struct PipelineManifestRecord final {
+    PipelineManifestRecordType type = PipelineManifestRecordType::graphics;
+    // All shaders of a pipeline are compiled with the same environment.
+    ShaderCompilationEnvironment environment;
+    std::vector<PipelineManifestShader> shaders;
+    std::vector<rhi::BindGroupLayout> bind_groups_layout;
+    // States below are only used by graphics pipelines.
+    std::vector<rhi::VertexInputBufferDesc> vertex_input_buffers;
+    rhi::TessellationState tessellation_state;
+    rhi::RasterizationState rasterization_state;
+    rhi::DepthStencilState depth_stencil_state;
+    rhi::ColorTargetState color_target_state;
+};
+
+// Keys are pipeline keys of `GraphicsManager`.
+using PipelineManifest = std::unordered_map<uint64_t, PipelineManifestRecord>;
+
+// Return an empty manifest if the file is not valid, e.g. it's written by an older version.
+auto read_pipeline_manifest(Dyn<rt::IFile>::Ref file) -> PipelineManifest;
+
+auto write_pipeline_manifest(Dyn<rt::IFile>::Ref file, PipelineManifest const& manifest) -> bool;
+
+}
@@ -9,8 +9,10 @@
 #include <bisemutum/graphics/render_graph_pass.hpp>
 #include <bisemutum/graphics/graphics_manager.hpp>
 #include <bisemutum/graphics/gpu_scene_system.hpp>
+#include <bisemutum/graphics/meshlet.hpp>
 #include <bisemutum/prelude/hash.hpp>
 #include <bisemutum/prelude/misc.hpp>
+#include <bisemutum/prelude/math.hpp>
 
 namespace bi::gfx {
 
@@ -101,6 +103,85 @@ auto need_barrier(BitFlags<rhi::ResourceAccessType> from, BitFlags<rhi::Resource
         });
 }
 
+auto meshlet_culling_params_of(
+    Camera const& camera, FragmentShader const& fragment_shader, Drawable const& drawable, CSpan<float4> planes
+) -> MeshletCullingParams {
+    auto matrix = drawable.transform.matrix();
+    auto matrix_world_to_object = math::inverse(matrix);
+
+    auto back_face_sign = fragment_shader.cull_mode == rhi::CullMode::back_face ? 1.0f
+        : fragment_shader.cull_mode == rhi::CullMode::front_face ? -1.0f : 0.0f;
+    // Mirroring transform flips the winding order of triangles.
+    if ((fragment_shader.front_face == rhi::FrontFace::cw) != (math::determinant(matrix) < 0.0f)) {
+        back_face_sign = -back_face_sign;
+    }
+
+    auto abs_scaling = math::abs(drawable.transform.scaling);
+    return MeshletCullingParams{
+        .frustum_planes = planes,
+        .matrix_object_to_world = matrix,
+        .max_scaling = std::max(abs_scaling.x, std::max(abs_scaling.y, abs_scaling.z)),
+        .view_position = float3{matrix_world_to_object * float4{camera.position, 1.0f}},
+        .view_direction = math::normalize(float3{matrix_world_to_object * float4{camera.front_dir, 0.0f}}),
+        .orthographic = camera.projection_type == ProjectionType::orthographic,
+        .back_face_sign = back_face_sign,
+    };
+}
+
+// Return none if all meshlets are culled, or empty ranges if none is culled.
+auto visible_index_ranges(
+    Drawable const& drawable, MeshletCullingParams const& params
+) -> Option<std::vector<DrawIndexRange>> {
+    auto meshlets = drawable.mesh->get_mesh_data().submesh_meshlets(drawable.submesh_index);
+    std::vector<DrawIndexRange> ranges;
+    bool all_visible = true;
+    for (auto const& meshlet : meshlets) {
+        if (!is_meshlet_visible(meshlet, params)) {
+            all_visible = false;
+            continue;
+        }
+        // Meshlets are contiguous in index data, so adjacent visible ones can be merged.
+        if (!ranges.empty() && ranges.back().index_offset + ranges.back().num_indices == meshlet.index_offset) {
+            ranges.back().num_indices += meshlet.num_indices;
+        } else {
+            ranges.push_back(DrawIndexRange{meshlet.index_offset, meshlet.num_indices});
+        }
+    }
+    if (ranges.empty()) { return {}; }
+    if (all_visible) { ranges.clear(); }
+    return ranges;
+}
+
+// Same as `MeshletCullingJobData` in 'meshlet_culling.hlsl'.
+struct MeshletCullingJobData final {
+    float4x4 matrix_object_to_world;
+    float4 view_position_or_direction;
+    uint32_t meshlet_offset;
+    uint32_t num_meshlets;
+    uint32_t first_index;
+    int32_t base_vertex;
+    uint32_t args_offset;
+    float max_scaling;
+    float back_face_sign;
+    uint32_t orthographic;
+};
+
+BI_SHADER_PARAMETERS_BEGIN(MeshletCullingPassParams)
+    BI_SHADER_PARAMETER(uint, num_jobs)
+    BI_SHADER_PARAMETER_ARRAY(float4, frustum_planes, [6])
+    BI_SHADER_PARAMETER_SRV_BUFFER(StructuredBuffer<MeshletCullingJobData>, jobs)
+    BI_SHADER_PARAMETER_SRV_BUFFER(StructuredBuffer<Meshlet>, meshlets)
+    BI_SHADER_PARAMETER_UAV_BUFFER(RWStructuredBuffer<uint>, indirect_args)
+    BI_SHADER_PARAMETER_UAV_BUFFER(RWStructuredBuffer<uint>, indirect_counts)
+BI_SHADER_PARAMETERS_END()
+
+struct MeshletCullingPassData final {
+    BufferHandle indirect_args;
+    BufferHandle indirect_counts;
+};
+
+constexpr uint32_t meshlet_culling_max_num_groups_x = 65535;
+
 } // namespace
 
 struct RenderGraph::Impl final {
@@ -388,9 +469,15 @@ struct RenderGraph::Impl final {
         graph_nodes_.emplace_back(std::move(node));
     }
 
-    auto add_rendered_object_list(RenderedObjectListDesc const& desc) -> RenderedObjectListHandle {
+    auto add_rendered_object_list(RenderGraph* rg, RenderedObjectListDesc const& desc) -> RenderedObjectListHandle {
+        auto meshlet_culling_mode = desc.do_frustum_culling ? desc.meshlet_culling_mode : MeshletCullingMode::none;
+        if (meshlet_culling_mode == MeshletCullingMode::gpu && !device_->properties().draw_indirect_count) {
+            meshlet_culling_mode = MeshletCullingMode::cpu;
+        }
+
         std::vector<Ref<Drawable>> drawables;
         std::unordered_map<Ref<Drawable>, float> drawable_camera_dist;
+        std::unordered_map<Ref<Drawable>, std::vector<DrawIndexRange>> drawable_index_ranges;
         auto gpu_scene = g_engine->system_manager()->get_system_for_current_scene<GpuSceneSystem>();
         auto camera_frustum_planes = desc.camera->get_frustum_planes();
         for (auto drawable : desc.candidate_drawables) {
@@ -405,9 +492,22 @@ struct RenderGraph::Impl final {
                 (desc.type.contains_any(RenderedObjectType::opaque) && mat_is_opaque)
                 || (desc.type.contains_any(RenderedObjectType::transparent) && !mat_is_opaque)
             ) {
+                auto const& mesh_data = drawable->mesh->get_mesh_data();
+                if (meshlet_culling_mode == MeshletCullingMode::cpu && mesh_data.has_meshlets()) {
+                    auto ranges = visible_index_ranges(
+                        *drawable,
+                        meshlet_culling_params_of(
+                            *desc.camera, *desc.fragment_shader, *drawable, camera_frustum_planes
+                        )
+                    );
+                    if (!ranges) { continue; }
+                    drawable_index_ranges.insert({drawable, std::move(ranges).value()});
+                }
+
                 drawables.push_back(drawable);
                 drawable_camera_dist.insert({drawable, math::distance(desc.camera->position, drawable->bounding_box().center())});
                 g_engine->graphics_manager()->update_mesh_buffers(drawable->mesh->get_mesh_data());
+                g_engine->graphics_manager()->record_texture_usage(desc.camera, drawable);
             }
         };
         std::sort(drawables.begin(), drawables.end(), [](Ref<Drawable> a, Ref<Drawable> b) {
@@ -457,7 +557,117 @@ struct RenderGraph::Impl final {
             }
         }
 
-        return static_cast<RenderedObjectListHandle>(rendered_object_lists_.size() - 1);
+        auto handle = static_cast<RenderedObjectListHandle>(rendered_object_lists_.size() - 1);
+        if (meshlet_culling_mode == MeshletCullingMode::cpu && !drawable_index_ranges.empty()) {
+            for (auto& item : list.items) {
+                item.index_ranges.resize(item.drawables.size());
+                for (size_t i = 0; i < item.drawables.size(); i++) {
+                    if (auto it = drawable_index_ranges.find(item.drawables[i]); it != drawable_index_ranges.end()) {
+                        item.index_ranges[i] = std::move(it->second);
+                    }
+                }
+            }
+        } else if (meshlet_culling_mode == MeshletCullingMode::gpu) {
+            add_meshlet_culling_pass(rg, handle, camera_frustum_planes);
+        }
+        return handle;
+    }
+    auto add_meshlet_culling_pass(
+        RenderGraph* rg, RenderedObjectListHandle handle, std::array<float4, 6> const& frustum_planes
+    ) -> void {
+        auto& list = rendered_object_lists_[static_cast<size_t>(handle)];
+        std::vector<MeshletCullingJobData> jobs_data;
+        Ptr<Buffer> meshlets_buffer = nullptr;
+        uint32_t num_total_meshlets = 0;
+        for (auto& item : list.items) {
+            item.meshlet_culling_jobs.resize(item.drawables.size(), ~0u);
+            for (size_t i = 0; i < item.drawables.size(); i++) {
+                auto drawable = item.drawables[i];
+                auto const& mesh_data = drawable->mesh->get_mesh_data();
+                auto num_meshlets = mesh_data.has_meshlets()
+                    ? static_cast<uint32_t>(mesh_data.submesh_meshlets(drawable->submesh_index).size()) : 0u;
+                if (num_meshlets == 0) { continue; }
+
+                auto [buffer, mesh_meshlet_offset] = g_engine->graphics_manager()->meshlets_buffer(mesh_data);
+                meshlets_buffer = buffer;
+                auto params = meshlet_culling_params_of(
+                    *list.camera, *list.fragment_shader, *drawable, frustum_planes
+                );
+                auto const& submesh = drawable->submesh_desc();
+                item.meshlet_culling_jobs[i] = static_cast<uint32_t>(jobs_data.size());
+                list.meshlet_culling_jobs.push_back(MeshletCullingJob{
+                    .num_meshlets = num_meshlets,
+                    .args_offset = num_total_meshlets,
+                });
+                jobs_data.push_back(MeshletCullingJobData{
+                    .matrix_object_to_world = params.matrix_object_to_world,
+                    .view_position_or_direction = float4{params.orthographic ? params.view_direction : params.view_position, 0.0f},
+                    .meshlet_offset = mesh_meshlet_offset + mesh_data.submesh_meshlet_offset(drawable->submesh_index),
+                    .num_meshlets = num_meshlets,
+                    .first_index = submesh.index_offset,
+                    .base_vertex = static_cast<int32_t>(submesh.base_vertex),
+                    .args_offset = num_total_meshlets,
+                    .max_scaling = params.max_scaling,
+                    .back_face_sign = params.back_face_sign,
+                    .orthographic = params.orthographic ? 1u : 0u,
+                });
+                num_total_meshlets += num_meshlets;
+            }
+        }
+        if (jobs_data.empty()) {
+            for (auto& item : list.items) { item.meshlet_culling_jobs.clear(); }
+            return;
+        }
+
+        if (num_used_meshlet_culling_resources_ == meshlet_culling_resources_.size()) {
+            auto& resources = meshlet_culling_resources_.emplace_back(Box<MeshletCullingResources>::make());
+            resources->params.initialize<MeshletCullingPassParams>();
+        }
+        auto resources = meshlet_culling_resources_[num_used_meshlet_culling_resources_++].ref();
+        Buffer::update_with_container(resources->jobs_buffer, jobs_data);
+        if (meshlet_culling_shader_.source.path.empty()) {
+            meshlet_culling_shader_.source.path = "/bisemutum/shaders/core/meshlet_culling.hlsl";
+            meshlet_culling_shader_.source.entry = "meshlet_culling_cs";
+            meshlet_culling_shader_.set_shader_params_struct<MeshletCullingPassParams>();
+        }
+
+        auto indirect_args = rg->add_buffer([num_total_meshlets](BufferBuilder& builder) {
+            builder.size(num_total_meshlets * sizeof(rhi::DrawIndexedIndirectCommand))
+                .usage({rhi::BufferUsage::storage_read_write, rhi::BufferUsage::indirect});
+        });
+        auto num_jobs = static_cast<uint32_t>(jobs_data.size());
+        auto indirect_counts = rg->add_buffer([num_jobs](BufferBuilder& builder) {
+            builder.size(num_jobs * sizeof(uint32_t))
+                .usage({rhi::BufferUsage::storage_read_write, rhi::BufferUsage::indirect});
+        });
+
+        auto [builder, pass_data] = rg->add_compute_pass<MeshletCullingPassData>("Meshlet Culling");
+        pass_data->indirect_args = builder.write(indirect_args);
+        pass_data->indirect_counts = builder.write(indirect_counts);
+        list.indirect_args = pass_data->indirect_args;
+        list.indirect_counts = pass_data->indirect_counts;
+
+        builder.set_execution_function<MeshletCullingPassData>(
+            [this, resources, meshlets_buffer, num_jobs, frustum_planes](
+                CRef<MeshletCullingPassData> pass_data, ComputePassContext const& ctx
+            ) {
+                auto params = resources->params.mutable_typed_data<MeshletCullingPassParams>();
+                params->num_jobs = num_jobs;
+                for (size_t i = 0; i < frustum_planes.size(); i++) {
+                    params->frustum_planes[i] = frustum_planes[i];
+                }
+                params->jobs = {&resources->jobs_buffer};
+                params->meshlets = {meshlets_buffer};
+                params->indirect_args = {ctx.rg->buffer(pass_data->indirect_args)};
+                params->indirect_counts = {ctx.rg->buffer(pass_data->indirect_counts)};
+                resources->params.update_uniform_buffer();
+                ctx.dispatch(
+                    meshlet_culling_shader_, resources->params,
+                    std::min(num_jobs, meshlet_culling_max_num_groups_x),
+                    ceil_div(num_jobs, meshlet_culling_max_num_groups_x)
+                );
+            }
+        );
     }
     auto rendered_object_list(RenderedObjectListHandle handle) const -> CRef<RenderedObjectList> {
         return rendered_object_lists_[static_cast<size_t>(handle)];
@@ -665,6 +875,7 @@ struct RenderGraph::Impl final {
         graph_is_invalid = false;
 
         rendered_object_lists_.clear();
+        num_used_meshlet_culling_resources_ = 0;
     }
     auto add_edge(Ref<Node> from, Ref<Node> to) -> void {
         from->out_nodes.push_back(to);
@@ -777,6 +988,14 @@ struct RenderGraph::Impl final {
     bool graph_is_invalid = false;
 
     std::vector<RenderedObjectList> rendered_object_lists_;
+
+    struct MeshletCullingResources final {
+        Buffer jobs_buffer;
+        ShaderParameter params;
+    };
+    std::vector<Box<MeshletCullingResources>> meshlet_culling_resources_;
+    size_t num_used_meshlet_culling_resources_ = 0;
+    ComputeShader meshlet_culling_shader_;
 };
 
 auto RenderGraph::Impl::BufferNode::create(RenderGraph::Impl& rg) -> void {
@@ -1296,7 +1515,7 @@ auto RenderGraph::add_blit_pass(
 }
 
 auto RenderGraph::add_rendered_object_list(RenderedObjectListDesc const& desc) -> RenderedObjectListHandle {
-    return impl()->add_rendered_object_list(desc);
+    return impl()->add_rendered_object_list(this, desc);
 }
 
 auto RenderGraph::set_graphics_device(Ref<rhi::Device> device, uint32_t num_frames) -> void {
@@ -269,7 +269,8 @@ auto GraphicsPassContext::render_list(RenderedObjectListHandle handle, ShaderPar
         resource_binding_ctx_->set_shader_params(
             cmd_encoder, graphics_set_fragment, graphics_set_visibility_fragment, params
         );
-        for (auto drawable : item.drawables) {
+        for (size_t i = 0; i < item.drawables.size(); i++) {
+            auto drawable = item.drawables[i];
             resource_binding_ctx_->set_shader_params(
                 cmd_encoder, graphics_set_mesh, graphics_set_visibility_mesh, drawable->shader_params
             );
@@ -279,7 +280,20 @@ auto GraphicsPassContext::render_list(RenderedObjectListHandle handle, ShaderPar
             );
             resource_binding_ctx_->set_samplers(cmd_encoder, graphics_set_samplers);
 
-            g_engine->graphics_manager()->draw_drawable(cmd_encoder, drawable);
+            if (!item.meshlet_culling_jobs.empty() && item.meshlet_culling_jobs[i] != ~0u) {
+                auto job_index = item.meshlet_culling_jobs[i];
+                auto const& job = list->meshlet_culling_jobs[job_index];
+                cmd_encoder->draw_indexed_indirect_count(
+                    rg->buffer(list->indirect_args)->rhi_buffer(),
+                    job.args_offset * sizeof(rhi::DrawIndexedIndirectCommand),
+                    rg->buffer(list->indirect_counts)->rhi_buffer(), job_index * sizeof(uint32_t),
+                    job.num_meshlets
+                );
+            } else if (!item.index_ranges.empty()) {
+                g_engine->graphics_manager()->draw_drawable(cmd_encoder, drawable, item.index_ranges[i]);
+            } else {
+                g_engine->graphics_manager()->draw_drawable(cmd_encoder, drawable);
+            }
         }
     }
 }
@@ -99,6 +99,14 @@ auto GraphicsPassBuilder::read(AccelerationStructureHandle handle) -> Accelerati
     handle = rg_->add_read_edge(pass_index_, handle);
     return handle;
 }
+auto GraphicsPassBuilder::read(RenderedObjectListHandle handle) -> RenderedObjectListHandle {
+    auto list = rg_->rendered_object_list(handle);
+    if (list->indirect_args != BufferHandle::invalid) {
+        read(list->indirect_args);
+        read(list->indirect_counts);
+    }
+    return handle;
+}
 auto GraphicsPassBuilder::write(BufferHandle handle) -> BufferHandle {
     write_buffers_.push_back(handle);
     handle = rg_->add_write_edge(pass_index_, handle);
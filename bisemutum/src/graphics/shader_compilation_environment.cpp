@@ -1,47 +1,47 @@
 #include <bisemutum/graphics/shader_compilation_environment.hpp>
 
-#include <fmt/format.h>
-
 namespace bi::gfx {
 
+namespace {
+
+auto hash_entry(std::string_view key, std::string_view value) -> uint64_t {
+    return crypto::fnv1a_64(value, crypto::fnv1a_64(key.size(), crypto::fnv1a_64(key)));
+}
+
+} // namespace
+
 auto ShaderCompilationEnvironment::set_define(std::string_view key, std::string const& defined) -> void {
-    defines.insert({std::string{key}, defined});
+    if (auto [it, inserted] = defines.insert({std::string{key}, defined}); inserted) {
+        defines_hash_ += hash_entry(it->first, it->second);
+    }
 }
 auto ShaderCompilationEnvironment::set_define(std::string_view key, std::string&& defined) -> void {
-    defines.insert({std::string{key}, std::move(defined)});
+    if (auto [it, inserted] = defines.insert({std::string{key}, std::move(defined)}); inserted) {
+        defines_hash_ += hash_entry(it->first, it->second);
+    }
 }
 auto ShaderCompilationEnvironment::reset_define(std::string_view key) -> void {
     if (auto it = defines.find(key); it != defines.end()) {
+        defines_hash_ -= hash_entry(it->first, it->second);
         defines.erase(it);
     }
 }
 
 auto ShaderCompilationEnvironment::set_replace_arg(std::string_view key, std::string const& content) -> void {
-    replace_args.insert({'$' + std::string{key}, content});
+    if (auto [it, inserted] = replace_args.insert({'$' + std::string{key}, content}); inserted) {
+        replace_args_hash_ += hash_entry(it->first, it->second);
+    }
 }
 auto ShaderCompilationEnvironment::set_replace_arg(std::string_view key, std::string&& content) -> void {
-    replace_args.insert({'$' + std::string{key}, std::move(content)});
+    if (auto [it, inserted] = replace_args.insert({'$' + std::string{key}, std::move(content)}); inserted) {
+        replace_args_hash_ += hash_entry(it->first, it->second);
+    }
 }
 auto ShaderCompilationEnvironment::reset_replace_arg(std::string_view key) -> void {
     if (auto it = replace_args.find('$' + std::string{key}); it != replace_args.end()) {
+        replace_args_hash_ -= hash_entry(it->first, it->second);
         replace_args.erase(it);
     }
 }
 
-auto ShaderCompilationEnvironment::get_config_identifier() const -> std::string {
-    size_t defines_hash = 0;
-    for (auto& [key, defined] : defines) {
-        defines_hash = hash_combine(defines_hash, hash(key, defined));
-    }
-    auto defines_hash_hex = fmt::format("{:x}", defines_hash);
-
-    size_t replace_hash = 0;
-    for (auto& [key, content] : replace_args) {
-        replace_hash = hash_combine(replace_hash, hash(key, content));
-    }
-    auto replace_hash_hex = fmt::format("{:x}", replace_hash);
-
-    return fmt::format("D{}-R{}", defines_hash_hex, replace_hash_hex);
-}
-
 }
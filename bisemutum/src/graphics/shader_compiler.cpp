@@ -1,16 +1,27 @@
 #define _SILENCE_CXX17_CODECVT_HEADER_DEPRECATION_WARNING
 #include <bisemutum/graphics/shader_compiler.hpp>
 
+#include <list>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
 #include <chrono>
 #include <locale>
 #include <codecvt>
 #include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_set>
 
 #include <fmt/format.h>
 #include <cprep/cprep.hpp>
 #include <bisemutum/engine/engine.hpp>
 #include <bisemutum/runtime/vfs.hpp>
+#include <bisemutum/runtime/thread_pool.hpp>
+#include <bisemutum/prelude/byte_stream.hpp>
 #include <bisemutum/rhi/device.hpp>
+#include <bisemutum/containers/hash.hpp>
+#include <bisemutum/utils/crypto.hpp>
 #ifdef _WIN32
 #include <wrl.h>
 template <typename T>
@@ -23,6 +34,30 @@ namespace bi::gfx {
 
 namespace {
 
+// Headers are required by paths like "dir/file.hlsl/../header.hlsl".
+auto normalize_shader_path(std::string_view path) -> std::string {
+    return std::filesystem::path{path}.lexically_normal().generic_string();
+}
+
+// Keys and hashes are saved in the binary info file, so they are hashed the same way in all builds.
+auto hash_content(std::string_view content) -> uint64_t {
+    return crypto::fnv1a_64(content);
+}
+
+auto shader_key_of(
+    std::string_view source_path, std::string_view entry, ShaderCompilationEnvironment const& environment
+) -> uint64_t {
+    auto key = crypto::fnv1a_64(source_path);
+    key = crypto::fnv1a_64(entry, crypto::fnv1a_64(source_path.size(), key));
+    return crypto::fnv1a_64(environment.config_hash(), key);
+}
+
+// A file read when preprocessing a shader, with the hash of its content at that time.
+struct ShaderDependency final {
+    std::string path;
+    uint64_t hash;
+};
+
 struct ShaderIncluder final : pep::cprep::ShaderIncluder {
     auto require_header(std::string_view header_name, std::string_view file_path, Result &result) -> bool override {
         auto vfs = g_engine->file_system();
@@ -32,6 +67,7 @@ struct ShaderIncluder final : pep::cprep::ShaderIncluder {
             loaded_files_.push_back(file.value().read_string_data());
             result.header_content = loaded_files_.back();
             result.header_path = rel_path;
+            dependencies_.push_back({normalize_shader_path(rel_path), hash_content(loaded_files_.back())});
             return true;
         }
 
@@ -39,6 +75,7 @@ struct ShaderIncluder final : pep::cprep::ShaderIncluder {
             loaded_files_.push_back(file.value().read_string_data());
             result.header_content = loaded_files_.back();
             result.header_path = header_name;
+            dependencies_.push_back({normalize_shader_path(header_name), hash_content(loaded_files_.back())});
             return true;
         }
 
@@ -49,8 +86,11 @@ struct ShaderIncluder final : pep::cprep::ShaderIncluder {
         loaded_files_.clear();
     }
 
+    auto dependencies() -> std::vector<ShaderDependency>& { return dependencies_; }
+
 private:
     std::list<std::string> loaded_files_;
+    std::vector<ShaderDependency> dependencies_;
 };
 
 auto chars_to_wstring(std::string_view str) -> std::wstring {
@@ -61,10 +101,20 @@ auto chars_to_wstring(std::string_view str) -> std::wstring {
 constexpr std::string_view shader_binaries_directory = "/project/binaries/shaders/";
 constexpr std::string_view shader_binary_info_file_path = "/project/binaries/shaders/binary_info.db";
 constexpr uint32_t shader_binary_info_file_magic_number = 0x5373d269;
+// 2: numeric shader keys, 3: keys and hashes are FNV-1a.
+constexpr uint32_t shader_binary_info_file_version = 3;
 
 } // namespace
 
 struct ShaderCompiler::Impl final {
+    // DXC compilers and the preprocessor are not thread-safe, so each compiling thread takes its own ones.
+    struct CompilerContext final {
+        CComPtr<IDxcUtils> dxc_utils;
+        CComPtr<IDxcCompiler3> dxc_compiler;
+        CComPtr<IDxcIncludeHandler> dxc_include_handler;
+        pep::cprep::Preprocessor shader_preprocessor;
+    };
+
     ~Impl() {
         save_shader_binary_info_file();
     }
@@ -73,6 +123,7 @@ struct ShaderCompiler::Impl final {
         this->device = device;
         switch (device->get_backend()) {
             case rhi::Backend::vulkan:
+            case rhi::Backend::null:
                 compiled_shader_suffix = ".spv";
                 break;
             case rhi::Backend::d3d12:
@@ -81,52 +132,137 @@ struct ShaderCompiler::Impl final {
         }
 
         read_shader_binary_info_file();
+    }
+
+    auto compile_shader(
+        std::string_view source_path,
+        std::string_view entry,
+        rhi::ShaderStage shader_stage,
+        ShaderCompilationEnvironment const& environment
+    ) -> ShaderCompilationResult {
+        auto shader_key = shader_key_of(source_path, entry, environment);
+        // The same shader is compiled by one thread at a time, so that its binary file is not read while written.
+        // Waiting threads then find the cached module.
+        {
+            std::unique_lock lock{mutex};
+            compiling_cv.wait(lock, [this, shader_key]() { return !compiling_keys.contains(shader_key); });
+            compiling_keys.insert(shader_key);
+        }
 
-        DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&dxc_utils));
-        DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&dxc_compiler));
+        auto context = acquire_context();
+        auto result = compile_shader_with(*context, shader_key, source_path, entry, shader_stage, environment);
+        release_context(std::move(context));
+
+        {
+            std::lock_guard lock{mutex};
+            compiling_keys.erase(shader_key);
+            if (result && compiled_request_keys.insert(shader_key).second) {
+                compiled_requests.push_back({std::string{source_path}, std::string{entry}, shader_stage, environment});
+            }
+        }
+        compiling_cv.notify_all();
+        return result;
+    }
 
-        dxc_utils->CreateDefaultIncludeHandler(&dxc_include_handler);
+    auto compile_shader_async(
+        std::vector<ShaderCompilationRequest>&& requests
+    ) -> std::future<std::vector<ShaderCompilationResult>> {
+        auto thread_pool = g_engine->thread_pool();
+        return thread_pool->async([this, thread_pool, requests = std::move(requests)]() {
+            std::vector<ShaderCompilationResult> results(requests.size(), std::string{});
+            thread_pool->parallel_for(requests.size(), [this, &requests, &results](size_t index) {
+                auto const& request = requests[index];
+                results[index] = compile_shader(
+                    request.source_path, request.entry, request.shader_stage, request.environment
+                );
+            });
+            return results;
+        });
     }
 
-    auto compile_shader(
+    auto compile_shader_with(
+        CompilerContext& context,
+        uint64_t shader_key,
         std::string_view source_path,
         std::string_view entry,
         rhi::ShaderStage shader_stage,
         ShaderCompilationEnvironment const& environment
-    ) -> Expected<Ref<rhi::ShaderModule>, std::string> {
-        auto shader_source = process_shader_include_and_macro(source_path, environment);
+    ) -> ShaderCompilationResult {
+        // Never moved or removed while compiling.
+        Ptr<ShaderBinaryInfo> shader_binary_info;
+        std::string shader_binary_path;
+        std::vector<ShaderDependency> recorded_dependencies;
+        uint64_t recorded_shader_hash = 0;
+        {
+            std::lock_guard lock{mutex};
+            auto& info = get_shader_binary_info(shader_key, source_path, entry);
+            shader_binary_info = info;
+            shader_binary_path = get_compiled_shader_path(info);
+            recorded_dependencies = info.dependencies;
+            recorded_shader_hash = info.shader_hash;
+        }
+
+        // The preprocessed source is the same if none of the included files is changed,
+        // so preprocessing is skipped until the source is really needed by DXC.
+        auto is_source_unchanged = !recorded_dependencies.empty() && std::all_of(
+            recorded_dependencies.begin(), recorded_dependencies.end(),
+            [this](ShaderDependency const& dependency) {
+                auto hash = get_file_hash(dependency.path);
+                return hash && hash.value() == dependency.hash;
+            }
+        );
+        // Dependencies and hash of the source are recorded in the binary info only when they match the binary file,
+        // so a failed compilation is reported again next time instead of loading the binary of an older source.
+        std::string shader_source;
+        std::vector<ShaderDependency> dependencies;
+        uint64_t shader_hash = 0;
+        bool is_preprocessed = false;
+        auto preprocess = [&]() {
+            shader_source = process_shader_include_and_macro(
+                context.shader_preprocessor, source_path, environment, dependencies
+            );
+            is_preprocessed = true;
+            shader_hash = hash_content(shader_source);
+            std::lock_guard lock{mutex};
+            for (auto const& dependency : dependencies) {
+                file_hashes.try_emplace(dependency.path, dependency.hash);
+            }
+            return recorded_shader_hash != shader_hash;
+        };
+        auto record_source = [&]() {
+            std::lock_guard lock{mutex};
+            shader_binary_info->dependencies = std::move(dependencies);
+            shader_binary_info->shader_hash = shader_hash;
+        };
+
+        auto need_to_compile = is_source_unchanged ? false : preprocess();
+        if (!need_to_compile) {
+            // Headers are changed but the preprocessed source is not.
+            if (is_preprocessed && !dependencies.empty()) {
+                record_source();
+            }
+            {
+                std::lock_guard lock{mutex};
+                if (auto it = cached_shader_module.find(shader_key); it != cached_shader_module.end()) {
+                    return it->second.ref();
+                }
+            }
+            if (auto compiled_shader_file = g_engine->file_system()->get_file(shader_binary_path); compiled_shader_file) {
+                auto compiled_shader = compiled_shader_file.value().map_binary_data();
+                rhi::ShaderModuleDesc sm_desc{
+                    .binary_data = compiled_shader,
+                };
+                return cache_shader_module(shader_key, device->create_shader_module(sm_desc));
+            }
+        }
+        if (!is_preprocessed) {
+            preprocess();
+        }
         DxcBuffer dxc_source{
             .Ptr = shader_source.c_str(),
             .Size = shader_source.size(),
             .Encoding = DXC_CP_UTF8,
         };
-        auto shader_key = fmt::format("{} {} {}", source_path, entry, environment.get_config_identifier());
-        auto& shader_binary_info = get_shader_binary_info(std::move(shader_key));
-        shader_binary_info.source_path = source_path;
-        shader_binary_info.entry = entry;
-        auto shader_hash = std::hash<std::string>{}(shader_source);
-        auto old_shader_binary_path = get_compiled_shader_path(shader_binary_info);
-        auto need_to_compile = shader_binary_info.shader_hash != shader_hash;
-        shader_binary_info.shader_hash = shader_hash;
-        auto shader_binary_path = get_compiled_shader_path(shader_binary_info);
-        auto compiled_shader_file = g_engine->file_system()->get_file(shader_binary_path);
-        need_to_compile |= !compiled_shader_file.has_value();
-        if (need_to_compile && g_engine->file_system()->has_file(old_shader_binary_path)) {
-            g_engine->file_system()->remove_file(old_shader_binary_path);
-        }
-        if (!need_to_compile) {
-            if (auto it = cached_shader_module.find(shader_binary_info.shader_key); it != cached_shader_module.end()) {
-                return it->second.ref();
-            }
-            auto compiled_shader = compiled_shader_file.value().read_binary_data();
-            rhi::ShaderModuleDesc sm_desc{
-                .binary_data = compiled_shader,
-            };
-            auto it = cached_shader_module.insert(
-                {shader_binary_info.shader_key, device->create_shader_module(sm_desc)}
-            ).first;
-            return it->second.ref();
-        }
 
         std::list<std::wstring> owned_args{};
         std::vector<LPCWSTR> args{
@@ -175,7 +311,9 @@ struct ShaderCompiler::Impl final {
         }
 
         CComPtr<IDxcResult> result;
-        dxc_compiler->Compile(&dxc_source, args.data(), args.size(), dxc_include_handler.Get(), IID_PPV_ARGS(&result));
+        context.dxc_compiler->Compile(
+            &dxc_source, args.data(), args.size(), context.dxc_include_handler.Get(), IID_PPV_ARGS(&result)
+        );
 
         HRESULT result_status;
         result->GetStatus(&result_status);
@@ -197,22 +335,101 @@ struct ShaderCompiler::Impl final {
                     reinterpret_cast<std::byte*>(compiled_shader->GetBufferPointer()), compiled_shader->GetBufferSize()
                 },
             };
-            auto it = cached_shader_module.insert(
-                {shader_binary_info.shader_key, device->create_shader_module(sm_desc)}
-            ).first;
-            return it->second.ref();
+            auto file = g_engine->file_system()->create_file(shader_binary_path);
+            if (file && file.value().write_binary_data(sm_desc.binary_data)) {
+                record_source();
+            }
+            return cache_shader_module(shader_key, device->create_shader_module(sm_desc));
         }
 
         return std::string{"Unknown compilation error."};
     }
 
+    // Modules compiled again replace cached ones only after they are invalidated, so the first cached module is kept.
+    auto cache_shader_module(
+        uint64_t shader_key, Box<rhi::ShaderModule>&& shader_module
+    ) -> Ref<rhi::ShaderModule> {
+        std::lock_guard lock{mutex};
+        return cached_shader_module.try_emplace(shader_key, std::move(shader_module)).first->second.ref();
+    }
+
+    auto acquire_context() -> Box<CompilerContext> {
+        {
+            std::lock_guard lock{contexts_mutex};
+            if (!free_contexts.empty()) {
+                auto context = std::move(free_contexts.back());
+                free_contexts.pop_back();
+                return context;
+            }
+        }
+        auto context = Box<CompilerContext>::make();
+        DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&context->dxc_utils));
+        DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&context->dxc_compiler));
+        context->dxc_utils->CreateDefaultIncludeHandler(&context->dxc_include_handler);
+        return context;
+    }
+    auto release_context(Box<CompilerContext>&& context) -> void {
+        std::lock_guard lock{contexts_mutex};
+        free_contexts.push_back(std::move(context));
+    }
+
+    auto get_compiled_requests() -> std::vector<ShaderCompilationRequest> {
+        std::lock_guard lock{mutex};
+        return compiled_requests;
+    }
+
+    auto invalidate_changed_files(CSpan<std::string> changed_paths) -> std::vector<Box<rhi::ShaderModule>> {
+        std::lock_guard lock{mutex};
+        StringHashSet changed_paths_set{changed_paths.begin(), changed_paths.end()};
+        // Changed files are hashed again when shaders using them are compiled next time.
+        for (auto const& path : changed_paths) {
+            file_hashes.erase(path);
+        }
+        std::vector<Box<rhi::ShaderModule>> invalidated_modules{};
+        for (auto it = cached_shader_module.begin(); it != cached_shader_module.end();) {
+            auto const& dependencies = shader_binary_infos[shader_binary_info_path_map.at(it->first)].dependencies;
+            auto is_changed = std::any_of(
+                dependencies.begin(), dependencies.end(),
+                [&changed_paths_set](ShaderDependency const& dependency) {
+                    return changed_paths_set.contains(dependency.path);
+                }
+            );
+            if (!is_changed) {
+                ++it;
+                continue;
+            }
+            invalidated_modules.push_back(std::move(it->second));
+            it = cached_shader_module.erase(it);
+        }
+        return invalidated_modules;
+    }
+
+    // Hashes are cached until the file is reported to be changed, so each file is read at most once.
+    auto get_file_hash(std::string const& path) -> Option<uint64_t> {
+        {
+            std::lock_guard lock{mutex};
+            if (auto it = file_hashes.find(path); it != file_hashes.end()) {
+                return it->second;
+            }
+        }
+        auto file = g_engine->file_system()->get_file(path);
+        if (!file) { return {}; }
+        auto hash = hash_content(file.value().read_string_data());
+        std::lock_guard lock{mutex};
+        file_hashes.insert_or_assign(path, hash);
+        return hash;
+    }
+
     auto process_shader_include_and_macro(
+        pep::cprep::Preprocessor& shader_preprocessor,
         std::string_view source_path,
-        ShaderCompilationEnvironment const& environment
+        ShaderCompilationEnvironment const& environment,
+        std::vector<ShaderDependency>& dependencies
     ) -> std::string {
         auto vfs = g_engine->file_system();
         auto file = vfs->get_file(source_path);
         auto shader_content = file.value().read_string_data();
+        auto shader_content_hash = hash_content(shader_content);
 
         std::list<std::string> options_owned_str{};
         std::vector<std::string_view> options(environment.defines.size() * 2);
@@ -235,8 +452,11 @@ struct ShaderCompiler::Impl final {
             source_path, shader_content, shader_includer, options.data(), options.size()
         );
         if (!result.error.empty()) {
+            // Leave dependencies empty so that it's always preprocessed again.
             return "";
         }
+        dependencies = std::move(shader_includer.dependencies());
+        dependencies.push_back({normalize_shader_path(source_path), shader_content_hash});
 
         for (auto const& [key, content] : environment.replace_args) {
             for (
@@ -251,47 +471,52 @@ struct ShaderCompiler::Impl final {
     }
 
     struct ShaderBinaryInfo final {
-        std::string shader_key;
+        uint64_t shader_key;
         std::string source_path;
         std::string entry;
         uint64_t shader_hash;
         uint64_t last_used_timestamp;
+        // Empty if the shader is not preprocessed successfully yet.
+        std::vector<ShaderDependency> dependencies;
     };
 
     auto read_shader_binary_info_file() -> void {
         auto file = g_engine->file_system()->get_file(shader_binary_info_file_path);
-        if (file) {
-            auto data = file.value().read_binary_data();
-            auto p_data = data.data();
-            auto p_data_end = p_data + data.size();
-
-            auto magic_number = *reinterpret_cast<uint32_t*>(p_data);
-            p_data += sizeof(uint32_t);
-            if (magic_number != shader_binary_info_file_magic_number) { return; }
-
-            auto num_info = *reinterpret_cast<uint32_t*>(p_data);
-            p_data += sizeof(uint32_t);
-
-            shader_binary_infos.resize(num_info);
-            shader_binary_info_path_map.reserve(num_info);
-            for (uint32_t i = 0; i < num_info; i++) {
-                auto path_length = *reinterpret_cast<uint32_t*>(p_data);
-                p_data += sizeof(uint32_t);
-                shader_binary_infos[i].source_path = std::string{reinterpret_cast<char*>(p_data), path_length};
-                p_data += path_length;
-                auto entry_length = *reinterpret_cast<uint32_t*>(p_data);
-                p_data += sizeof(uint32_t);
-                shader_binary_infos[i].entry = std::string{reinterpret_cast<char*>(p_data), entry_length};
-                p_data += entry_length;
-                shader_binary_infos[i].shader_hash = *reinterpret_cast<uint64_t*>(p_data);
-                p_data += sizeof(uint64_t);
-                shader_binary_infos[i].last_used_timestamp = *reinterpret_cast<uint64_t*>(p_data);
-                p_data += sizeof(uint64_t);
-                shader_binary_info_path_map.insert({shader_binary_infos[i].shader_key, i});
+        if (!file) { return; }
+
+        ReadByteStream bs{file.value().read_binary_data()};
+        uint32_t magic_number = 0;
+        uint32_t version = 0;
+        uint64_t num_info = 0;
+        bs.read(magic_number).read(version).read(num_info);
+        if (
+            magic_number != shader_binary_info_file_magic_number || version != shader_binary_info_file_version
+        ) {
+            return;
+        }
+
+        for (uint64_t i = 0; i < num_info && bs.curr_offset() < bs.size(); i++) {
+            auto& info = shader_binary_infos.emplace_back();
+            bs.read(info.shader_key).read(info.source_path).read(info.entry);
+            bs.read(info.shader_hash).read(info.last_used_timestamp);
+            uint64_t num_dependencies = 0;
+            bs.read(num_dependencies);
+            info.dependencies.resize(num_dependencies);
+            for (auto& dependency : info.dependencies) {
+                bs.read(dependency.path).read(dependency.hash);
             }
+            if (bs.curr_offset() > bs.size()) {
+                shader_binary_infos.pop_back();
+                break;
+            }
+        }
+        shader_binary_info_path_map.reserve(shader_binary_infos.size());
+        for (size_t i = 0; i < shader_binary_infos.size(); i++) {
+            shader_binary_info_path_map.insert({shader_binary_infos[i].shader_key, i});
         }
     }
 
+    // Indices in the map are not valid anymore after saving since binary infos are sorted.
     auto save_shader_binary_info_file() -> void {
         std::sort(
             shader_binary_infos.begin(), shader_binary_infos.end(),
@@ -305,20 +530,39 @@ struct ShaderCompiler::Impl final {
             auto const& info = shader_binary_infos.back();
             if (info.last_used_timestamp < remove_time_threshold) {
                 g_engine->file_system()->remove_file(get_compiled_shader_path(info));
-                shader_binary_info_path_map.erase(info.shader_key);
                 shader_binary_infos.pop_back();
             } else {
                 break;
             }
         }
-        // TODO - write file
+
+        WriteByteStream bs{};
+        bs.write(shader_binary_info_file_magic_number)
+            .write(shader_binary_info_file_version)
+            .write(static_cast<uint64_t>(shader_binary_infos.size()));
+        for (auto const& info : shader_binary_infos) {
+            bs.write(info.shader_key).write(info.source_path).write(info.entry);
+            bs.write(info.shader_hash).write(info.last_used_timestamp);
+            bs.write(static_cast<uint64_t>(info.dependencies.size()));
+            for (auto const& dependency : info.dependencies) {
+                bs.write(dependency.path).write(dependency.hash);
+            }
+        }
+        if (auto file = g_engine->file_system()->create_file(shader_binary_info_file_path); file) {
+            file.value().write_binary_data(bs.data());
+        }
     }
 
+    // Variants of the same source are compiled to different binaries.
     auto get_compiled_shader_path(ShaderBinaryInfo const& info) -> std::string {
-        return fmt::format("{}{}{}", shader_binaries_directory, info.source_path, compiled_shader_suffix);
+        return fmt::format(
+            "{}{}.{:016x}{}", shader_binaries_directory, info.source_path, info.shader_key, compiled_shader_suffix
+        );
     }
 
-    auto get_shader_binary_info(std::string&& shader_key) -> ShaderBinaryInfo& {
+    auto get_shader_binary_info(
+        uint64_t shader_key, std::string_view source_path, std::string_view entry
+    ) -> ShaderBinaryInfo& {
         auto timestamp = std::chrono::system_clock::now().time_since_epoch().count();
         if (auto it = shader_binary_info_path_map.find(shader_key); it != shader_binary_info_path_map.end()) {
             auto& info = shader_binary_infos[it->second];
@@ -326,25 +570,34 @@ struct ShaderCompiler::Impl final {
             return info;
         }
         auto& info = shader_binary_infos.emplace_back();
-        info.shader_key = std::move(shader_key);
+        info.shader_key = shader_key;
+        info.source_path = source_path;
+        info.entry = entry;
         info.shader_hash = 0;
         info.last_used_timestamp = timestamp;
-        shader_binary_info_path_map.insert({info.shader_key, shader_binary_infos.size()});
+        shader_binary_info_path_map.insert({info.shader_key, shader_binary_infos.size() - 1});
         return info;
     }
 
     Ptr<rhi::Device> device;
     std::string_view compiled_shader_suffix;
 
-    CComPtr<IDxcUtils> dxc_utils;
-    CComPtr<IDxcCompiler3> dxc_compiler;
-    CComPtr<IDxcIncludeHandler> dxc_include_handler;
-
-    pep::cprep::Preprocessor shader_preprocessor;
-
-    std::vector<ShaderBinaryInfo> shader_binary_infos;
-    std::unordered_map<std::string_view, size_t> shader_binary_info_path_map;
-    std::unordered_map<std::string_view, Box<rhi::ShaderModule>> cached_shader_module;
+    std::vector<Box<CompilerContext>> free_contexts;
+    std::mutex contexts_mutex;
+
+    // Guards binary infos, cached modules, file hashes and compiled requests.
+    std::mutex mutex;
+    // Binary infos are referenced while compiling without the lock, so a deque is used to keep them in place.
+    std::deque<ShaderBinaryInfo> shader_binary_infos;
+    std::unordered_map<uint64_t, size_t> shader_binary_info_path_map;
+    std::unordered_map<uint64_t, Box<rhi::ShaderModule>> cached_shader_module;
+    // Content hashes of source and header files read in this session.
+    StringHashMap<uint64_t> file_hashes;
+    std::vector<ShaderCompilationRequest> compiled_requests;
+    // Keys of shaders being compiled, guarded by the mutex too.
+    std::unordered_set<uint64_t> compiling_keys;
+    std::condition_variable compiling_cv;
+    std::unordered_set<uint64_t> compiled_request_keys;
 };
 
 ShaderCompiler::ShaderCompiler() = default;
@@ -358,8 +611,24 @@ auto ShaderCompiler::compile_shader(
     std::string_view entry,
     rhi::ShaderStage shader_stage,
     ShaderCompilationEnvironment const& environment
-) -> Expected<Ref<rhi::ShaderModule>, std::string> {
+) -> ShaderCompilationResult {
     return impl()->compile_shader(source_path, entry, shader_stage, environment);
 }
 
+auto ShaderCompiler::compile_shader_async(
+    std::vector<ShaderCompilationRequest> requests
+) -> std::future<std::vector<ShaderCompilationResult>> {
+    return impl()->compile_shader_async(std::move(requests));
+}
+
+auto ShaderCompiler::compiled_requests() -> std::vector<ShaderCompilationRequest> {
+    return impl()->get_compiled_requests();
+}
+
+auto ShaderCompiler::invalidate_changed_files(
+    CSpan<std::string> changed_paths
+) -> std::vector<Box<rhi::ShaderModule>> {
+    return impl()->invalidate_changed_files(changed_paths);
+}
+
 }
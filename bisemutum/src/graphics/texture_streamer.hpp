@@ -0,0 +1,50 @@
+#pragma once
+
+#include <limits>
+#include <unordered_map>
+
+#include <bisemutum/graphics/texture_streaming.hpp>
+#include <bisemutum/containers/slotmap.hpp>
+
+namespace bi::gfx {
+
+struct Camera;
+struct Drawable;
+
+struct TextureStreamer final {
+    auto initialize(TextureStreamingSettings const& settings) -> void;
+
+    auto settings() const -> TextureStreamingSettings const& { return settings_; }
+
+    auto add(StreamedTextureDesc&& desc) -> StreamedTextureHandle;
+    auto remove(StreamedTextureHandle handle) -> void;
+
+    // Record texel footprints of textures used by `drawable` when rendered by `camera`.
+    auto record_usage(CRef<Camera> camera, CRef<Drawable> drawable) -> void;
+
+    // Decide resident levels from usages recorded in the last frame and update textures.
+    // It should be called when commands of current frame are being recorded.
+    auto update() -> void;
+
+private:
+    auto required_level(StreamedTextureHandle handle, float uv_per_pixel) const -> uint32_t;
+
+    struct StreamedTextureData final {
+        StreamedTextureDesc desc;
+        // Size of levels from each level to the last one.
+        std::vector<uint64_t> resident_sizes;
+        uint32_t tail_level = 0;
+        uint32_t first_level = 0;
+        uint32_t wanted_level = 0;
+        uint64_t last_used_frame = 0;
+        // Smallest texcoord difference between adjacent pixels recorded in this frame.
+        float min_uv_per_pixel = std::numeric_limits<float>::max();
+    };
+
+    TextureStreamingSettings settings_;
+    SlotMap<StreamedTextureData, StreamedTextureHandle> textures_;
+    std::unordered_map<Texture const*, StreamedTextureHandle> texture_handles_;
+    uint64_t frame_ = 0;
+};
+
+}
@@ -0,0 +1,193 @@
+#include <bisemutum/graphics/texture_streaming.hpp>
+
+#include <cmath>
+#include <algorithm>
+
+#include <bisemutum/engine/engine.hpp>
+#include <bisemutum/graphics/graphics_manager.hpp>
+#include <bisemutum/graphics/camera.hpp>
+#include <bisemutum/graphics/drawable.hpp>
+
+#include "texture_streamer.hpp"
+
+namespace bi::gfx {
+
+auto streamed_texture_tail_level(
+    TextureStreamingSettings const& settings, uint32_t width, uint32_t height, uint32_t num_levels
+) -> uint32_t {
+    auto max_size = std::max(width, height);
+    uint32_t tail_level = 0;
+    while (settings.enabled && tail_level + 1 < num_levels && (max_size >> tail_level) > settings.tail_size) {
+        ++tail_level;
+    }
+    return tail_level;
+}
+
+StreamedTexture::StreamedTexture(StreamedTextureDesc desc) {
+    handle_ = g_engine->graphics_manager()->add_streamed_texture(std::move(desc));
+}
+
+StreamedTexture::~StreamedTexture() {
+    reset();
+}
+
+StreamedTexture::StreamedTexture(StreamedTexture&& rhs) noexcept : handle_(rhs.handle_) {
+    rhs.handle_ = StreamedTextureHandle::invalid;
+}
+
+auto StreamedTexture::operator=(StreamedTexture&& rhs) noexcept -> StreamedTexture& {
+    if (this != &rhs) {
+        reset();
+        handle_ = rhs.handle_;
+        rhs.handle_ = StreamedTextureHandle::invalid;
+    }
+    return *this;
+}
+
+auto StreamedTexture::reset() -> void {
+    if (handle_ != StreamedTextureHandle::invalid) {
+        g_engine->graphics_manager()->remove_streamed_texture(handle_);
+        handle_ = StreamedTextureHandle::invalid;
+    }
+}
+
+auto TextureStreamer::initialize(TextureStreamingSettings const& settings) -> void {
+    settings_ = settings;
+}
+
+auto TextureStreamer::add(StreamedTextureDesc&& desc) -> StreamedTextureHandle {
+    StreamedTextureData data{.desc = std::move(desc)};
+    auto num_levels = static_cast<uint32_t>(data.desc.level_sizes.size());
+    data.resident_sizes.resize(num_levels + 1, 0);
+    for (auto level = num_levels; level > 0; level--) {
+        data.resident_sizes[level - 1] = data.resident_sizes[level] + data.desc.level_sizes[level - 1];
+    }
+    // All levels stay resident if streaming is disabled.
+    data.tail_level = streamed_texture_tail_level(settings_, data.desc.width, data.desc.height, num_levels);
+    data.first_level = data.tail_level;
+    data.wanted_level = data.tail_level;
+    data.last_used_frame = frame_;
+
+    auto texture = data.desc.texture.get();
+    auto handle = textures_.insert(std::move(data));
+    texture_handles_.insert({texture, handle});
+    auto& inserted = textures_.get(handle);
+    inserted.desc.update_levels(inserted.first_level);
+    return handle;
+}
+
+auto TextureStreamer::remove(StreamedTextureHandle handle) -> void {
+    if (auto data = textures_.try_get(handle); data) {
+        texture_handles_.erase(data->desc.texture.get());
+        textures_.remove(handle);
+    }
+}
+
+auto TextureStreamer::record_usage(CRef<Camera> camera, CRef<Drawable> drawable) -> void {
+    if (texture_handles_.empty() || !drawable->material) { return; }
+    auto const& target = camera->target_texture();
+    if (!target.has_value()) { return; }
+
+    // Size of a pixel at the closest point of the drawable, 0 if the camera is inside it.
+    // Pixels of orthographic cameras have the same size at any distance.
+    auto pixel_size = 0.0f;
+    if (camera->projection_type == ProjectionType::perspective) {
+        auto bbox = drawable->bounding_box();
+        auto closest_point = math::clamp(camera->position, bbox.p_min, bbox.p_max);
+        pixel_size = 2.0f * std::tan(math::radians(camera->yfov * 0.5f))
+            * math::distance(camera->position, closest_point) / target.desc().extent.height;
+    } else {
+        pixel_size = 2.0f * camera->ortho_half_height() / target.desc().extent.height;
+    }
+    auto const& scaling = drawable->transform.scaling;
+    auto max_scaling = std::max({std::abs(scaling.x), std::abs(scaling.y), std::abs(scaling.z)});
+    auto texcoord_density = drawable->mesh->get_mesh_data().submesh_texcoord_density(drawable->submesh_index);
+    auto uv_per_pixel = max_scaling > 0.0f ? texcoord_density * pixel_size / max_scaling : 0.0f;
+
+    for (auto const& [_, texture] : drawable->material->texture_params) {
+        if (auto it = texture_handles_.find(texture.get()); it != texture_handles_.end()) {
+            auto& data = textures_.get(it->second);
+            data.min_uv_per_pixel = std::min(data.min_uv_per_pixel, uv_per_pixel);
+        }
+    }
+}
+
+auto TextureStreamer::required_level(StreamedTextureHandle handle, float uv_per_pixel) const -> uint32_t {
+    auto const& data = textures_.get(handle);
+    auto texels_per_pixel = std::max(data.desc.width, data.desc.height) * uv_per_pixel;
+    if (texels_per_pixel <= 1.0f) { return 0; }
+    return std::min(static_cast<uint32_t>(std::log2(texels_per_pixel)), data.tail_level);
+}
+
+auto TextureStreamer::update() -> void {
+    if (!settings_.enabled) { return; }
+    ++frame_;
+
+    uint32_t max_tail_level = 0;
+    for (auto [handle, data] : textures_.pairs()) {
+        if (data->min_uv_per_pixel < std::numeric_limits<float>::max()) {
+            data->wanted_level = required_level(handle, data->min_uv_per_pixel);
+            data->last_used_frame = frame_;
+            data->min_uv_per_pixel = std::numeric_limits<float>::max();
+        } else if (frame_ - data->last_used_frame > settings_.num_unused_frames_to_evict) {
+            data->wanted_level = data->tail_level;
+        }
+        max_tail_level = std::max(max_tail_level, data->tail_level);
+    }
+
+    // Drop the same number of top levels from all textures until they fit in the budget.
+    uint32_t level_bias = 0;
+    for (; level_bias < max_tail_level; level_bias++) {
+        uint64_t total_size = 0;
+        for (auto const& data : textures_) {
+            total_size += data.resident_sizes[std::min(data.wanted_level + level_bias, data.tail_level)];
+        }
+        if (total_size <= settings_.memory_budget) { break; }
+    }
+
+    std::vector<std::pair<StreamedTextureHandle, uint32_t>> evictions{};
+    std::vector<std::pair<StreamedTextureHandle, uint32_t>> stream_ins{};
+    for (auto [handle, data] : textures_.pairs()) {
+        auto target_level = std::min(data->wanted_level + level_bias, data->tail_level);
+        if (target_level > data->first_level) {
+            evictions.emplace_back(handle, target_level);
+        } else if (target_level < data->first_level) {
+            stream_ins.emplace_back(handle, target_level);
+        }
+    }
+
+    // Remaining levels are uploaded again when levels are dropped, so evictions share the upload budget.
+    // They go first to free memory for stream-ins, and the largest textures free the most.
+    std::sort(evictions.begin(), evictions.end(), [this](auto const& a, auto const& b) {
+        return textures_.get(a.first).resident_sizes[textures_.get(a.first).first_level]
+            > textures_.get(b.first).resident_sizes[textures_.get(b.first).first_level];
+    });
+    uint64_t upload_size = 0;
+    for (auto [handle, target_level] : evictions) {
+        auto& data = textures_.get(handle);
+        auto size = data.resident_sizes[target_level];
+        if (upload_size > 0 && upload_size + size > settings_.max_upload_size_per_frame) {
+            // Textures can't be streamed in before the memory is freed.
+            return;
+        }
+        if (!data.desc.update_levels(target_level)) { continue; }
+        upload_size += size;
+        data.first_level = target_level;
+    }
+
+    // Textures missing most levels are streamed in first.
+    std::sort(stream_ins.begin(), stream_ins.end(), [this](auto const& a, auto const& b) {
+        return textures_.get(a.first).first_level - a.second > textures_.get(b.first).first_level - b.second;
+    });
+    for (auto [handle, target_level] : stream_ins) {
+        auto& data = textures_.get(handle);
+        auto size = data.resident_sizes[target_level];
+        if (upload_size > 0 && upload_size + size > settings_.max_upload_size_per_frame) { break; }
+        // Levels may still be read from files, they are uploaded in later frames.
+        if (!data.desc.update_levels(target_level)) { continue; }
+        upload_size += size;
+        data.first_level = target_level;
+    }
+}
+
+}
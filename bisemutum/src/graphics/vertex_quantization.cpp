@@ -0,0 +1,88 @@
+#include <bisemutum/graphics/vertex_quantization.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace bi::gfx {
+
+namespace {
+
+// Same as `oct_encode()` and `oct_decode()` in 'pack.hlsl'.
+auto oct_encode(float3 n) -> float2 {
+    n /= std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (n.z < 0.0f) {
+        return float2{
+            (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+            (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f),
+        };
+    }
+    return float2{n.x, n.y};
+}
+auto oct_decode(float2 f) -> float3 {
+    float3 n{f.x, f.y, 1.0f - std::abs(f.x) - std::abs(f.y)};
+    auto t = math::clamp(-n.z, 0.0f, 1.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return math::normalize(n);
+}
+
+auto is_valid_direction(float3 const& v) -> bool {
+    auto length = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+    return length > 0.0f && std::isfinite(length);
+}
+
+} // namespace
+
+auto position_quantization_of(BoundingBox const& bbox) -> PositionQuantization {
+    // Boxes of flat meshes, e.g. planes, count as empty in `BoundingBox::is_empty()` but are quantized as well.
+    if (math::any(math::greaterThan(bbox.p_min, bbox.p_max))) { return {}; }
+    // Keep the scale non-zero for flat boxes so that dequantization is still valid.
+    return PositionQuantization{
+        .offset = bbox.p_min,
+        .scale = math::max(bbox.extent(), float3{std::numeric_limits<float>::min()}),
+    };
+}
+
+auto quantize_position(float3 const& position, PositionQuantization const& quantization) -> uint2 {
+    auto unorm = math::clamp((position - quantization.offset) / quantization.scale, 0.0f, 1.0f);
+    return uint2{
+        math::packUnorm2x16(float2{unorm.x, unorm.y}),
+        math::packUnorm2x16(float2{unorm.z, 0.0f}),
+    };
+}
+auto dequantize_position(uint2 quantized, PositionQuantization const& quantization) -> float3 {
+    auto xy = math::unpackUnorm2x16(quantized.x);
+    auto z = math::unpackUnorm2x16(quantized.y).x;
+    return quantization.offset + quantization.scale * float3{xy.x, xy.y, z};
+}
+
+auto quantize_normal(float3 const& normal) -> uint32_t {
+    if (!is_valid_direction(normal)) { return math::packSnorm2x16(float2{0.0f}); }
+    return math::packSnorm2x16(oct_encode(normal));
+}
+auto dequantize_normal(uint32_t quantized) -> float3 {
+    return oct_decode(math::unpackSnorm2x16(quantized));
+}
+
+auto quantize_tangent(float4 const& tangent) -> uint2 {
+    float3 direction{tangent.x, tangent.y, tangent.z};
+    auto encoded = is_valid_direction(direction) ? oct_encode(direction) : float2{1.0f, 0.0f};
+    return uint2{
+        math::packSnorm2x16(encoded),
+        math::packSnorm2x16(float2{tangent.w < 0.0f ? -1.0f : 1.0f, 0.0f}),
+    };
+}
+auto dequantize_tangent(uint2 quantized) -> float4 {
+    auto direction = oct_decode(math::unpackSnorm2x16(quantized.x));
+    auto handedness = math::unpackSnorm2x16(quantized.y).x < 0.0f ? -1.0f : 1.0f;
+    return float4{direction, handedness};
+}
+
+auto quantize_texcoord(float2 const& texcoord) -> uint32_t {
+    return math::packHalf2x16(texcoord);
+}
+auto dequantize_texcoord(uint32_t quantized) -> float2 {
+    return math::unpackHalf2x16(quantized);
+}
+
+}
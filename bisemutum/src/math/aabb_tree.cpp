@@ -0,0 +1,59 @@
+#include <bisemutum/math/aabb_tree.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace bi {
+
+auto AabbTree::build(CSpan<BoundingBox> boxes) -> void {
+    clear();
+    if (boxes.empty()) { return; }
+
+    boxes_.assign(boxes.begin(), boxes.end());
+    indices_.resize(boxes.size());
+    std::iota(indices_.begin(), indices_.end(), 0u);
+    nodes_.reserve(2 * boxes.size());
+    nodes_.emplace_back();
+    build_node(0, 0, static_cast<uint32_t>(boxes.size()), 1);
+}
+
+auto AabbTree::clear() -> void {
+    nodes_.clear();
+    indices_.clear();
+    boxes_.clear();
+}
+
+auto AabbTree::build_node(uint32_t node_index, uint32_t begin, uint32_t end, uint32_t depth) -> void {
+    BoundingBox bbox{};
+    BoundingBox centroid_bbox{};
+    for (uint32_t i = begin; i < end; i++) {
+        bbox.add(boxes_[indices_[i]]);
+        centroid_bbox.add(boxes_[indices_[i]].center());
+    }
+    nodes_[node_index].bbox = bbox;
+
+    auto count = end - begin;
+    auto extent = centroid_bbox.extent();
+    if (count <= max_leaf_size || depth + 1 >= max_depth || math::all(math::lessThanEqual(extent, float3(0.0f)))) {
+        nodes_[node_index].first = begin;
+        nodes_[node_index].count = count;
+        return;
+    }
+
+    auto axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+    auto mid = begin + count / 2;
+    std::nth_element(
+        indices_.begin() + begin, indices_.begin() + mid, indices_.begin() + end,
+        [this, axis](uint32_t a, uint32_t b) { return boxes_[a].center()[axis] < boxes_[b].center()[axis]; }
+    );
+
+    auto left_index = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+    nodes_.emplace_back();
+    nodes_[node_index].first = left_index;
+    nodes_[node_index].count = 0;
+    build_node(left_index, begin, mid, depth + 1);
+    build_node(left_index + 1, mid, end, depth + 1);
+}
+
+}
@@ -1,22 +1,235 @@
 #include <bisemutum/prelude/byte_stream.hpp>
 
+#include <atomic>
+
+#include <bisemutum/prelude/option.hpp>
+
 #define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
 #include <miniz.h>
+#include <zstd.h>
+#include <lz4.h>
 
 namespace bi {
 
+namespace {
+
+// Compressed parts of old assets start with the uncompressed length, which never reaches this value.
+constexpr uint64_t chunked_compressed_part_tag = ~0ull;
+
+constexpr int zstd_compression_level = 3;
+
+auto for_each_chunk(
+    ParallelFor const& parallel_for, size_t num_chunks, std::function<auto(size_t) -> void> func
+) -> void {
+    if (num_chunks > 1 && parallel_for) {
+        parallel_for(num_chunks, std::move(func));
+    } else {
+        for (size_t i = 0; i < num_chunks; i++) { func(i); }
+    }
+}
+
+// Return empty if it fails.
+auto compress_chunk(CompressionCodec codec, CSpan<std::byte> src) -> Option<std::vector<std::byte>> {
+    std::vector<std::byte> dst{};
+    switch (codec) {
+        case CompressionCodec::none:
+            dst.assign(src.begin(), src.end());
+            return dst;
+        case CompressionCodec::miniz: {
+            mz_ulong length = mz_compressBound(src.size());
+            dst.resize(length);
+            auto result = mz_compress(
+                reinterpret_cast<unsigned char*>(dst.data()), &length,
+                reinterpret_cast<unsigned char const*>(src.data()), src.size()
+            );
+            if (result != MZ_OK) { return {}; }
+            dst.resize(length);
+            return dst;
+        }
+        case CompressionCodec::zstd: {
+            dst.resize(ZSTD_compressBound(src.size()));
+            auto length = ZSTD_compress(dst.data(), dst.size(), src.data(), src.size(), zstd_compression_level);
+            if (ZSTD_isError(length)) { return {}; }
+            dst.resize(length);
+            return dst;
+        }
+        case CompressionCodec::lz4: {
+            dst.resize(LZ4_compressBound(static_cast<int>(src.size())));
+            auto length = LZ4_compress_default(
+                reinterpret_cast<char const*>(src.data()), reinterpret_cast<char*>(dst.data()),
+                static_cast<int>(src.size()), static_cast<int>(dst.size())
+            );
+            if (length <= 0) { return {}; }
+            dst.resize(length);
+            return dst;
+        }
+    }
+    return {};
+}
+
+auto decompress_chunk(CompressionCodec codec, CSpan<std::byte> src, Span<std::byte> dst) -> bool {
+    switch (codec) {
+        case CompressionCodec::none:
+            if (src.size() != dst.size()) { return false; }
+            std::copy_n(src.data(), src.size(), dst.data());
+            return true;
+        case CompressionCodec::miniz: {
+            mz_ulong length = dst.size();
+            auto result = mz_uncompress(
+                reinterpret_cast<unsigned char*>(dst.data()), &length,
+                reinterpret_cast<unsigned char const*>(src.data()), src.size()
+            );
+            return result == MZ_OK && length == dst.size();
+        }
+        case CompressionCodec::zstd: {
+            auto length = ZSTD_decompress(dst.data(), dst.size(), src.data(), src.size());
+            return !ZSTD_isError(length) && length == dst.size();
+        }
+        case CompressionCodec::lz4: {
+            auto length = LZ4_decompress_safe(
+                reinterpret_cast<char const*>(src.data()), reinterpret_cast<char*>(dst.data()),
+                static_cast<int>(src.size()), static_cast<int>(dst.size())
+            );
+            return length >= 0 && static_cast<size_t>(length) == dst.size();
+        }
+    }
+    return false;
+}
+
+// Decompress chunks of a compressed part when they are read.
+struct ChunkedDecompressionSource final {
+    CompressionCodec codec;
+    uint64_t data_length;
+    uint64_t chunk_size;
+    // Offsets of compressed chunks, with the total size at the end.
+    std::vector<uint64_t> chunk_offsets;
+    std::vector<std::byte> owned_compressed_data;
+    CSpan<std::byte> compressed_data;
+    ParallelFor parallel_for;
+
+    size_t next_chunk = 0;
+    // The last decompressed chunk if it doesn't fit in the destination.
+    std::vector<std::byte> pending_chunk;
+    size_t pending_offset = 0;
+
+    auto num_chunks() const -> size_t { return chunk_offsets.size() - 1; }
+    auto chunk_length(size_t index) const -> uint64_t {
+        return std::min<uint64_t>(chunk_size, data_length - index * chunk_size);
+    }
+
+    auto decompress(size_t index, Span<std::byte> dst) const -> bool {
+        return decompress_chunk(
+            codec,
+            {compressed_data.data() + chunk_offsets[index], chunk_offsets[index + 1] - chunk_offsets[index]},
+            dst
+        );
+    }
+
+    auto read_some(Span<std::byte> dst) -> size_t {
+        if (pending_offset < pending_chunk.size()) {
+            auto length = std::min(dst.size(), pending_chunk.size() - pending_offset);
+            std::copy_n(pending_chunk.data() + pending_offset, length, dst.data());
+            pending_offset += length;
+            return length;
+        }
+        if (next_chunk >= num_chunks()) { return 0; }
+
+        auto first_chunk = next_chunk;
+        uint64_t length = 0;
+        while (next_chunk < num_chunks() && length + chunk_length(next_chunk) <= dst.size()) {
+            length += chunk_length(next_chunk);
+            ++next_chunk;
+        }
+        if (next_chunk == first_chunk) {
+            pending_chunk.resize(chunk_length(next_chunk));
+            pending_offset = 0;
+            if (!decompress(next_chunk++, pending_chunk)) { return stop(); }
+            return read_some(dst);
+        }
+
+        // Whole chunks are decompressed into `dst` directly.
+        std::atomic<bool> succeeded = true;
+        for_each_chunk(parallel_for, next_chunk - first_chunk, [&](size_t i) {
+            auto index = first_chunk + i;
+            if (!decompress(index, {dst.data() + i * chunk_size, chunk_length(index)})) {
+                succeeded = false;
+            }
+        });
+        return succeeded ? length : stop();
+    }
+
+    // Corrupted data is treated as the end.
+    auto stop() -> size_t {
+        next_chunk = num_chunks();
+        pending_chunk.clear();
+        pending_offset = 0;
+        return 0;
+    }
+};
+
+} // namespace
+
+ReadByteStream::ReadByteStream(Dyn<IByteStreamSource>::Box source, size_t size, size_t window_size)
+    : owned_data_(std::max<size_t>(window_size, 1)), data_(owned_data_.data(), size_t{0}), source_(std::move(source)), size_(size)
+{}
+
 auto ReadByteStream::set_offset(size_t offset) -> void {
-    curr_offset_ = std::min(offset, data_.size());
+    if (!source_) {
+        curr_offset_ = std::min(offset, data_.size());
+        return;
+    }
+    if (offset < curr_offset()) { return; }
+    auto skip_size = offset - curr_offset();
+    while (skip_size > 0) {
+        if (curr_offset_ == data_.size() && !refill()) { break; }
+        auto length = std::min(skip_size, data_.size() - curr_offset_);
+        curr_offset_ += length;
+        skip_size -= length;
+    }
 }
 
 auto ReadByteStream::read_raw(std::byte* dst, size_t size) -> ReadByteStream& {
-    if (curr_offset_ + size <= data_.size() && size > 0) {
-        std::copy_n(data_.data() + curr_offset_, size, dst);
-        curr_offset_ += size;
+    if (!source_) {
+        if (curr_offset_ + size <= data_.size() && size > 0) {
+            std::copy_n(data_.data() + curr_offset_, size, dst);
+            curr_offset_ += size;
+        }
+        return *this;
+    }
+
+    while (size > 0) {
+        if (curr_offset_ == data_.size()) {
+            if (size >= owned_data_.size()) {
+                // Large reads bypass the window.
+                window_offset_ += data_.size();
+                data_ = {owned_data_.data(), size_t{0}};
+                curr_offset_ = 0;
+                auto length = source_.value().read_some({dst, size});
+                if (length == 0) { break; }
+                window_offset_ += length;
+                dst += length;
+                size -= length;
+                continue;
+            }
+            if (!refill()) { break; }
+        }
+        auto length = std::min(size, data_.size() - curr_offset_);
+        std::copy_n(data_.data() + curr_offset_, length, dst);
+        curr_offset_ += length;
+        dst += length;
+        size -= length;
     }
     return *this;
 }
 
+auto ReadByteStream::refill() -> bool {
+    window_offset_ += data_.size();
+    curr_offset_ = 0;
+    auto length = source_.value().read_some(owned_data_);
+    data_ = {owned_data_.data(), length};
+    return length > 0;
+}
+
 auto ReadByteStream::read(std::string& str) -> ReadByteStream& {
     uint64_t length = 0;
     read(length);
@@ -25,24 +238,100 @@ auto ReadByteStream::read(std::string& str) -> ReadByteStream& {
     return *this;
 }
 
-auto ReadByteStream::read_compressed_part(ReadByteStream& uncompressed_bs) -> ReadByteStream& {
-    uint64_t data_length = 0;
-    uint64_t compressed_length = 0;
-    read(data_length).read(compressed_length);
+auto ReadByteStream::read_compressed_part(
+    ReadByteStream& uncompressed_bs, ParallelFor parallel_for
+) -> ReadByteStream& {
+    return read_compressed_part_impl(uncompressed_bs, false, std::move(parallel_for));
+}
 
-    std::vector<std::byte> uncompressed_data{data_length};
-    mz_ulong temp_data_length = data_length;
-    mz_uncompress(
-        reinterpret_cast<unsigned char*>(uncompressed_data.data()), &temp_data_length,
-        reinterpret_cast<unsigned char const*>(data_.data() + curr_offset_), compressed_length
-    );
-    curr_offset_ += compressed_length;
+auto ReadByteStream::read_compressed_part_streaming(
+    ReadByteStream& uncompressed_bs, ParallelFor parallel_for
+) -> ReadByteStream& {
+    return read_compressed_part_impl(uncompressed_bs, true, std::move(parallel_for));
+}
 
-    uncompressed_bs = ReadByteStream{std::move(uncompressed_data)};
+auto ReadByteStream::read_compressed_part_impl(
+    ReadByteStream& uncompressed_bs, bool streaming, ParallelFor&& parallel_for
+) -> ReadByteStream& {
+    uncompressed_bs = {};
 
+    uint64_t tag = 0;
+    read(tag);
+    if (tag != chunked_compressed_part_tag) {
+        // Whole data is compressed by miniz in old assets.
+        auto data_length = tag;
+        uint64_t compressed_length = 0;
+        read(compressed_length);
+        std::vector<std::byte> compressed_storage{};
+        auto compressed_data = read_or_view(compressed_length, compressed_storage);
+        if (compressed_data.size() != compressed_length) { return *this; }
+        std::vector<std::byte> uncompressed_data(data_length);
+        if (decompress_chunk(CompressionCodec::miniz, compressed_data, uncompressed_data)) {
+            uncompressed_bs = ReadByteStream{std::move(uncompressed_data)};
+        }
+        return *this;
+    }
+
+    ChunkedDecompressionSource source{};
+    uint32_t codec = 0;
+    uint32_t num_chunks = 0;
+    read(codec).read(num_chunks).read(source.data_length).read(source.chunk_size);
+    source.codec = static_cast<CompressionCodec>(codec);
+    // Each chunk has its compressed length stored, don't allocate for chunks that can't be in the data.
+    if (curr_offset() > size() || num_chunks > (size() - curr_offset()) / sizeof(uint64_t)) {
+        set_offset(size());
+        return *this;
+    }
+    source.chunk_offsets.resize(num_chunks + 1, 0);
+    for (uint32_t i = 0; i < num_chunks; i++) {
+        uint64_t compressed_length = 0;
+        read(compressed_length);
+        source.chunk_offsets[i + 1] = source.chunk_offsets[i] + compressed_length;
+    }
+    if (
+        source.chunk_size == 0
+        || (source.data_length + source.chunk_size - 1) / source.chunk_size != num_chunks
+        || curr_offset() + source.chunk_offsets.back() > size()
+    ) {
+        set_offset(size());
+        return *this;
+    }
+    source.compressed_data = read_or_view(source.chunk_offsets.back(), source.owned_compressed_data);
+    if (source.compressed_data.size() != source.chunk_offsets.back()) { return *this; }
+    source.parallel_for = std::move(parallel_for);
+
+    if (streaming) {
+        auto data_length = source.data_length;
+        uncompressed_bs = ReadByteStream{
+            make_poly<IByteStreamSource, ChunkedDecompressionSource>(std::move(source)), data_length
+        };
+        return *this;
+    }
+
+    std::vector<std::byte> uncompressed_data(source.data_length);
+    if (source.read_some(uncompressed_data) == source.data_length) {
+        uncompressed_bs = ReadByteStream{std::move(uncompressed_data)};
+    }
     return *this;
 }
 
+auto ReadByteStream::read_or_view(size_t size, std::vector<std::byte>& storage) -> CSpan<std::byte> {
+    if (!source_) {
+        if (curr_offset_ + size > data_.size()) {
+            curr_offset_ = data_.size();
+            return {};
+        }
+        CSpan<std::byte> view{data_.data() + curr_offset_, size};
+        curr_offset_ += size;
+        return view;
+    }
+    storage.resize(size);
+    auto offset = curr_offset();
+    read_raw(storage.data(), size);
+    if (curr_offset() - offset != size) { return {}; }
+    return storage;
+}
+
 
 auto WriteByteStream::reserve(size_t size) -> void {
     data_.reserve(size);
@@ -74,21 +363,43 @@ auto WriteByteStream::write(std::string_view value) -> WriteByteStream& {
     return *this;
 }
 
-auto WriteByteStream::compress_data(size_t from) -> WriteByteStream& {
+auto WriteByteStream::compress_data(
+    size_t from, CompressionCodec codec, ParallelFor const& parallel_for
+) -> WriteByteStream& {
     auto data_length = curr_offset_ - from;
-    auto compressed_length = mz_compressBound(data_length);
-    std::vector<std::byte> compressed_data{compressed_length};
-    mz_compress(
-        reinterpret_cast<unsigned char*>(compressed_data.data()), &compressed_length,
-        reinterpret_cast<unsigned char const*>(data_.data() + from), data_length
-    );
-    compressed_data.resize(compressed_length);
+    auto num_chunks = (data_length + compression_chunk_size - 1) / compression_chunk_size;
+    std::vector<std::vector<std::byte>> compressed_chunks(num_chunks);
+    auto compress_all = [&](CompressionCodec chunk_codec) {
+        std::atomic<bool> succeeded = true;
+        for_each_chunk(parallel_for, num_chunks, [&](size_t index) {
+            auto offset = index * compression_chunk_size;
+            auto length = std::min<uint64_t>(compression_chunk_size, data_length - offset);
+            auto chunk = compress_chunk(chunk_codec, {data_.data() + from + offset, length});
+            if (chunk) {
+                compressed_chunks[index] = std::move(chunk).value();
+            } else {
+                succeeded = false;
+            }
+        });
+        return succeeded.load();
+    };
+    if (!compress_all(codec)) {
+        codec = CompressionCodec::none;
+        compress_all(codec);
+    }
 
     std::vector<std::byte> last_data{data_.begin() + curr_offset_, data_.end()};
     data_.resize(from);
     curr_offset_ = from;
-    write(static_cast<uint64_t>(data_length));
-    write(compressed_data);
+    write(chunked_compressed_part_tag);
+    write(static_cast<uint32_t>(codec)).write(static_cast<uint32_t>(num_chunks));
+    write(static_cast<uint64_t>(data_length)).write(compression_chunk_size);
+    for (auto const& chunk : compressed_chunks) {
+        write(static_cast<uint64_t>(chunk.size()));
+    }
+    for (auto const& chunk : compressed_chunks) {
+        write_raw(chunk.data(), chunk.size());
+    }
     auto temp_offset = curr_offset_;
     write_raw(last_data.data(), last_data.size());
     curr_offset_ = temp_offset;
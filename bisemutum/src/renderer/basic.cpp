@@ -1,5 +1,6 @@
 #include <bisemutum/renderer/basic.hpp>
 
+#include <bisemutum/engine/engine.hpp>
 #include <bisemutum/runtime/component_utils.hpp>
 #include <bisemutum/runtime/system_manager.hpp>
 #include <bisemutum/runtime/logger.hpp>
@@ -227,8 +227,8 @@ auto LightsContext::collect_all_lights() -> void {
         data.inv_height_sqr = 1.0f / (light.height * light.height);
         data.two_sided = light.two_sided;
         if (light.texture.asset_id() != rt::AssetId::invalid && rect_light_textures.size() < max_num_rect_light_textures) {
-            light.texture.load();
-            auto tex = light.texture.asset();
+            // The light is untextured until the texture is loaded.
+            auto tex = light.texture.load_async() == rt::AssetState::loaded ? light.texture.asset() : nullptr;
             if (tex && tex->texture.desc().dim == rhi::TextureDimension::d2) {
                 data.texture_index = rect_light_textures.size();
                 data.inv_texel_size = std::max(
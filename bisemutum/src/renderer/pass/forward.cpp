@@ -106,7 +106,9 @@ auto ForwardPass::render(gfx::Camera const& camera, gfx::RenderGraph& rg, InputD
         .fragment_shader = fragment_shader_,
         .type = gfx::RenderedObjectType::opaque,
         .candidate_drawables = input.drawables,
+        .meshlet_culling_mode = gfx::MeshletCullingMode::cpu,
     });
+    builder.read(pass_data->list);
 
     fragment_shader_params_.update_uniform_buffer();
 
@@ -170,6 +172,7 @@ auto ForwardTransparentPass::render(gfx::Camera const& camera, gfx::RenderGraph&
         .candidate_drawables = input.drawables,
         .sorting_mode = gfx::RendererObjectSortingMode::from_back_to_front,
     });
+    builder.read(pass_data->list);
 
     fragment_shader_params_.update_uniform_buffer();
 
@@ -75,7 +75,9 @@ auto GBufferdPass::render(
         .fragment_shader = fragment_shader_,
         .type = gfx::RenderedObjectType::opaque,
         .candidate_drawables = drawables,
+        .meshlet_culling_mode = gfx::MeshletCullingMode::cpu,
     });
+    builder.read(pass_data->list);
 
     fragment_shader_params_.update_uniform_buffer();
 
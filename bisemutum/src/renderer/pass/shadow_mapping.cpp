@@ -41,6 +41,7 @@ auto ShadowMappingPass::render(
             .candidate_drawables = input.drawables,
             .do_frustum_culling = false,
         });
+        builder.read(pass_data->list);
         builder.set_execution_function<PassData>(
             [this](CRef<PassData> pass_data, gfx::GraphicsPassContext const& ctx) {
                 ctx.render_list(pass_data->list, fragment_shader_params_);
@@ -67,6 +68,7 @@ auto ShadowMappingPass::render(
             .candidate_drawables = input.drawables,
             .do_frustum_culling = false,
         });
+        builder.read(pass_data->list);
         builder.set_execution_function<PassData>(
             [this](CRef<PassData> pass_data, gfx::GraphicsPassContext const& ctx) {
                 ctx.render_list(pass_data->list, fragment_shader_params_);
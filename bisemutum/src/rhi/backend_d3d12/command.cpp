@@ -5,6 +5,8 @@
 #include <WinPixEventRuntime/pix3.h>
 #endif
 
+#include <bisemutum/prelude/math.hpp>
+
 #include "device.hpp"
 #include "resource.hpp"
 #include "accel.hpp"
@@ -15,6 +17,16 @@ namespace bi::rhi {
 
 namespace {
 
+// Rows of block-compressed formats are counted in 4x4 blocks.
+auto format_block_dim(ResourceFormat format) -> uint32_t {
+    return is_compressed_format(format) ? 4 : 1;
+}
+auto buffer_row_pitch(ResourceFormat format, uint32_t pixels_per_row) -> uint32_t {
+    return is_compressed_format(format)
+        ? ceil_div(pixels_per_row, 4u) * format_block_size(format)
+        : pixels_per_row * format_texel_size(format);
+}
+
 #ifndef NDEBUG
 auto encode_event_color(float r, float g, float b) -> UINT64 {
     return PIX_COLOR(static_cast<BYTE>(r * 255.0f), static_cast<BYTE>(g * 255.0f), static_cast<BYTE>(b * 255.0f));
@@ -239,8 +251,9 @@ auto CommandEncoderD3D12::copy_buffer_to_texture(
     uint32_t region_depth, region_layers;
     dst_texture_dx->get_depth_and_layer(region.texture_extent.depth_or_layers, region_depth, region_layers);
     region_layers = std::min(region_layers, tex_layers - region.texture_layer);
-    auto row_pitch = region.buffer_pixels_per_row * format_texel_size(dst_texture_dx->desc().format);
-    auto layer_size = region.buffer_rows_per_texture * row_pitch;
+    auto block_dim = format_block_dim(dst_texture_dx->desc().format);
+    auto row_pitch = buffer_row_pitch(dst_texture_dx->desc().format, region.buffer_pixels_per_row);
+    auto layer_size = ceil_div(region.buffer_rows_per_texture, block_dim) * row_pitch;
     for (uint32_t layer = 0; layer < region_layers; layer++) {
         D3D12_TEXTURE_COPY_LOCATION src_loc{
             .pResource = src_buffer_dx->raw(),
@@ -249,8 +262,8 @@ auto CommandEncoderD3D12::copy_buffer_to_texture(
                 .Offset = region.buffer_offset + layer * layer_size,
                 .Footprint = {
                     .Format = to_dx_format(dst_texture_dx->desc().format),
-                    .Width = std::min(region.texture_extent.width, extent.width),
-                    .Height = std::min(region.texture_extent.height, extent.height),
+                    .Width = aligned_size(std::min(region.texture_extent.width, extent.width), block_dim),
+                    .Height = aligned_size(std::min(region.texture_extent.height, extent.height), block_dim),
                     .Depth = std::min(region_depth, tex_depth),
                     .RowPitch = row_pitch,
                 }
@@ -273,8 +286,8 @@ auto CommandEncoderD3D12::copy_buffer_to_texture(
             .left = 0,
             .top = 0,
             .front = 0,
-            .right = std::min(region.texture_extent.width, extent.width),
-            .bottom = std::min(region.texture_extent.height, extent.height),
+            .right = aligned_size(std::min(region.texture_extent.width, extent.width), block_dim),
+            .bottom = aligned_size(std::min(region.texture_extent.height, extent.height), block_dim),
             .back = std::min(region_depth, tex_depth),
         };
         cmd_list_->CopyTextureRegion(
@@ -294,8 +307,9 @@ auto CommandEncoderD3D12::copy_texture_to_buffer(
     uint32_t region_depth, region_layers;
     src_texture_dx->get_depth_and_layer(region.texture_extent.depth_or_layers, region_depth, region_layers);
     region_layers = std::min(region_layers, tex_layers - region.texture_layer);
-    auto row_pitch = region.buffer_pixels_per_row * format_texel_size(src_texture_dx->desc().format);
-    auto layer_size = region.buffer_rows_per_texture * row_pitch;
+    auto block_dim = format_block_dim(src_texture_dx->desc().format);
+    auto row_pitch = buffer_row_pitch(src_texture_dx->desc().format, region.buffer_pixels_per_row);
+    auto layer_size = ceil_div(region.buffer_rows_per_texture, block_dim) * row_pitch;
     for (uint32_t layer = 0; layer < region_layers; layer++) {
         D3D12_TEXTURE_COPY_LOCATION src_loc{
             .pResource = src_texture_dx->raw(),
@@ -309,8 +323,8 @@ auto CommandEncoderD3D12::copy_texture_to_buffer(
                 .Offset = region.buffer_offset + layer_size,
                 .Footprint = {
                     .Format = to_dx_format(src_texture_dx->desc().format),
-                    .Width = std::min(region.texture_extent.width, extent.width),
-                    .Height = std::min(region.texture_extent.height, extent.height),
+                    .Width = aligned_size(std::min(region.texture_extent.width, extent.width), block_dim),
+                    .Height = aligned_size(std::min(region.texture_extent.height, extent.height), block_dim),
                     .Depth = std::min(region_depth, tex_depth),
                     .RowPitch = row_pitch,
                 }
@@ -759,6 +773,18 @@ auto GraphicsCommandEncoderD3D12::draw_indexed(
     cmd_list_->DrawIndexedInstanced(num_indices, num_instance, first_index, vertex_offset, first_instance);
 }
 
+auto GraphicsCommandEncoderD3D12::draw_indexed_indirect_count(
+    Ref<Buffer> buffer, uint64_t offset,
+    Ref<Buffer> count_buffer, uint64_t count_offset,
+    uint32_t max_num_draws, uint32_t stride
+) -> void {
+    cmd_list_->ExecuteIndirect(
+        device_->get_draw_indexed_command_signature(stride), max_num_draws,
+        buffer.cast_to<BufferD3D12>()->raw(), offset,
+        count_buffer.cast_to<BufferD3D12>()->raw(), count_offset
+    );
+}
+
 
 ComputeCommandEncoderD3D12::ComputeCommandEncoderD3D12(
     Ref<DeviceD3D12> device, Ref<CommandEncoderD3D12> base_encoder, bool has_label
@@ -156,6 +156,11 @@ struct GraphicsCommandEncoderD3D12 final : GraphicsCommandEncoder {
         uint32_t vertex_offset,
         uint32_t first_instance
     ) -> void override;
+    auto draw_indexed_indirect_count(
+        Ref<Buffer> buffer, uint64_t offset,
+        Ref<Buffer> count_buffer, uint64_t count_offset,
+        uint32_t max_num_draws, uint32_t stride
+    ) -> void override;
 
 private:
     Ref<DeviceD3D12> device_;
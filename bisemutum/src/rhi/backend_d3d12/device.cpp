@@ -146,6 +146,9 @@ auto DeviceD3D12::initialize_device_properties() -> void {
     D3D12_FEATURE_DATA_D3D12_OPTIONS7 feature_supports7{};
     device_->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS7, &feature_supports7, sizeof(feature_supports7));
     device_properties_.meshlet_pipeline = feature_supports7.MeshShaderTier != D3D12_MESH_SHADER_TIER_NOT_SUPPORTED;
+
+    // Count buffer of `ExecuteIndirect()` is always supported.
+    device_properties_.draw_indirect_count = true;
 }
 
 auto DeviceD3D12::create_queues() -> void {
@@ -535,4 +538,22 @@ auto DeviceD3D12::get_local_root_signature(uint32_t size_in_bytes, uint32_t spac
     return it->second.Get();
 }
 
+auto DeviceD3D12::get_draw_indexed_command_signature(uint32_t stride) -> ID3D12CommandSignature* {
+    auto [it, need_to_create] = cached_draw_indexed_command_signatures_.try_emplace(stride);
+    if (need_to_create) {
+        D3D12_INDIRECT_ARGUMENT_DESC argument_desc{
+            .Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED,
+        };
+        D3D12_COMMAND_SIGNATURE_DESC signature_desc{
+            .ByteStride = stride,
+            .NumArgumentDescs = 1,
+            .pArgumentDescs = &argument_desc,
+            .NodeMask = 0,
+        };
+        // No root signature is needed since only draw arguments are changed.
+        device_->CreateCommandSignature(&signature_desc, nullptr, IID_PPV_ARGS(&it->second));
+    }
+    return it->second.Get();
+}
+
 }
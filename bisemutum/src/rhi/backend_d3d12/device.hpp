@@ -88,6 +88,7 @@ struct DeviceD3D12 final : Device {
     auto dsv_heap() const -> Ref<RenderTargetDescriptorHeapD3D12> { return dsv_heap_.ref(); }
 
     auto get_local_root_signature(uint32_t size_in_bytes, uint32_t space, uint32_t register_) -> ID3D12RootSignature*;
+    auto get_draw_indexed_command_signature(uint32_t stride) -> ID3D12CommandSignature*;
 
 private:
     auto initialize_device_properties() -> void;
@@ -118,6 +119,7 @@ private:
         std::tuple<uint32_t, uint32_t, uint32_t>,
         Microsoft::WRL::ComPtr<ID3D12RootSignature>
     > caced_local_root_signatures_;
+    std::unordered_map<uint32_t, Microsoft::WRL::ComPtr<ID3D12CommandSignature>> cached_draw_indexed_command_signatures_;
 };
 
 }
@@ -89,7 +89,7 @@ auto PipelineStateCacheD3D12::read_from(Dyn<rt::IFile>::Ref file) -> void {
     DXGI_ADAPTER_DESC adapter_desc{};
     adapter_->GetDesc(&adapter_desc);
 
-    auto file_data = file.read_binary_data();
+    auto file_data = file.map_binary_data();
     ReadByteStream bs{file_data};
     
     uint32_t vendor_id = 0;
@@ -0,0 +1,315 @@
+#include "command.hpp"
+
+#include <algorithm>
+
+#include <bisemutum/prelude/math.hpp>
+
+#include "device.hpp"
+#include "resource.hpp"
+
+namespace bi::rhi {
+
+namespace {
+
+auto texture_copy_size(
+    TextureDesc const& desc, uint32_t level, Extent3D const& extent, ResourceFormat format
+) -> uint64_t {
+    uint64_t width = extent.width == ~0u ? std::max(desc.extent.width >> level, 1u) : extent.width;
+    uint64_t height = extent.height == ~0u ? std::max(desc.extent.height >> level, 1u) : extent.height;
+    uint64_t depth = extent.depth_or_layers;
+    if (depth == ~0u) {
+        depth = desc.dim == TextureDimension::d3 ? std::max(desc.extent.depth_or_layers >> level, 1u) : 1u;
+    }
+    if (is_compressed_format(format)) {
+        return ceil_div<uint64_t>(width, 4) * ceil_div<uint64_t>(height, 4) * depth * format_block_size(format);
+    }
+    return width * height * depth * format_texel_size(format);
+}
+
+} // namespace
+
+auto CommandPoolNull::get_command_encoder() -> Box<CommandEncoder> {
+    return Box<CommandEncoderNull>::make(device_);
+}
+
+auto CommandEncoderNull::finish() -> Box<CommandBuffer> {
+    finished_ = true;
+    return Box<CommandBufferNull>::make(std::move(stream_));
+}
+
+auto CommandEncoderNull::push_label(CommandLabel const& label) -> void {
+    stream_.record(NullCommandType::push_label);
+}
+
+auto CommandEncoderNull::pop_label() -> void {
+    stream_.record(NullCommandType::pop_label);
+}
+
+auto CommandEncoderNull::copy_buffer_to_buffer(
+    CRef<Buffer> src_buffer,
+    Ref<Buffer> dst_buffer,
+    BufferCopyDesc const& region
+) -> void {
+    auto length = region.length;
+    if (length == ~0ull) {
+        length = std::min(
+            src_buffer->desc().size - region.src_offset, dst_buffer->desc().size - region.dst_offset
+        );
+    }
+    stream_.record(
+        NullCommandType::copy_buffer_to_buffer,
+        src_buffer.cast_to<BufferNull const>().get(), dst_buffer.cast_to<BufferNull>().get(),
+        region.src_offset, region.dst_offset, length
+    );
+}
+
+auto CommandEncoderNull::copy_texture_to_texture(
+    CRef<Texture> src_texture,
+    Ref<Texture> dst_texture,
+    TextureCopyDesc const& region
+) -> void {
+    auto size = texture_copy_size(src_texture->desc(), region.src_level, region.extent, src_texture->desc().format);
+    stream_.record(NullCommandType::copy_texture_to_texture, size);
+}
+
+auto CommandEncoderNull::copy_buffer_to_texture(
+    CRef<Buffer> src_buffer,
+    Ref<Texture> dst_texture,
+    BufferTextureCopyDesc const& region
+) -> void {
+    auto size = texture_copy_size(
+        dst_texture->desc(), region.texture_level, region.texture_extent, dst_texture->desc().format
+    );
+    stream_.record(NullCommandType::copy_buffer_to_texture, src_buffer.cast_to<BufferNull const>().get(), size);
+}
+
+auto CommandEncoderNull::copy_texture_to_buffer(
+    CRef<Texture> src_texture,
+    Ref<Buffer> dst_buffer,
+    BufferTextureCopyDesc const& region
+) -> void {
+    auto size = texture_copy_size(
+        src_texture->desc(), region.texture_level, region.texture_extent, src_texture->desc().format
+    );
+    stream_.record(NullCommandType::copy_texture_to_buffer, size);
+}
+
+auto CommandEncoderNull::build_bottom_level_acceleration_structure(
+    CSpan<AccelerationStructureGeometryBuildDesc> build_infos
+) -> void {
+    stream_.record(
+        NullCommandType::build_bottom_level_acceleration_structure, static_cast<uint32_t>(build_infos.size())
+    );
+}
+
+auto CommandEncoderNull::build_top_level_acceleration_structure(
+    AccelerationStructureInstanceBuildDesc const& build_info
+) -> void {
+    stream_.record(NullCommandType::build_top_level_acceleration_structure);
+}
+
+auto CommandEncoderNull::copy_acceleration_structure(
+    CRef<AccelerationStructure> src_acceleration_structure,
+    Ref<AccelerationStructure> dst_acceleration_structure
+) -> void {
+    stream_.record(NullCommandType::copy_acceleration_structure);
+}
+
+auto CommandEncoderNull::compact_acceleration_structure(
+    CRef<AccelerationStructure> src_acceleration_structure,
+    Ref<AccelerationStructure> dst_acceleration_structure
+) -> void {
+    stream_.record(NullCommandType::copy_acceleration_structure);
+}
+
+auto CommandEncoderNull::resource_barriers(
+    CSpan<BufferBarrier> buffer_barriers, CSpan<TextureBarrier> texture_barriers
+) -> void {
+    stream_.record(
+        NullCommandType::resource_barriers,
+        static_cast<uint32_t>(buffer_barriers.size()), static_cast<uint32_t>(texture_barriers.size())
+    );
+}
+
+auto CommandEncoderNull::set_descriptor_heaps(CSpan<Ref<DescriptorHeap>> heaps) -> void {
+    stream_.record(NullCommandType::set_descriptor_heaps, static_cast<uint32_t>(heaps.size()));
+}
+
+auto CommandEncoderNull::begin_render_pass(
+    CommandLabel const& label, RenderTargetDesc const& desc
+) -> Box<GraphicsCommandEncoder> {
+    return Box<GraphicsCommandEncoderNull>::make(unsafe_make_ref(this), desc);
+}
+
+auto CommandEncoderNull::begin_compute_pass(CommandLabel const& label) -> Box<ComputeCommandEncoder> {
+    return Box<ComputeCommandEncoderNull>::make(unsafe_make_ref(this));
+}
+
+auto CommandEncoderNull::begin_raytracing_pass(CommandLabel const& label) -> Box<RaytracingCommandEncoder> {
+    return Box<RaytracingCommandEncoderNull>::make(unsafe_make_ref(this));
+}
+
+
+GraphicsCommandEncoderNull::GraphicsCommandEncoderNull(
+    Ref<CommandEncoderNull> base_encoder, RenderTargetDesc const& desc
+) : base_encoder_(base_encoder) {
+    base_encoder_->in_pass_ = true;
+    base_encoder_->stream_.record(
+        NullCommandType::begin_render_pass,
+        static_cast<uint32_t>(desc.colors.size()), static_cast<uint8_t>(desc.depth_stencil.has_value())
+    );
+}
+
+GraphicsCommandEncoderNull::~GraphicsCommandEncoderNull() {
+    base_encoder_->stream_.record(NullCommandType::end_render_pass);
+    base_encoder_->in_pass_ = false;
+}
+
+auto GraphicsCommandEncoderNull::push_label(CommandLabel const& label) -> void {
+    base_encoder_->stream_.record(NullCommandType::push_label);
+}
+
+auto GraphicsCommandEncoderNull::pop_label() -> void {
+    base_encoder_->stream_.record(NullCommandType::pop_label);
+}
+
+auto GraphicsCommandEncoderNull::set_pipeline(CRef<GraphicsPipeline> pipeline) -> void {
+    base_encoder_->stream_.record(NullCommandType::set_pipeline);
+}
+
+auto GraphicsCommandEncoderNull::set_descriptors(
+    uint32_t from_group_index, CSpan<DescriptorHandle> descriptors
+) -> void {
+    base_encoder_->stream_.record(NullCommandType::set_descriptors, static_cast<uint32_t>(descriptors.size()));
+}
+
+auto GraphicsCommandEncoderNull::push_constants(void const* data, uint32_t size, uint32_t offset) -> void {
+    base_encoder_->stream_.record(NullCommandType::push_constants, size);
+}
+
+auto GraphicsCommandEncoderNull::set_viewports(CSpan<Viewport> viewports) -> void {
+    base_encoder_->stream_.record(NullCommandType::set_viewports, static_cast<uint32_t>(viewports.size()));
+}
+
+auto GraphicsCommandEncoderNull::set_scissors(CSpan<Scissor> scissors) -> void {
+    base_encoder_->stream_.record(NullCommandType::set_scissors, static_cast<uint32_t>(scissors.size()));
+}
+
+auto GraphicsCommandEncoderNull::set_vertex_buffer(
+    CSpan<Ref<Buffer>> buffers, CSpan<uint64_t> offsets, uint32_t first_binding
+) -> void {
+    base_encoder_->stream_.record(NullCommandType::set_vertex_buffer, static_cast<uint32_t>(buffers.size()));
+}
+
+auto GraphicsCommandEncoderNull::set_index_buffer(Ref<Buffer> buffer, uint64_t offset, IndexType index_type) -> void {
+    base_encoder_->stream_.record(NullCommandType::set_index_buffer);
+}
+
+auto GraphicsCommandEncoderNull::draw(
+    uint32_t num_vertices,
+    uint32_t num_instance,
+    uint32_t first_vertex,
+    uint32_t first_instance
+) -> void {
+    base_encoder_->stream_.record(NullCommandType::draw, num_vertices, num_instance);
+}
+
+auto GraphicsCommandEncoderNull::draw_indexed(
+    uint32_t num_indices,
+    uint32_t num_instance,
+    uint32_t first_index,
+    uint32_t vertex_offset,
+    uint32_t first_instance
+) -> void {
+    base_encoder_->stream_.record(NullCommandType::draw_indexed, num_indices, num_instance);
+}
+
+auto GraphicsCommandEncoderNull::draw_indexed_indirect_count(
+    Ref<Buffer> buffer, uint64_t offset,
+    Ref<Buffer> count_buffer, uint64_t count_offset,
+    uint32_t max_num_draws, uint32_t stride
+) -> void {
+    base_encoder_->stream_.record(NullCommandType::draw_indexed_indirect_count, max_num_draws);
+}
+
+
+ComputeCommandEncoderNull::ComputeCommandEncoderNull(Ref<CommandEncoderNull> base_encoder)
+    : base_encoder_(base_encoder)
+{
+    base_encoder_->in_pass_ = true;
+    base_encoder_->stream_.record(NullCommandType::begin_compute_pass);
+}
+
+ComputeCommandEncoderNull::~ComputeCommandEncoderNull() {
+    base_encoder_->stream_.record(NullCommandType::end_compute_pass);
+    base_encoder_->in_pass_ = false;
+}
+
+auto ComputeCommandEncoderNull::push_label(CommandLabel const& label) -> void {
+    base_encoder_->stream_.record(NullCommandType::push_label);
+}
+
+auto ComputeCommandEncoderNull::pop_label() -> void {
+    base_encoder_->stream_.record(NullCommandType::pop_label);
+}
+
+auto ComputeCommandEncoderNull::set_pipeline(CRef<ComputePipeline> pipeline) -> void {
+    base_encoder_->stream_.record(NullCommandType::set_pipeline);
+}
+
+auto ComputeCommandEncoderNull::set_descriptors(
+    uint32_t from_group_index, CSpan<DescriptorHandle> descriptors
+) -> void {
+    base_encoder_->stream_.record(NullCommandType::set_descriptors, static_cast<uint32_t>(descriptors.size()));
+}
+
+auto ComputeCommandEncoderNull::push_constants(void const* data, uint32_t size, uint32_t offset) -> void {
+    base_encoder_->stream_.record(NullCommandType::push_constants, size);
+}
+
+auto ComputeCommandEncoderNull::dispatch(uint32_t num_groups_x, uint32_t num_groups_y, uint32_t num_groups_z) -> void {
+    base_encoder_->stream_.record(NullCommandType::dispatch, num_groups_x, num_groups_y, num_groups_z);
+}
+
+
+RaytracingCommandEncoderNull::RaytracingCommandEncoderNull(Ref<CommandEncoderNull> base_encoder)
+    : base_encoder_(base_encoder)
+{
+    base_encoder_->in_pass_ = true;
+    base_encoder_->stream_.record(NullCommandType::begin_raytracing_pass);
+}
+
+RaytracingCommandEncoderNull::~RaytracingCommandEncoderNull() {
+    base_encoder_->stream_.record(NullCommandType::end_raytracing_pass);
+    base_encoder_->in_pass_ = false;
+}
+
+auto RaytracingCommandEncoderNull::push_label(CommandLabel const& label) -> void {
+    base_encoder_->stream_.record(NullCommandType::push_label);
+}
+
+auto RaytracingCommandEncoderNull::pop_label() -> void {
+    base_encoder_->stream_.record(NullCommandType::pop_label);
+}
+
+auto RaytracingCommandEncoderNull::set_pipeline(CRef<RaytracingPipeline> pipeline) -> void {
+    base_encoder_->stream_.record(NullCommandType::set_pipeline);
+}
+
+auto RaytracingCommandEncoderNull::set_descriptors(
+    uint32_t from_group_index, CSpan<DescriptorHandle> descriptors
+) -> void {
+    base_encoder_->stream_.record(NullCommandType::set_descriptors, static_cast<uint32_t>(descriptors.size()));
+}
+
+auto RaytracingCommandEncoderNull::push_constants(void const* data, uint32_t size, uint32_t offset) -> void {
+    base_encoder_->stream_.record(NullCommandType::push_constants, size);
+}
+
+auto RaytracingCommandEncoderNull::dispatch_rays(
+    RaytracingShaderBindingTableBuffers const& sbt, uint32_t width, uint32_t height, uint32_t depth
+) -> void {
+    base_encoder_->stream_.record(NullCommandType::dispatch_rays, width, height, depth);
+}
+
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstring>
+
+#include <bisemutum/rhi/command.hpp>
+
+namespace bi::rhi {
+
+struct DeviceNull;
+
+enum class NullCommandType : uint8_t {
+    push_label,
+    pop_label,
+    copy_buffer_to_buffer,
+    copy_texture_to_texture,
+    copy_buffer_to_texture,
+    copy_texture_to_buffer,
+    build_bottom_level_acceleration_structure,
+    build_top_level_acceleration_structure,
+    copy_acceleration_structure,
+    resource_barriers,
+    set_descriptor_heaps,
+    begin_render_pass,
+    end_render_pass,
+    begin_compute_pass,
+    end_compute_pass,
+    begin_raytracing_pass,
+    end_raytracing_pass,
+    set_pipeline,
+    set_descriptors,
+    push_constants,
+    set_viewports,
+    set_scissors,
+    set_vertex_buffer,
+    set_index_buffer,
+    draw,
+    draw_indexed,
+    draw_indexed_indirect_count,
+    dispatch,
+    dispatch_rays,
+};
+
+// Commands are stored as a type byte followed by their trivially copyable arguments, without padding.
+// Only counts and sizes are kept, except for buffer copies which are replayed on submission.
+struct NullCommandStream final {
+    template <typename... Args> requires (std::is_trivially_copyable_v<Args> && ...)
+    auto record(NullCommandType type, Args const&... args) -> void {
+        auto offset = data_.size();
+        data_.resize(offset + sizeof(type) + (sizeof(Args) + ... + 0));
+        auto ptr = data_.data() + offset;
+        std::memcpy(ptr, &type, sizeof(type));
+        ptr += sizeof(type);
+        ((std::memcpy(ptr, &args, sizeof(Args)), ptr += sizeof(Args)), ...);
+    }
+
+    auto data() const -> CSpan<std::byte> { return data_; }
+
+private:
+    std::vector<std::byte> data_;
+};
+
+struct NullCommandReader final {
+    NullCommandReader(CSpan<std::byte> data) : data_(data) {}
+
+    auto has_next() const -> bool { return offset_ < data_.size(); }
+
+    template <typename T> requires std::is_trivially_copyable_v<T>
+    auto read() -> T {
+        T value;
+        std::memcpy(&value, data_.data() + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return value;
+    }
+
+private:
+    CSpan<std::byte> data_;
+    size_t offset_ = 0;
+};
+
+struct CommandPoolNull final : CommandPool {
+    CommandPoolNull(Ref<DeviceNull> device) : device_(device) {}
+
+    auto reset() -> void override {}
+
+    auto get_command_encoder() -> Box<CommandEncoder> override;
+
+private:
+    Ref<DeviceNull> device_;
+};
+
+struct CommandBufferNull final : CommandBuffer {
+    CommandBufferNull(NullCommandStream&& stream) : stream_(std::move(stream)) {}
+
+    auto stream() const -> NullCommandStream const& { return stream_; }
+
+private:
+    NullCommandStream stream_;
+};
+
+struct GraphicsCommandEncoderNull;
+struct ComputeCommandEncoderNull;
+struct RaytracingCommandEncoderNull;
+
+struct CommandEncoderNull final : CommandEncoder {
+    CommandEncoderNull(Ref<DeviceNull> device) : device_(device) {}
+
+    auto finish() -> Box<CommandBuffer> override;
+
+    auto push_label(CommandLabel const& label) -> void override;
+
+    auto pop_label() -> void override;
+
+    auto copy_buffer_to_buffer(
+        CRef<Buffer> src_buffer,
+        Ref<Buffer> dst_buffer,
+        BufferCopyDesc const& region
+    ) -> void override;
+
+    auto copy_texture_to_texture(
+        CRef<Texture> src_texture,
+        Ref<Texture> dst_texture,
+        TextureCopyDesc const& region
+    ) -> void override;
+
+    auto copy_buffer_to_texture(
+        CRef<Buffer> src_buffer,
+        Ref<Texture> dst_texture,
+        BufferTextureCopyDesc const& region
+    ) -> void override;
+
+    auto copy_texture_to_buffer(
+        CRef<Texture> src_texture,
+        Ref<Buffer> dst_buffer,
+        BufferTextureCopyDesc const& region
+    ) -> void override;
+
+    auto build_bottom_level_acceleration_structure(
+        CSpan<AccelerationStructureGeometryBuildDesc> build_infos
+    ) -> void override;
+
+    auto build_top_level_acceleration_structure(
+        AccelerationStructureInstanceBuildDesc const& build_info
+    ) -> void override;
+
+    auto copy_acceleration_structure(
+        CRef<AccelerationStructure> src_acceleration_structure,
+        Ref<AccelerationStructure> dst_acceleration_structure
+    ) -> void override;
+
+    auto compact_acceleration_structure(
+        CRef<AccelerationStructure> src_acceleration_structure,
+        Ref<AccelerationStructure> dst_acceleration_structure
+    ) -> void override;
+
+    auto resource_barriers(
+        CSpan<BufferBarrier> buffer_barriers, CSpan<TextureBarrier> texture_barriers
+    ) -> void override;
+
+    auto set_descriptor_heaps(CSpan<Ref<DescriptorHeap>> heaps) -> void override;
+
+    auto begin_render_pass(
+        CommandLabel const& label, RenderTargetDesc const& desc
+    ) -> Box<GraphicsCommandEncoder> override;
+
+    auto begin_compute_pass(CommandLabel const& label) -> Box<ComputeCommandEncoder> override;
+
+    auto begin_raytracing_pass(CommandLabel const& label) -> Box<RaytracingCommandEncoder> override;
+
+    auto valid() const -> bool override { return !finished_ && !in_pass_; }
+
+private:
+    friend GraphicsCommandEncoderNull;
+    friend ComputeCommandEncoderNull;
+    friend RaytracingCommandEncoderNull;
+
+    Ref<DeviceNull> device_;
+    NullCommandStream stream_;
+    bool finished_ = false;
+    bool in_pass_ = false;
+};
+
+struct GraphicsCommandEncoderNull final : GraphicsCommandEncoder {
+    GraphicsCommandEncoderNull(Ref<CommandEncoderNull> base_encoder, RenderTargetDesc const& desc);
+    ~GraphicsCommandEncoderNull() override;
+
+    auto push_label(CommandLabel const& label) -> void override;
+
+    auto pop_label() -> void override;
+
+    auto set_pipeline(CRef<GraphicsPipeline> pipeline) -> void override;
+
+    auto set_descriptors(uint32_t from_group_index, CSpan<DescriptorHandle> descriptors) -> void override;
+    auto push_constants(void const* data, uint32_t size, uint32_t offset) -> void override;
+
+    auto set_viewports(CSpan<Viewport> viewports) -> void override;
+    auto set_scissors(CSpan<Scissor> scissors) -> void override;
+
+    auto set_vertex_buffer(
+        CSpan<Ref<Buffer>> buffers, CSpan<uint64_t> offsets, uint32_t first_binding
+    ) -> void override;
+    auto set_index_buffer(Ref<Buffer> buffer, uint64_t offset, IndexType index_type) -> void override;
+
+    auto draw(
+        uint32_t num_vertices,
+        uint32_t num_instance,
+        uint32_t first_vertex,
+        uint32_t first_instance
+    ) -> void override;
+    auto draw_indexed(
+        uint32_t num_indices,
+        uint32_t num_instance,
+        uint32_t first_index,
+        uint32_t vertex_offset,
+        uint32_t first_instance
+    ) -> void override;
+    auto draw_indexed_indirect_count(
+        Ref<Buffer> buffer, uint64_t offset,
+        Ref<Buffer> count_buffer, uint64_t count_offset,
+        uint32_t max_num_draws, uint32_t stride
+    ) -> void override;
+
+private:
+    Ref<CommandEncoderNull> base_encoder_;
+};
+
+struct ComputeCommandEncoderNull final : ComputeCommandEncoder {
+    ComputeCommandEncoderNull(Ref<CommandEncoderNull> base_encoder);
+    ~ComputeCommandEncoderNull() override;
+
+    auto push_label(CommandLabel const& label) -> void override;
+
+    auto pop_label() -> void override;
+
+    auto set_pipeline(CRef<ComputePipeline> pipeline) -> void override;
+
+    auto set_descriptors(uint32_t from_group_index, CSpan<DescriptorHandle> descriptors) -> void override;
+    auto push_constants(void const* data, uint32_t size, uint32_t offset) -> void override;
+
+    auto dispatch(uint32_t num_groups_x, uint32_t num_groups_y, uint32_t num_groups_z) -> void override;
+
+private:
+    Ref<CommandEncoderNull> base_encoder_;
+};
+
+struct RaytracingCommandEncoderNull final : RaytracingCommandEncoder {
+    RaytracingCommandEncoderNull(Ref<CommandEncoderNull> base_encoder);
+    ~RaytracingCommandEncoderNull() override;
+
+    auto push_label(CommandLabel const& label) -> void override;
+
+    auto pop_label() -> void override;
+
+    auto set_pipeline(CRef<RaytracingPipeline> pipeline) -> void override;
+
+    auto set_descriptors(uint32_t from_group_index, CSpan<DescriptorHandle> descriptors) -> void override;
+    auto push_constants(void const* data, uint32_t size, uint32_t offset) -> void override;
+
+    auto dispatch_rays(
+        RaytracingShaderBindingTableBuffers const& sbt, uint32_t width, uint32_t height, uint32_t depth
+    ) -> void override;
+
+private:
+    Ref<CommandEncoderNull> base_encoder_;
+};
+
+}
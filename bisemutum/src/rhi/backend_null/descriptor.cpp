@@ -0,0 +1,25 @@
+#include "descriptor.hpp"
+
+#include "device.hpp"
+
+namespace bi::rhi {
+
+DescriptorHeapNull::DescriptorHeapNull(Ref<DeviceNull> device, DescriptorHeapDesc const& desc)
+    : total_size_(static_cast<uint64_t>(desc.max_count) * descriptor_size)
+{
+    start_address_ = device->allocate_address_range(total_size_);
+}
+
+auto DescriptorHeapNull::size_of_descriptor(DescriptorType type) const -> uint32_t {
+    return type == DescriptorType::none || type == DescriptorType::count ? 0u : descriptor_size;
+}
+
+auto DescriptorHeapNull::size_of_descriptor(BindGroupLayout const& layout) const -> uint32_t {
+    uint32_t size = 0;
+    for (auto const& entry : layout) {
+        size += entry.count * size_of_descriptor(entry.type);
+    }
+    return size;
+}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <bisemutum/rhi/descriptor.hpp>
+
+namespace bi::rhi {
+
+struct DeviceNull;
+
+// Handles are fake addresses reserved from the device, no descriptor data is stored.
+struct DescriptorHeapNull final : DescriptorHeap {
+    static constexpr uint32_t descriptor_size = 32;
+
+    DescriptorHeapNull(Ref<DeviceNull> device, DescriptorHeapDesc const& desc);
+
+    auto total_heap_size() const -> uint64_t override { return total_size_; }
+
+    auto size_of_descriptor(DescriptorType type) const -> uint32_t override;
+    auto size_of_descriptor(BindGroupLayout const& layout) const -> uint32_t override;
+    auto alignment_of_descriptor(DescriptorType type) const -> uint32_t override { return descriptor_size; }
+    auto alignment_of_descriptor(BindGroupLayout const& layout) const -> uint32_t override { return descriptor_size; }
+
+    auto start_address() const -> DescriptorHandle override { return {start_address_, start_address_}; }
+
+private:
+    uint64_t total_size_;
+    uint64_t start_address_;
+};
+
+}
@@ -0,0 +1,317 @@
+#include "device.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+#include "command.hpp"
+#include "resource.hpp"
+#include "descriptor.hpp"
+#include "pipeline.hpp"
+#include "swapchain.hpp"
+#include "sync.hpp"
+
+namespace bi::rhi {
+
+auto null_device_statistics(CRef<Device> device) -> Option<NullDeviceStatistics> {
+    if (device->get_backend() != Backend::null) { return {}; }
+    return device.cast_to<DeviceNull const>()->statistics();
+}
+
+auto reset_null_device_statistics(Ref<Device> device) -> void {
+    if (device->get_backend() != Backend::null) { return; }
+    device.cast_to<DeviceNull>()->reset_statistics();
+}
+
+auto null_shader_module_binary(CRef<Device> device, CRef<ShaderModule> shader_module) -> Option<CSpan<std::byte>> {
+    if (device->get_backend() != Backend::null) { return {}; }
+    auto const& binary_data = shader_module.cast_to<ShaderModuleNull const>()->binary_data;
+    return CSpan<std::byte>{binary_data};
+}
+
+auto DeviceNull::create(DeviceDesc const& desc) -> Box<DeviceNull> {
+    return Box<DeviceNull>::make(desc);
+}
+
+DeviceNull::DeviceNull(DeviceDesc const& desc) : queue_(unsafe_make_ref(this)) {
+    device_properties_ = DeviceProperties{
+        .gpu_name = "Null Device",
+        .separate_sampler_heap = true,
+        .descriptor_heap_suballocation = true,
+        .meshlet_pipeline = false,
+        .raytracing_pipeline = false,
+        .draw_indirect_count = true,
+    };
+}
+
+auto DeviceNull::raytracing_shader_binding_table_requirements() const -> RaytracingShaderBindingTableRequirements {
+    return RaytracingShaderBindingTableRequirements{
+        .handle_size = RaytracingPipelineNull::shader_handle_size,
+        .handle_alignment = RaytracingPipelineNull::shader_handle_size,
+        .base_alignment = 64,
+    };
+}
+
+auto DeviceNull::get_queue(QueueType type) -> Ref<Queue> {
+    return queue_;
+}
+
+auto DeviceNull::create_command_pool(CommandPoolDesc const& desc) -> Box<CommandPool> {
+    return Box<CommandPoolNull>::make(unsafe_make_ref(this));
+}
+
+auto DeviceNull::create_swapchain(SwapchainDesc const& desc) -> Box<Swapchain> {
+    return Box<SwapchainNull>::make(desc);
+}
+
+auto DeviceNull::create_fence() -> Box<Fence> {
+    return Box<FenceNull>::make();
+}
+
+auto DeviceNull::create_semaphore() -> Box<Semaphore> {
+    return Box<SemaphoreNull>::make();
+}
+
+auto DeviceNull::create_buffer(BufferDesc const& desc) -> Box<Buffer> {
+    {
+        std::lock_guard lock{stats_mutex_};
+        ++stats_.buffers_created;
+    }
+    return Box<BufferNull>::make(desc);
+}
+
+auto DeviceNull::create_texture(TextureDesc const& desc) -> Box<Texture> {
+    {
+        std::lock_guard lock{stats_mutex_};
+        ++stats_.textures_created;
+    }
+    return Box<TextureNull>::make(desc);
+}
+
+auto DeviceNull::create_sampler(SamplerDesc const& desc) -> Box<Sampler> {
+    return Box<SamplerNull>::make(desc);
+}
+
+auto DeviceNull::create_acceleration_structure(AccelerationStructureDesc const& desc) -> Box<AccelerationStructure> {
+    auto address = allocate_address_range(std::max<uint64_t>(desc.buffer_range_size, 1));
+    return Box<AccelerationStructureNull>::make(desc, address);
+}
+
+auto DeviceNull::create_descriptor_heap(DescriptorHeapDesc const& desc) -> Box<DescriptorHeap> {
+    return Box<DescriptorHeapNull>::make(unsafe_make_ref(this), desc);
+}
+
+auto DeviceNull::create_shader_module(ShaderModuleDesc const& desc) -> Box<ShaderModule> {
+    return Box<ShaderModuleNull>::make(desc.binary_data);
+}
+
+auto DeviceNull::create_graphics_pipeline(GraphicsPipelineDesc const& desc) -> Box<GraphicsPipeline> {
+    {
+        std::lock_guard lock{stats_mutex_};
+        ++stats_.pipelines_created;
+    }
+    return Box<GraphicsPipelineNull>::make(desc);
+}
+
+auto DeviceNull::create_compute_pipeline(ComputePipelineDesc const& desc) -> Box<ComputePipeline> {
+    {
+        std::lock_guard lock{stats_mutex_};
+        ++stats_.pipelines_created;
+    }
+    return Box<ComputePipelineNull>::make(desc);
+}
+
+auto DeviceNull::create_raytracing_pipeline(RaytracingPipelineDesc const& desc) -> Box<RaytracingPipeline> {
+    {
+        std::lock_guard lock{stats_mutex_};
+        ++stats_.pipelines_created;
+    }
+    return Box<RaytracingPipelineNull>::make(desc);
+}
+
+auto DeviceNull::create_descriptor(BufferDescriptorDesc const& buffer_desc, DescriptorHandle handle) -> void {
+    std::lock_guard lock{stats_mutex_};
+    ++stats_.descriptor_writes;
+}
+auto DeviceNull::create_descriptor(TextureDescriptorDesc const& texture_desc, DescriptorHandle handle) -> void {
+    std::lock_guard lock{stats_mutex_};
+    ++stats_.descriptor_writes;
+}
+auto DeviceNull::create_descriptor(Ref<Sampler> sampler, DescriptorHandle handle) -> void {
+    std::lock_guard lock{stats_mutex_};
+    ++stats_.descriptor_writes;
+}
+auto DeviceNull::create_descriptor(Ref<AccelerationStructure> accel, DescriptorHandle handle) -> void {
+    std::lock_guard lock{stats_mutex_};
+    ++stats_.descriptor_writes;
+}
+
+auto DeviceNull::copy_descriptors(
+    DescriptorHandle dst_desciptor,
+    CSpan<DescriptorHandle> src_descriptors,
+    BindGroupLayout const& bind_group_layout
+) -> void {
+    std::lock_guard lock{stats_mutex_};
+    stats_.descriptor_copies += src_descriptors.size();
+}
+
+auto DeviceNull::get_acceleration_structure_memory_size(
+    AccelerationStructureGeometryBuildInput const& build_info
+) -> AccelerationStructureMemoryInfo {
+    uint64_t num_primitives = 0;
+    for (auto const& geometry : build_info.geometries) {
+        if (auto triangles = std::get_if<AccelerationStructureTriangleDesc>(&geometry.geometry); triangles) {
+            num_primitives += triangles->num_triangles;
+        } else {
+            num_primitives += std::get<AccelerationStructureProcedualDesc>(geometry.geometry).num_primitives;
+        }
+    }
+    auto size = std::max<uint64_t>(num_primitives, 1) * 64;
+    return AccelerationStructureMemoryInfo{
+        .acceleration_structure_size = size,
+        .build_scratch_size = size,
+        .update_scratch_size = size,
+    };
+}
+
+auto DeviceNull::get_acceleration_structure_memory_size(
+    AccelerationStructureInstanceBuildInput const& build_info
+) -> AccelerationStructureMemoryInfo {
+    auto size = std::max<uint64_t>(build_info.num_instances, 1) * 64;
+    return AccelerationStructureMemoryInfo{
+        .acceleration_structure_size = size,
+        .build_scratch_size = size,
+        .update_scratch_size = size,
+    };
+}
+
+auto DeviceNull::execute(NullCommandStream const& stream) -> void {
+    std::lock_guard lock{stats_mutex_};
+    ++stats_.submitted_command_buffers;
+    stats_.recorded_command_bytes += stream.data().size();
+
+    NullCommandReader reader{stream.data()};
+    while (reader.has_next()) {
+        switch (reader.read<NullCommandType>()) {
+            case NullCommandType::copy_buffer_to_buffer: {
+                auto src = reader.read<BufferNull const*>();
+                auto dst = reader.read<BufferNull*>();
+                auto src_offset = reader.read<uint64_t>();
+                auto dst_offset = reader.read<uint64_t>();
+                auto length = reader.read<uint64_t>();
+                // Buffers without storage have never been written and are read as zeros.
+                if (src->has_storage()) {
+                    std::memcpy(dst->storage() + dst_offset, src->storage() + src_offset, length);
+                } else if (dst->has_storage()) {
+                    std::memset(dst->storage() + dst_offset, 0, length);
+                }
+                stats_.bytes_copied += length;
+                if (src->desc().memory_property == BufferMemoryProperty::cpu_to_gpu) {
+                    stats_.bytes_uploaded += length;
+                }
+                break;
+            }
+            case NullCommandType::copy_buffer_to_texture: {
+                auto src = reader.read<BufferNull const*>();
+                auto size = reader.read<uint64_t>();
+                stats_.bytes_copied += size;
+                if (src->desc().memory_property == BufferMemoryProperty::cpu_to_gpu) {
+                    stats_.bytes_uploaded += size;
+                }
+                break;
+            }
+            case NullCommandType::copy_texture_to_texture:
+            case NullCommandType::copy_texture_to_buffer:
+                stats_.bytes_copied += reader.read<uint64_t>();
+                break;
+            case NullCommandType::build_bottom_level_acceleration_structure:
+                stats_.acceleration_structure_builds += reader.read<uint32_t>();
+                break;
+            case NullCommandType::build_top_level_acceleration_structure:
+                ++stats_.acceleration_structure_builds;
+                break;
+            case NullCommandType::resource_barriers:
+                stats_.buffer_barriers += reader.read<uint32_t>();
+                stats_.texture_barriers += reader.read<uint32_t>();
+                break;
+            case NullCommandType::set_descriptor_heaps:
+            case NullCommandType::set_viewports:
+            case NullCommandType::set_scissors:
+            case NullCommandType::set_vertex_buffer:
+                reader.read<uint32_t>();
+                break;
+            case NullCommandType::begin_render_pass:
+                reader.read<uint32_t>();
+                reader.read<uint8_t>();
+                ++stats_.render_passes;
+                break;
+            case NullCommandType::begin_compute_pass:
+                ++stats_.compute_passes;
+                break;
+            case NullCommandType::begin_raytracing_pass:
+                ++stats_.raytracing_passes;
+                break;
+            case NullCommandType::set_pipeline:
+                ++stats_.pipeline_binds;
+                break;
+            case NullCommandType::set_descriptors:
+                stats_.descriptor_binds += reader.read<uint32_t>();
+                break;
+            case NullCommandType::push_constants:
+                stats_.push_constant_bytes += reader.read<uint32_t>();
+                break;
+            case NullCommandType::draw:
+                reader.read<uint32_t>();
+                reader.read<uint32_t>();
+                ++stats_.draws;
+                break;
+            case NullCommandType::draw_indexed:
+                reader.read<uint32_t>();
+                reader.read<uint32_t>();
+                ++stats_.draw_indexed;
+                break;
+            case NullCommandType::draw_indexed_indirect_count:
+                reader.read<uint32_t>();
+                ++stats_.draw_indexed_indirect;
+                break;
+            case NullCommandType::dispatch:
+                reader.read<uint32_t>();
+                reader.read<uint32_t>();
+                reader.read<uint32_t>();
+                ++stats_.dispatches;
+                break;
+            case NullCommandType::dispatch_rays:
+                reader.read<uint32_t>();
+                reader.read<uint32_t>();
+                reader.read<uint32_t>();
+                ++stats_.dispatch_rays;
+                break;
+            case NullCommandType::push_label:
+            case NullCommandType::pop_label:
+            case NullCommandType::copy_acceleration_structure:
+            case NullCommandType::set_index_buffer:
+            case NullCommandType::end_render_pass:
+            case NullCommandType::end_compute_pass:
+            case NullCommandType::end_raytracing_pass:
+                break;
+        }
+    }
+}
+
+auto DeviceNull::allocate_address_range(uint64_t size) -> uint64_t {
+    std::lock_guard lock{address_mutex_};
+    auto address = next_address_;
+    next_address_ += (size + 255) & ~255ull;
+    return address;
+}
+
+auto DeviceNull::statistics() const -> NullDeviceStatistics {
+    std::lock_guard lock{stats_mutex_};
+    return stats_;
+}
+
+auto DeviceNull::reset_statistics() -> void {
+    std::lock_guard lock{stats_mutex_};
+    stats_ = {};
+}
+
+}
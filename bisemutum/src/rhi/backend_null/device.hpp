@@ -0,0 +1,89 @@
+#pragma once
+
+#include <mutex>
+
+#include <bisemutum/rhi/null_device.hpp>
+
+#include "queue.hpp"
+
+namespace bi::rhi {
+
+struct NullCommandStream;
+
+struct DeviceNull final : Device {
+    DeviceNull(DeviceDesc const& desc);
+
+    static auto create(DeviceDesc const& desc) -> Box<DeviceNull>;
+
+    auto get_backend() const -> Backend override { return Backend::null; }
+
+    auto raytracing_shader_binding_table_requirements() const -> RaytracingShaderBindingTableRequirements override;
+
+    auto get_queue(QueueType type) -> Ref<Queue> override;
+
+    auto create_command_pool(CommandPoolDesc const& desc) -> Box<CommandPool> override;
+
+    auto create_swapchain(SwapchainDesc const& desc) -> Box<Swapchain> override;
+
+    auto create_fence() -> Box<Fence> override;
+
+    auto create_semaphore() -> Box<Semaphore> override;
+
+    auto create_buffer(BufferDesc const& desc) -> Box<Buffer> override;
+
+    auto create_texture(TextureDesc const& desc) -> Box<Texture> override;
+
+    auto create_sampler(SamplerDesc const& desc) -> Box<Sampler> override;
+
+    auto create_acceleration_structure(AccelerationStructureDesc const& desc) -> Box<AccelerationStructure> override;
+
+    auto create_descriptor_heap(DescriptorHeapDesc const& desc) -> Box<DescriptorHeap> override;
+
+    auto create_shader_module(ShaderModuleDesc const& desc) -> Box<ShaderModule> override;
+
+    auto create_graphics_pipeline(GraphicsPipelineDesc const& desc) -> Box<GraphicsPipeline> override;
+
+    auto create_compute_pipeline(ComputePipelineDesc const& desc) -> Box<ComputePipeline> override;
+
+    auto create_raytracing_pipeline(RaytracingPipelineDesc const& desc) -> Box<RaytracingPipeline> override;
+
+    auto create_descriptor(BufferDescriptorDesc const& buffer_desc, DescriptorHandle handle) -> void override;
+    auto create_descriptor(TextureDescriptorDesc const& texture_desc, DescriptorHandle handle) -> void override;
+    auto create_descriptor(Ref<Sampler> sampler, DescriptorHandle handle) -> void override;
+    auto create_descriptor(Ref<AccelerationStructure> accel, DescriptorHandle handle) -> void override;
+
+    auto copy_descriptors(
+        DescriptorHandle dst_desciptor,
+        CSpan<DescriptorHandle> src_descriptors,
+        BindGroupLayout const& bind_group_layout
+    ) -> void override;
+
+    auto initialize_pipeline_cache_from(std::string_view cache_file_path) -> void override {}
+
+    auto get_acceleration_structure_memory_size(
+        AccelerationStructureGeometryBuildInput const& build_info
+    ) -> AccelerationStructureMemoryInfo override;
+    auto get_acceleration_structure_memory_size(
+        AccelerationStructureInstanceBuildInput const& build_info
+    ) -> AccelerationStructureMemoryInfo override;
+
+    // Replay a submitted command stream, only buffer copies take effect.
+    auto execute(NullCommandStream const& stream) -> void;
+
+    // Reserve a range of fake addresses, used as descriptor handles and acceleration structure references.
+    auto allocate_address_range(uint64_t size) -> uint64_t;
+
+    auto statistics() const -> NullDeviceStatistics;
+    auto reset_statistics() -> void;
+
+private:
+    QueueNull queue_;
+
+    mutable std::mutex stats_mutex_;
+    NullDeviceStatistics stats_;
+
+    std::mutex address_mutex_;
+    uint64_t next_address_ = 1ull << 32;
+};
+
+}
@@ -0,0 +1,25 @@
+#include "pipeline.hpp"
+
+#include <cstring>
+
+#include <bisemutum/prelude/math.hpp>
+
+namespace bi::rhi {
+
+auto RaytracingPipelineNull::get_shader_binding_table_sizes() const -> RaytracingShaderBindingTableSizes {
+    auto const& sizes = desc_.shader_record_sizes;
+    return RaytracingShaderBindingTableSizes{
+        .raygen_size = aligned_size(shader_handle_size + sizes.raygen, shader_handle_size),
+        .miss_stride = aligned_size(shader_handle_size + sizes.miss, shader_handle_size),
+        .hit_group_stride = aligned_size(shader_handle_size + sizes.hit_group, shader_handle_size),
+        .callable_stride = aligned_size(shader_handle_size + sizes.callable, shader_handle_size),
+    };
+}
+
+auto RaytracingPipelineNull::get_shader_handle(
+    RaytracingShaderBindingTableType type, uint32_t from_index, uint32_t count, void* dst_data
+) const -> void {
+    std::memset(dst_data, 0, static_cast<size_t>(count) * shader_handle_size);
+}
+
+}
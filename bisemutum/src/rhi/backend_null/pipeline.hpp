@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+#include <bisemutum/rhi/pipeline.hpp>
+
+namespace bi::rhi {
+
+struct ShaderModuleNull final : ShaderModule {
+    ShaderModuleNull(CSpan<std::byte> binary_data) : binary_data(binary_data.begin(), binary_data.end()) {}
+
+    std::vector<std::byte> binary_data;
+};
+
+struct GraphicsPipelineNull final : GraphicsPipeline {
+    GraphicsPipelineNull(GraphicsPipelineDesc const& desc) : GraphicsPipeline(desc) {}
+};
+
+struct ComputePipelineNull final : ComputePipeline {
+    ComputePipelineNull(ComputePipelineDesc const& desc) : ComputePipeline(desc) {}
+};
+
+struct RaytracingPipelineNull final : RaytracingPipeline {
+    static constexpr uint32_t shader_handle_size = 32;
+
+    RaytracingPipelineNull(RaytracingPipelineDesc const& desc) : RaytracingPipeline(desc) {}
+
+    auto get_shader_binding_table_sizes() const -> RaytracingShaderBindingTableSizes override;
+
+    auto get_shader_handle(
+        RaytracingShaderBindingTableType type, uint32_t from_index, uint32_t count, void* dst_data
+    ) const -> void override;
+};
+
+}
@@ -0,0 +1,22 @@
+#include "queue.hpp"
+
+#include "device.hpp"
+#include "command.hpp"
+
+namespace bi::rhi {
+
+QueueNull::QueueNull(Ref<DeviceNull> device) : device_(device) {}
+
+auto QueueNull::submit_command_buffer(
+    CSpan<Box<CommandBuffer>> cmd_buffers,
+    CSpan<CRef<Semaphore>> wait_semaphores,
+    CSpan<CRef<Semaphore>> signal_semaphores,
+    Option<Ref<Fence>> signal_fence
+) const -> void {
+    // Commands are replayed synchronously, so semaphores and fences are always signaled.
+    for (auto& cmd_buffer : cmd_buffers) {
+        device_->execute(cmd_buffer.ref().cast_to<CommandBufferNull>()->stream());
+    }
+}
+
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <bisemutum/rhi/queue.hpp>
+
+namespace bi::rhi {
+
+struct DeviceNull;
+
+struct QueueNull final : Queue {
+    QueueNull(Ref<DeviceNull> device);
+
+    auto wait_idle() const -> void override {}
+
+    auto submit_command_buffer(
+        CSpan<Box<CommandBuffer>> cmd_buffers,
+        CSpan<CRef<Semaphore>> wait_semaphores,
+        CSpan<CRef<Semaphore>> signal_semaphores,
+        Option<Ref<Fence>> signal_fence
+    ) const -> void override;
+
+private:
+    Ref<DeviceNull> device_;
+};
+
+}
@@ -0,0 +1,12 @@
+#include "resource.hpp"
+
+namespace bi::rhi {
+
+auto BufferNull::storage() -> std::byte* {
+    if (data_.empty() && desc_.size > 0) {
+        data_.resize(desc_.size);
+    }
+    return data_.data();
+}
+
+}
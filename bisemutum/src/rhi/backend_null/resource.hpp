@@ -0,0 +1,45 @@
+#pragma once
+
+#include <bisemutum/rhi/resource.hpp>
+#include <bisemutum/rhi/sampler.hpp>
+#include <bisemutum/rhi/accel.hpp>
+
+namespace bi::rhi {
+
+// Storage is allocated when the buffer is mapped or written by a copy,
+// so that GPU-only buffers never touched by the CPU cost nothing.
+struct BufferNull final : Buffer {
+    BufferNull(BufferDesc const& desc) { desc_ = desc; }
+
+    auto map() -> void* override { return storage(); }
+
+    auto unmap() -> void override {}
+
+    auto storage() -> std::byte*;
+    auto has_storage() const -> bool { return !data_.empty(); }
+    auto storage() const -> std::byte const* { return data_.data(); }
+
+private:
+    std::vector<std::byte> data_;
+};
+
+// Texels are not stored.
+struct TextureNull final : Texture {
+    TextureNull(TextureDesc const& desc) { desc_ = desc; }
+};
+
+struct SamplerNull final : Sampler {
+    SamplerNull(SamplerDesc const& desc) { desc_ = desc; }
+};
+
+struct AccelerationStructureNull final : AccelerationStructure {
+    AccelerationStructureNull(AccelerationStructureDesc const& desc, uint64_t address)
+        : address_(address) { desc_ = desc; }
+
+    auto gpu_reference() const -> uint64_t override { return address_; }
+
+private:
+    uint64_t address_;
+};
+
+}
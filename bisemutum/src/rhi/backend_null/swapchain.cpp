@@ -0,0 +1,19 @@
+#include "swapchain.hpp"
+
+namespace bi::rhi {
+
+SwapchainNull::SwapchainNull(SwapchainDesc const& desc) {
+    resize(desc.width, desc.height);
+}
+
+auto SwapchainNull::resize(uint32_t width, uint32_t height) -> void {
+    texture_ = Box<TextureNull>::make(TextureDesc{
+        .extent = {width, height, 1},
+        .levels = 1,
+        .format = format(),
+        .dim = TextureDimension::d2,
+        .usages = TextureUsage::color_attachment,
+    });
+}
+
+}
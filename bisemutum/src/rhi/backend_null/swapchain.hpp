@@ -0,0 +1,28 @@
+#pragma once
+
+#include <bisemutum/prelude/box.hpp>
+#include <bisemutum/rhi/swapchain.hpp>
+
+#include "resource.hpp"
+
+namespace bi::rhi {
+
+// Always presents the same texture, nothing is shown on the window.
+struct SwapchainNull final : Swapchain {
+    SwapchainNull(SwapchainDesc const& desc);
+
+    auto resize(uint32_t width, uint32_t height) -> void override;
+
+    auto acquire_next_texture(Ref<Semaphore> acquired_semaphore) -> bool override { return true; }
+
+    auto current_texture() -> Ref<Texture> override { return texture_.ref(); }
+
+    auto present(CSpan<Ref<Semaphore>> wait_semaphores) -> void override {}
+
+    auto format() const -> ResourceFormat override { return ResourceFormat::bgra8_unorm; }
+
+private:
+    Box<TextureNull> texture_;
+};
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <bisemutum/rhi/sync.hpp>
+
+namespace bi::rhi {
+
+// Submitted commands are finished immediately, so the fence is always signaled.
+struct FenceNull final : Fence {
+    auto reset() -> void override {}
+
+    auto signal_on(Ref<const Queue> queue) -> void override {}
+
+    auto wait(uint64_t timeout) -> void override {}
+
+    auto is_finished() -> bool override { return true; }
+};
+
+struct SemaphoreNull final : Semaphore {};
+
+}
@@ -912,6 +912,19 @@ auto GraphicsCommandEncoderVulkan::draw_indexed(
     vkCmdDrawIndexed(cmd_buffer_, num_indices, num_instance, first_index, vertex_offset, first_instance);
 }
 
+auto GraphicsCommandEncoderVulkan::draw_indexed_indirect_count(
+    Ref<Buffer> buffer, uint64_t offset,
+    Ref<Buffer> count_buffer, uint64_t count_offset,
+    uint32_t max_num_draws, uint32_t stride
+) -> void {
+    vkCmdDrawIndexedIndirectCount(
+        cmd_buffer_,
+        buffer.cast_to<BufferVulkan>()->raw(), offset,
+        count_buffer.cast_to<BufferVulkan>()->raw(), count_offset,
+        max_num_draws, stride
+    );
+}
+
 
 ComputeCommandEncoderVulkan::ComputeCommandEncoderVulkan(
     Ref<DeviceVulkan> device, Ref<CommandEncoderVulkan> base_encoder, bool has_label
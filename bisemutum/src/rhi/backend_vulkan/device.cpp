@@ -352,6 +352,7 @@ auto DeviceVulkan::pick_device(DeviceDesc const& desc) -> void {
     }
 
     vkGetPhysicalDeviceFeatures2(physical_device_, &device_features);
+    device_properties_.draw_indirect_count = vk12_features.drawIndirectCount;
 
     VkDeviceCreateInfo device_ci{
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
@@ -94,4 +94,30 @@ auto format_texel_size(ResourceFormat format) -> uint32_t {
     }
 }
 
+
+auto format_block_size(ResourceFormat format) -> uint32_t {
+    switch (format) {
+        case ResourceFormat::bc1_rgb_unorm:
+        case ResourceFormat::bc1_rgb_srgb:
+        case ResourceFormat::bc1_rgba_unorm:
+        case ResourceFormat::bc1_rgba_srgb:
+        case ResourceFormat::bc4_unorm:
+        case ResourceFormat::bc4_snorm:
+            return 8;
+        case ResourceFormat::bc2_unorm:
+        case ResourceFormat::bc2_srgb:
+        case ResourceFormat::bc3_unorm:
+        case ResourceFormat::bc3_srgb:
+        case ResourceFormat::bc5_unorm:
+        case ResourceFormat::bc5_snorm:
+        case ResourceFormat::bc6h_ufloat:
+        case ResourceFormat::bc6h_sfloat:
+        case ResourceFormat::bc7_unorm:
+        case ResourceFormat::bc7_sgrb:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
 }
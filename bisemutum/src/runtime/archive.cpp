@@ -0,0 +1,282 @@
+#include <bisemutum/runtime/archive.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+#include <bisemutum/runtime/logger.hpp>
+#include <bisemutum/utils/crypto.hpp>
+
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
+#include <miniz.h>
+
+namespace bi::rt {
+
+static_assert(sizeof(ArchiveHeader) == 40);
+static_assert(sizeof(ArchiveEntry) == 48);
+
+namespace {
+
+auto align_up(uint64_t value, uint64_t alignment) -> uint64_t {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+auto entry_path_of(ArchiveEntry const& entry, CSpan<std::byte> string_pool) -> std::string_view {
+    return {reinterpret_cast<char const*>(string_pool.data()) + entry.path_offset, entry.path_length};
+}
+
+} // namespace
+
+auto archive_path_hash(std::string_view path) -> uint64_t {
+    return crypto::fnv1a_64(path);
+}
+
+auto build_archive(
+    std::filesystem::path const& src_dir, std::filesystem::path const& dst_path, ArchiveBuildSettings const& settings
+) -> bool {
+    if (!std::filesystem::is_directory(src_dir)) {
+        log::error("general", "Archive source directory '{}' not found.", src_dir.string());
+        return false;
+    }
+    auto dst_abs_path = std::filesystem::absolute(dst_path).lexically_normal();
+
+    std::vector<std::pair<std::string, std::filesystem::path>> files{};
+    for (auto const& dir_entry : std::filesystem::recursive_directory_iterator{src_dir}) {
+        if (!dir_entry.is_regular_file()) { continue; }
+        if (std::filesystem::absolute(dir_entry.path()).lexically_normal() == dst_abs_path) { continue; }
+        auto rel_path = dir_entry.path().lexically_relative(src_dir).generic_string();
+        files.emplace_back(std::move(rel_path), dir_entry.path());
+    }
+    // Make the pack reproducible.
+    std::sort(files.begin(), files.end());
+
+    std::ofstream fout(dst_path, std::ios::binary);
+    if (!fout) {
+        log::error("general", "Failed to create archive '{}'.", dst_path.string());
+        return false;
+    }
+    uint64_t curr_offset = 0;
+    auto write_at = [&fout, &curr_offset](uint64_t offset, void const* data, size_t size) {
+        static constexpr char zeros[archive_page_alignment]{};
+        while (curr_offset < offset) {
+            auto padding = std::min<uint64_t>(offset - curr_offset, archive_page_alignment);
+            fout.write(zeros, padding);
+            curr_offset += padding;
+        }
+        fout.write(static_cast<char const*>(data), size);
+        curr_offset += size;
+    };
+
+    ArchiveHeader header{};
+    write_at(0, &header, sizeof(header));
+
+    std::vector<ArchiveEntry> entries{};
+    entries.reserve(files.size());
+    std::string string_pool{};
+    std::vector<std::byte> compressed_data{};
+    for (auto const& [rel_path, path] : files) {
+        PhysicalFile file{path, false};
+        auto data = file.map_binary_data();
+
+        auto& entry = entries.emplace_back();
+        entry.path_hash = archive_path_hash(rel_path);
+        entry.path_offset = string_pool.size();
+        entry.path_length = rel_path.size();
+        entry.size = data.size();
+        string_pool += rel_path;
+
+        auto chunk = data;
+        entry.chunk_type = ArchiveChunkType::stored;
+        if (settings.compress && !data.empty()) {
+            auto compressed_length = mz_compressBound(data.size());
+            compressed_data.resize(compressed_length);
+            auto result = mz_compress(
+                reinterpret_cast<unsigned char*>(compressed_data.data()), &compressed_length,
+                reinterpret_cast<unsigned char const*>(data.data()), data.size()
+            );
+            auto max_length = static_cast<uint64_t>(data.size() * (1.0f - settings.min_compression_saving));
+            if (result == MZ_OK && compressed_length <= max_length) {
+                entry.chunk_type = ArchiveChunkType::compressed;
+                chunk = {compressed_data.data(), compressed_length};
+            }
+        }
+
+        auto alignment = entry.chunk_type == ArchiveChunkType::stored
+            ? archive_page_alignment : archive_chunk_alignment;
+        entry.chunk_offset = align_up(curr_offset, alignment);
+        entry.chunk_size = chunk.size();
+        write_at(entry.chunk_offset, chunk.data(), chunk.size());
+    }
+
+    std::sort(entries.begin(), entries.end(), [&string_pool](ArchiveEntry const& a, ArchiveEntry const& b) {
+        if (a.path_hash != b.path_hash) { return a.path_hash < b.path_hash; }
+        return std::string_view{string_pool}.substr(a.path_offset, a.path_length)
+            < std::string_view{string_pool}.substr(b.path_offset, b.path_length);
+    });
+
+    header.num_entries = entries.size();
+    header.entries_offset = align_up(curr_offset, archive_chunk_alignment);
+    write_at(header.entries_offset, entries.data(), entries.size() * sizeof(ArchiveEntry));
+    header.string_pool_offset = curr_offset;
+    header.string_pool_size = string_pool.size();
+    write_at(header.string_pool_offset, string_pool.data(), string_pool.size());
+
+    fout.seekp(0);
+    fout.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    if (!fout) {
+        log::error("general", "Failed to write archive '{}'.", dst_path.string());
+        return false;
+    }
+    log::info("general", "Packed {} files into '{}' ({} bytes).", entries.size(), dst_path.string(), curr_offset);
+    return true;
+}
+
+
+ArchiveFile::ArchiveFile(PhysicalFile pack, ArchiveEntry const& entry, std::string path)
+    : pack_(std::move(pack)), entry_(entry), path_(std::move(path)) {}
+
+auto ArchiveFile::filename() const -> std::string {
+    return path_.substr(path_.rfind('/') + 1);
+}
+auto ArchiveFile::extension() const -> std::string {
+    auto filename = this->filename();
+    auto p = filename.rfind('.');
+    return p == std::string::npos ? std::string{} : filename.substr(p);
+}
+
+auto ArchiveFile::read_string_data() -> std::string {
+    auto data = map_binary_data();
+    return {reinterpret_cast<char const*>(data.data()), data.size()};
+}
+auto ArchiveFile::read_binary_data() -> std::vector<std::byte> {
+    if (entry_.chunk_type == ArchiveChunkType::compressed && !decompressed_) {
+        return decompress();
+    }
+    auto data = map_binary_data();
+    return {data.begin(), data.end()};
+}
+auto ArchiveFile::map_binary_data() -> CSpan<std::byte> {
+    if (entry_.chunk_type == ArchiveChunkType::stored) {
+        return chunk_data();
+    }
+    if (!decompressed_) {
+        decompressed_data_ = decompress();
+        decompressed_ = true;
+    }
+    return decompressed_data_;
+}
+
+auto ArchiveFile::chunk_data() -> CSpan<std::byte> {
+    auto pack_data = pack_.map_binary_data();
+    return {pack_data.data() + entry_.chunk_offset, entry_.chunk_size};
+}
+
+auto ArchiveFile::decompress() -> std::vector<std::byte> {
+    auto chunk = chunk_data();
+    std::vector<std::byte> data(entry_.size);
+    mz_ulong length = entry_.size;
+    auto result = mz_uncompress(
+        reinterpret_cast<unsigned char*>(data.data()), &length,
+        reinterpret_cast<unsigned char const*>(chunk.data()), chunk.size()
+    );
+    if (result != MZ_OK || length != entry_.size) {
+        log::error("general", "Failed to decompress '{}' from archive.", path_);
+        return {};
+    }
+    return data;
+}
+
+
+struct ArchiveSubFileSystem::Impl final {
+    Impl(std::filesystem::path pack_path) : pack(std::move(pack_path), false) {
+        auto data = pack.map_binary_data();
+        if (data.size() < sizeof(ArchiveHeader)) {
+            log::error("general", "Archive '{}' is invalid.", pack.filename());
+            return;
+        }
+        ArchiveHeader header{};
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.magic_number != archive_magic_number || header.version != archive_version) {
+            log::error("general", "Archive '{}' is invalid or of unsupported version.", pack.filename());
+            return;
+        }
+        if (
+            !is_range_in(header.entries_offset, header.num_entries, sizeof(ArchiveEntry), data.size())
+            || !is_range_in(header.string_pool_offset, header.string_pool_size, 1, data.size())
+            || header.entries_offset % alignof(ArchiveEntry) != 0
+        ) {
+            log::error("general", "Archive '{}' is truncated.", pack.filename());
+            return;
+        }
+        // Entries are aligned in the pack and used in place.
+        entries = {
+            reinterpret_cast<ArchiveEntry const*>(data.data() + header.entries_offset), header.num_entries
+        };
+        string_pool = {data.data() + header.string_pool_offset, header.string_pool_size};
+        // Files are read without further checks, so a broken entry invalidates the whole pack.
+        for (auto const& entry : entries) {
+            if (
+                !is_range_in(entry.chunk_offset, entry.chunk_size, 1, data.size())
+                || !is_range_in(entry.path_offset, entry.path_length, 1, string_pool.size())
+                || (entry.chunk_type == ArchiveChunkType::stored && entry.chunk_size != entry.size)
+                || (entry.chunk_type != ArchiveChunkType::stored && entry.chunk_type != ArchiveChunkType::compressed)
+            ) {
+                log::error("general", "Archive '{}' has invalid entries.", pack.filename());
+                entries = {};
+                string_pool = {};
+                return;
+            }
+        }
+        if (!std::is_sorted(entries.begin(), entries.end(), [](ArchiveEntry const& a, ArchiveEntry const& b) {
+            return a.path_hash < b.path_hash;
+        })) {
+            log::error("general", "Archive '{}' has unsorted entries.", pack.filename());
+            entries = {};
+            string_pool = {};
+            return;
+        }
+        valid = true;
+    }
+
+    // `offset + count * stride <= size` without overflow.
+    static auto is_range_in(uint64_t offset, uint64_t count, uint64_t stride, uint64_t size) -> bool {
+        return offset <= size && count <= (size - offset) / stride;
+    }
+
+    auto find_entry(std::string_view path) const -> ArchiveEntry const* {
+        auto hash = archive_path_hash(path);
+        auto it = std::lower_bound(
+            entries.begin(), entries.end(), hash,
+            [](ArchiveEntry const& entry, uint64_t hash) { return entry.path_hash < hash; }
+        );
+        for (; it != entries.end() && it->path_hash == hash; it++) {
+            if (entry_path_of(*it, string_pool) == path) { return it; }
+        }
+        return nullptr;
+    }
+
+    // Copies share the mapping.
+    PhysicalFile pack;
+    CSpan<ArchiveEntry> entries;
+    CSpan<std::byte> string_pool;
+    bool valid = false;
+};
+
+ArchiveSubFileSystem::ArchiveSubFileSystem(std::filesystem::path pack_path) : PImpl(std::move(pack_path)) {}
+
+auto ArchiveSubFileSystem::is_valid() const -> bool {
+    return impl()->valid;
+}
+
+auto ArchiveSubFileSystem::has_file(std::string_view path) const -> bool {
+    return impl()->find_entry(path) != nullptr;
+}
+
+auto ArchiveSubFileSystem::get_file(std::string_view path) const -> Option<Dyn<IFile>::Box> {
+    if (auto entry = impl()->find_entry(path); entry) {
+        return Dyn<IFile>::Box{ArchiveFile{impl()->pack, *entry, std::string{path}}};
+    }
+    return {};
+}
+
+}
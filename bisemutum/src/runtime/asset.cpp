@@ -21,6 +21,10 @@ auto AssetPtr::load() const -> AssetAny* {
     return g_engine->asset_manager()->load_asset(asset_id);
 }
 
+auto AssetPtr::load_async() const -> AssetState {
+    return g_engine->asset_manager()->load_async(asset_id);
+}
+
 auto AssetPtr::edit(std::string_view type) -> bool {
     auto asset_mgr = g_engine->asset_manager();
 
@@ -40,25 +44,4 @@ auto AssetPtr::edit(std::string_view type) -> bool {
     return edited;
 }
 
-
-auto check_if_binary_asset_valid(
-    std::string_view filename, uint32_t magic_number, std::string const& type_name, std::string_view expected_type_name
-) -> bool {
-    if (magic_number != rt::asset_magic_number) {
-        log::critical(
-            "general",
-            "Failed to load {} ('{}'): Invalid file data.", expected_type_name, filename
-        );
-        return false;
-    }
-    if (type_name != expected_type_name) {
-        log::critical(
-            "general",
-            "Failed to load {} ('{}'): Incorrect asset type name.", expected_type_name, filename
-        );
-        return false;
-    }
-    return true;
-}
-
 }
@@ -1,38 +1,97 @@
 #include <bisemutum/runtime/asset_manager.hpp>
 
+#include <chrono>
+#include <future>
+#include <unordered_set>
+
 #include <bisemutum/engine/engine.hpp>
 #include <bisemutum/runtime/vfs.hpp>
+#include <bisemutum/runtime/asset_metadata_index.hpp>
 #include <bisemutum/runtime/logger.hpp>
+#include <bisemutum/runtime/thread_pool.hpp>
 #include <bisemutum/containers/hash.hpp>
 
 namespace bi::rt {
 
 namespace {
 
+constexpr std::string_view engine_asset_metadata_path = "/bisemutum/assets/asset_metadata.toml";
+
 auto is_asset_id_builtin(uint64_t asset_id) -> bool {
     return (asset_id & (1ull << 62)) != 0;
 }
 
 }
 
-struct AssetManager::Impl final {
-    auto initialize(Dyn<IFile>::Ref metadata_file) -> bool {
-        next_id = 0;
-
-        auto engine_assets_metadata_file =
-            g_engine->file_system()->get_file("/bisemutum/assets/asset_metadata.toml").value();
-        if (!load_metadata_from(*&engine_assets_metadata_file)) { return false; }
+auto asset_metadata_index_path(std::string_view metadata_path) -> std::string {
+    auto path = std::string{metadata_path};
+    if (auto p = path.rfind('.'); p != std::string::npos && path.find('/', p) == std::string::npos) {
+        path.resize(p);
+    }
+    return path + std::string{asset_metadata_index_extension};
+}
 
-        if (!load_metadata_from(metadata_file)) { return false; }
+struct AssetManager::Impl final {
+    ~Impl() {
+        // Loaders and files referenced by running tasks must outlive them.
+        for (auto& [_, pending] : pending_loads) {
+            if (pending.decoded.valid()) {
+                pending.decoded.wait();
+            }
+        }
+    }
 
+    auto initialize(std::string_view metadata_path) -> bool {
+        next_id = 0;
+        if (!load_metadata(engine_asset_metadata_path, false)) { return false; }
+        if (!load_metadata(metadata_path, true)) { return false; }
         return true;
     }
-    auto load_metadata_from(Dyn<IFile>::Ref metadata_file) -> bool {
-        auto metadata_str = metadata_file.read_string_data();
+    auto load_metadata(std::string_view metadata_path, bool is_project) -> bool {
+        auto fs = g_engine->file_system();
+        auto metadata_file = fs->get_file(metadata_path);
+        auto metadata_hash = metadata_file ? crypto::md5(metadata_file.value().map_binary_data()) : crypto::MD5{};
+
+        if (auto index_file = fs->get_file(asset_metadata_index_path(metadata_path)); index_file) {
+            auto index_opt = AssetMetadataIndex::load(std::move(index_file).value());
+            if (!index_opt) {
+                log::warn("general", "Asset metadata index of '{}' is invalid, it's imported again.", metadata_path);
+            } else if (metadata_file && index_opt.value().source_hash() != metadata_hash) {
+                log::warn(
+                    "general", "Asset metadata '{}' is changed after the index is written, it's imported again.",
+                    metadata_path
+                );
+            } else {
+                auto const& index = index_opt.value();
+                assets.reserve(assets.size() + index.size());
+                for (size_t i = 0; i < index.size(); i++) {
+                    auto data = index[i];
+                    add_metadata(AssetMetadata{
+                        .id = data.id,
+                        .type = std::string{data.type},
+                        .path = std::string{data.path},
+                    });
+                }
+                ++next_id;
+                if (is_project) {
+                    project_index = IndexState{
+                        .source_hash = index.source_hash(),
+                        .is_written = true,
+                        .num_sorted = index.num_sorted(),
+                        .num_appended = index.num_appended(),
+                    };
+                }
+                return true;
+            }
+        }
 
+        if (!metadata_file) {
+            log::critical("general", "Asset metadata file '{}' not found.", metadata_path);
+            return false;
+        }
         std::vector<AssetMetadata> metadata;
         try {
-            auto value = serde::Value::from_toml(metadata_str);
+            auto value = serde::Value::from_toml(metadata_file.value().read_string_data());
             if (value.contains("assets")) {
                 metadata = value["assets"].get<decltype(metadata)>();
             }
@@ -43,18 +102,26 @@ struct AssetManager::Impl final {
 
         assets.reserve(assets.size() + metadata.size());
         for (auto &data : metadata) {
-            auto it = assets.try_emplace(data.id, Asset{.metadata = std::move(data)}).first;
-            if (!is_asset_id_builtin(data.id)) {
-                next_id = std::max(next_id, data.id);
-            }
-            auto asset_id = static_cast<AssetId>(it->first);
-            assets_path_map[it->second.metadata.path] = asset_id;
-            assets_type_map[it->second.metadata.type].push_back(asset_id);
+            add_metadata(std::move(data));
         }
         ++next_id;
 
+        if (is_project) {
+            // Write the index now, so that the next startup doesn't need to parse TOML.
+            project_index = IndexState{.source_hash = metadata_hash};
+            save_metadata_index(metadata_path);
+        }
         return true;
     }
+    auto add_metadata(AssetMetadata&& data) -> void {
+        if (!is_asset_id_builtin(data.id)) {
+            next_id = std::max(next_id, data.id);
+        }
+        auto it = assets.try_emplace(data.id, Asset{.metadata = std::move(data)}).first;
+        auto asset_id = static_cast<AssetId>(it->first);
+        assets_path_map[it->second.metadata.path] = asset_id;
+        assets_type_map[it->second.metadata.type].push_back(asset_id);
+    }
 
     auto register_asset(std::string_view type, AssetFunctions&& functions) -> void {
         asset_functions.insert({type, std::move(functions)});
@@ -102,15 +169,192 @@ struct AssetManager::Impl final {
         if (it == assets.end()) {
             return nullptr;
         }
-        if (it->second.state == AssetState::not_loaded) {
-            auto& loader = asset_functions.at(it->second.metadata.type).loader;
-            auto asset_file = g_engine->file_system()->get_file(it->second.metadata.path).value();
-            it->second.content = loader(*&asset_file);
-            it->second.state = it->second.content.has_value() ? AssetState::loaded : AssetState::error;
-            return std::addressof(it->second.content);
-        } else {
-            return std::addressof(it->second.content);
+        auto& asset = it->second;
+        if (asset.state == AssetState::not_loaded) {
+            auto asset_file = get_asset_file(asset.metadata.path);
+            if (!asset_file) {
+                asset.state = AssetState::error;
+                return std::addressof(asset.content);
+            }
+            auto& functions = asset_functions.at(asset.metadata.type);
+            asset.content = functions.loader(*&asset_file.value());
+            if (!asset.content.has_value()) {
+                asset.state = AssetState::error;
+            } else if (!functions.finalizer) {
+                asset.state = AssetState::loaded;
+            } else {
+                asset.state = AssetState::loading;
+                pending_loads.try_emplace(it->first);
+                finish_pending_load(it->first, true);
+            }
+        } else if (asset.state == AssetState::loading) {
+            finish_pending_load(it->first, true);
+        }
+        return std::addressof(asset.content);
+    }
+
+    auto load_async(AssetId asset_id, std::function<AssetLoadCallback> callback) -> AssetState {
+        auto it = assets.find(static_cast<uint64_t>(asset_id));
+        if (it == assets.end()) {
+            if (callback) { callback(nullptr); }
+            return AssetState::not_found;
+        }
+        auto& asset = it->second;
+        auto& functions = asset_functions.at(asset.metadata.type);
+        if (asset.state == AssetState::not_loaded && !functions.finalizer) {
+            load_asset(asset_id);
+        } else if (asset.state == AssetState::not_loaded) {
+            auto asset_file = get_asset_file(asset.metadata.path);
+            if (asset_file) {
+                asset.state = AssetState::loading;
+                auto& pending = pending_loads[it->first];
+                pending.decoded = g_engine->thread_pool()->async(
+                    [loader = &functions.loader, file = std::move(asset_file.value())]() mutable {
+                        return (*loader)(*&file);
+                    }
+                );
+            } else {
+                asset.state = AssetState::error;
+            }
+        }
+
+        if (asset.state == AssetState::loading) {
+            if (callback) {
+                pending_loads.at(it->first).callbacks.push_back(std::move(callback));
+            }
+        } else if (callback) {
+            callback(asset.state == AssetState::loaded ? std::addressof(asset.content) : nullptr);
+        }
+        return asset.state;
+    }
+
+    auto update() -> void {
+        // Finalizers and callbacks may start new loads, which are handled in the next update.
+        std::vector<uint64_t> pending_ids{};
+        pending_ids.reserve(pending_loads.size());
+        for (auto& [id, _] : pending_loads) {
+            pending_ids.push_back(id);
+        }
+        for (auto id : pending_ids) {
+            finish_pending_load(id, false);
+        }
+    }
+
+    auto unload_asset(AssetId asset_id) -> AssetAny {
+        auto it = assets.find(static_cast<uint64_t>(asset_id));
+        if (it == assets.end() || it->second.state != AssetState::loaded || it->second.dirty) {
+            return {};
         }
+        auto& asset = it->second;
+        auto content = std::move(asset.content);
+        asset.content = {};
+        asset.state = AssetState::not_loaded;
+        return content;
+    }
+
+    auto reload_changed_assets(CSpan<std::string> changed_paths) -> void {
+        auto now = std::chrono::steady_clock::now();
+        std::erase_if(saved_times, [now](auto const& entry) { return now - entry.second > saved_file_ignore_time; });
+
+        for (auto const& path : changed_paths) {
+            if (saved_times.contains(path)) { continue; }
+            auto path_it = assets_path_map.find(path);
+            if (path_it == assets_path_map.end()) { continue; }
+            auto id = static_cast<uint64_t>(path_it->second);
+            auto& asset = assets.at(id);
+            if (asset.state == AssetState::error) {
+                // Try again when it's required next time.
+                asset.state = AssetState::not_loaded;
+                continue;
+            }
+            if (asset.state != AssetState::loaded) { continue; }
+            if (asset.dirty) {
+                log::warn("general", "Asset '{}' is changed on disk but has unsaved changes, it's not reloaded.", path);
+                continue;
+            }
+
+            auto asset_file = g_engine->file_system()->get_file(path);
+            if (!asset_file) { continue; }
+            auto& functions = asset_functions.at(asset.metadata.type);
+            auto content = functions.loader(*&asset_file.value());
+            if (!content.has_value()) {
+                log::error("general", "Failed to reload asset '{}', the old one is kept.", path);
+                continue;
+            }
+            functions.replacer(asset.content, std::move(content));
+            log::info("general", "Reloaded asset '{}'.", path);
+            if (functions.finalizer) {
+                asset.state = AssetState::loading;
+                pending_loads.try_emplace(id);
+                finish_pending_load(id, false);
+            }
+        }
+    }
+
+    auto get_asset_file(std::string_view path) -> Option<Dyn<IFile>::Box> {
+        auto asset_file = g_engine->file_system()->get_file(path);
+        if (!asset_file) {
+            log::error("general", "Asset file '{}' not found.", path);
+        }
+        return asset_file;
+    }
+
+    // Return true if the load is finished (successfully or not).
+    // When `wait` is true, block until it's decoded and load dependencies synchronously if needed.
+    auto finish_pending_load(uint64_t id, bool wait) -> bool {
+        auto pending_it = pending_loads.find(id);
+        if (pending_it == pending_loads.end()) {
+            return true;
+        }
+        if (finishing_loads.contains(id)) {
+            return false;
+        }
+        auto& asset = assets.at(id);
+
+        auto& decoded = pending_it->second.decoded;
+        if (decoded.valid()) {
+            if (!wait && decoded.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+                return false;
+            }
+            asset.content = decoded.get();
+            if (!asset.content.has_value()) {
+                asset.state = AssetState::error;
+            }
+        }
+
+        finishing_loads.insert(id);
+        auto& finalizer = asset_functions.at(asset.metadata.type).finalizer;
+        while (asset.state == AssetState::loading) {
+            asset.state = finalizer(asset.content);
+            if (asset.state != AssetState::loading || !wait) { break; }
+
+            auto progressed = false;
+            std::vector<uint64_t> dependency_ids{};
+            for (auto& [dependency_id, _] : pending_loads) {
+                if (!finishing_loads.contains(dependency_id)) {
+                    dependency_ids.push_back(dependency_id);
+                }
+            }
+            for (auto dependency_id : dependency_ids) {
+                progressed |= finish_pending_load(dependency_id, true);
+            }
+            if (!progressed) {
+                log::error("general", "Failed to load asset '{}': Dependencies can't be loaded.", asset.metadata.path);
+                asset.state = AssetState::error;
+            }
+        }
+        finishing_loads.erase(id);
+        if (asset.state == AssetState::loading) {
+            return false;
+        }
+
+        auto callbacks = std::move(pending_loads.at(id).callbacks);
+        pending_loads.erase(id);
+        auto content = asset.state == AssetState::loaded ? std::addressof(asset.content) : nullptr;
+        for (auto& callback : callbacks) {
+            callback(content);
+        }
+        return true;
     }
 
     auto create_asset(
@@ -124,28 +368,91 @@ struct AssetManager::Impl final {
         it->second.metadata = {it->first, std::string{asset_type_name}, std::string{asset_path}};
         assets_path_map[it->second.metadata.path] = id;
         assets_type_map[it->second.metadata.type].push_back(id);
+        unindexed_ids.push_back(it->first);
         return {id, std::addressof(it->second.content)};
     }
 
-    auto save_all_assets(Dyn<IFile>::Ref metadata_file, bool force) -> void {
+    auto save_all_assets(std::string_view metadata_path, bool force) -> void {
+        // Files are created here, while assets are serialized and written on worker threads.
+        std::vector<std::pair<Ref<Asset>, Dyn<IFile>::Box>> assets_to_save;
         for (auto& [_, asset] : assets) {
             if ((!force && !asset.dirty) || !asset.content.has_value()) { continue; }
             auto asset_file = g_engine->file_system()->create_file(asset.metadata.path).value();
-            auto& saver = asset_functions[asset.metadata.type].saver;
-            saver(*&asset_file, asset.content);
+            assets_to_save.emplace_back(asset, std::move(asset_file));
             asset.dirty = false;
+            saved_times.insert_or_assign(asset.metadata.path, std::chrono::steady_clock::now());
+        }
+        g_engine->thread_pool()->parallel_for(assets_to_save.size(), [this, &assets_to_save](size_t index) {
+            auto& [asset, asset_file] = assets_to_save[index];
+            auto const& saver = asset_functions.at(asset->metadata.type).saver;
+            saver(*&asset_file, asset->content);
+        });
+
+        // Exporting serializes and hashes all metadata, so it's only done when forced. Other saves only append to
+        // the index, which keeps the hash of the last exported file, so that it's still used on the next startup.
+        if (force) {
+            std::vector<AssetMetadata> metadata{};
+            metadata.reserve(assets.size());
+            for (auto& [_, asset] : assets) {
+                if (is_asset_id_builtin(asset.metadata.id)) { continue; }
+                metadata.push_back(asset.metadata);
+            }
+            serde::Value value{};
+            serde::to_value(value["assets"], metadata);
+            auto metadata_toml = value.to_toml();
+            auto metadata_file = g_engine->file_system()->create_file(metadata_path).value();
+            metadata_file.write_string_data(metadata_toml);
+            // The index is written again with the hash of the exported file.
+            auto metadata_bytes = CSpan<std::byte>{
+                reinterpret_cast<std::byte const*>(metadata_toml.data()), metadata_toml.size()
+            };
+            project_index = IndexState{.source_hash = crypto::md5(metadata_bytes)};
+        }
+        save_metadata_index(metadata_path);
+    }
+
+    auto save_metadata_index(std::string_view metadata_path) -> void {
+        auto index_path = asset_metadata_index_path(metadata_path);
+        auto index_file = g_engine->file_system()->create_file(index_path);
+        if (!index_file) {
+            log::error("general", "Failed to create asset metadata index '{}'.", index_path);
+            return;
         }
 
-        std::vector<AssetMetadata> metadata{};
+        // Rewrite the index if appended records would outnumber sorted ones.
+        auto can_append = project_index.is_written
+            && project_index.num_appended + unindexed_ids.size() <= project_index.num_sorted;
+        if (can_append && unindexed_ids.empty()) { return; }
+        if (can_append) {
+            std::vector<AssetMetadataView> metadata{};
+            metadata.reserve(unindexed_ids.size());
+            for (auto id : unindexed_ids) {
+                auto const& data = assets.at(id).metadata;
+                metadata.push_back(AssetMetadataView{.id = data.id, .type = data.type, .path = data.path});
+            }
+            if (AssetMetadataIndex::append(*&index_file.value(), metadata, project_index.source_hash)) {
+                project_index.num_appended += unindexed_ids.size();
+                unindexed_ids.clear();
+                return;
+            }
+        }
+
+        std::vector<AssetMetadataView> metadata{};
         metadata.reserve(assets.size());
         for (auto& [_, asset] : assets) {
             if (is_asset_id_builtin(asset.metadata.id)) { continue; }
-            metadata.push_back(asset.metadata);
+            auto const& data = asset.metadata;
+            metadata.push_back(AssetMetadataView{.id = data.id, .type = data.type, .path = data.path});
+        }
+        auto num_entries = metadata.size();
+        if (!AssetMetadataIndex::write(*&index_file.value(), std::move(metadata), project_index.source_hash)) {
+            log::error("general", "Failed to write asset metadata index '{}'.", index_path);
+            return;
         }
-        serde::Value value{};
-        serde::to_value(value["assets"], metadata);
-        auto metadata_toml = value.to_toml();
-        metadata_file.write_string_data(metadata_toml);
+        project_index.is_written = true;
+        project_index.num_sorted = num_entries;
+        project_index.num_appended = 0;
+        unindexed_ids.clear();
     }
 
     struct Asset final {
@@ -155,16 +462,39 @@ struct AssetManager::Impl final {
         bool dirty = false;
     };
     std::unordered_map<uint64_t, Asset> assets;
+
+    struct PendingLoad final {
+        // Invalid after it's decoded, while the asset waits for dependencies in the finalizer.
+        std::future<AssetAny> decoded;
+        std::vector<std::function<AssetLoadCallback>> callbacks;
+    };
+    std::unordered_map<uint64_t, PendingLoad> pending_loads;
+    std::unordered_set<uint64_t> finishing_loads;
+
     std::unordered_map<std::string_view, AssetId> assets_path_map;
     std::unordered_map<std::string_view, std::vector<AssetId>> assets_type_map;
     uint64_t next_id;
     std::unordered_map<std::string_view, AssetFunctions> asset_functions;
+
+    // State of the index file of project assets, so that new assets can be appended to it.
+    struct IndexState final {
+        crypto::MD5 source_hash{};
+        bool is_written = false;
+        size_t num_sorted = 0;
+        size_t num_appended = 0;
+    } project_index;
+    // Assets created after the index is written.
+    std::vector<uint64_t> unindexed_ids;
+
+    // Changes of files written by the manager itself are reported a bit later, and they are ignored.
+    static constexpr auto saved_file_ignore_time = std::chrono::seconds{2};
+    StringHashMap<std::chrono::steady_clock::time_point> saved_times;
 };
 
 AssetManager::AssetManager() = default;
 
-auto AssetManager::initialize(Dyn<IFile>::Ref metadata_file) -> bool {
-    return impl()->initialize(metadata_file);
+auto AssetManager::initialize(std::string_view metadata_path) -> bool {
+    return impl()->initialize(metadata_path);
 }
 
 auto AssetManager::register_asset(std::string_view type, AssetFunctions&& functions) -> void {
@@ -175,6 +505,22 @@ auto AssetManager::state_of(AssetId asset_id) -> AssetState {
     return impl()->state_of(asset_id);
 }
 
+auto AssetManager::load_async(AssetId asset_id, std::function<AssetLoadCallback> callback) -> AssetState {
+    return impl()->load_async(asset_id, std::move(callback));
+}
+
+auto AssetManager::update() -> void {
+    impl()->update();
+}
+
+auto AssetManager::unload_asset(AssetId asset_id) -> AssetAny {
+    return impl()->unload_asset(asset_id);
+}
+
+auto AssetManager::reload_changed_assets(CSpan<std::string> changed_paths) -> void {
+    impl()->reload_changed_assets(changed_paths);
+}
+
 auto AssetManager::metadata_of(AssetId asset_id) const -> CPtr<AssetMetadata> {
     return impl()->metadata_of(asset_id);
 }
@@ -197,8 +543,8 @@ auto AssetManager::create_asset(
     return impl()->create_asset(asset_type_name, asset_path, std::move(asset));
 }
 
-auto AssetManager::save_all_assets(Dyn<IFile>::Ref metadata_file, bool force) -> void {
-    impl()->save_all_assets(metadata_file, force);
+auto AssetManager::save_all_assets(std::string_view metadata_path, bool force) -> void {
+    impl()->save_all_assets(metadata_path, force);
 }
 
 }
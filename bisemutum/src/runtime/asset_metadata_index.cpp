@@ -0,0 +1,173 @@
+#include <bisemutum/runtime/asset_metadata_index.hpp>
+
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+#include <bisemutum/prelude/byte_stream.hpp>
+#include <bisemutum/runtime/logger.hpp>
+
+namespace bi::rt {
+
+static_assert(sizeof(AssetMetadataIndexHeader) == 56);
+static_assert(sizeof(AssetMetadataIndexEntry) == 24);
+static_assert(sizeof(AssetMetadataIndexType) == 8);
+
+namespace {
+
+constexpr size_t appended_record_header_size = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+constexpr uint32_t source_hash_record_type_length = ~0u;
+
+} // namespace
+
+auto AssetMetadataIndex::load(Dyn<IFile>::Box file) -> Option<AssetMetadataIndex> {
+    AssetMetadataIndex index{std::move(file)};
+    auto data = index.file_.map_binary_data();
+    auto& header = index.header_;
+    if (data.size() < sizeof(header)) { return {}; }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic_number != asset_metadata_index_magic_number || header.version != asset_metadata_index_version) {
+        return {};
+    }
+
+    auto entries_offset = sizeof(header);
+    auto types_offset = entries_offset + header.num_entries * sizeof(AssetMetadataIndexEntry);
+    auto type_pool_offset = types_offset + header.num_types * sizeof(AssetMetadataIndexType);
+    auto path_pool_offset = type_pool_offset + header.type_pool_size;
+    auto appended_offset = path_pool_offset + header.path_pool_size;
+    if (appended_offset > data.size()) {
+        log::error("general", "Asset metadata index '{}' is truncated.", index.file_.filename());
+        return {};
+    }
+    // Entries and types are aligned in the file and used in place.
+    index.entries_ = {
+        reinterpret_cast<AssetMetadataIndexEntry const*>(data.data() + entries_offset), header.num_entries
+    };
+    index.types_ = {reinterpret_cast<AssetMetadataIndexType const*>(data.data() + types_offset), header.num_types};
+    index.type_pool_ = {reinterpret_cast<char const*>(data.data() + type_pool_offset), header.type_pool_size};
+    index.path_pool_ = {reinterpret_cast<char const*>(data.data() + path_pool_offset), header.path_pool_size};
+    index.source_hash_ = header.source_hash;
+
+    for (auto offset = appended_offset; offset + appended_record_header_size <= data.size();) {
+        uint64_t id = 0;
+        uint32_t type_length = 0;
+        uint32_t path_length = 0;
+        std::memcpy(&id, data.data() + offset, sizeof(id));
+        std::memcpy(&type_length, data.data() + offset + sizeof(id), sizeof(type_length));
+        std::memcpy(&path_length, data.data() + offset + sizeof(id) + sizeof(type_length), sizeof(path_length));
+        offset += appended_record_header_size;
+        if (type_length == source_hash_record_type_length) {
+            if (path_length != sizeof(crypto::MD5) || offset + path_length > data.size()) { break; }
+            std::memcpy(&index.source_hash_, data.data() + offset, sizeof(crypto::MD5));
+            offset += path_length;
+            continue;
+        }
+        // An interrupted append leaves a partial record, which is ignored.
+        if (offset + type_length + path_length > data.size()) { break; }
+        auto chars = reinterpret_cast<char const*>(data.data() + offset);
+        index.appended_.push_back(AssetMetadataView{
+            .id = id,
+            .type = {chars, type_length},
+            .path = {chars + type_length, path_length},
+        });
+        offset += type_length + path_length;
+    }
+    return index;
+}
+
+auto AssetMetadataIndex::write(
+    Dyn<IFile>::Ref file, std::vector<AssetMetadataView> metadata, crypto::MD5 const& source_hash
+) -> bool {
+    std::sort(metadata.begin(), metadata.end(), [](AssetMetadataView const& a, AssetMetadataView const& b) {
+        return a.id < b.id;
+    });
+
+    std::vector<AssetMetadataIndexEntry> entries{};
+    entries.reserve(metadata.size());
+    std::vector<AssetMetadataIndexType> types{};
+    std::unordered_map<std::string_view, uint32_t> type_indices{};
+    std::string type_pool{};
+    std::string path_pool{};
+    for (auto const& data : metadata) {
+        auto [type_it, is_new_type] = type_indices.try_emplace(data.type, static_cast<uint32_t>(types.size()));
+        if (is_new_type) {
+            types.push_back(AssetMetadataIndexType{
+                .offset = static_cast<uint32_t>(type_pool.size()),
+                .length = static_cast<uint32_t>(data.type.size()),
+            });
+            type_pool += data.type;
+        }
+        entries.push_back(AssetMetadataIndexEntry{
+            .id = data.id,
+            .path_offset = path_pool.size(),
+            .path_length = static_cast<uint32_t>(data.path.size()),
+            .type_index = type_it->second,
+        });
+        path_pool += data.path;
+    }
+
+    AssetMetadataIndexHeader header{
+        .num_entries = entries.size(),
+        .num_types = types.size(),
+        .type_pool_size = type_pool.size(),
+        .path_pool_size = path_pool.size(),
+        .source_hash = source_hash,
+    };
+    WriteByteStream bs{};
+    bs.reserve(
+        sizeof(header) + entries.size() * sizeof(AssetMetadataIndexEntry)
+        + types.size() * sizeof(AssetMetadataIndexType) + type_pool.size() + path_pool.size()
+    );
+    bs.write(header);
+    bs.write_raw(reinterpret_cast<std::byte const*>(entries.data()), entries.size() * sizeof(AssetMetadataIndexEntry));
+    bs.write_raw(reinterpret_cast<std::byte const*>(types.data()), types.size() * sizeof(AssetMetadataIndexType));
+    bs.write_raw(reinterpret_cast<std::byte const*>(type_pool.data()), type_pool.size());
+    bs.write_raw(reinterpret_cast<std::byte const*>(path_pool.data()), path_pool.size());
+    return file.write_binary_data(bs.data());
+}
+
+auto AssetMetadataIndex::append(
+    Dyn<IFile>::Ref file, CSpan<AssetMetadataView> metadata, crypto::MD5 const& source_hash
+) -> bool {
+    WriteByteStream bs{};
+    for (auto const& data : metadata) {
+        bs.write(data.id)
+            .write(static_cast<uint32_t>(data.type.size()))
+            .write(static_cast<uint32_t>(data.path.size()));
+        bs.write_raw(reinterpret_cast<std::byte const*>(data.type.data()), data.type.size());
+        bs.write_raw(reinterpret_cast<std::byte const*>(data.path.data()), data.path.size());
+    }
+    // Written last, so that an interrupted append keeps the old hash and the TOML file is imported again.
+    bs.write(uint64_t{0}).write(source_hash_record_type_length).write(static_cast<uint32_t>(sizeof(crypto::MD5)));
+    bs.write_raw(reinterpret_cast<std::byte const*>(&source_hash), sizeof(crypto::MD5));
+    return file.append_binary_data(bs.data());
+}
+
+auto AssetMetadataIndex::operator[](size_t index) const -> AssetMetadataView {
+    return index < entries_.size() ? view_of(entries_[index]) : appended_[index - entries_.size()];
+}
+
+auto AssetMetadataIndex::find(uint64_t id) const -> Option<AssetMetadataView> {
+    auto it = std::lower_bound(
+        entries_.begin(), entries_.end(), id,
+        [](AssetMetadataIndexEntry const& entry, uint64_t id) { return entry.id < id; }
+    );
+    if (it != entries_.end() && it->id == id) {
+        return view_of(*it);
+    }
+    for (auto const& data : appended_) {
+        if (data.id == id) { return data; }
+    }
+    return {};
+}
+
+auto AssetMetadataIndex::view_of(AssetMetadataIndexEntry const& entry) const -> AssetMetadataView {
+    auto const& type = types_[entry.type_index];
+    return AssetMetadataView{
+        .id = entry.id,
+        .type = type_pool_.substr(type.offset, type.length),
+        .path = path_pool_.substr(entry.path_offset, entry.path_length),
+    };
+}
+
+}
@@ -49,5 +49,15 @@ auto ComponentManager::get_serializer(std::string_view type) const -> std::funct
 auto ComponentManager::get_editor(std::string_view type) const -> std::function<ComponentEditor> const& {
     return get_metadata(type).editor;
 }
+auto ComponentManager::get_bulk_serializer(
+    std::string_view type
+) const -> std::function<ComponentBulkSerializer> const& {
+    return get_metadata(type).bulk_serializer;
+}
+auto ComponentManager::get_bulk_deserializer(
+    std::string_view type
+) const -> std::function<ComponentBulkDeserializer> const& {
+    return get_metadata(type).bulk_deserializer;
+}
 
 }
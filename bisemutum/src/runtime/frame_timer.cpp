@@ -1,5 +1,7 @@
 #include <bisemutum/runtime/frame_timer.hpp>
 
+#include <algorithm>
+
 namespace bi::rt {
 
 auto FrameTimer::delta_time() -> double {
@@ -24,6 +26,14 @@ auto FrameTimer::reset() -> void {
 }
 
 auto FrameTimer::tick() -> void {
+    if (fixed_delta_time_ > 0.0) {
+        delta_time_ = fixed_delta_time_;
+        prev_time_ += std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+            std::chrono::duration<double>{delta_time_}
+        );
+        return;
+    }
+
     auto curr_time = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> delta = curr_time - prev_time_;
     delta_time_ = delta.count();
@@ -41,6 +51,10 @@ auto FrameTimer::start() -> void {
     }
 }
 
+auto FrameTimer::set_fixed_delta_time(double fixed_delta_time) -> void {
+    fixed_delta_time_ = std::max(fixed_delta_time, 0.0);
+}
+
 auto FrameTimer::stop() -> void {
     if (!stopped_) {
         stop_time_ = std::chrono::high_resolution_clock::now();
@@ -13,6 +13,8 @@ auto to_spd_log_level(LogLevel log_level) -> spdlog::level::level_enum {
 
 }
 
+LoggerManager* g_logger_manager = nullptr;
+
 LoggerManager::LoggerManager() {
     auto sink_console = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
     sink_console->set_pattern("%^[%Y-%m-%d %H:%M:%S.%e] [%l] [%n] [thread %t] %v%$");
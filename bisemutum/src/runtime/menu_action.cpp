@@ -27,9 +27,7 @@ auto menu_action_add_prefab_to_scene(MenuActionContext const& ctx) -> void {
             if (vfs_choosed_path.empty()) { return; }
             auto asset_id = g_engine->asset_manager()->asset_id_of(vfs_choosed_path);
             if (asset_id == rt::AssetId::invalid) { return; }
-            rt::TAssetPtr<rt::Prefab> prefab{asset_id};
-            prefab.load();
-            prefab.asset()->instantiate();
+            rt::Prefab::instantiate_async(asset_id);
         }
     );
 }
@@ -12,29 +12,35 @@
 namespace bi::rt {
 
 auto Prefab::load(Dyn<rt::IFile>::Ref file) -> rt::AssetAny {
-    auto prefab_mgr = g_engine->system_manager()->get_global_system<PrefabManager>();
-
     Prefab prefab{};
-    prefab.object_ = prefab_mgr->scene()->create_scene_object(nullptr, false);
+    prefab.value_ = serde::Value::from_toml(file.read_string_data());
+    return prefab;
+}
+
+auto Prefab::finalize_load() -> AssetState {
+    auto prefab_mgr = g_engine->system_manager()->get_global_system<PrefabManager>();
+    object_ = prefab_mgr->scene()->create_scene_object(nullptr, false);
 
-    auto value = serde::Value::from_toml(file.read_string_data());
-    auto table = value.get_ref<serde::Value::Table>();
+    // The parsed file is not needed anymore.
+    auto value = std::move(value_);
+    value_ = {};
+    auto& table = value.get_ref<serde::Value::Table>();
 
     if (auto it = table.find("components"); it != table.end()) {
         for (auto& component_value : it->second.get_ref<serde::Value::Array>()) {
             auto deserializer = g_engine->component_manager()->get_deserializer(
                 component_value["type"].get_ref<serde::Value::String>()
             );
-            deserializer(prefab.object_.value(), component_value["value"]);
+            deserializer(object_.value(), component_value["value"]);
         }
     }
     if (auto it = table.find("name"); it != table.end()) {
-        prefab.object_.value()->set_name(it->second.get_ref<serde::Value::String>());
+        object_.value()->set_name(it->second.get_ref<serde::Value::String>());
     }
 
     if (auto it = table.find("objects"); it != table.end()) {
         auto& scene_objects_value = it->second.get_ref<serde::Value::Array>();
-        std::vector<Ref<SceneObject>> parsed_objects{prefab.object_.value()};
+        std::vector<Ref<SceneObject>> parsed_objects{object_.value()};
         parsed_objects.reserve(scene_objects_value.size() + 1);
         std::vector<int> objects_parent;
         objects_parent.reserve(scene_objects_value.size());
@@ -42,7 +48,7 @@ auto Prefab::load(Dyn<rt::IFile>::Ref file) -> rt::AssetAny {
             auto& object_table = object_value.get_ref<serde::Value::Table>();
             auto parent = object_table.at("parent").get<int>();
             objects_parent.push_back(parent);
-            parsed_objects.push_back(prefab_mgr->scene()->create_scene_object(prefab.object_.value(), false));
+            parsed_objects.push_back(prefab_mgr->scene()->create_scene_object(object_.value(), false));
             if (auto it = object_table.find("components"); it != object_table.end()) {
                 for (auto& component_value : it->second.get_ref<serde::Value::Array>()) {
                     auto deserializer = g_engine->component_manager()->get_deserializer(
@@ -60,7 +66,7 @@ auto Prefab::load(Dyn<rt::IFile>::Ref file) -> rt::AssetAny {
         }
     }
 
-    return prefab;
+    return AssetState::loaded;
 }
 
 auto Prefab::create_from(CRef<SceneObject> object, std::string_view dst_path) -> void {
@@ -109,9 +115,19 @@ auto Prefab::save(Dyn<rt::IFile>::Ref file) const -> void {
     file.write_string_data(value.to_toml());
 }
 
-auto Prefab::instantiate() -> void {
+auto Prefab::instantiate() -> Ref<SceneObject> {
     auto current_scene = g_engine->world()->current_scene().value();
-    object_->clone(true, current_scene);
+    return object_->clone(true, current_scene);
+}
+
+auto Prefab::instantiate_async(AssetId prefab_id, std::function<auto(Ptr<SceneObject>) -> void> callback) -> void {
+    g_engine->asset_manager()->load_async(prefab_id, [callback = std::move(callback)](AssetAny* prefab) {
+        Ptr<SceneObject> object = nullptr;
+        if (prefab) {
+            object = aa::any_cast<Prefab&>(*prefab).instantiate();
+        }
+        if (callback) { callback(object); }
+    });
 }
 
 }
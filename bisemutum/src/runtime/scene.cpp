@@ -1,10 +1,14 @@
 #include <bisemutum/runtime/scene.hpp>
 
 #include <vector>
+#include <map>
+
+#include <fmt/format.h>
 
 #include <bisemutum/engine/engine.hpp>
 #include <bisemutum/runtime/scene_object.hpp>
 #include <bisemutum/runtime/component_manager.hpp>
+#include <bisemutum/runtime/logger.hpp>
 
 namespace bi::rt {
 
@@ -172,4 +176,111 @@ auto Scene::save_to_value(serde::Value& value) const -> void {
     }
 }
 
+
+// Binary layout:
+// magic, version, parent index of each object, name of each object,
+// then for each component type: type name, indices of owner objects, byte size of the blob and the blob itself.
+auto Scene::load_from_byte_stream(ReadByteStream& bs) -> std::vector<Ref<SceneObject>> {
+    uint32_t magic_number = 0;
+    uint32_t version = 0;
+    bs.read(magic_number).read(version);
+    if (magic_number != scene_magic_number) {
+        throw serde::Exception{"invalid binary scene data"};
+    }
+    if (version != scene_binary_version) {
+        throw serde::Exception{fmt::format("unsupported binary scene version {}", version)};
+    }
+
+    std::vector<int32_t> objects_parent;
+    bs.read(objects_parent);
+    std::vector<Ref<SceneObject>> parsed_objects;
+    parsed_objects.reserve(objects_parent.size());
+    std::string name;
+    for (size_t i = 0; i < objects_parent.size(); i++) {
+        parsed_objects.push_back(create_scene_object(nullptr, false));
+        bs.read(name);
+        parsed_objects.back()->set_name(name);
+    }
+
+    uint64_t num_component_types = 0;
+    bs.read(num_component_types);
+    std::string component_type;
+    std::vector<uint32_t> component_owners;
+    std::vector<Ref<SceneObject>> component_objects;
+    for (uint64_t i = 0; i < num_component_types; i++) {
+        uint64_t blob_size = 0;
+        bs.read(component_type).read(component_owners).read(blob_size);
+        auto blob_end = bs.curr_offset() + blob_size;
+
+        auto metadata = g_engine->component_manager()->try_get_metadata(component_type);
+        if (!metadata) {
+            log::warn("general", "Unknown component type '{}' in binary scene, skipped.", component_type);
+            bs.set_offset(blob_end);
+            continue;
+        }
+        component_objects.clear();
+        component_objects.reserve(component_owners.size());
+        for (auto owner : component_owners) {
+            component_objects.push_back(parsed_objects.at(owner));
+        }
+        metadata->bulk_deserializer(bs, component_objects);
+        bs.set_offset(blob_end);
+    }
+
+    std::vector<Ref<SceneObject>> root_objects;
+    for (size_t i = 0; i < parsed_objects.size(); i++) {
+        if (objects_parent[i] >= 0 && static_cast<size_t>(objects_parent[i]) < parsed_objects.size()) {
+            parsed_objects[i]->attach_under(parsed_objects[objects_parent[i]]);
+        } else {
+            root_objects.push_back(parsed_objects[i]);
+        }
+    }
+    return root_objects;
+}
+auto Scene::save_to_byte_stream(WriteByteStream& bs) const -> void {
+    std::vector<CRef<SceneObject>> root_objects;
+    for_each_root_object([&root_objects](CRef<SceneObject> object) {
+        root_objects.push_back(object);
+    });
+    save_to_byte_stream(bs, root_objects);
+}
+auto Scene::save_to_byte_stream(WriteByteStream& bs, CSpan<CRef<SceneObject>> root_objects) const -> void {
+    std::vector<CRef<SceneObject>> objects{root_objects.begin(), root_objects.end()};
+    std::vector<int32_t> objects_parent(objects.size(), -1);
+    for (size_t i = 0; i < objects.size(); i++) {
+        objects[i]->for_each_children([&objects, &objects_parent, i](CRef<SceneObject> ch) {
+            objects.push_back(ch);
+            objects_parent.push_back(static_cast<int32_t>(i));
+        });
+    }
+
+    struct ComponentsOfType final {
+        std::vector<uint32_t> owners;
+        std::vector<void const*> values;
+    };
+    std::map<std::string_view, ComponentsOfType> components;
+    for (size_t i = 0; i < objects.size(); i++) {
+        objects[i]->for_each_component([&components, i](std::string_view component_type, void const* component_value) {
+            auto& components_of_type = components[component_type];
+            components_of_type.owners.push_back(static_cast<uint32_t>(i));
+            components_of_type.values.push_back(component_value);
+        });
+    }
+
+    bs.write(scene_magic_number).write(scene_binary_version);
+    bs.write(objects_parent);
+    for (auto object : objects) {
+        bs.write(object->get_name());
+    }
+    bs.write(static_cast<uint64_t>(components.size()));
+    WriteByteStream blob_bs{};
+    for (auto& [component_type, components_of_type] : components) {
+        blob_bs.clear();
+        auto& serializer = g_engine->component_manager()->get_bulk_serializer(component_type);
+        serializer(blob_bs, components_of_type.values);
+        bs.write(component_type).write(components_of_type.owners).write(static_cast<uint64_t>(blob_bs.data().size()));
+        bs.write_raw(blob_bs.data().data(), blob_bs.data().size());
+    }
+}
+
 }
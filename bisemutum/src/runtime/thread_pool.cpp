@@ -0,0 +1,127 @@
+#include <bisemutum/runtime/thread_pool.hpp>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <queue>
+
+namespace bi::rt {
+
+namespace {
+
+struct ParallelForState final {
+    std::function<auto(size_t) -> void> func;
+    size_t count = 0;
+    std::atomic<size_t> next_index = 0;
+    std::atomic<size_t> num_finished = 0;
+    std::mutex finished_mutex;
+    std::condition_variable finished_cv;
+
+    auto run() -> void {
+        size_t num_done = 0;
+        for (auto index = next_index.fetch_add(1); index < count; index = next_index.fetch_add(1)) {
+            func(index);
+            ++num_done;
+        }
+        if (num_done > 0 && num_finished.fetch_add(num_done) + num_done == count) {
+            std::lock_guard lock{finished_mutex};
+            finished_cv.notify_all();
+        }
+    }
+};
+
+} // namespace
+
+ThreadPool* g_thread_pool = nullptr;
+
+struct ThreadPool::Impl final {
+    Impl(uint32_t num_threads) {
+        if (num_threads == 0) {
+            num_threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+        workers.reserve(num_threads);
+        for (uint32_t i = 0; i < num_threads; i++) {
+            workers.emplace_back([this]() { worker_loop(); });
+        }
+    }
+    ~Impl() {
+        {
+            std::lock_guard lock{tasks_mutex};
+            stopping = true;
+        }
+        tasks_cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    auto submit(std::function<auto() -> void>&& task) -> void {
+        {
+            std::lock_guard lock{tasks_mutex};
+            tasks.push(std::move(task));
+        }
+        tasks_cv.notify_one();
+    }
+
+    auto parallel_for(size_t count, std::function<auto(size_t) -> void>&& func) -> void {
+        if (count == 0) { return; }
+        if (count == 1) {
+            func(0);
+            return;
+        }
+
+        auto state = std::make_shared<ParallelForState>();
+        state->func = std::move(func);
+        state->count = count;
+        auto num_helpers = std::min(count - 1, workers.size());
+        for (size_t i = 0; i < num_helpers; i++) {
+            submit([state]() { state->run(); });
+        }
+        state->run();
+
+        std::unique_lock lock{state->finished_mutex};
+        state->finished_cv.wait(lock, [&state, count]() { return state->num_finished.load() == count; });
+    }
+
+    auto worker_loop() -> void {
+        while (true) {
+            std::function<auto() -> void> task;
+            {
+                std::unique_lock lock{tasks_mutex};
+                tasks_cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) { return; }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<auto() -> void>> tasks;
+    std::mutex tasks_mutex;
+    std::condition_variable tasks_cv;
+    bool stopping = false;
+};
+
+ThreadPool::ThreadPool(uint32_t num_threads) : PImpl(num_threads) {}
+
+auto ThreadPool::num_threads() const -> uint32_t {
+    return static_cast<uint32_t>(impl()->workers.size());
+}
+
+auto ThreadPool::submit(std::function<auto() -> void> task) -> void {
+    impl()->submit(std::move(task));
+}
+
+auto ThreadPool::parallel_for(size_t count, std::function<auto(size_t) -> void> func) -> void {
+    impl()->parallel_for(count, std::move(func));
+}
+auto ThreadPool::parallel_for_fn() -> std::function<auto(size_t, std::function<auto(size_t) -> void>) -> void> {
+    return [this](size_t count, std::function<auto(size_t) -> void> func) {
+        parallel_for(count, std::move(func));
+    };
+}
+
+}
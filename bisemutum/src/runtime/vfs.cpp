@@ -1,7 +1,25 @@
 #include <bisemutum/runtime/vfs.hpp>
 
 #include <list>
+#include <atomic>
 #include <fstream>
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
 
 #include <bisemutum/prelude/ref.hpp>
 #include <bisemutum/containers/hash.hpp>
@@ -44,6 +62,52 @@ auto normalize_path(std::string_view path) -> std::string {
     return normalized_path;
 }
 
+// Return null if the file can't be mapped, e.g. when it's empty.
+auto map_physical_file(std::filesystem::path const& path) -> std::pair<std::shared_ptr<std::byte const>, size_t> {
+#ifdef _WIN32
+    auto file = CreateFileW(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) { return {}; }
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return {};
+    }
+    auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) { return {}; }
+    auto ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!ptr) { return {}; }
+    return {
+        std::shared_ptr<std::byte const>{
+            static_cast<std::byte const*>(ptr), [](std::byte const* ptr) { UnmapViewOfFile(ptr); }
+        },
+        static_cast<size_t>(size.QuadPart),
+    };
+#else
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { return {}; }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return {};
+    }
+    size_t size = st.st_size;
+    auto ptr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) { return {}; }
+    return {
+        std::shared_ptr<std::byte const>{
+            static_cast<std::byte const*>(ptr),
+            [size](std::byte const* ptr) { ::munmap(const_cast<std::byte*>(ptr), size); }
+        },
+        size,
+    };
+#endif
+}
+
 struct VirtualDirectory final {
     auto create_dir(std::string_view path) -> Ptr<VirtualDirectory> {
         auto normalized_path = normalize_path(path);
@@ -159,6 +223,17 @@ struct VirtualDirectory final {
         return sub_fs_pars;
     }
 
+    // Visit all mounted sub file systems with their mount paths like "/project/".
+    template <typename F>
+    auto for_each_sub_fs(std::string const& path, F&& func) -> void {
+        if (sub_fs_.has_value()) {
+            func(path, *&sub_fs_.value());
+        }
+        for (auto& [name, dir] : name_map_) {
+            dir->for_each_sub_fs(path + name + '/', func);
+        }
+    }
+
     auto has_sub_fs() const -> bool { return sub_fs_.has_value(); }
     auto get_sub_fs() -> Dyn<ISubFileSystem>::Ptr { return &sub_fs_.value(); }
     auto get_sub_fs() const -> Dyn<ISubFileSystem>::CPtr { return &sub_fs_.value(); }
@@ -210,6 +285,7 @@ struct FileSystem::Impl final {
             return false;
         } else {
             dir->set_sub_fs(std::move(sub_fs));
+            clear_path_cache();
             return true;
         }
     }
@@ -218,6 +294,7 @@ struct FileSystem::Impl final {
         auto dir = root.get_dir(target);
         if (dir.has_value() && dir->has_sub_fs()) {
             dir->reset_sub_fs();
+            clear_path_cache();
             return true;
         } else {
             return false;
@@ -230,16 +307,59 @@ struct FileSystem::Impl final {
     }
 
     auto get_file(std::string_view path) const -> Option<Dyn<IFile>::Box> {
+        uint64_t generation = 0;
+        {
+            std::shared_lock lock{path_cache_mutex};
+            generation = path_cache_generation;
+            if (auto it = path_cache.find(path); it != path_cache.end()) {
+                auto const& resolved = it->second;
+                if (!resolved.sub_fs.has_value()) {
+                    ++path_cache_hits;
+                    return {};
+                }
+                auto sub_fs = resolved.sub_fs.value();
+                if (auto file = sub_fs.get_file(resolved.sub_path); file.has_value()) {
+                    ++path_cache_hits;
+                    return file;
+                }
+                // The file is removed outside of the file system, resolve it again.
+            }
+        }
+        ++path_cache_misses;
+
+        ResolvedPath resolved{.normalized_path = normalize_path(path)};
+        Option<Dyn<IFile>::Box> file{};
         auto sub_fs_pairs = root.collect_sub_fs(path);
         for (auto it = sub_fs_pairs.rbegin(); it != sub_fs_pairs.rend(); it++) {
-            if (auto file = it->second.get_file(it->first); file.has_value()) {
-                return file;
+            if (file = it->second.get_file(it->first); file.has_value()) {
+                resolved.sub_fs = it->second;
+                resolved.sub_path = std::move(it->first);
+                break;
             }
         }
-        return {};
+        std::unique_lock lock{path_cache_mutex};
+        // The path is resolved without the lock, drop the result if the cache is invalidated meanwhile.
+        if (generation != path_cache_generation) { return file; }
+        if (auto it = path_cache.find(path); it != path_cache.end()) {
+            if (!it->second.sub_fs.has_value()) { --num_missing_path_cache_entries; }
+            path_cache.erase(it);
+        }
+        if (!resolved.sub_fs.has_value()) {
+            // Probing many missing paths shouldn't grow the cache without bound.
+            if (num_missing_path_cache_entries >= max_missing_path_cache_entries) {
+                path_cache_invalidated_entries += std::erase_if(path_cache, [](auto const& entry) {
+                    return !entry.second.sub_fs.has_value();
+                });
+                num_missing_path_cache_entries = 0;
+            }
+            ++num_missing_path_cache_entries;
+        }
+        path_cache.insert({std::string{path}, std::move(resolved)});
+        return file;
     }
 
     auto create_file(std::string_view path) -> Option<Dyn<IFile>::Box> {
+        invalidate_path(path);
         auto sub_fs_pairs = root.collect_writable_sub_fs(path);
         for (auto it = sub_fs_pairs.rbegin(); it != sub_fs_pairs.rend(); it++) {
             if (auto file = it->second.create_file(it->first); file.has_value()) {
@@ -250,6 +370,7 @@ struct FileSystem::Impl final {
     }
 
     auto remove_file(std::string_view path) -> bool {
+        invalidate_path(path);
         auto sub_fs_pairs = root.collect_writable_sub_fs(path);
         for (auto it = sub_fs_pairs.rbegin(); it != sub_fs_pairs.rend(); it++) {
             if (it->second.remove_file(it->first)) {
@@ -259,6 +380,48 @@ struct FileSystem::Impl final {
         return false;
     }
 
+    // Different spellings of the same path are cached separately, so entries are matched by normalized paths.
+    auto invalidate_path(std::string_view path) -> void {
+        auto normalized_path = normalize_path(path);
+        std::unique_lock lock{path_cache_mutex};
+        ++path_cache_generation;
+        path_cache_invalidated_entries += std::erase_if(path_cache, [this, &normalized_path](auto const& entry) {
+            if (entry.second.normalized_path != normalized_path) { return false; }
+            if (!entry.second.sub_fs.has_value()) { --num_missing_path_cache_entries; }
+            return true;
+        });
+    }
+
+    auto poll_changed_files() -> std::vector<std::string> {
+        std::vector<std::string> changed_paths{};
+        root.for_each_sub_fs("/", [&changed_paths](std::string const& mount_path, Dyn<ISubFileSystem>::Ref sub_fs) {
+            for (auto const& path : sub_fs.poll_changed_files()) {
+                changed_paths.push_back(mount_path + path);
+            }
+        });
+        for (auto const& path : changed_paths) {
+            invalidate_path(path);
+        }
+        return changed_paths;
+    }
+
+    auto clear_path_cache() -> void {
+        std::unique_lock lock{path_cache_mutex};
+        ++path_cache_generation;
+        path_cache_invalidated_entries += path_cache.size();
+        path_cache.clear();
+        num_missing_path_cache_entries = 0;
+    }
+
+    auto path_cache_statistics() const -> PathCacheStatistics {
+        std::shared_lock lock{path_cache_mutex};
+        return PathCacheStatistics{
+            .hits = path_cache_hits,
+            .misses = path_cache_misses,
+            .invalidated_entries = path_cache_invalidated_entries,
+        };
+    }
+
     auto try_convert_physical_path_to_vfs_path(std::filesystem::path const& path) -> std::string {
         // Some special paths
         std::string_view mount_points[]{
@@ -282,6 +445,23 @@ struct FileSystem::Impl final {
     }
 
     VirtualDirectory root;
+
+    struct ResolvedPath final {
+        std::string normalized_path;
+        // Empty if the file is not found.
+        Option<Dyn<ISubFileSystem>::CRef> sub_fs;
+        std::string sub_path;
+    };
+    static constexpr size_t max_missing_path_cache_entries = 4096;
+
+    mutable StringHashMap<ResolvedPath> path_cache;
+    mutable std::shared_mutex path_cache_mutex;
+    // Bumped by invalidations, guarded by `path_cache_mutex`.
+    uint64_t path_cache_generation = 0;
+    mutable size_t num_missing_path_cache_entries = 0;
+    mutable std::atomic<uint64_t> path_cache_hits = 0;
+    mutable std::atomic<uint64_t> path_cache_misses = 0;
+    mutable uint64_t path_cache_invalidated_entries = 0;
 };
 
 FileSystem::FileSystem() = default;
@@ -308,6 +488,15 @@ auto FileSystem::remove_file(std::string_view path) -> bool {
 auto FileSystem::try_convert_physical_path_to_vfs_path(std::filesystem::path const& path) -> std::string {
     return impl()->try_convert_physical_path_to_vfs_path(path);
 }
+auto FileSystem::invalidate_path_cache() -> void {
+    impl()->clear_path_cache();
+}
+auto FileSystem::path_cache_statistics() const -> PathCacheStatistics {
+    return impl()->path_cache_statistics();
+}
+auto FileSystem::poll_changed_files() -> std::vector<std::string> {
+    return impl()->poll_changed_files();
+}
 
 
 PhysicalFile::PhysicalFile(std::filesystem::path path, bool writable) : path_(std::move(path)), writable_(writable) {}
@@ -331,9 +520,40 @@ auto PhysicalFile::read_binary_data() -> std::vector<std::byte> {
     fin.read(reinterpret_cast<char*>(data.data()), size);
     return data;
 }
+auto PhysicalFile::map_binary_data() -> CSpan<std::byte> {
+    if (!mapping_) {
+        auto [mapping, size] = map_physical_file(path_);
+        if (!mapping) {
+            // Fallback to a copy that is shared in the same way.
+            auto data = std::make_shared<std::vector<std::byte>>(read_binary_data());
+            size = data->size();
+            mapping = std::shared_ptr<std::byte const>{data, data->data()};
+        }
+        mapping_ = std::move(mapping);
+        mapped_data_ = CSpan<std::byte>{mapping_.get(), size};
+    }
+    return mapped_data_;
+}
+auto PhysicalFile::size() const -> uint64_t {
+    if (mapping_) { return mapped_data_.size(); }
+    std::error_code ec{};
+    auto size = std::filesystem::file_size(path_, ec);
+    return ec ? 0 : size;
+}
+auto PhysicalFile::range_reader() const -> FileRangeReader {
+    return [path = path_](uint64_t offset, Span<std::byte> dst) {
+        std::ifstream fin(path, std::ios::binary);
+        if (!fin) { return false; }
+        fin.seekg(offset);
+        fin.read(reinterpret_cast<char*>(dst.data()), dst.size());
+        return fin.gcount() == static_cast<std::streamsize>(dst.size());
+    };
+}
 
 auto PhysicalFile::write_string_data(std::string_view data) -> bool {
     if (!writable_) { return false; }
+    mapping_.reset();
+    mapped_data_ = {};
     std::ofstream fout(path_);
     if (!fout) { return false; }
     fout.write(data.data(), data.size());
@@ -341,15 +561,116 @@ auto PhysicalFile::write_string_data(std::string_view data) -> bool {
 }
 auto PhysicalFile::write_binary_data(CSpan<std::byte> data) -> bool {
     if (!writable_) { return false; }
+    mapping_.reset();
+    mapped_data_ = {};
     std::ofstream fout(path_, std::ios::binary);
     if (!fout) { return false; }
     fout.write(reinterpret_cast<char const*>(data.data()), data.size());
     return true;
 }
+auto PhysicalFile::append_binary_data(CSpan<std::byte> data) -> bool {
+    if (!writable_) { return false; }
+    mapping_.reset();
+    mapped_data_ = {};
+    std::ofstream fout(path_, std::ios::binary | std::ios::app);
+    if (!fout) { return false; }
+    fout.write(reinterpret_cast<char const*>(data.data()), data.size());
+    return true;
+}
+
+
+#ifdef __linux__
+struct PhysicalSubFileSystem::Watcher final {
+    Watcher(std::filesystem::path root_path) : root_path(std::move(root_path)) {
+        fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd >= 0) {
+            add_watches("");
+        }
+    }
+    ~Watcher() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    // inotify doesn't watch subdirectories, so each of them is watched separately.
+    // Files are collected into `found_files` if it's set, since files may be created in a new directory
+    // before it's watched.
+    auto add_watches(std::string const& dir, std::vector<std::string>* found_files = nullptr) -> void {
+        constexpr uint32_t mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+        auto dir_path = root_path / dir;
+        auto wd = ::inotify_add_watch(fd, dir_path.c_str(), mask);
+        if (wd < 0) { return; }
+        watched_dirs.insert_or_assign(wd, dir);
+        std::error_code ec{};
+        for (auto const& entry : std::filesystem::directory_iterator(dir_path, ec)) {
+            auto path = dir + entry.path().filename().string();
+            if (entry.is_symlink(ec)) { continue; }
+            if (entry.is_directory(ec)) {
+                add_watches(path + '/', found_files);
+            } else if (found_files && entry.is_regular_file(ec)) {
+                found_files->push_back(std::move(path));
+            }
+        }
+    }
+
+    auto poll() -> std::vector<std::string> {
+        std::vector<std::string> changed_paths{};
+        if (fd < 0) { return changed_paths; }
+
+        alignas(inotify_event) char buffer[4096];
+        while (true) {
+            auto length = ::read(fd, buffer, sizeof(buffer));
+            if (length <= 0) { break; }
+            for (ssize_t offset = 0; offset < length;) {
+                auto event = reinterpret_cast<inotify_event const*>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+                if (event->mask & IN_IGNORED) {
+                    watched_dirs.erase(event->wd);
+                    continue;
+                }
+                auto it = watched_dirs.find(event->wd);
+                if (it == watched_dirs.end() || event->len == 0) { continue; }
+                auto path = it->second + event->name;
+                if (event->mask & IN_ISDIR) {
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                        add_watches(path + '/', &changed_paths);
+                    }
+                } else {
+                    changed_paths.push_back(std::move(path));
+                }
+            }
+        }
+
+        // A saved file usually gets several events.
+        std::sort(changed_paths.begin(), changed_paths.end());
+        changed_paths.erase(std::unique(changed_paths.begin(), changed_paths.end()), changed_paths.end());
+        return changed_paths;
+    }
+
+    std::filesystem::path root_path;
+    int fd = -1;
+    std::unordered_map<int, std::string> watched_dirs;
+};
+#else
+struct PhysicalSubFileSystem::Watcher final {
+    Watcher(std::filesystem::path const&) {}
+
+    auto poll() -> std::vector<std::string> { return {}; }
+};
+#endif
 
+PhysicalSubFileSystem::PhysicalSubFileSystem(std::filesystem::path root_path, bool writable, bool watch_changes)
+    : root_path_(std::move(root_path)), writable_(writable)
+{
+    if (watch_changes) {
+        watcher_ = std::make_shared<Watcher>(root_path_);
+    }
+}
 
-PhysicalSubFileSystem::PhysicalSubFileSystem(std::filesystem::path root_path, bool writable)
-    : root_path_(std::move(root_path)), writable_(writable) {}
+auto PhysicalSubFileSystem::poll_changed_files() -> std::vector<std::string> {
+    return watcher_ ? watcher_->poll() : std::vector<std::string>{};
+}
 
 auto PhysicalSubFileSystem::has_file(std::string_view path) const -> bool {
     auto full_path = root_path_ / path;
@@ -395,7 +716,8 @@ auto PhysicalSubFileSystem::remove_file(std::string_view path) -> bool {
 namespace {
 
 struct MemoryFileData final {
-    std::vector<std::byte> data;
+    // Replaced as a whole by writes, so that spans mapped from old data stay valid.
+    std::shared_ptr<std::vector<std::byte> const> data = std::make_shared<std::vector<std::byte>>();
 };
 
 struct MemorySubFileSystemDirectory final {
@@ -486,6 +808,8 @@ private:
 
 struct MemoryFile::Impl final {
     Ptr<MemoryFileData> file;
+    // Snapshot returned by the last `map_binary_data()`.
+    std::shared_ptr<std::vector<std::byte> const> mapped_data;
 
     std::string filename;
     bool writable;
@@ -507,22 +831,33 @@ auto MemoryFile::extension() const -> std::string {
 }
 
 auto MemoryFile::read_string_data() -> std::string {
-    return {reinterpret_cast<char const*>(impl()->file->data.data()), impl()->file->data.size()};
+    auto const& data = *impl()->file->data;
+    return {reinterpret_cast<char const*>(data.data()), data.size()};
 }
 auto MemoryFile::read_binary_data() -> std::vector<std::byte> {
-    return impl()->file->data;
+    return *impl()->file->data;
+}
+auto MemoryFile::map_binary_data() -> CSpan<std::byte> {
+    impl()->mapped_data = impl()->file->data;
+    return *impl()->mapped_data;
+}
+auto MemoryFile::size() const -> uint64_t {
+    return impl()->file->data->size();
+}
+auto MemoryFile::range_reader() const -> FileRangeReader {
+    return [data = impl()->file->data](uint64_t offset, Span<std::byte> dst) {
+        if (offset > data->size() || dst.size() > data->size() - offset) { return false; }
+        std::copy_n(data->data() + offset, dst.size(), dst.data());
+        return true;
+    };
 }
 
 auto MemoryFile::write_string_data(std::string_view data) -> bool {
-    if (!impl()->writable) { return false; }
-    impl()->file->data.resize(data.size());
-    std::memcpy(impl()->file->data.data(), data.data(), data.size());
-    return true;
+    return write_binary_data({reinterpret_cast<std::byte const*>(data.data()), data.size()});
 }
 auto MemoryFile::write_binary_data(CSpan<std::byte> data) -> bool {
     if (!impl()->writable) { return false; }
-    impl()->file->data.resize(data.size());
-    std::memcpy(impl()->file->data.data(), data.data(), data.size());
+    impl()->file->data = std::make_shared<std::vector<std::byte>>(data.begin(), data.end());
     return true;
 }
 
@@ -9,7 +9,10 @@
 #include <bisemutum/runtime/logger.hpp>
 #include <bisemutum/runtime/component_manager.hpp>
 #include <bisemutum/runtime/system_manager.hpp>
+#include <bisemutum/runtime/vfs.hpp>
+#include <bisemutum/runtime/world_partition.hpp>
 #include <bisemutum/utils/serde.hpp>
+#include <bisemutum/prelude/byte_stream.hpp>
 
 namespace bi::rt {
 
@@ -28,9 +31,13 @@ struct World::Impl final {
         if (current_scene == scene) {
             current_scene = nullptr;
         }
-        scene->for_each_root_object([scene](Ref<SceneObject> object) {
-            scene->destroy_scene_object_and_its_children(object);
+        std::vector<Ref<SceneObject>> root_objects{};
+        scene->for_each_root_object([&root_objects](Ref<SceneObject> object) {
+            root_objects.push_back(object);
         });
+        for (auto object : root_objects) {
+            scene->destroy_scene_object_and_its_children(object);
+        }
         auto it = scenes_it_map.find(scene.get());
         scenes.erase(it->second);
         scenes_it_map.erase(it);
@@ -38,21 +45,121 @@ struct World::Impl final {
 
     auto load_scene(std::string_view scene_file_str) -> bool {
         auto scene = create_scene(false);
+        if (!load_toml_scene_to(scene, scene_file_str)) {
+            destroy_scene(scene);
+            return false;
+        }
+        return true;
+    }
+
+    auto load_scene_binary(CSpan<std::byte> scene_file_data) -> bool {
+        auto scene = create_scene(false);
+        if (!load_binary_scene_to(scene, scene_file_data)) {
+            destroy_scene(scene);
+            return false;
+        }
+        return true;
+    }
+
+    auto load_scene_file(Dyn<IFile>::Ref scene_file) -> bool {
+        if (is_binary_scene_file(scene_file)) {
+            auto scene_file_data = scene_file.map_binary_data();
+            return load_scene_binary(scene_file_data);
+        } else {
+            return load_scene(scene_file.read_string_data());
+        }
+    }
+
+    auto load_scene_from_path(std::string_view scene_file_path) -> bool {
+        auto scene_file = g_engine->file_system()->get_file(scene_file_path);
+        if (!scene_file) {
+            log::error("general", "Scene file '{}' not found.", scene_file_path);
+            return false;
+        }
+        if (scene_file.value().extension() == world_partition_extension) {
+            auto base_dir = scene_file_path.substr(0, scene_file_path.rfind('/') + 1);
+            return load_partitioned_scene(scene_file.value().read_string_data(), base_dir);
+        }
+        return load_scene_file(*&scene_file.value());
+    }
+
+    auto load_partitioned_scene(std::string_view manifest_str, std::string_view base_dir) -> bool {
+        WorldPartitionDesc desc{};
+        try {
+            desc = serde::Value::from_toml(manifest_str).get<WorldPartitionDesc>();
+        } catch (std::exception const& e) {
+            log::error("general", "World partition manifest is invalid: {}", e.what());
+            return false;
+        }
+        auto scene = create_scene(false);
+        auto partition = g_engine->system_manager()->get_system_for<WorldPartitionSystem>(scene);
+        if (!partition || !partition->open(std::move(desc), base_dir)) {
+            destroy_scene(scene);
+            return false;
+        }
+        return true;
+    }
+
+    auto save_currnet_scene(Dyn<IFile>::Ref scene_file) const -> void {
+        if (scene_file.extension() == world_partition_extension) {
+            log::warn("general", "Partitioned scene is not saved, rebuild it from the source scene instead.");
+            return;
+        }
+        if (current_scene) {
+            save_scene_to(current_scene.value(), scene_file);
+        }
+    }
+
+    auto convert_scene_file(Dyn<IFile>::Ref src_scene_file, Dyn<IFile>::Ref dst_scene_file) -> bool {
+        auto scene = create_scene(true);
+        auto loaded = false;
+        if (is_binary_scene_file(src_scene_file)) {
+            auto scene_file_data = src_scene_file.map_binary_data();
+            loaded = load_binary_scene_to(scene, scene_file_data);
+        } else {
+            loaded = load_toml_scene_to(scene, src_scene_file.read_string_data());
+        }
+        if (loaded) {
+            save_scene_to(scene, dst_scene_file);
+        }
+        destroy_scene(scene);
+        return loaded;
+    }
+
+    static auto is_binary_scene_file(Dyn<IFile>::Ref scene_file) -> bool {
+        return scene_file.extension() == scene_binary_extension;
+    }
+
+    static auto load_toml_scene_to(Ref<Scene> scene, std::string_view scene_file_str) -> bool {
         try {
             auto scene_value = serde::Value::from_toml(scene_file_str);
             scene->load_from_value(std::move(scene_value));
             return true;
         } catch (std::exception const& e) {
-            destroy_scene(scene);
             log::error("general", "Scene file is invalid: {}", e.what());
             return false;
         }
     }
 
-    auto save_currnet_scene(Dyn<IFile>::Ref scene_file) const -> void {
-        if (current_scene) {
+    static auto load_binary_scene_to(Ref<Scene> scene, CSpan<std::byte> scene_file_data) -> bool {
+        try {
+            ReadByteStream bs{scene_file_data};
+            scene->load_from_byte_stream(bs);
+            return true;
+        } catch (std::exception const& e) {
+            log::error("general", "Binary scene file is invalid: {}", e.what());
+            return false;
+        }
+    }
+
+    static auto save_scene_to(CRef<Scene> scene, Dyn<IFile>::Ref scene_file) -> void {
+        if (is_binary_scene_file(scene_file)) {
+            WriteByteStream bs{};
+            scene->save_to_byte_stream(bs);
+            scene_file.write_binary_data(bs.data());
+        } else {
             serde::Value value{};
-            current_scene->save_to_value(value);
+            scene->save_to_value(value);
             scene_file.write_string_data(value.to_toml());
         }
     }
@@ -84,8 +191,21 @@ auto World::create_scene(bool is_dummy_scene) -> Ref<Scene> {
 auto World::load_scene(std::string_view scene_json_str) -> bool {
     return impl()->load_scene(scene_json_str);
 }
+auto World::load_scene_binary(CSpan<std::byte> scene_file_data) -> bool {
+    return impl()->load_scene_binary(scene_file_data);
+}
+auto World::load_scene_file(Dyn<IFile>::Ref scene_file) -> bool {
+    return impl()->load_scene_file(scene_file);
+}
+auto World::load_scene_from_path(std::string_view scene_file_path) -> bool {
+    return impl()->load_scene_from_path(scene_file_path);
+}
 auto World::save_currnet_scene(Dyn<IFile>::Ref scene_file) const -> void {
     impl()->save_currnet_scene(scene_file);
 }
 
+auto World::convert_scene_file(Dyn<IFile>::Ref src_scene_file, Dyn<IFile>::Ref dst_scene_file) -> bool {
+    return impl()->convert_scene_file(src_scene_file, dst_scene_file);
+}
+
 }
@@ -0,0 +1,568 @@
+#include <bisemutum/runtime/world_partition.hpp>
+
+#include <set>
+#include <map>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <unordered_set>
+
+#include <bisemutum/engine/engine.hpp>
+#include <bisemutum/runtime/world.hpp>
+#include <bisemutum/runtime/scene.hpp>
+#include <bisemutum/runtime/scene_object.hpp>
+#include <bisemutum/runtime/logger.hpp>
+#include <bisemutum/runtime/component_manager.hpp>
+#include <bisemutum/runtime/asset_manager.hpp>
+#include <bisemutum/runtime/system_manager.hpp>
+#include <bisemutum/runtime/thread_pool.hpp>
+#include <bisemutum/graphics/graphics_manager.hpp>
+#include <bisemutum/graphics/gpu_scene_system.hpp>
+#include <bisemutum/graphics/camera.hpp>
+#include <bisemutum/prelude/byte_stream.hpp>
+
+namespace bi::rt {
+
+namespace {
+
+auto for_each_object_in_hierarchy(CRef<SceneObject> root, std::function<auto(CRef<SceneObject>) -> void> const& op) -> void {
+    op(root);
+    root->for_each_children([&op](CRef<SceneObject> child) {
+        for_each_object_in_hierarchy(child, op);
+    });
+}
+
+auto collect_asset_ids(serde::Value const& value, std::set<uint64_t>& asset_ids) -> void {
+    if (value.is_table()) {
+        for (auto& [key, field_value] : value.get_ref<serde::Value::Table>()) {
+            if (key == "asset_id" && field_value.is_integer()) {
+                auto asset_id = static_cast<uint64_t>(field_value.get<serde::Value::Integer>());
+                if (asset_id != static_cast<uint64_t>(AssetId::invalid)) {
+                    asset_ids.insert(asset_id);
+                }
+            } else {
+                collect_asset_ids(field_value, asset_ids);
+            }
+        }
+    } else if (value.is_array()) {
+        for (auto& elem : value.get_ref<serde::Value::Array>()) {
+            collect_asset_ids(elem, asset_ids);
+        }
+    }
+}
+
+auto collect_object_asset_ids(CRef<SceneObject> root, std::set<uint64_t>& asset_ids) -> void {
+    for_each_object_in_hierarchy(root, [&asset_ids](CRef<SceneObject> object) {
+        object->for_each_component([&asset_ids](std::string_view component_type, void const* component_value) {
+            auto serializer = g_engine->component_manager()->get_serializer(component_type);
+            serde::Value value{};
+            serializer(value, component_value);
+            collect_asset_ids(value, asset_ids);
+        });
+    });
+}
+
+auto cell_key(int3 coord) -> uint64_t {
+    constexpr uint64_t mask = (1ull << 21) - 1;
+    return (static_cast<uint64_t>(coord.x) & mask)
+        | ((static_cast<uint64_t>(coord.y) & mask) << 21)
+        | ((static_cast<uint64_t>(coord.z) & mask) << 42);
+}
+
+auto distance_to_cell(float3 const& position, int3 coord, float cell_size) -> float {
+    auto p_min = float3(coord) * cell_size;
+    auto p_max = p_min + cell_size;
+    auto d = math::max(math::max(p_min - position, position - p_max), float3(0.0f));
+    return math::length(d);
+}
+
+auto write_chunk(CRef<Scene> scene, std::string const& path, CSpan<CRef<SceneObject>> root_objects) -> Option<uint64_t> {
+    WriteByteStream bs{};
+    scene->save_to_byte_stream(bs, root_objects);
+    auto file = g_engine->file_system()->create_file(path);
+    if (!file || !file.value().write_binary_data(bs.data())) {
+        log::error("general", "Failed to write world partition chunk '{}'.", path);
+        return {};
+    }
+    return bs.data().size();
+}
+
+} // namespace
+
+auto build_world_partition(
+    CRef<Scene> scene, WorldPartitionSettings const& settings, std::string_view manifest_path
+) -> bool {
+    if (settings.cell_size <= 0.0f) {
+        log::error("general", "Cell size of world partition must be positive.");
+        return false;
+    }
+
+    auto dir_end = manifest_path.rfind('/') + 1;
+    auto base_dir = std::string{manifest_path.substr(0, dir_end)};
+    auto manifest_name = manifest_path.substr(dir_end);
+    auto chunk_dir = fmt::format("{}_cells/", manifest_name.substr(0, manifest_name.rfind('.')));
+
+    std::unordered_set<std::string_view> streamed_types{
+        settings.streamed_component_types.begin(), settings.streamed_component_types.end()
+    };
+    std::vector<CRef<SceneObject>> persistent_objects{};
+    std::map<std::tuple<int, int, int>, std::vector<CRef<SceneObject>>> cells_objects{};
+    scene->for_each_root_object([&](CRef<SceneObject> object) {
+        auto streamed = false;
+        for_each_object_in_hierarchy(object, [&streamed, &streamed_types](CRef<SceneObject> o) {
+            o->for_each_component([&streamed, &streamed_types](std::string_view component_type, void const*) {
+                streamed = streamed || streamed_types.contains(component_type);
+            });
+        });
+        if (streamed) {
+            auto coord = int3(math::floor(object->world_transform().translation / settings.cell_size));
+            cells_objects[{coord.x, coord.y, coord.z}].push_back(object);
+        } else {
+            persistent_objects.push_back(object);
+        }
+    });
+
+    WorldPartitionDesc desc{
+        .settings = settings,
+        .persistent_chunk_file = chunk_dir + "persistent" + std::string{scene_binary_extension},
+    };
+    if (!write_chunk(scene, base_dir + desc.persistent_chunk_file, persistent_objects)) { return false; }
+
+    // Sizes of shared assets are stored once, in a stable order.
+    std::map<uint64_t, uint64_t> asset_sizes{};
+    auto add_asset = [&asset_sizes](uint64_t asset_id) -> void {
+        if (asset_sizes.contains(asset_id)) { return; }
+        uint64_t size = 0;
+        if (auto metadata = g_engine->asset_manager()->metadata_of(static_cast<AssetId>(asset_id)); metadata) {
+            if (auto file = g_engine->file_system()->get_file(metadata->path); file) {
+                size = file.value().size();
+            }
+        }
+        asset_sizes.insert({asset_id, size});
+    };
+
+    desc.cells.reserve(cells_objects.size());
+    for (auto& [coord_tuple, objects] : cells_objects) {
+        auto [x, y, z] = coord_tuple;
+        auto& cell = desc.cells.emplace_back();
+        cell.coord = int3(x, y, z);
+        cell.chunk_file = fmt::format("{}cell_{}_{}_{}{}", chunk_dir, x, y, z, scene_binary_extension);
+        auto chunk_size = write_chunk(scene, base_dir + cell.chunk_file, objects);
+        if (!chunk_size) { return false; }
+
+        std::set<uint64_t> asset_ids{};
+        for (auto object : objects) {
+            collect_object_asset_ids(object, asset_ids);
+        }
+        cell.memory_size = chunk_size.value();
+        for (auto asset_id : asset_ids) {
+            add_asset(asset_id);
+        }
+        cell.asset_dependencies.assign(asset_ids.begin(), asset_ids.end());
+    }
+    desc.assets.reserve(asset_sizes.size());
+    for (auto [asset_id, size] : asset_sizes) {
+        desc.assets.push_back({.id = asset_id, .memory_size = size});
+    }
+
+    serde::Value value{};
+    serde::to_value(value, desc);
+    auto manifest_file = g_engine->file_system()->create_file(manifest_path);
+    if (!manifest_file || !manifest_file.value().write_string_data(value.to_toml())) {
+        log::error("general", "Failed to write world partition manifest '{}'.", manifest_path);
+        return false;
+    }
+    return true;
+}
+
+auto build_world_partition(
+    Dyn<IFile>::Ref src_scene_file, WorldPartitionSettings const& settings, std::string_view manifest_path
+) -> bool {
+    auto world = g_engine->world();
+    auto scene = world->create_scene(true);
+    auto succeeded = false;
+    try {
+        if (src_scene_file.extension() == scene_binary_extension) {
+            auto scene_file_data = src_scene_file.map_binary_data();
+            ReadByteStream bs{scene_file_data};
+            scene->load_from_byte_stream(bs);
+        } else {
+            scene->load_from_value(serde::Value::from_toml(src_scene_file.read_string_data()));
+        }
+        succeeded = build_world_partition(scene, settings, manifest_path);
+    } catch (std::exception const& e) {
+        log::error("general", "Scene file is invalid: {}", e.what());
+    }
+    world->destroy_scene(scene);
+    return succeeded;
+}
+
+
+struct WorldPartitionSystem::Impl final {
+    enum class CellState : uint8_t {
+        unloaded,
+        reading,
+        loaded,
+        failed,
+    };
+
+    struct CellRuntime final {
+        CellState state = CellState::unloaded;
+        // Set when the cell goes out of range before its chunk is read, the data is dropped when it is ready.
+        bool cancelled = false;
+        std::future<std::vector<std::byte>> chunk_data;
+        std::vector<Ref<SceneObject>> root_objects;
+    };
+
+    ~Impl() {
+        // Scene may be destroyed already, only wait for worker threads here.
+        for (auto& cell : cells) {
+            if (cell.chunk_data.valid()) { cell.chunk_data.wait(); }
+        }
+    }
+
+    auto update() -> void {
+        if (!opened) { return; }
+        release_unused_assets();
+
+        std::vector<float3> camera_positions{};
+        if (auto gpu_scene = g_engine->system_manager()->get_system_for<gfx::GpuSceneSystem>(scene.value()); gpu_scene) {
+            gpu_scene->for_each_camera([&camera_positions](gfx::Camera const& camera) {
+                camera_positions.push_back(camera.position);
+            });
+        }
+
+        auto& settings = desc.settings;
+        std::vector<float> cells_distance(cells.size(), std::numeric_limits<float>::max());
+        for (size_t i = 0; i < cells.size(); i++) {
+            for (auto const& position : camera_positions) {
+                cells_distance[i] = std::min(
+                    cells_distance[i], distance_to_cell(position, desc.cells[i].coord, settings.cell_size)
+                );
+            }
+        }
+
+        std::vector<size_t> sorted_cells(cells.size());
+        std::iota(sorted_cells.begin(), sorted_cells.end(), 0);
+        std::sort(sorted_cells.begin(), sorted_cells.end(), [&cells_distance](size_t a, size_t b) {
+            return cells_distance[a] < cells_distance[b];
+        });
+
+        // Nearest cells in range are wanted as long as they fit in the budget.
+        std::vector<bool> wanted(cells.size(), false);
+        std::unordered_set<uint64_t> wanted_assets{};
+        uint64_t wanted_memory_size = 0;
+        for (auto index : sorted_cells) {
+            if (cells_distance[index] > settings.streaming_range) { break; }
+            if (cells[index].state == CellState::failed) { continue; }
+            auto size = cell_memory_size(index, [&wanted_assets](uint64_t asset_id) {
+                return wanted_assets.contains(asset_id);
+            });
+            if (wanted_memory_size + size > settings.memory_budget) { continue; }
+            wanted[index] = true;
+            wanted_memory_size += size;
+            wanted_assets.insert(desc.cells[index].asset_dependencies.begin(), desc.cells[index].asset_dependencies.end());
+        }
+
+        // Unload from the farthest, keep cells within the unloading range unless more memory is needed.
+        auto unload_range = settings.streaming_range * settings.unload_range_scale;
+        auto missing_memory_size = 0ull;
+        std::unordered_set<uint64_t> missing_assets{};
+        for (size_t i = 0; i < cells.size(); i++) {
+            if (wanted[i] && !is_resident(cells[i])) {
+                missing_memory_size += cell_memory_size(i, [this, &missing_assets](uint64_t asset_id) {
+                    return resident_asset_refs.contains(asset_id) || missing_assets.contains(asset_id);
+                });
+                missing_assets.insert(desc.cells[i].asset_dependencies.begin(), desc.cells[i].asset_dependencies.end());
+            }
+        }
+        for (auto it = sorted_cells.rbegin(); it != sorted_cells.rend(); it++) {
+            auto index = *it;
+            auto& cell = cells[index];
+            if (wanted[index] || !is_resident(cell) || cell.cancelled) { continue; }
+            if (
+                cells_distance[index] > unload_range
+                || resident_memory_size + missing_memory_size > settings.memory_budget
+            ) {
+                unload_cell(index);
+            }
+        }
+
+        for (auto index : sorted_cells) {
+            if (!wanted[index]) { continue; }
+            auto& cell = cells[index];
+            if (cell.state == CellState::reading) {
+                cell.cancelled = false;
+            } else if (cell.state == CellState::unloaded) {
+                auto size = cell_memory_size(index, [this](uint64_t asset_id) {
+                    return resident_asset_refs.contains(asset_id);
+                });
+                if (resident_memory_size + size > settings.memory_budget) { continue; }
+                start_reading(index);
+            }
+        }
+
+        uint32_t num_committed = 0;
+        for (auto index : sorted_cells) {
+            auto& cell = cells[index];
+            if (cell.state != CellState::reading) { continue; }
+            if (cell.chunk_data.wait_for(std::chrono::seconds{0}) != std::future_status::ready) { continue; }
+            if (cell.cancelled) {
+                drop_reading(index);
+            } else if (num_committed < settings.max_cells_committed_per_frame && request_dependencies(index)) {
+                commit_cell(index);
+                ++num_committed;
+            }
+        }
+    }
+
+    auto open(WorldPartitionDesc&& new_desc, std::string_view new_base_dir) -> bool {
+        close();
+
+        desc = std::move(new_desc);
+        base_dir = new_base_dir;
+        if (!desc.persistent_chunk_file.empty()) {
+            auto file = g_engine->file_system()->get_file(base_dir + desc.persistent_chunk_file);
+            if (!file) {
+                log::error("general", "Persistent chunk '{}' not found.", desc.persistent_chunk_file);
+                return false;
+            }
+            auto chunk_data = file.value().map_binary_data();
+            try {
+                ReadByteStream bs{chunk_data};
+                persistent_objects = scene->load_from_byte_stream(bs);
+            } catch (std::exception const& e) {
+                log::error("general", "Persistent chunk '{}' is invalid: {}", desc.persistent_chunk_file, e.what());
+                return false;
+            }
+            std::set<uint64_t> asset_ids{};
+            for (auto object : persistent_objects) {
+                collect_object_asset_ids(object, asset_ids);
+            }
+            persistent_assets.insert(asset_ids.begin(), asset_ids.end());
+        }
+
+        cells.resize(desc.cells.size());
+        for (size_t i = 0; i < desc.cells.size(); i++) {
+            cells_index_map.insert({cell_key(desc.cells[i].coord), i});
+        }
+        for (auto const& asset : desc.assets) {
+            asset_memory_sizes.insert({asset.id, asset.memory_size});
+        }
+        opened = true;
+        return true;
+    }
+
+    auto close() -> void {
+        for (size_t i = 0; i < cells.size(); i++) {
+            if (cells[i].state == CellState::reading) {
+                cells[i].chunk_data.wait();
+                drop_reading(i);
+            } else if (cells[i].state == CellState::loaded) {
+                unload_cell(i);
+            }
+        }
+        for (auto object : persistent_objects) {
+            scene->destroy_scene_object_and_its_children(object);
+        }
+        persistent_objects.clear();
+        cells.clear();
+        cells_index_map.clear();
+        asset_memory_sizes.clear();
+        resident_asset_refs.clear();
+        persistent_assets.clear();
+        streamed_assets.clear();
+        releasing_assets.clear();
+        resident_memory_size = 0;
+        opened = false;
+    }
+
+    auto is_cell_loaded(int3 coord) const -> bool {
+        auto it = cells_index_map.find(cell_key(coord));
+        return it != cells_index_map.end() && cells[it->second].state == CellState::loaded;
+    }
+
+    auto num_loaded_cells() const -> size_t {
+        return std::count_if(cells.begin(), cells.end(), [](CellRuntime const& cell) {
+            return cell.state == CellState::loaded;
+        });
+    }
+
+    static auto is_resident(CellRuntime const& cell) -> bool {
+        return cell.state == CellState::reading || cell.state == CellState::loaded;
+    }
+
+    // Size of the chunk plus its dependent assets that are not counted yet.
+    template <typename F>
+    auto cell_memory_size(size_t index, F&& is_asset_counted) const -> uint64_t {
+        auto size = desc.cells[index].memory_size;
+        for (auto asset_id : desc.cells[index].asset_dependencies) {
+            if (is_asset_counted(asset_id)) { continue; }
+            if (auto it = asset_memory_sizes.find(asset_id); it != asset_memory_sizes.end()) {
+                size += it->second;
+            }
+        }
+        return size;
+    }
+
+    auto add_resident(size_t index) -> void {
+        resident_memory_size += desc.cells[index].memory_size;
+        for (auto asset_id : desc.cells[index].asset_dependencies) {
+            if (resident_asset_refs[asset_id]++ == 0) {
+                if (auto it = asset_memory_sizes.find(asset_id); it != asset_memory_sizes.end()) {
+                    resident_memory_size += it->second;
+                }
+            }
+        }
+    }
+
+    auto remove_resident(size_t index) -> void {
+        resident_memory_size -= desc.cells[index].memory_size;
+        for (auto asset_id : desc.cells[index].asset_dependencies) {
+            auto it = resident_asset_refs.find(asset_id);
+            if (--it->second == 0) {
+                resident_asset_refs.erase(it);
+                if (streamed_assets.contains(asset_id)) {
+                    releasing_assets.push_back(asset_id);
+                }
+                if (auto size_it = asset_memory_sizes.find(asset_id); size_it != asset_memory_sizes.end()) {
+                    resident_memory_size -= size_it->second;
+                }
+            }
+        }
+    }
+
+    auto start_reading(size_t index) -> void {
+        auto& cell = cells[index];
+        cell.state = CellState::reading;
+        cell.cancelled = false;
+        cell.chunk_data = g_engine->thread_pool()->async([path = base_dir + desc.cells[index].chunk_file]() {
+            auto file = g_engine->file_system()->get_file(path);
+            return file ? file.value().read_binary_data() : std::vector<std::byte>{};
+        });
+        add_resident(index);
+    }
+
+    auto drop_reading(size_t index) -> void {
+        auto& cell = cells[index];
+        cell.chunk_data = {};
+        cell.state = CellState::unloaded;
+        cell.cancelled = false;
+        remove_resident(index);
+    }
+
+    // Dependent assets are loaded asynchronously, the cell is committed after all of them are finished.
+    auto request_dependencies(size_t index) -> bool {
+        auto asset_manager = g_engine->asset_manager();
+        auto ready = true;
+        for (auto asset_id : desc.cells[index].asset_dependencies) {
+            auto id = static_cast<AssetId>(asset_id);
+            if (!persistent_assets.contains(asset_id) && asset_manager->state_of(id) == AssetState::not_loaded) {
+                streamed_assets.insert(asset_id);
+            }
+            if (AssetPtr{id}.load_async() == AssetState::loading) { ready = false; }
+        }
+        return ready;
+    }
+
+    // Objects of unloaded cells are destroyed at the end of the frame, so their assets are released in the next
+    // update. Assets that are still loading are released when a cell depending on them is unloaded again.
+    auto release_unused_assets() -> void {
+        for (auto asset_id : releasing_assets) {
+            if (resident_asset_refs.contains(asset_id) || !streamed_assets.contains(asset_id)) { continue; }
+            auto content = g_engine->asset_manager()->unload_asset(static_cast<AssetId>(asset_id));
+            if (!content.has_value()) { continue; }
+            streamed_assets.erase(asset_id);
+            // GPU resources of the asset may still be used by frames in flight.
+            g_engine->graphics_manager()->add_delayed_destroy([content = std::move(content)]() {});
+        }
+        releasing_assets.clear();
+    }
+
+    auto commit_cell(size_t index) -> void {
+        auto& cell = cells[index];
+        auto& cell_desc = desc.cells[index];
+        auto chunk_data = cell.chunk_data.get();
+        if (chunk_data.empty()) {
+            log::error("general", "World partition chunk '{}' not found.", cell_desc.chunk_file);
+            drop_reading(index);
+            cell.state = CellState::failed;
+            return;
+        }
+
+        try {
+            ReadByteStream bs{chunk_data};
+            cell.root_objects = scene->load_from_byte_stream(bs);
+            cell.state = CellState::loaded;
+        } catch (std::exception const& e) {
+            log::error("general", "World partition chunk '{}' is invalid: {}", cell_desc.chunk_file, e.what());
+            drop_reading(index);
+            cell.state = CellState::failed;
+        }
+    }
+
+    auto unload_cell(size_t index) -> void {
+        auto& cell = cells[index];
+        if (cell.state == CellState::reading) {
+            cell.cancelled = true;
+            return;
+        }
+        for (auto object : cell.root_objects) {
+            scene->destroy_scene_object_and_its_children(object);
+        }
+        cell.root_objects.clear();
+        cell.state = CellState::unloaded;
+        remove_resident(index);
+    }
+
+    Ptr<Scene> scene;
+
+    bool opened = false;
+    WorldPartitionDesc desc;
+    std::string base_dir;
+    std::vector<CellRuntime> cells;
+    std::unordered_map<uint64_t, size_t> cells_index_map;
+    std::vector<Ref<SceneObject>> persistent_objects;
+    std::unordered_map<uint64_t, uint64_t> asset_memory_sizes;
+    // Number of resident cells depending on each asset.
+    std::unordered_map<uint64_t, uint32_t> resident_asset_refs;
+    // Memory size of cells that are being read or loaded, and of their dependent assets.
+    uint64_t resident_memory_size = 0;
+    // Assets used by persistent objects are never released.
+    std::unordered_set<uint64_t> persistent_assets;
+    // Assets loaded for cells, they are released when no resident cell depends on them.
+    std::unordered_set<uint64_t> streamed_assets;
+    std::vector<uint64_t> releasing_assets;
+};
+
+WorldPartitionSystem::WorldPartitionSystem() = default;
+
+auto WorldPartitionSystem::init_on(Ref<Scene> scene) -> void {
+    impl()->scene = scene;
+}
+
+auto WorldPartitionSystem::update() -> void {
+    impl()->update();
+}
+
+auto WorldPartitionSystem::open(WorldPartitionDesc desc, std::string_view base_dir) -> bool {
+    return impl()->open(std::move(desc), base_dir);
+}
+auto WorldPartitionSystem::close() -> void {
+    impl()->close();
+}
+
+auto WorldPartitionSystem::is_opened() const -> bool {
+    return impl()->opened;
+}
+auto WorldPartitionSystem::is_cell_loaded(int3 coord) const -> bool {
+    return impl()->is_cell_loaded(coord);
+}
+auto WorldPartitionSystem::num_loaded_cells() const -> size_t {
+    return impl()->num_loaded_cells();
+}
+auto WorldPartitionSystem::loaded_memory_size() const -> uint64_t {
+    return impl()->resident_memory_size;
+}
+
+}
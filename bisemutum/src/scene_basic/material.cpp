@@ -100,40 +100,57 @@ auto MaterialAsset::load(Dyn<rt::IFile>::Ref file) -> rt::AssetAny {
         return {};
     }
 
-    if (!desc.referenced_material.empty()) {
-        desc.referenced_material.load();
-        if (!desc.referenced_material.asset()) {
-            log::critical("general", "Failed to load material: Invalid referenced material.");
-            return {};
-        }
-    }
-    for (auto& [_, tex] : desc.texture_params) {
-        tex.load();
-        if (!tex.asset()) {
-            log::critical("general", "Failed to load material: Invalid texture.");
-            return {};
-        }
-    }
-
     MaterialAsset mat{};
     mat.material.surface_model = desc.surface_model;
     mat.material.blend_mode = desc.blend_mode;
     mat.material.value_params = std::move(desc.value_params);
     mat.material.material_function = std::move(desc.material_function);
-    mat.material.referenced_material = &desc.referenced_material.asset()->material;
     mat.referenced_material = desc.referenced_material.asset_id();
     mat.referenced_textures.reserve(desc.texture_params.size());
-    mat.material.texture_params.reserve(desc.texture_params.size());
-    mat.material.sampler_params.reserve(desc.texture_params.size());
     for (auto& [name, tex] : desc.texture_params) {
-        mat.referenced_textures.emplace_back(name, tex.asset_id());
-        mat.material.sampler_params.emplace_back(name + "_sampler", tex.asset()->sampler.value());
-        mat.material.texture_params.emplace_back(std::move(name), make_ref(tex.asset()->texture));
+        mat.referenced_textures.emplace_back(std::move(name), tex.asset_id());
     }
-    mat.material.update_shader_parameter();
     return mat;
 }
 
+auto MaterialAsset::finalize_load() -> rt::AssetState {
+    rt::TAssetPtr<MaterialAsset> referenced{referenced_material};
+    if (!referenced.empty()) {
+        auto state = referenced.load_async();
+        if (state == rt::AssetState::loading) { return rt::AssetState::loading; }
+        if (state != rt::AssetState::loaded) {
+            log::critical("general", "Failed to load material: Invalid referenced material.");
+            return rt::AssetState::error;
+        }
+    }
+    std::vector<rt::TAssetPtr<TextureAsset>> textures{};
+    textures.reserve(referenced_textures.size());
+    auto waiting_textures = false;
+    for (auto& [_, tex_id] : referenced_textures) {
+        auto state = textures.emplace_back(tex_id).load_async();
+        if (state == rt::AssetState::loading) {
+            waiting_textures = true;
+        } else if (state != rt::AssetState::loaded) {
+            log::critical("general", "Failed to load material: Invalid texture.");
+            return rt::AssetState::error;
+        }
+    }
+    if (waiting_textures) { return rt::AssetState::loading; }
+
+    material.referenced_material = referenced.empty() ? nullptr : &referenced.asset()->material;
+    material.texture_params.clear();
+    material.sampler_params.clear();
+    material.texture_params.reserve(referenced_textures.size());
+    material.sampler_params.reserve(referenced_textures.size());
+    for (size_t i = 0; auto& [name, _] : referenced_textures) {
+        auto tex = textures[i++].asset();
+        material.sampler_params.emplace_back(name + "_sampler", tex->sampler.value());
+        material.texture_params.emplace_back(name, make_ref(tex->texture));
+    }
+    material.update_shader_parameter();
+    return rt::AssetState::loaded;
+}
+
 auto MaterialAsset::save(Dyn<rt::IFile>::Ref file) const -> void {
     MaterialDesc desc{
         .surface_model = material.surface_model,
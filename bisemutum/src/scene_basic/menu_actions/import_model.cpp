@@ -1,5 +1,6 @@
 #include "import_model.hpp"
 
+#include <bisemutum/engine/engine.hpp>
 #include <bisemutum/prelude/misc.hpp>
 #include <bisemutum/scene_basic/static_mesh.hpp>
 #include <bisemutum/scene_basic/texture.hpp>
@@ -12,9 +13,12 @@
 #include <bisemutum/runtime/asset_manager.hpp>
 #include <bisemutum/runtime/prefab.hpp>
 #include <bisemutum/runtime/logger.hpp>
+#include <bisemutum/runtime/thread_pool.hpp>
 #include <bisemutum/runtime/vfs.hpp>
 #include <bisemutum/graphics/graphics_manager.hpp>
 #include <bisemutum/graphics/resource_builder.hpp>
+#include <bisemutum/graphics/mesh_optimization.hpp>
+#include <bisemutum/graphics/meshlet.hpp>
 #define TINYGLTF_IMPLEMENTATION
 #include <tiny_gltf.h>
 #include <assimp/Importer.hpp>
@@ -24,6 +28,182 @@
 
 namespace bi::editor {
 
+namespace {
+
+auto optimize_imported_mesh(StaticMesh& mesh, std::string_view mesh_name) -> void {
+    auto statistics = gfx::optimize_mesh(mesh.get_mutable_mesh_data());
+    log::info(
+        "general", "Optimized mesh '{}': vertices {} -> {}, ACMR {:.3f} -> {:.3f}, overdraw {:.3f} -> {:.3f}.",
+        mesh_name, statistics.num_vertices_before, statistics.num_vertices_after,
+        statistics.acmr_before, statistics.acmr_after, statistics.overdraw_before, statistics.overdraw_after
+    );
+    mesh.get_mutable_mesh_data().set_quantized(true);
+    // Meshlets are built last, since they reorder triangles and their bounds account for quantization.
+    gfx::build_meshlets(mesh.get_mutable_mesh_data());
+}
+
+// Keep encoded images when loading glTF files, they are decoded by `decode_gltf_image()` in parallel.
+auto keep_encoded_gltf_image(
+    tinygltf::Image* image, int image_index, std::string* err, std::string* warn,
+    int req_width, int req_height, unsigned char const* bytes, int size, void* user_data
+) -> bool {
+    image->image.assign(bytes, bytes + size);
+    image->as_is = true;
+    return true;
+}
+auto decode_gltf_image(tinygltf::Image& image, int image_index) -> void {
+    if (!image.as_is) { return; }
+    auto encoded = std::move(image.image);
+    image.image.clear();
+    image.as_is = false;
+    std::string err;
+    std::string warn;
+    if (!tinygltf::LoadImageData(
+        &image, image_index, &err, &warn, 0, 0, encoded.data(), static_cast<int>(encoded.size()), nullptr
+    )) {
+        log::warn("general", "Failed to decode image '{}': {}", image.name, err);
+        image.image.clear();
+    }
+}
+
+// Expand to RGBA8, generate mipmaps and block-compress. Only CPU data are produced so that it can run on worker threads.
+auto process_gltf_image(
+    tinygltf::Image const& gltf_img, MipmapSettings const& mipmap_settings, TextureSemantic semantic
+) -> TextureLevels {
+    rhi::TextureDesc desc = gfx::TextureBuilder{}
+        .dim_2d(rhi::ResourceFormat::rgba8_unorm, gltf_img.width, gltf_img.height)
+        .mipmap()
+        .usage({rhi::TextureUsage::sampled, rhi::TextureUsage::storage_read_write});
+
+    auto num_pixels = gltf_img.width * gltf_img.height;
+    std::vector<std::byte> texture_data(num_pixels * 4);
+    for (int i = 0; i < num_pixels; i++) {
+        for (int c = 0; c < gltf_img.component; c++) {
+            texture_data[4 * i + c] = static_cast<std::byte>(gltf_img.image[gltf_img.component * i + c]);
+        }
+        for (int c = gltf_img.component; c < 3; c++) {
+            texture_data[4 * i + c] = texture_data[4 * i];
+        }
+        if (gltf_img.component == 3) {
+            texture_data[4 * i + 3] = static_cast<std::byte>(255);
+        }
+    }
+
+    auto levels = generate_mipmaps(desc, texture_data, mipmap_settings);
+    if (!levels) {
+        // Remaining levels are generated on GPU.
+        return TextureLevels{.desc = desc, .data = std::move(texture_data), .level_offsets = {0}};
+    }
+    auto compressed = compress_texture(desc, levels.value().data, levels.value().level_offsets, semantic);
+    if (!compressed) { return std::move(levels).value(); }
+    // Block-compressed textures can't be written by shaders.
+    compressed.value().desc.usages = {rhi::TextureUsage::sampled};
+    return std::move(compressed).value();
+}
+
+// Vertices and indices of triangle primitives are appended as submeshes.
+auto load_gltf_mesh(tinygltf::Model const& gltf_model, tinygltf::Mesh const& gltf_mesh, gfx::MeshData& mesh_data) -> void {
+    std::vector<gfx::SubmeshDesc> submeshes;
+    size_t num_vertices = 0;
+    size_t num_indices = 0;
+    std::vector<uint32_t> temp_index_buffer_u32;
+    std::vector<uint16_t> temp_index_buffer_u16;
+    std::vector<uint8_t> temp_index_buffer_u8;
+    for (auto const& gltf_prim : gltf_mesh.primitives) {
+        if (gltf_prim.mode != TINYGLTF_MODE_TRIANGLES) {
+            continue;
+        }
+
+        auto& submesh = submeshes.emplace_back();
+        submesh.base_vertex = num_vertices;
+        submesh.index_offset = num_indices;
+
+        // indices
+        {
+            auto const& index_acc = gltf_model.accessors[gltf_prim.indices];
+            auto const& buffer_view = gltf_model.bufferViews[index_acc.bufferView];
+            auto const& buffer = gltf_model.buffers[buffer_view.buffer];
+            submesh.num_indices = index_acc.count;
+            num_indices += index_acc.count;
+            switch (index_acc.componentType) {
+                case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT:
+                    temp_index_buffer_u32.resize(index_acc.count);
+                    std::memcpy(
+                        temp_index_buffer_u32.data(),
+                        &buffer.data[index_acc.byteOffset + buffer_view.byteOffset],
+                        index_acc.count * sizeof(uint32_t)
+                    );
+                    std::copy(
+                        temp_index_buffer_u32.begin(), temp_index_buffer_u32.end(),
+                        std::back_inserter(mesh_data.mutable_indices())
+                    );
+                    break;
+                case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT:
+                    temp_index_buffer_u16.resize(index_acc.count);
+                    std::memcpy(
+                        temp_index_buffer_u16.data(),
+                        &buffer.data[index_acc.byteOffset + buffer_view.byteOffset],
+                        index_acc.count * sizeof(uint16_t)
+                    );
+                    std::copy(
+                        temp_index_buffer_u16.begin(), temp_index_buffer_u16.end(),
+                        std::back_inserter(mesh_data.mutable_indices())
+                    );
+                    break;
+                case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE:
+                    temp_index_buffer_u8.resize(index_acc.count);
+                    std::memcpy(
+                        temp_index_buffer_u8.data(),
+                        &buffer.data[index_acc.byteOffset + buffer_view.byteOffset],
+                        index_acc.count * sizeof(uint8_t)
+                    );
+                    std::copy(
+                        temp_index_buffer_u8.begin(), temp_index_buffer_u8.end(),
+                        std::back_inserter(mesh_data.mutable_indices())
+                    );
+                    break;
+                default: unreachable();
+            }
+        }
+
+        size_t submesh_num_vertices = 0;
+        auto add_vertex_attribute = [&]<typename T>(char const* name, std::vector<T>& vertices) {
+            auto attrib_it = gltf_prim.attributes.find(name);
+            if (attrib_it == gltf_prim.attributes.end()) {
+                vertices.resize(vertices.size() + submesh_num_vertices, T{0.0f});
+                return;
+            }
+
+            auto const& acc = gltf_model.accessors[attrib_it->second];
+            auto const& buffer_view = gltf_model.bufferViews[acc.bufferView];
+            auto const& buffer = gltf_model.buffers[buffer_view.buffer];
+            auto const* buffer_data = &buffer.data[acc.byteOffset + buffer_view.byteOffset];
+
+            BI_ASSERT(acc.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
+            if (buffer_view.byteStride == 0) {
+                auto typed_buffer_data = reinterpret_cast<T const*>(buffer_data);
+                std::copy(typed_buffer_data, typed_buffer_data + acc.count, std::back_inserter(vertices));
+            } else {
+                for (size_t i = 0; i < acc.count; i++) {
+                    auto& v = vertices.emplace_back();
+                    std::memcpy(&v, buffer_data + i * buffer_view.byteStride, sizeof(v));
+                }
+            }
+        };
+
+        add_vertex_attribute("POSITION", mesh_data.mutable_positions());
+        submesh_num_vertices = mesh_data.positions().size() - num_vertices;
+        num_vertices += submesh_num_vertices;
+
+        add_vertex_attribute("NORMAL", mesh_data.mutable_normals());
+
+        add_vertex_attribute("TEXCOORD_0", mesh_data.mutable_texcoords());
+    }
+    mesh_data.set_submehes(std::move(submeshes));
+}
+
+} // namespace
+
 auto menu_action_import_model_gltf(MenuActionContext const& ctx) -> void {
     ctx.file_dialog->choose_file(
         "Import Model (glTF)", "Choose File", ".gltf,.glb",
@@ -32,6 +212,7 @@ auto menu_action_import_model_gltf(MenuActionContext const& ctx) -> void {
             if (!std::filesystem::exists(path)) { return; }
 
             tinygltf::TinyGLTF loader;
+            loader.SetImageLoader(keep_encoded_gltf_image, nullptr);
             std::string load_err;
             std::string load_warn;
             tinygltf::Model gltf_model;
@@ -58,9 +239,72 @@ auto menu_action_import_model_gltf(MenuActionContext const& ctx) -> void {
             auto base_object = current_scene->create_scene_object();
             base_object->set_name(model_name);
 
+            // Textures used in different ways by materials are kept as general color data.
+            std::vector<Option<TextureSemantic>> tex_semantics{gltf_model.textures.size()};
+            std::vector<MipmapSettings> tex_mipmap_settings{gltf_model.textures.size()};
+            auto use_texture_as = [&](int index, TextureSemantic semantic, bool srgb_encoded = false) {
+                if (index < 0 || index >= tex_semantics.size()) { return; }
+                auto& tex_semantic = tex_semantics[index];
+                tex_semantic = !tex_semantic || tex_semantic.value() == semantic ? semantic : TextureSemantic::albedo;
+                tex_mipmap_settings[index].srgb_encoded |= srgb_encoded;
+            };
+            for (auto const& gltf_mat : gltf_model.materials) {
+                auto const& gltf_pbr = gltf_mat.pbrMetallicRoughness;
+                // Base color and emission textures are sRGB-encoded in glTF.
+                use_texture_as(gltf_pbr.baseColorTexture.index, TextureSemantic::albedo, true);
+                use_texture_as(gltf_pbr.metallicRoughnessTexture.index, TextureSemantic::albedo);
+                use_texture_as(gltf_mat.emissiveTexture.index, TextureSemantic::albedo, true);
+                use_texture_as(gltf_mat.normalTexture.index, TextureSemantic::normal);
+                use_texture_as(gltf_mat.occlusionTexture.index, TextureSemantic::mask);
+                if (gltf_mat.alphaMode == "MASK" && gltf_pbr.baseColorTexture.index >= 0) {
+                    tex_mipmap_settings[gltf_pbr.baseColorTexture.index].alpha_cutoff =
+                        static_cast<float>(gltf_mat.alphaCutoff);
+                }
+            }
+
+            // Decode images and process meshes on worker threads. Assets are created before that,
+            // since the asset manager is only used on the main thread.
             std::unordered_set<std::string> used_names{};
-            std::vector<rt::AssetId> tex_ids{gltf_model.textures.size()};
-            std::vector<Ptr<TextureAsset>> tex_assets{gltf_model.textures.size()};
+            std::vector<rt::AssetId> mesh_ids{gltf_model.meshes.size()};
+            std::vector<Ptr<StaticMesh>> meshes{gltf_model.meshes.size()};
+            std::vector<std::string> mesh_names{gltf_model.meshes.size()};
+            for (size_t i = 0; auto const& gltf_mesh : gltf_model.meshes) {
+                size_t num_vertices = 0;
+                for (auto const& gltf_prim : gltf_mesh.primitives) {
+                    if (gltf_prim.mode != TINYGLTF_MODE_TRIANGLES) { continue; }
+                    auto const& pos_acc = gltf_model.accessors[gltf_prim.attributes.at("POSITION")];
+                    num_vertices += pos_acc.count;
+                }
+                if (num_vertices == 0) { ++i; continue; }
+
+                auto mesh_name = gltf_mesh.name;
+                if (mesh_name.empty() || used_names.contains(mesh_name)) {
+                    mesh_name = fmt::format("mesh{}", i);
+                }
+                used_names.insert(mesh_name);
+
+                auto mesh_path = fmt::format("/project/imported/models/{}/{}.static_mesh.biasset", model_name, mesh_name);
+                auto [mesh_asset_id, mesh] = g_engine->asset_manager()->create_asset(mesh_path, StaticMesh{});
+                mesh_ids[i] = mesh_asset_id;
+                meshes[i] = mesh;
+                mesh_names[i] = std::move(mesh_name);
+
+                ++i;
+            }
+            auto num_images = gltf_model.images.size();
+            g_engine->thread_pool()->parallel_for(num_images + meshes.size(), [&](size_t index) {
+                if (index < num_images) {
+                    decode_gltf_image(gltf_model.images[index], static_cast<int>(index));
+                    return;
+                }
+                index -= num_images;
+                if (!meshes[index]) { return; }
+                auto mesh = meshes[index].value();
+                load_gltf_mesh(gltf_model, gltf_model.meshes[index], mesh->get_mutable_mesh_data());
+                mesh->calculate_tspace();
+                optimize_imported_mesh(*mesh, mesh_names[index]);
+            });
+
             tinygltf::Image default_gltf_image{};
             default_gltf_image.name = std::string("default");
             default_gltf_image.width = 1;
@@ -69,6 +313,24 @@ auto menu_action_import_model_gltf(MenuActionContext const& ctx) -> void {
             default_gltf_image.bits = 8;
             default_gltf_image.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
             default_gltf_image.image = {255, 255, 255, 255};
+            std::vector<TextureLevels> tex_levels{gltf_model.textures.size()};
+            g_engine->thread_pool()->parallel_for(gltf_model.textures.size(), [&](size_t index) {
+                auto const& gltf_tex = gltf_model.textures[index];
+                auto const* gltf_img = &default_gltf_image;
+                if (
+                    gltf_tex.source >= 0 && gltf_tex.source < gltf_model.images.size()
+                    && !gltf_model.images[gltf_tex.source].image.empty()
+                ) {
+                    gltf_img = &gltf_model.images[gltf_tex.source];
+                }
+                tex_levels[index] = process_gltf_image(
+                    *gltf_img, tex_mipmap_settings[index], tex_semantics[index].value_or(TextureSemantic::albedo)
+                );
+            });
+
+            used_names.clear();
+            std::vector<rt::AssetId> tex_ids{gltf_model.textures.size()};
+            std::vector<Ptr<TextureAsset>> tex_assets{gltf_model.textures.size()};
             for (size_t i = 0; auto const& gltf_tex : gltf_model.textures) {
                 auto tex_name = gltf_tex.name;
                 if (tex_name.empty() || used_names.contains(tex_name)) {
@@ -81,31 +343,9 @@ auto menu_action_import_model_gltf(MenuActionContext const& ctx) -> void {
                 tex_ids[i] = tex_asset_id;
                 tex_assets[i] = tex;
 
-                auto const* gltf_img = &default_gltf_image;
-                if (gltf_tex.source >= 0 && gltf_tex.source < gltf_model.images.size()) {
-                    gltf_img = &gltf_model.images[gltf_tex.source];
-                }
-                auto format = rhi::ResourceFormat::rgba8_unorm;
-
-                auto num_pixels = gltf_img->width * gltf_img->height;
-                tex->texture_data.resize(gltf_img->width * gltf_img->height * 4);
-                for (int i = 0; i < num_pixels; i++) {
-                    for (int c = 0; c < gltf_img->component; c++) {
-                        tex->texture_data[4 * i + c] = static_cast<std::byte>(gltf_img->image[gltf_img->component * i + c]);
-                    }
-                    for (int c = gltf_img->component; c < 3; c++) {
-                        tex->texture_data[4 * i + c] = tex->texture_data[4 * i];
-                    }
-                    if (gltf_img->component == 3) {
-                        tex->texture_data[4 * i + 3] = static_cast<std::byte>(255);
-                    }
-                }
-                tex->texture = gfx::Texture{
-                    gfx::TextureBuilder{}
-                        .dim_2d(format, gltf_img->width, gltf_img->height)
-                        .mipmap()
-                        .usage({rhi::TextureUsage::sampled, rhi::TextureUsage::storage_read_write})
-                };
+                tex->texture = gfx::Texture{tex_levels[i].desc};
+                tex->texture_data = std::move(tex_levels[i].data);
+                tex->level_offsets = std::move(tex_levels[i].level_offsets);
                 tex->update_gpu_data();
 
                 rhi::SamplerDesc sampler_desc{
@@ -144,7 +384,6 @@ auto menu_action_import_model_gltf(MenuActionContext const& ctx) -> void {
 
                 ++i;
             }
-
             used_names.clear();
             std::vector<rt::AssetId> mat_ids{gltf_model.materials.size()};
             for (size_t i = 0; auto const& gltf_mat : gltf_model.materials) {
@@ -210,7 +449,8 @@ float4 base_color = PARAM_base_color_tex.Sample(PARAM_base_color_tex_sampler, ve
 surface.base_color = base_color.xyz;
 surface.opacity = base_color.w;
 
-float3 normal_map_value = PARAM_normal_map.Sample(PARAM_normal_map_sampler, vertex.texcoord).xyz * 2.0 - 1.0;
+float2 normal_map_xy = PARAM_normal_map.Sample(PARAM_normal_map_sampler, vertex.texcoord).xy * 2.0 - 1.0;
+float3 normal_map_value = float3(normal_map_xy, sqrt(saturate(1.0 - dot(normal_map_xy, normal_map_xy))));
 normal_map_value = normalize(normal_map_value * float3(PARAM_normal_map_scale, PARAM_normal_map_scale, 1.0));
 surface.normal_map_value = normal_map_value * 0.5 + 0.5;
 
@@ -234,131 +474,6 @@ surface.two_sided = PARAM_two_sided != 0;
                 ++i;
             }
 
-            used_names.clear();
-            std::vector<rt::AssetId> mesh_ids{gltf_model.meshes.size()};
-            for (size_t i = 0; auto const& gltf_mesh : gltf_model.meshes) {
-                size_t num_vertices = 0;
-                size_t num_indices = 0;
-                for (auto const& gltf_prim : gltf_mesh.primitives) {
-                    if (gltf_prim.mode != TINYGLTF_MODE_TRIANGLES) { continue; }
-                    auto const& pos_acc = gltf_model.accessors[gltf_prim.attributes.at("POSITION")];
-                    num_vertices += pos_acc.count;
-                    auto const& index_acc = gltf_model.accessors[gltf_prim.indices];
-                    num_indices += index_acc.count;
-                }
-                if (num_vertices == 0) { ++i; continue; }
-
-                auto mesh_name = gltf_mesh.name;
-                if (mesh_name.empty() || used_names.contains(mesh_name)) {
-                    mesh_name = fmt::format("mesh{}", i);
-                }
-                used_names.insert(mesh_name);
-
-                auto mesh_path = fmt::format("/project/imported/models/{}/{}.static_mesh.biasset", model_name, mesh_name);
-                auto [mesh_asset_id, mesh] = g_engine->asset_manager()->create_asset(mesh_path, StaticMesh{});
-                mesh_ids[i] = mesh_asset_id;
-
-                std::vector<gfx::SubmeshDesc> submeshes;
-                num_vertices = 0;
-                num_indices = 0;
-                std::vector<uint32_t> temp_index_buffer_u32;
-                std::vector<uint16_t> temp_index_buffer_u16;
-                std::vector<uint8_t> temp_index_buffer_u8;
-                for (auto const& gltf_prim : gltf_mesh.primitives) {
-                    if (gltf_prim.mode != TINYGLTF_MODE_TRIANGLES) {
-                        continue;
-                    }
-
-                    auto& submesh = submeshes.emplace_back();
-                    submesh.base_vertex = num_vertices;
-                    submesh.index_offset = num_indices;
-
-                    // indices
-                    {
-                        auto const& index_acc = gltf_model.accessors[gltf_prim.indices];
-                        auto const& buffer_view = gltf_model.bufferViews[index_acc.bufferView];
-                        auto const& buffer = gltf_model.buffers[buffer_view.buffer];
-                        submesh.num_indices = index_acc.count;
-                        num_indices += index_acc.count;
-                        switch (index_acc.componentType) {
-                            case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT:
-                                temp_index_buffer_u32.resize(index_acc.count);
-                                std::memcpy(
-                                    temp_index_buffer_u32.data(),
-                                    &buffer.data[index_acc.byteOffset + buffer_view.byteOffset],
-                                    index_acc.count * sizeof(uint32_t)
-                                );
-                                std::copy(
-                                    temp_index_buffer_u32.begin(), temp_index_buffer_u32.end(),
-                                    std::back_inserter(mesh->get_mutable_mesh_data().mutable_indices())
-                                );
-                                break;
-                            case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT:
-                                temp_index_buffer_u16.resize(index_acc.count);
-                                std::memcpy(
-                                    temp_index_buffer_u16.data(),
-                                    &buffer.data[index_acc.byteOffset + buffer_view.byteOffset],
-                                    index_acc.count * sizeof(uint16_t)
-                                );
-                                std::copy(
-                                    temp_index_buffer_u16.begin(), temp_index_buffer_u16.end(),
-                                    std::back_inserter(mesh->get_mutable_mesh_data().mutable_indices())
-                                );
-                                break;
-                            case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE:
-                                temp_index_buffer_u8.resize(index_acc.count);
-                                std::memcpy(
-                                    temp_index_buffer_u8.data(),
-                                    &buffer.data[index_acc.byteOffset + buffer_view.byteOffset],
-                                    index_acc.count * sizeof(uint8_t)
-                                );
-                                std::copy(
-                                    temp_index_buffer_u8.begin(), temp_index_buffer_u8.end(),
-                                    std::back_inserter(mesh->get_mutable_mesh_data().mutable_indices())
-                                );
-                                break;
-                            default: unreachable();
-                        }
-                    }
-
-                    size_t submesh_num_vertices = 0;
-                    auto add_vertex_attribute = [&]<typename T>(char const* name, std::vector<T>& vertices) {
-                        auto attrib_it = gltf_prim.attributes.find(name);
-                        if (attrib_it == gltf_prim.attributes.end()) {
-                            vertices.resize(vertices.size() + submesh_num_vertices, T{0.0f});
-                            return;
-                        }
-
-                        auto const& acc = gltf_model.accessors[attrib_it->second];
-                        auto const& buffer_view = gltf_model.bufferViews[acc.bufferView];
-                        auto const& buffer = gltf_model.buffers[buffer_view.buffer];
-                        auto const* buffer_data = &buffer.data[acc.byteOffset + buffer_view.byteOffset];
-
-                        BI_ASSERT(acc.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
-                        if (buffer_view.byteStride == 0) {
-                            auto typed_buffer_data = reinterpret_cast<T const*>(buffer_data);
-                            std::copy(typed_buffer_data, typed_buffer_data + acc.count, std::back_inserter(vertices));
-                        } else {
-                            for (size_t i = 0; i < acc.count; i++) {
-                                auto& v = vertices.emplace_back();
-                                std::memcpy(&v, buffer_data + i * buffer_view.byteStride, sizeof(v));
-                            }
-                        }
-                    };
-
-                    add_vertex_attribute("POSITION", mesh->get_mutable_mesh_data().mutable_positions());
-                    submesh_num_vertices = mesh->get_mesh_data().positions().size() - num_vertices;
-                    num_vertices += submesh_num_vertices;
-
-                    add_vertex_attribute("NORMAL", mesh->get_mutable_mesh_data().mutable_normals());
-
-                    add_vertex_attribute("TEXCOORD_0", mesh->get_mutable_mesh_data().mutable_texcoords());
-                }
-                mesh->get_mutable_mesh_data().set_submehes(std::move(submeshes));
-                mesh->calculate_tspace();
-
-                ++i;
-            }
 
             used_names.clear();
             size_t num_nodes = 0;
@@ -437,7 +552,7 @@ auto menu_action_import_model_assimp(MenuActionContext const& ctx) -> void {
             if (!std::filesystem::exists(path)) { return; }
             rt::PhysicalFile file{path, false};
 
-            auto file_data = file.read_binary_data();
+            auto file_data = file.map_binary_data();
             Assimp::Importer importer{};
             importer.SetPropertyInteger(
                 AI_CONFIG_PP_RVC_FLAGS,
@@ -470,7 +585,6 @@ auto menu_action_import_model_assimp(MenuActionContext const& ctx) -> void {
             auto current_scene = g_engine->world()->current_scene().value();
             auto object = current_scene->create_scene_object();
             object->set_name(model_name);
-            auto curr_object = object;
 
             std::unordered_set<std::string> used_names{};
             std::vector<rt::AssetId> mat_ids{scene->mNumMaterials};
@@ -508,6 +622,10 @@ surface.roughness = PARAM_roughness;
             }
 
             used_names.clear();
+            std::vector<Ptr<StaticMesh>> meshes{scene->mNumMeshes};
+            std::vector<std::string> mesh_names{scene->mNumMeshes};
+            std::vector<Ref<rt::SceneObject>> mesh_objects{scene->mNumMeshes, object};
+            std::vector<rt::AssetId> mesh_ids{scene->mNumMeshes};
             for (uint32_t i = 0; i < scene->mNumMeshes; i++) {
                 auto ai_mesh = scene->mMeshes[i];
 
@@ -517,13 +635,21 @@ surface.roughness = PARAM_roughness;
                 }
                 used_names.insert(mesh_name);
                 if (scene->mNumMeshes > 1) {
-                    curr_object = current_scene->create_scene_object(object);
-                    curr_object->set_name(mesh_name);
+                    mesh_objects[i] = current_scene->create_scene_object(object);
+                    mesh_objects[i]->set_name(mesh_name);
                 }
 
                 auto mesh_path = fmt::format("/project/imported/models/{}/{}.static_mesh.biasset", model_name, mesh_name);
                 auto [mesh_asset_id, mesh] = g_engine->asset_manager()->create_asset(mesh_path, StaticMesh{});
+                mesh_ids[i] = mesh_asset_id;
+                meshes[i] = mesh;
+                mesh_names[i] = std::move(mesh_name);
+            }
 
+            // Meshes are filled and processed on worker threads, components are attached after that.
+            g_engine->thread_pool()->parallel_for(scene->mNumMeshes, [&](size_t index) {
+                auto ai_mesh = scene->mMeshes[index];
+                auto mesh = meshes[index].value();
                 mesh->resize(ai_mesh->mNumVertices, ai_mesh->mNumFaces * 3);
                 mesh->set_positions_raw(reinterpret_cast<float3 const*>(ai_mesh->mVertices));
                 mesh->set_normals_raw(reinterpret_cast<float3 const*>(ai_mesh->mNormals));
@@ -537,12 +663,15 @@ surface.roughness = PARAM_roughness;
                     mesh->set_index_at(3 * i + 2, ai_face.mIndices[2]);
                 }
                 mesh->calculate_tspace();
+                optimize_imported_mesh(*mesh, mesh_names[index]);
+            });
 
-                curr_object->attach_component(StaticMeshComponent{
-                    .static_mesh = {mesh_asset_id},
+            for (uint32_t i = 0; i < scene->mNumMeshes; i++) {
+                mesh_objects[i]->attach_component(StaticMeshComponent{
+                    .static_mesh = {mesh_ids[i]},
                 });
-                curr_object->attach_component(MeshRendererComponent{
-                    .materials = {{mat_ids[ai_mesh->mMaterialIndex]}},
+                mesh_objects[i]->attach_component(MeshRendererComponent{
+                    .materials = {{mat_ids[scene->mMeshes[i]->mMaterialIndex]}},
                 });
             }
 
@@ -1,5 +1,6 @@
 #include "import_texture.hpp"
 
+#include <bisemutum/engine/engine.hpp>
 #include <bisemutum/scene_basic/texture.hpp>
 #include <bisemutum/editor/file_dialog.hpp>
 #include <bisemutum/graphics/graphics_manager.hpp>
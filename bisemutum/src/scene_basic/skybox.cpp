@@ -52,8 +52,7 @@ struct SkyboxSystem::Impl final {
         curr_skybox_info.specular_strength = 0.0f;
         if (curr_skybox) {
             auto component = curr_skybox->get_component<SkyboxComponent>();
-            if (!component->texture.empty()) {
-                component->texture.load();
+            if (component->texture.load_async() == rt::AssetState::loaded) {
                 if (component->texture.asset()->texture.has_value()) {
                     auto& desc = component->texture.asset()->texture.desc();
                     if (
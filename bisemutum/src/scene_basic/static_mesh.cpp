@@ -1,45 +1,29 @@
 #include <bisemutum/scene_basic/static_mesh.hpp>
 
-#include <bisemutum/prelude/byte_stream.hpp>
-#include <bisemutum/runtime/logger.hpp>
+#include <bisemutum/runtime/thread_pool.hpp>
 #include <bisemutum/graphics/resource_builder.hpp>
 #include <mikktspace.h>
 
 namespace bi {
 
-auto StaticMesh::load(Dyn<rt::IFile>::Ref file) -> rt::AssetAny {
-    auto binary_data = file.read_binary_data();
-    ReadByteStream bs{binary_data};
+namespace {
 
-    uint32_t magic_number = 0;
-    std::string asset_type_name;
-    uint32_t version = 0;
-    bs.read(magic_number).read(asset_type_name).read(version);
-    if (!rt::check_if_binary_asset_valid<StaticMesh>(file.filename(), magic_number, asset_type_name)) {
-        return {};
-    }
+auto engine_parallel_for() -> ParallelFor {
+    return rt::g_thread_pool ? rt::g_thread_pool->parallel_for_fn() : ParallelFor{};
+}
+
+} // namespace
 
+auto StaticMesh::load(Dyn<rt::IFile>::Ref file) -> rt::AssetAny {
     StaticMesh mesh{};
-    if (version == 1) {
-        mesh.mesh_.load_from_byte_stream(bs);
-    } else if (version == 2) {
-        ReadByteStream data_bs{};
-        bs.read_compressed_part(data_bs);
-        mesh.mesh_.load_from_byte_stream(data_bs);
+    if (!read_static_mesh_data(file, mesh.mesh_, engine_parallel_for())) {
+        return {};
     }
-
     return mesh;
 }
 
 auto StaticMesh::save(Dyn<rt::IFile>::Ref file) const -> void {
-    WriteByteStream bs{};
-    bs.write(rt::asset_magic_number).write(StaticMesh::asset_type_name).write(2u);
-
-    auto data_from = bs.curr_offset();
-    mesh_.save_to_byte_stream(bs);
-    bs.compress_data(data_from);
-
-    file.write_binary_data(bs.data());
+    write_static_mesh_data(file, mesh_, engine_parallel_for());
 }
 
 auto StaticMesh::fill_shader_params(
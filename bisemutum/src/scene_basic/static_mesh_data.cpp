@@ -0,0 +1,49 @@
+#include <bisemutum/scene_basic/static_mesh_data.hpp>
+
+#include <bisemutum/runtime/asset.hpp>
+#include <bisemutum/runtime/logger.hpp>
+
+namespace bi {
+
+auto read_static_mesh_data(
+    Dyn<rt::IFile>::Ref file, gfx::MeshData& mesh, ParallelFor const& parallel_for
+) -> bool {
+    auto binary_data = file.map_binary_data();
+    ReadByteStream bs{binary_data};
+
+    uint32_t magic_number = 0;
+    std::string asset_type_name;
+    uint32_t version = 0;
+    bs.read(magic_number).read(asset_type_name).read(version);
+    if (!rt::check_if_binary_asset_valid(file.filename(), magic_number, asset_type_name, static_mesh_asset_type_name)) {
+        return false;
+    }
+
+    if (version == 1) {
+        mesh.load_from_byte_stream(bs, 0);
+    } else if (version >= 2 && version <= 4) {
+        ReadByteStream data_bs{};
+        bs.read_compressed_part_streaming(data_bs, parallel_for);
+        // Version 3 adds quantized vertex attributes and version 4 adds meshlets.
+        mesh.load_from_byte_stream(data_bs, version - 2);
+    } else {
+        log::critical("general", "Failed to load StaticMesh ('{}'): Unknown version {}.", file.filename(), version);
+        return false;
+    }
+    return true;
+}
+
+auto write_static_mesh_data(
+    Dyn<rt::IFile>::Ref file, gfx::MeshData const& mesh, ParallelFor const& parallel_for
+) -> bool {
+    WriteByteStream bs{};
+    bs.write(rt::asset_magic_number).write(static_mesh_asset_type_name).write(4u);
+
+    auto data_from = bs.curr_offset();
+    mesh.save_to_byte_stream(bs);
+    bs.compress_data(data_from, CompressionCodec::zstd, parallel_for);
+
+    return file.write_binary_data(bs.data());
+}
+
+}
@@ -41,22 +41,27 @@ struct StaticMeshRenderSystem::Impl final {
         }
         destroyed_entities.clear();
 
+        std::vector<entt::entity> loading_entities{};
         for (auto entity : dirty_entities) {
             auto object = scene->object_of(entity);
             if (!object->has_components<StaticMeshComponent, MeshRendererComponent>()) {
                 continue;
             }
+            auto mesh = object->get_component<StaticMeshComponent>();
+            auto renderer = object->get_component<MeshRendererComponent>();
+            // Drawables are updated after the mesh and its materials are loaded, instead of waiting for them.
+            auto assets_state = load_assets_async(*mesh, *renderer);
+            if (assets_state == rt::AssetState::loading) {
+                loading_entities.push_back(entity);
+                continue;
+            } else if (assets_state != rt::AssetState::loaded) {
+                continue;
+            }
             auto handle_it = drawable_handles.find(entity);
             if (handle_it == drawable_handles.end()) {
                 handle_it = drawable_handles.insert({entity, {}}).first;
             }
-            auto mesh = object->get_component<StaticMeshComponent>();
-            auto renderer = object->get_component<MeshRendererComponent>();
-            mesh->static_mesh.load();
-            auto num_submehes = std::min<uint32_t>(
-                renderer->materials.size(),
-                mesh->static_mesh.asset()->get_mesh_data().num_submehes() - renderer->submesh_start_index
-            );
+            auto num_submehes = num_submeshes_of(*mesh, *renderer);
             if (handle_it->second.size() < num_submehes) {
                 auto new_count = num_submehes - handle_it->second.size();
                 for (size_t i = 0; i < new_count; i++) {
@@ -72,7 +77,6 @@ struct StaticMeshRenderSystem::Impl final {
             }
             for (uint32_t i = 0; i < num_submehes; i++) {
                 auto drawable = gpu_scene->get_drawable(handle_it->second[i]);
-                renderer->materials[i].load();
                 drawable->mesh = mesh->static_mesh.asset().get();
                 drawable->material = &renderer->materials[i].asset()->material;
                 drawable->submesh_index = renderer->submesh_start_index + i;
@@ -85,7 +89,8 @@ struct StaticMeshRenderSystem::Impl final {
             }
         }
         dirty_entities.clear();
-        dirty_meshes.clear();
+        dirty_entities.insert(loading_entities.begin(), loading_entities.end());
+        std::erase_if(dirty_meshes, [this](entt::entity entity) { return !dirty_entities.contains(entity); });
 
         for (auto& [entity, handles] : drawable_handles) {
             auto object = scene->object_of(entity);
@@ -96,6 +101,28 @@ struct StaticMeshRenderSystem::Impl final {
         }
     }
 
+    auto num_submeshes_of(StaticMeshComponent const& mesh, MeshRendererComponent const& renderer) -> uint32_t {
+        return std::min<uint32_t>(
+            renderer.materials.size(),
+            mesh.static_mesh.asset()->get_mesh_data().num_submehes() - renderer.submesh_start_index
+        );
+    }
+
+    auto load_assets_async(StaticMeshComponent const& mesh, MeshRendererComponent const& renderer) -> rt::AssetState {
+        auto state = mesh.static_mesh.load_async();
+        if (state != rt::AssetState::loaded) { return state; }
+        auto num_submehes = num_submeshes_of(mesh, renderer);
+        for (uint32_t i = 0; i < num_submehes; i++) {
+            auto material_state = renderer.materials[i].load_async();
+            if (material_state == rt::AssetState::loading) {
+                state = rt::AssetState::loading;
+            } else if (material_state != rt::AssetState::loaded) {
+                return material_state;
+            }
+        }
+        return state;
+    }
+
     auto on_construct(entt::registry& ecs_registry, entt::entity entity) -> void {
         dirty_entities.insert(entity);
     }
@@ -1,40 +1,22 @@
 #include <bisemutum/scene_basic/texture.hpp>
 
-#include <bisemutum/prelude/byte_stream.hpp>
+#include <chrono>
+#include <functional>
+
+#include <bisemutum/prelude/math.hpp>
 #include <bisemutum/engine/engine.hpp>
 #include <bisemutum/runtime/logger.hpp>
+#include <bisemutum/runtime/thread_pool.hpp>
 #include <bisemutum/graphics/graphics_manager.hpp>
 #include <bisemutum/graphics/resource_builder.hpp>
 #include <bisemutum/rhi/sampler.hpp>
 
-#define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
 
 namespace bi {
 
-namespace rhi {
-
-BI_SREFL(
-    type(SamplerDesc),
-    field(mag_filter),
-    field(min_filter),
-    field(mipmap_mode),
-    field(address_mode_u),
-    field(address_mode_v),
-    field(address_mode_w),
-    field(border_color),
-    field(compare_enabled),
-    field(compare_op),
-    field(anisotropy),
-    field(lod_bias),
-    field(lod_min),
-    field(lod_max)
-)
-
-} // namespace rhi
-
 namespace {
 
 struct TextureAssetDesc final {
@@ -78,85 +60,116 @@ auto get_format(uint32_t num_bits, uint32_t num_channels, bool srgb, bool is_flo
     return rhi::ResourceFormat::undefined;
 }
 
+// Copy stored levels from `first_level` of the full mip chain, which are level 0 and after of the texture.
+// Buffer offsets are relative to the first copied level.
+auto copy_stored_levels(
+    rhi::TextureDesc const& desc, CSpan<uint64_t> level_offsets, uint32_t first_level,
+    std::function<auto(rhi::BufferTextureCopyDesc const&) -> void> copy
+) -> void {
+    auto block_dim = rhi::is_compressed_format(desc.format) ? 4u : 1u;
+    for (auto level = first_level; level < level_offsets.size(); level++) {
+        auto extent = texture_level_extent(desc, level);
+        copy(rhi::BufferTextureCopyDesc{
+            .buffer_offset = level_offsets[level] - level_offsets[first_level],
+            .buffer_pixels_per_row = aligned_size(extent.width, block_dim),
+            .buffer_rows_per_texture = aligned_size(extent.height, block_dim),
+            .texture_extent = extent,
+            .texture_level = level - first_level,
+        });
+    }
+}
+
+// LOD range of sampler is relative to the full mip chain, so textures with a custom one are not streamed.
+auto is_streamable(TextureAssetHeader const& header) -> bool {
+    auto const& desc = header.desc;
+    return desc.dim == rhi::TextureDimension::d2
+        && desc.levels > 1 && header.level_offsets.size() == desc.levels
+        && header.sampler.lod_min <= 0.0f && header.sampler.lod_max >= desc.levels;
+}
+
 } // namespace
 
 auto TextureAsset::load(Dyn<rt::IFile>::Ref file) -> rt::AssetAny {
-    auto binary_data = file.read_binary_data();
-    ReadByteStream bs{binary_data};
-
-    uint32_t magic_number = 0;
-    std::string asset_type_name;
-    uint32_t version = 0;
-    bs.read(magic_number).read(asset_type_name).read(version);
-    if (!rt::check_if_binary_asset_valid<TextureAsset>(file.filename(), magic_number, asset_type_name)) {
-        return {};
-    }
+    auto header = read_texture_asset_header(file);
+    if (!header) { return {}; }
+    auto parallel_for = g_engine->thread_pool()->parallel_for_fn();
 
-    rhi::SamplerDesc sampler_desc{};
-    bs.read(sampler_desc);
-    rhi::TextureDesc texture_desc{};
-    bs.read(texture_desc);
-
-    TextureAsset texture{
-        .texture = texture_desc,
-        .sampler = g_engine->graphics_manager()->get_sampler(sampler_desc),
-    };
-
-    if (version == 1) {
-        uint32_t storage_type = 0;
-        bs.read(storage_type);
-        if (storage_type == 0) {
-            bs.read(texture.texture_data);
-        } else if (storage_type == 1) {
-            auto bytes_per_layer =
-                texture_desc.extent.width * texture_desc.extent.height * rhi::format_texel_size(texture_desc.format);
-            texture.texture_data.resize(bytes_per_layer * texture_desc.extent.depth_or_layers);
-            for (uint32_t layer = 0; layer < texture_desc.extent.depth_or_layers; layer++) {
-                std::vector<std::byte> png_data;
-                bs.read(png_data);
-                int temp_width, temp_height, temp_comp;
-                auto image_data = stbi_load_from_memory(
-                    reinterpret_cast<stbi_uc*>(png_data.data()), png_data.size(),
-                    &temp_width, &temp_height, &temp_comp, 0
-                );
-                std::copy_n(
-                    reinterpret_cast<std::byte const*>(image_data), bytes_per_layer,
-                    texture.texture_data.data() + layer * bytes_per_layer
-                );
-            }
-        }
+    TextureAsset texture{};
+    // Only tail levels are read if the file can be read again when other levels are streamed in.
+    auto reader = file.range_reader();
+    if (reader && is_streamable(header.value()) && !header.value().level_file_offsets.empty()) {
+        auto const& desc = header.value().desc;
+        auto tail_level = gfx::streamed_texture_tail_level(
+            g_engine->graphics_manager()->texture_streaming_settings(),
+            desc.extent.width, desc.extent.height, desc.levels
+        );
+        auto levels = read_texture_asset_levels(reader, header.value(), tail_level, desc.levels, parallel_for);
+        if (!levels) { return {}; }
+        texture.texture_data = std::move(levels).value();
+        texture.data_first_level_ = tail_level;
+        texture.level_reader_ = std::move(reader);
     } else {
-        ReadByteStream data_bs{};
-        bs.read_compressed_part(data_bs);
-        data_bs.read(texture.texture_data);
+        auto data = read_texture_asset_data(file, parallel_for);
+        if (!data) { return {}; }
+        texture.texture_data = std::move(data.value().levels.data);
     }
-
-    texture.update_gpu_data();
-
+    texture.level_offsets = header.value().level_offsets;
+    texture.loaded_header_ = std::move(header).value();
     return texture;
 }
 
-auto TextureAsset::save(Dyn<rt::IFile>::Ref file) const -> void {
-    WriteByteStream bs{};
-    bs.write(rt::asset_magic_number).write(TextureAsset::asset_type_name).write(2u);
+auto TextureAsset::finalize_load() -> rt::AssetState {
+    sampler = g_engine->graphics_manager()->get_sampler(loaded_header_.sampler);
 
-    auto& sampler_desc = sampler->rhi_sampler()->desc();
-    bs.write(sampler_desc);
-    auto& texture_desc = texture.desc();
-    bs.write(texture_desc);
-
-    auto data_from = bs.curr_offset();
-    bs.write(texture_data);
-    bs.compress_data(data_from);
+    auto const& desc = loaded_header_.desc;
+    if (is_streamable(loaded_header_)) {
+        std::vector<uint64_t> level_sizes(desc.levels);
+        for (uint32_t level = 0; level < desc.levels; level++) {
+            level_sizes[level] = texture_level_size(desc, level);
+        }
+        streamed_texture_ = gfx::StreamedTexture{gfx::StreamedTextureDesc{
+            .texture = texture,
+            .width = desc.extent.width,
+            .height = desc.extent.height,
+            .level_sizes = std::move(level_sizes),
+            .update_levels = [this](uint32_t first_level) { return update_resident_levels(first_level); },
+        }};
+    } else {
+        texture = desc;
+        update_gpu_data();
+    }
+    return rt::AssetState::loaded;
+}
 
-    file.write_binary_data(bs.data());
+auto TextureAsset::save(Dyn<rt::IFile>::Ref file) const -> void {
+    auto parallel_for = g_engine->thread_pool()->parallel_for_fn();
+    std::vector<std::byte> all_levels_data{};
+    if (data_first_level_ > 0) {
+        auto levels = read_texture_asset_levels(level_reader_, loaded_header_, 0, data_first_level_, parallel_for);
+        if (!levels) {
+            log::error("general", "Failed to save texture '{}': Streamed levels can't be read.", file.filename());
+            return;
+        }
+        all_levels_data = std::move(levels).value();
+        all_levels_data.insert(all_levels_data.end(), texture_data.begin(), texture_data.end());
+    }
+    write_texture_asset_data(
+        file, sampler->rhi_sampler()->desc(), full_texture_desc(), level_offsets,
+        data_first_level_ > 0 ? all_levels_data : texture_data, parallel_for
+    );
 }
 
 auto TextureAsset::update_gpu_data() -> void {
-    gfx::Buffer temp_buffer{gfx::BufferBuilder().size(texture_data.size()).mem_upload()};
-    temp_buffer.set_data_raw(texture_data.data(), texture_data.size());
+    upload_levels(full_texture_desc(), resident_level_);
+}
+
+auto TextureAsset::upload_levels(rhi::TextureDesc const& full_desc, uint32_t first_level) -> void {
+    auto data_offset = level_offsets[first_level] - level_offsets[data_first_level_];
+    auto data_size = texture_data.size() - data_offset;
+    gfx::Buffer temp_buffer{gfx::BufferBuilder().size(data_size).mem_upload()};
+    temp_buffer.set_data_raw(texture_data.data() + data_offset, data_size);
     g_engine->graphics_manager()->execute_in_this_frame(
-        [this, &temp_buffer](Ref<rhi::CommandEncoder> cmd) {
+        [this, &full_desc, first_level, &temp_buffer](Ref<rhi::CommandEncoder> cmd) {
             auto access = BitFlags{rhi::ResourceAccessType::transfer_write};
             cmd->resource_barriers({}, {
                 rhi::TextureBarrier{
@@ -164,16 +177,10 @@ auto TextureAsset::update_gpu_data() -> void {
                     .dst_access_type = access,
                 },
             });
-            auto& extent = texture.desc().extent;
-            cmd->copy_buffer_to_texture(
-                temp_buffer.rhi_buffer(),
-                texture.rhi_texture(),
-                rhi::BufferTextureCopyDesc{
-                    .buffer_pixels_per_row = extent.width,
-                    .buffer_rows_per_texture = extent.height,
-                }
-            );
-            if (texture.desc().levels > 1) {
+            copy_stored_levels(full_desc, level_offsets, first_level, [&](rhi::BufferTextureCopyDesc const& region) {
+                cmd->copy_buffer_to_texture(temp_buffer.rhi_buffer(), texture.rhi_texture(), region);
+            });
+            if (level_offsets.size() < full_desc.levels) {
                 g_engine->graphics_manager()->generate_mipmaps_2d(cmd, texture, access);
                 BI_ASSERT(access == rhi::ResourceAccessType::sampled_texture_read);
             } else {
@@ -190,6 +197,9 @@ auto TextureAsset::update_gpu_data() -> void {
 }
 
 auto TextureAsset::update_cpu_data() -> void {
+    // Streamed textures are never written on GPU.
+    if (streamed_texture_.has_value()) { return; }
+
     gfx::Buffer temp_buffer{gfx::BufferBuilder().size(texture_data.size()).mem_readback()};
     g_engine->graphics_manager()->execute_in_this_frame(
         [this, &temp_buffer](Ref<rhi::CommandEncoder> cmd) {
@@ -200,15 +210,9 @@ auto TextureAsset::update_cpu_data() -> void {
                     .dst_access_type = access,
                 },
             });
-            auto& extent = texture.desc().extent;
-            cmd->copy_texture_to_buffer(
-                texture.rhi_texture(),
-                temp_buffer.rhi_buffer(),
-                rhi::BufferTextureCopyDesc{
-                    .buffer_pixels_per_row = extent.width,
-                    .buffer_rows_per_texture = extent.height,
-                }
-            );
+            copy_stored_levels(texture.desc(), level_offsets, 0, [&](rhi::BufferTextureCopyDesc const& region) {
+                cmd->copy_texture_to_buffer(texture.rhi_texture(), temp_buffer.rhi_buffer(), region);
+            });
             cmd->resource_barriers({}, {
                 rhi::TextureBarrier{
                     .texture = texture.rhi_texture(),
@@ -221,4 +225,102 @@ auto TextureAsset::update_cpu_data() -> void {
     temp_buffer.get_data_raw(texture_data.data(), texture_data.size());
 }
 
+auto TextureAsset::generate_mipmaps(MipmapSettings const& settings) -> bool {
+    if (level_offsets.size() >= full_texture_desc().levels) { return true; }
+    auto levels = bi::generate_mipmaps(full_texture_desc(), texture_data, settings);
+    if (!levels) { return false; }
+    texture_data = std::move(levels.value().data);
+    level_offsets = std::move(levels.value().level_offsets);
+    return true;
+}
+
+auto TextureAsset::compress(TextureSemantic semantic) -> bool {
+    auto const& full_desc = full_texture_desc();
+    if (rhi::is_compressed_format(full_desc.format)) { return true; }
+    if (!read_all_levels()) { return false; }
+    if (full_desc.dim != rhi::TextureDimension::d3 && !generate_mipmaps()) { return false; }
+    auto compressed = compress_texture(full_desc, texture_data, level_offsets, semantic);
+    if (!compressed) { return false; }
+
+    auto desc = compressed.value().desc;
+    // Block-compressed textures can't be written by shaders.
+    desc.usages = {rhi::TextureUsage::sampled};
+    texture_data = std::move(compressed.value().data);
+    level_offsets = std::move(compressed.value().level_offsets);
+    // The new texture is fully resident and no longer matches the file.
+    streamed_texture_.reset();
+    resident_level_ = 0;
+    level_reader_ = {};
+    pending_levels_ = {};
+    texture = desc;
+    return true;
+}
+
+auto TextureAsset::full_texture_desc() const -> rhi::TextureDesc const& {
+    return streamed_texture_.has_value() ? loaded_header_.desc : texture.desc();
+}
+
+auto TextureAsset::update_resident_levels(uint32_t first_level) -> bool {
+    if (!read_levels_async(first_level)) { return false; }
+
+    auto desc = loaded_header_.desc;
+    desc.extent = texture_level_extent(desc, first_level);
+    desc.levels -= first_level;
+    // The old texture is destroyed after frames in flight finish.
+    texture = desc;
+    resident_level_ = first_level;
+    upload_levels(loaded_header_.desc, first_level);
+
+    // Dropped levels are read from the file again when they are streamed in.
+    if (level_reader_ && first_level > data_first_level_) {
+        auto dropped_size = level_offsets[first_level] - level_offsets[data_first_level_];
+        texture_data = std::vector<std::byte>(texture_data.begin() + dropped_size, texture_data.end());
+        data_first_level_ = first_level;
+    }
+    return true;
+}
+
+auto TextureAsset::read_levels_async(uint32_t first_level) -> bool {
+    if (
+        pending_levels_.valid()
+        && pending_levels_.wait_for(std::chrono::seconds{0}) == std::future_status::ready
+    ) {
+        auto levels = pending_levels_.get();
+        if (!levels) {
+            log::error("general", "Failed to read levels of a streamed texture, its current levels are kept.");
+            level_reader_ = {};
+        } else if (pending_last_level_ == data_first_level_) {
+            levels.value().insert(levels.value().end(), texture_data.begin(), texture_data.end());
+            texture_data = std::move(levels).value();
+            data_first_level_ = pending_first_level_;
+        }
+    }
+    if (first_level >= data_first_level_) { return true; }
+
+    if (!pending_levels_.valid() && level_reader_) {
+        pending_first_level_ = first_level;
+        pending_last_level_ = data_first_level_;
+        pending_levels_ = g_engine->thread_pool()->async(
+            [reader = level_reader_, header = loaded_header_, first_level, last_level = data_first_level_]() {
+                return read_texture_asset_levels(
+                    reader, header, first_level, last_level, g_engine->thread_pool()->parallel_for_fn()
+                );
+            }
+        );
+    }
+    return false;
+}
+
+auto TextureAsset::read_all_levels() -> bool {
+    if (data_first_level_ == 0) { return true; }
+    auto levels = read_texture_asset_levels(
+        level_reader_, loaded_header_, 0, data_first_level_, g_engine->thread_pool()->parallel_for_fn()
+    );
+    if (!levels) { return false; }
+    levels.value().insert(levels.value().end(), texture_data.begin(), texture_data.end());
+    texture_data = std::move(levels).value();
+    data_first_level_ = 0;
+    return true;
+}
+
 }
@@ -0,0 +1,202 @@
+#include <bisemutum/scene_basic/texture_asset_data.hpp>
+
+#include <algorithm>
+
+#include <bisemutum/prelude/byte_stream.hpp>
+#include <bisemutum/runtime/asset.hpp>
+
+// Implemented here rather than in 'texture.cpp', since headless tools don't link the latter.
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+namespace bi {
+
+namespace {
+
+// 1: raw or PNG data, 2: compressed data, 3: mipmaps, 4: level offsets, 5: levels are compressed separately.
+constexpr uint32_t texture_asset_version = 5;
+
+// Return the version, or 0 if it's not a valid texture asset. `bs` is at data of levels then.
+auto read_header(ReadByteStream& bs, std::string const& filename, TextureAssetHeader& header) -> uint32_t {
+    uint32_t magic_number = 0;
+    std::string asset_type_name;
+    uint32_t version = 0;
+    bs.read(magic_number).read(asset_type_name).read(version);
+    if (!rt::check_if_binary_asset_valid(filename, magic_number, asset_type_name, texture_asset_type_name)) {
+        return 0;
+    }
+
+    bs.read(header.sampler);
+    bs.read(header.desc);
+    auto& level_offsets = header.level_offsets;
+    level_offsets = {0};
+    if (version >= 4) {
+        bs.read(level_offsets);
+    } else if (version == 3) {
+        // Levels were tightly packed.
+        uint32_t stored_levels = 0;
+        bs.read(stored_levels);
+        level_offsets.resize(stored_levels);
+        for (uint32_t level = 1; level < stored_levels; level++) {
+            level_offsets[level] = level_offsets[level - 1] + texture_level_size(header.desc, level - 1);
+        }
+    }
+    if (version >= 5) {
+        bs.read(header.data_size);
+        bs.read(header.level_file_offsets);
+    }
+    return version;
+}
+
+auto is_valid_level_range(TextureAssetHeader const& header, uint32_t first_level, uint32_t last_level) -> bool {
+    auto const& level_offsets = header.level_offsets;
+    auto const& file_offsets = header.level_file_offsets;
+    if (first_level >= last_level || last_level > level_offsets.size()) { return false; }
+    if (file_offsets.size() != level_offsets.size() + 1) { return false; }
+    for (size_t level = 0; level < level_offsets.size(); level++) {
+        auto level_end = level + 1 < level_offsets.size() ? level_offsets[level + 1] : header.data_size;
+        if (level_offsets[level] > level_end || file_offsets[level] > file_offsets[level + 1]) { return false; }
+    }
+    return true;
+}
+
+// `parts` is data of the file from the first level to read.
+auto read_levels(
+    CSpan<std::byte> parts, TextureAssetHeader const& header, uint32_t first_level, uint32_t last_level,
+    ParallelFor const& parallel_for
+) -> Option<std::vector<std::byte>> {
+    auto const& level_offsets = header.level_offsets;
+    auto const& file_offsets = header.level_file_offsets;
+    if (file_offsets[last_level] - file_offsets[first_level] > parts.size()) { return {}; }
+    auto level_end = [&](uint32_t level) {
+        return level + 1 < level_offsets.size() ? level_offsets[level + 1] : header.data_size;
+    };
+
+    std::vector<std::byte> data(level_end(last_level - 1) - level_offsets[first_level]);
+    ReadByteStream bs{parts};
+    for (auto level = first_level; level < last_level; level++) {
+        bs.set_offset(file_offsets[level] - file_offsets[first_level]);
+        ReadByteStream level_bs{};
+        bs.read_compressed_part(level_bs, parallel_for);
+        auto level_size = level_end(level) - level_offsets[level];
+        if (level_bs.size() != level_size) { return {}; }
+        level_bs.read_raw(data.data() + level_offsets[level] - level_offsets[first_level], level_size);
+    }
+    return data;
+}
+
+} // namespace
+
+auto read_texture_asset_data(
+    Dyn<rt::IFile>::Ref file, ParallelFor const& parallel_for
+) -> Option<TextureAssetData> {
+    auto binary_data = file.map_binary_data();
+    ReadByteStream bs{binary_data};
+
+    TextureAssetHeader header{};
+    auto version = read_header(bs, file.filename(), header);
+    if (version == 0) { return {}; }
+
+    TextureAssetData data{};
+    data.sampler = header.sampler;
+    data.levels.desc = header.desc;
+    data.levels.level_offsets = header.level_offsets;
+    auto const& texture_desc = data.levels.desc;
+    auto& texture_data = data.levels.data;
+
+    if (version == 1) {
+        uint32_t storage_type = 0;
+        bs.read(storage_type);
+        if (storage_type == 0) {
+            bs.read(texture_data);
+        } else if (storage_type == 1) {
+            auto bytes_per_layer =
+                texture_desc.extent.width * texture_desc.extent.height * rhi::format_texel_size(texture_desc.format);
+            texture_data.resize(bytes_per_layer * texture_desc.extent.depth_or_layers);
+            for (uint32_t layer = 0; layer < texture_desc.extent.depth_or_layers; layer++) {
+                std::vector<std::byte> png_data;
+                bs.read(png_data);
+                int temp_width, temp_height, temp_comp;
+                auto image_data = stbi_load_from_memory(
+                    reinterpret_cast<stbi_uc*>(png_data.data()), png_data.size(),
+                    &temp_width, &temp_height, &temp_comp, 0
+                );
+                std::copy_n(
+                    reinterpret_cast<std::byte const*>(image_data), bytes_per_layer,
+                    texture_data.data() + layer * bytes_per_layer
+                );
+                stbi_image_free(image_data);
+            }
+        }
+    } else if (version >= 5) {
+        auto num_levels = static_cast<uint32_t>(header.level_offsets.size());
+        if (!is_valid_level_range(header, 0, num_levels) || header.level_file_offsets[0] > binary_data.size()) {
+            return {};
+        }
+        auto levels = read_levels(
+            {binary_data.data() + header.level_file_offsets[0], binary_data.size() - header.level_file_offsets[0]},
+            header, 0, num_levels, parallel_for
+        );
+        if (!levels) { return {}; }
+        texture_data = std::move(levels).value();
+    } else {
+        ReadByteStream data_bs{};
+        bs.read_compressed_part_streaming(data_bs, parallel_for);
+        data_bs.read(texture_data);
+    }
+
+    return data;
+}
+
+auto read_texture_asset_header(Dyn<rt::IFile>::Ref file) -> Option<TextureAssetHeader> {
+    ReadByteStream bs{file.map_binary_data()};
+    TextureAssetHeader header{};
+    if (read_header(bs, file.filename(), header) == 0) { return {}; }
+    return header;
+}
+
+auto read_texture_asset_levels(
+    rt::FileRangeReader const& reader, TextureAssetHeader const& header, uint32_t first_level, uint32_t last_level,
+    ParallelFor const& parallel_for
+) -> Option<std::vector<std::byte>> {
+    if (!reader || !is_valid_level_range(header, first_level, last_level)) { return {}; }
+    auto const& file_offsets = header.level_file_offsets;
+    std::vector<std::byte> parts(file_offsets[last_level] - file_offsets[first_level]);
+    if (!reader(file_offsets[first_level], parts)) { return {}; }
+    return read_levels(parts, header, first_level, last_level, parallel_for);
+}
+
+auto write_texture_asset_data(
+    Dyn<rt::IFile>::Ref file, rhi::SamplerDesc const& sampler, rhi::TextureDesc const& desc,
+    CSpan<uint64_t> level_offsets, CSpan<std::byte> data, ParallelFor const& parallel_for
+) -> bool {
+    WriteByteStream bs{};
+    bs.write(rt::asset_magic_number).write(texture_asset_type_name).write(texture_asset_version);
+
+    bs.write(sampler);
+    bs.write(desc);
+    bs.write(static_cast<uint64_t>(level_offsets.size()));
+    bs.write_raw(reinterpret_cast<std::byte const*>(level_offsets.data()), level_offsets.size() * sizeof(uint64_t));
+    bs.write(static_cast<uint64_t>(data.size()));
+
+    // Each level is compressed separately, so that streamed textures can read levels when they are needed.
+    std::vector<WriteByteStream> parts(level_offsets.size());
+    for (size_t level = 0; level < level_offsets.size(); level++) {
+        auto level_end = level + 1 < level_offsets.size() ? level_offsets[level + 1] : data.size();
+        parts[level].write_raw(data.data() + level_offsets[level], level_end - level_offsets[level]);
+        parts[level].compress_data(0, CompressionCodec::zstd, parallel_for);
+    }
+    std::vector<uint64_t> level_file_offsets(parts.size() + 1);
+    level_file_offsets[0] = bs.curr_offset() + sizeof(uint64_t) * (level_file_offsets.size() + 1);
+    for (size_t level = 0; level < parts.size(); level++) {
+        level_file_offsets[level + 1] = level_file_offsets[level] + parts[level].data().size();
+    }
+    bs.write(level_file_offsets);
+    for (auto const& part : parts) {
+        bs.write_raw(part.data().data(), part.data().size());
+    }
+
+    return file.write_binary_data(bs.data());
+}
+
+}
@@ -0,0 +1,473 @@
+#include <bisemutum/scene_basic/texture_compression.hpp>
+
+#include <cmath>
+#include <array>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+
+#include <bisemutum/prelude/misc.hpp>
+#include <bisemutum/prelude/math.hpp>
+#include <bisemutum/runtime/logger.hpp>
+
+#include "texture_image.hpp"
+
+namespace bi {
+
+namespace {
+
+constexpr uint32_t block_dim = 4;
+constexpr uint32_t block_texels = block_dim * block_dim;
+
+using Block = std::array<TextureTexel, block_texels>;
+
+auto fetch_block(TextureImage const& image, uint32_t block_x, uint32_t block_y) -> Block {
+    Block block;
+    for (uint32_t y = 0; y < block_dim; y++) {
+        for (uint32_t x = 0; x < block_dim; x++) {
+            // Texels out of the image replicate the edge.
+            block[y * block_dim + x] = image.at(
+                std::min(block_x * block_dim + x, image.width - 1), std::min(block_y * block_dim + y, image.height - 1)
+            );
+        }
+    }
+    return block;
+}
+
+
+// Blocks are filled from the least significant bit of the first byte.
+struct BlockWriter final {
+    auto write(uint32_t value, uint32_t num_bits) -> void {
+        for (uint32_t i = 0; i < num_bits; i++, pos++) {
+            if (value >> i & 1) {
+                data[pos / 8] |= static_cast<std::byte>(1u << (pos % 8));
+            }
+        }
+    }
+
+    std::array<std::byte, 16> data{};
+    uint32_t pos = 0;
+};
+
+// Interpolation weights of 4-bit indices used by BC6H and BC7, in 1/64.
+constexpr std::array<uint32_t, 16> weights4{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+template <size_t N>
+using Point = std::array<float, N>;
+
+template <size_t N>
+auto distance_sqr(Point<N> const& a, Point<N> const& b) -> float {
+    float result = 0.0f;
+    for (size_t c = 0; c < N; c++) { result += (a[c] - b[c]) * (a[c] - b[c]); }
+    return result;
+}
+
+// Endpoints covering the points along their principal axis.
+template <size_t N>
+auto principal_endpoints(std::array<Point<N>, block_texels> const& points) -> std::pair<Point<N>, Point<N>> {
+    Point<N> mean{};
+    for (auto const& p : points) {
+        for (size_t c = 0; c < N; c++) { mean[c] += p[c] / block_texels; }
+    }
+    std::array<Point<N>, N> covariance{};
+    for (auto const& p : points) {
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) { covariance[i][j] += (p[i] - mean[i]) * (p[j] - mean[j]); }
+        }
+    }
+
+    // Start from the channel with the largest variance, so that anti-correlated channels are handled.
+    size_t max_channel = 0;
+    for (size_t c = 1; c < N; c++) {
+        if (covariance[c][c] > covariance[max_channel][max_channel]) { max_channel = c; }
+    }
+    Point<N> axis{};
+    axis[max_channel] = 1.0f;
+    for (int iter = 0; iter < 8; iter++) {
+        Point<N> next{};
+        float length_sqr = 0.0f;
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) { next[i] += covariance[i][j] * axis[j]; }
+            length_sqr += next[i] * next[i];
+        }
+        if (length_sqr < 1e-12f) { return {mean, mean}; }
+        auto inv_length = 1.0f / std::sqrt(length_sqr);
+        for (size_t i = 0; i < N; i++) { axis[i] = next[i] * inv_length; }
+    }
+
+    auto min_t = std::numeric_limits<float>::max();
+    auto max_t = std::numeric_limits<float>::lowest();
+    for (auto const& p : points) {
+        float t = 0.0f;
+        for (size_t c = 0; c < N; c++) { t += (p[c] - mean[c]) * axis[c]; }
+        min_t = std::min(min_t, t);
+        max_t = std::max(max_t, t);
+    }
+    std::pair<Point<N>, Point<N>> endpoints;
+    for (size_t c = 0; c < N; c++) {
+        endpoints.first[c] = mean[c] + axis[c] * min_t;
+        endpoints.second[c] = mean[c] + axis[c] * max_t;
+    }
+    return endpoints;
+}
+
+// Least squares endpoints for fixed interpolation factors. Return false if they are degenerate.
+template <size_t N>
+auto refine_endpoints(
+    std::array<Point<N>, block_texels> const& points, std::array<float, block_texels> const& factors,
+    Point<N>& e0, Point<N>& e1
+) -> bool {
+    float a = 0.0f;
+    float b = 0.0f;
+    float c = 0.0f;
+    Point<N> x0{};
+    Point<N> x1{};
+    for (uint32_t i = 0; i < block_texels; i++) {
+        auto t = factors[i];
+        a += (1.0f - t) * (1.0f - t);
+        b += (1.0f - t) * t;
+        c += t * t;
+        for (size_t ch = 0; ch < N; ch++) {
+            x0[ch] += (1.0f - t) * points[i][ch];
+            x1[ch] += t * points[i][ch];
+        }
+    }
+    auto det = a * c - b * b;
+    if (std::abs(det) < 1e-6f) { return false; }
+    for (size_t ch = 0; ch < N; ch++) {
+        e0[ch] = (c * x0[ch] - b * x1[ch]) / det;
+        e1[ch] = (a * x1[ch] - b * x0[ch]) / det;
+    }
+    return true;
+}
+
+// Index of the nearest palette entry for each point, return the total squared error.
+template <size_t N, size_t M>
+auto assign_indices(
+    std::array<Point<N>, block_texels> const& points, std::array<Point<N>, M> const& palette,
+    std::array<uint32_t, block_texels>& indices
+) -> float {
+    float total_error = 0.0f;
+    for (uint32_t i = 0; i < block_texels; i++) {
+        auto best_error = std::numeric_limits<float>::max();
+        for (uint32_t j = 0; j < M; j++) {
+            auto error = distance_sqr(points[i], palette[j]);
+            if (error < best_error) {
+                best_error = error;
+                indices[i] = j;
+            }
+        }
+        total_error += best_error;
+    }
+    return total_error;
+}
+
+
+// BC4 with 8 interpolated values. `values` are in [0, 255].
+auto encode_bc4_channel(std::array<Point<1>, block_texels> const& values, BlockWriter& writer) -> void {
+    struct Candidate final {
+        uint32_t r0 = 0;
+        uint32_t r1 = 0;
+        std::array<uint32_t, block_texels> indices{};
+        float error = std::numeric_limits<float>::max();
+    };
+    auto evaluate = [&values](float e0, float e1) {
+        Candidate candidate{};
+        candidate.r0 = static_cast<uint32_t>(std::clamp(std::round(std::max(e0, e1)), 0.0f, 255.0f));
+        candidate.r1 = static_cast<uint32_t>(std::clamp(std::round(std::min(e0, e1)), 0.0f, 255.0f));
+        // `r0 > r1` selects the 8 values mode, equal endpoints only use index 0.
+        if (candidate.r0 == candidate.r1) {
+            candidate.error = 0.0f;
+            for (auto const& v : values) { candidate.error += (v[0] - candidate.r0) * (v[0] - candidate.r0); }
+            return candidate;
+        }
+        std::array<Point<1>, 8> palette;
+        palette[0][0] = candidate.r0;
+        palette[1][0] = candidate.r1;
+        for (uint32_t i = 2; i < 8; i++) {
+            palette[i][0] = static_cast<float>(((8 - i) * candidate.r0 + (i - 1) * candidate.r1) / 7);
+        }
+        candidate.error = assign_indices(values, palette, candidate.indices);
+        return candidate;
+    };
+
+    auto [min_it, max_it] = std::minmax_element(
+        values.begin(), values.end(), [](Point<1> const& a, Point<1> const& b) { return a[0] < b[0]; }
+    );
+    auto best = evaluate((*max_it)[0], (*min_it)[0]);
+    if (best.r0 != best.r1) {
+        std::array<float, block_texels> factors;
+        for (uint32_t i = 0; i < block_texels; i++) {
+            auto index = best.indices[i];
+            factors[i] = index == 0 ? 0.0f : index == 1 ? 1.0f : (index - 1) / 7.0f;
+        }
+        Point<1> e0, e1;
+        if (refine_endpoints(values, factors, e0, e1)) {
+            if (auto refined = evaluate(e0[0], e1[0]); refined.error < best.error) { best = refined; }
+        }
+    }
+
+    writer.write(best.r0, 8);
+    writer.write(best.r1, 8);
+    for (auto index : best.indices) { writer.write(index, 3); }
+}
+
+auto encode_bc4_block(Block const& block, BlockWriter& writer, uint32_t channel) -> void {
+    std::array<Point<1>, block_texels> values;
+    for (uint32_t i = 0; i < block_texels; i++) {
+        values[i][0] = std::clamp(block[i][channel], 0.0f, 1.0f) * 255.0f;
+    }
+    encode_bc4_channel(values, writer);
+}
+
+
+// BC7 mode 6: 1 subset, RGBA endpoints of 7 bits with a unique p-bit and 4-bit indices.
+auto encode_bc7_block(Block const& block, BlockWriter& writer) -> void {
+    std::array<Point<4>, block_texels> points;
+    for (uint32_t i = 0; i < block_texels; i++) {
+        for (uint32_t c = 0; c < 4; c++) { points[i][c] = std::clamp(block[i][c], 0.0f, 1.0f) * 255.0f; }
+    }
+
+    struct Candidate final {
+        std::array<std::array<uint32_t, 4>, 2> endpoints{};
+        std::array<uint32_t, 2> p_bits{};
+        std::array<uint32_t, block_texels> indices{};
+        float error = std::numeric_limits<float>::max();
+    };
+    auto evaluate = [&points](Point<4> const& e0, Point<4> const& e1) {
+        Candidate candidate{};
+        std::array<Point<4>, 2> endpoints_unorm;
+        for (uint32_t e = 0; e < 2; e++) {
+            auto const& endpoint = e == 0 ? e0 : e1;
+            auto best_error = std::numeric_limits<float>::max();
+            for (uint32_t p = 0; p < 2; p++) {
+                std::array<uint32_t, 4> quantized;
+                Point<4> unorm;
+                for (uint32_t c = 0; c < 4; c++) {
+                    quantized[c] = static_cast<uint32_t>(std::clamp(std::round((endpoint[c] - p) * 0.5f), 0.0f, 127.0f));
+                    unorm[c] = static_cast<float>(quantized[c] << 1 | p);
+                }
+                if (auto error = distance_sqr(unorm, endpoint); error < best_error) {
+                    best_error = error;
+                    candidate.endpoints[e] = quantized;
+                    candidate.p_bits[e] = p;
+                    endpoints_unorm[e] = unorm;
+                }
+            }
+        }
+        std::array<Point<4>, 16> palette;
+        for (uint32_t i = 0; i < 16; i++) {
+            for (uint32_t c = 0; c < 4; c++) {
+                auto a = static_cast<uint32_t>(endpoints_unorm[0][c]);
+                auto b = static_cast<uint32_t>(endpoints_unorm[1][c]);
+                palette[i][c] = static_cast<float>(((64 - weights4[i]) * a + weights4[i] * b + 32) >> 6);
+            }
+        }
+        candidate.error = assign_indices(points, palette, candidate.indices);
+        return candidate;
+    };
+
+    auto [e0, e1] = principal_endpoints(points);
+    auto best = evaluate(e0, e1);
+    for (int iter = 0; iter < 2; iter++) {
+        std::array<float, block_texels> factors;
+        for (uint32_t i = 0; i < block_texels; i++) { factors[i] = weights4[best.indices[i]] / 64.0f; }
+        if (!refine_endpoints(points, factors, e0, e1)) { break; }
+        auto refined = evaluate(e0, e1);
+        if (refined.error >= best.error) { break; }
+        best = refined;
+    }
+
+    // The most significant bit of the first index is implicitly 0.
+    if (best.indices[0] >= 8) {
+        std::swap(best.endpoints[0], best.endpoints[1]);
+        std::swap(best.p_bits[0], best.p_bits[1]);
+        for (auto& index : best.indices) { index = 15 - index; }
+    }
+
+    writer.write(1u << 6, 7);
+    for (uint32_t c = 0; c < 4; c++) {
+        writer.write(best.endpoints[0][c], 7);
+        writer.write(best.endpoints[1][c], 7);
+    }
+    writer.write(best.p_bits[0], 1);
+    writer.write(best.p_bits[1], 1);
+    for (uint32_t i = 0; i < block_texels; i++) { writer.write(best.indices[i], i == 0 ? 3 : 4); }
+}
+
+
+// Map a non-negative float to the bit pattern of the nearest half, continuously.
+// BC6H interpolates in this space.
+auto to_half_space(float value) -> float {
+    value = std::clamp(value, 0.0f, 65504.0f);
+    if (value < 0x1p-14f) { return value * 0x1p24f; }
+    int exponent;
+    auto mantissa = std::frexp(value, &exponent);
+    return (exponent + 14) * 1024.0f + (mantissa * 2.0f - 1.0f) * 1024.0f;
+}
+
+// BC6H mode 11: 1 region, unsigned RGB endpoints of 10 bits without transform and 4-bit indices.
+auto encode_bc6h_block(Block const& block, BlockWriter& writer) -> void {
+    std::array<Point<3>, block_texels> points;
+    for (uint32_t i = 0; i < block_texels; i++) {
+        for (uint32_t c = 0; c < 3; c++) { points[i][c] = to_half_space(block[i][c]); }
+    }
+
+    // Decoders scale interpolated 16-bit values by 31/64 to get the half.
+    auto quantize = [](float half) {
+        auto value = half * 64.0f / 31.0f;
+        return static_cast<uint32_t>(std::clamp(std::round((value - 32.0f) / 64.0f), 0.0f, 1023.0f));
+    };
+    auto unquantize = [](uint32_t value) -> uint32_t {
+        if (value == 0) { return 0; }
+        if (value == 1023) { return 0xffff; }
+        return ((value << 16) + 0x8000) >> 10;
+    };
+
+    struct Candidate final {
+        std::array<std::array<uint32_t, 3>, 2> endpoints{};
+        std::array<uint32_t, block_texels> indices{};
+        float error = std::numeric_limits<float>::max();
+    };
+    auto evaluate = [&](Point<3> const& e0, Point<3> const& e1) {
+        Candidate candidate{};
+        for (uint32_t c = 0; c < 3; c++) {
+            candidate.endpoints[0][c] = quantize(e0[c]);
+            candidate.endpoints[1][c] = quantize(e1[c]);
+        }
+        std::array<Point<3>, 16> palette;
+        for (uint32_t i = 0; i < 16; i++) {
+            for (uint32_t c = 0; c < 3; c++) {
+                auto a = unquantize(candidate.endpoints[0][c]);
+                auto b = unquantize(candidate.endpoints[1][c]);
+                auto value = ((64 - weights4[i]) * a + weights4[i] * b + 32) >> 6;
+                palette[i][c] = static_cast<float>((value * 31) >> 6);
+            }
+        }
+        candidate.error = assign_indices(points, palette, candidate.indices);
+        return candidate;
+    };
+
+    auto [e0, e1] = principal_endpoints(points);
+    auto best = evaluate(e0, e1);
+    for (int iter = 0; iter < 2; iter++) {
+        std::array<float, block_texels> factors;
+        for (uint32_t i = 0; i < block_texels; i++) { factors[i] = weights4[best.indices[i]] / 64.0f; }
+        if (!refine_endpoints(points, factors, e0, e1)) { break; }
+        auto refined = evaluate(e0, e1);
+        if (refined.error >= best.error) { break; }
+        best = refined;
+    }
+
+    if (best.indices[0] >= 8) {
+        std::swap(best.endpoints[0], best.endpoints[1]);
+        for (auto& index : best.indices) { index = 15 - index; }
+    }
+
+    writer.write(0x03, 5);
+    for (uint32_t e = 0; e < 2; e++) {
+        for (uint32_t c = 0; c < 3; c++) { writer.write(best.endpoints[e][c], 10); }
+    }
+    for (uint32_t i = 0; i < block_texels; i++) { writer.write(best.indices[i], i == 0 ? 3 : 4); }
+}
+
+
+auto encode_block(rhi::ResourceFormat format, Block const& block, std::byte* dst) -> void {
+    BlockWriter writer{};
+    switch (format) {
+        case rhi::ResourceFormat::bc4_unorm:
+            encode_bc4_block(block, writer, 0);
+            break;
+        case rhi::ResourceFormat::bc5_unorm:
+            encode_bc4_block(block, writer, 0);
+            encode_bc4_block(block, writer, 1);
+            break;
+        case rhi::ResourceFormat::bc6h_ufloat:
+            encode_bc6h_block(block, writer);
+            break;
+        default:
+            encode_bc7_block(block, writer);
+            break;
+    }
+    std::memcpy(dst, writer.data.data(), rhi::format_block_size(format));
+}
+
+} // namespace
+
+auto block_compressed_format(TextureSemantic semantic, bool srgb) -> rhi::ResourceFormat {
+    switch (semantic) {
+        case TextureSemantic::albedo:
+            return srgb ? rhi::ResourceFormat::bc7_sgrb : rhi::ResourceFormat::bc7_unorm;
+        case TextureSemantic::normal:
+            return rhi::ResourceFormat::bc5_unorm;
+        case TextureSemantic::mask:
+            return rhi::ResourceFormat::bc4_unorm;
+        case TextureSemantic::hdr:
+            return rhi::ResourceFormat::bc6h_ufloat;
+    }
+    unreachable();
+}
+
+auto compress_texture(
+    rhi::TextureDesc const& desc, CSpan<std::byte> data, CSpan<uint64_t> level_offsets, TextureSemantic semantic
+) -> Option<TextureLevels> {
+    if (!is_texture_image_format(desc.format)) {
+        log::error("general", "Texture of format {} can't be block-compressed.", static_cast<uint32_t>(desc.format));
+        return {};
+    }
+    auto num_levels = static_cast<uint32_t>(std::min<size_t>(level_offsets.size(), desc.levels));
+    for (uint32_t level = 0; level < num_levels; level++) {
+        if (data.size() < level_offsets[level] + texture_level_size(desc, level)) {
+            log::error("general", "Texture data is smaller than its level {}.", level);
+            return {};
+        }
+    }
+
+    auto compressed_desc = desc;
+    compressed_desc.format = block_compressed_format(semantic, rhi::is_srgb_format(desc.format));
+    compressed_desc.levels = num_levels;
+    auto compressed = allocate_texture_levels(compressed_desc, num_levels);
+
+    auto num_layers = desc.extent.depth_or_layers;
+    std::vector<TextureImage> images(num_levels * num_layers);
+    for_each_texture_task(images.size(), [&](size_t index) {
+        auto level = static_cast<uint32_t>(index / num_layers);
+        auto layer = index % num_layers;
+        auto extent = texture_level_extent(desc, level);
+        auto layer_size = texture_level_size(desc, level) / num_layers;
+        images[index] = read_texture_image(
+            desc.format, data.data() + level_offsets[level] + layer * layer_size, extent.width, extent.height
+        );
+    });
+
+    struct BlockRow final {
+        uint32_t level;
+        uint32_t layer;
+        uint32_t block_y;
+    };
+    std::vector<BlockRow> block_rows{};
+    for (uint32_t level = 0; level < num_levels; level++) {
+        auto num_blocks_y = ceil_div(texture_level_extent(desc, level).height, block_dim);
+        for (uint32_t layer = 0; layer < num_layers; layer++) {
+            for (uint32_t block_y = 0; block_y < num_blocks_y; block_y++) {
+                block_rows.push_back({level, layer, block_y});
+            }
+        }
+    }
+    auto block_size = rhi::format_block_size(compressed_desc.format);
+    for_each_texture_task(block_rows.size(), [&](size_t index) {
+        auto [level, layer, block_y] = block_rows[index];
+        auto const& image = images[level * num_layers + layer];
+        auto num_blocks_x = ceil_div(image.width, block_dim);
+        auto num_blocks_y = ceil_div(image.height, block_dim);
+        auto row_data = compressed.data.data() + compressed.level_offsets[level]
+            + (layer * num_blocks_y + block_y) * num_blocks_x * block_size;
+        for (uint32_t block_x = 0; block_x < num_blocks_x; block_x++) {
+            encode_block(compressed_desc.format, fetch_block(image, block_x, block_y), row_data + block_x * block_size);
+        }
+    });
+
+    return compressed;
+}
+
+}
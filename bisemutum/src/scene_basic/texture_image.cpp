@@ -0,0 +1,156 @@
+#include "texture_image.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include <bisemutum/runtime/thread_pool.hpp>
+
+namespace bi {
+
+namespace {
+
+enum class ChannelType : uint8_t {
+    unorm8,
+    sfloat16,
+    sfloat32,
+};
+
+struct ImageFormatInfo final {
+    ChannelType channel_type = ChannelType::unorm8;
+    uint32_t num_channels = 0;
+};
+
+auto image_format_info(rhi::ResourceFormat format) -> ImageFormatInfo {
+    switch (format) {
+        case rhi::ResourceFormat::r8_unorm:
+        case rhi::ResourceFormat::r8_srgb:
+            return {ChannelType::unorm8, 1};
+        case rhi::ResourceFormat::rg8_unorm:
+        case rhi::ResourceFormat::rg8_srgb:
+            return {ChannelType::unorm8, 2};
+        case rhi::ResourceFormat::rgba8_unorm:
+        case rhi::ResourceFormat::rgba8_srgb:
+            return {ChannelType::unorm8, 4};
+        case rhi::ResourceFormat::r16_sfloat:
+            return {ChannelType::sfloat16, 1};
+        case rhi::ResourceFormat::rg16_sfloat:
+            return {ChannelType::sfloat16, 2};
+        case rhi::ResourceFormat::rgba16_sfloat:
+            return {ChannelType::sfloat16, 4};
+        case rhi::ResourceFormat::r32_sfloat:
+            return {ChannelType::sfloat32, 1};
+        case rhi::ResourceFormat::rg32_sfloat:
+            return {ChannelType::sfloat32, 2};
+        case rhi::ResourceFormat::rgba32_sfloat:
+            return {ChannelType::sfloat32, 4};
+        default:
+            return {};
+    }
+}
+
+auto half_to_float(uint16_t value) -> float {
+    auto exponent = static_cast<int>(value >> 10 & 0x1f);
+    auto mantissa = static_cast<float>(value & 0x3ff);
+    float result = 0.0f;
+    if (exponent == 0) {
+        result = std::ldexp(mantissa, -24);
+    } else if (exponent == 31) {
+        result = mantissa == 0.0f ? INFINITY : NAN;
+    } else {
+        result = std::ldexp(mantissa + 1024.0f, exponent - 25);
+    }
+    return value & 0x8000 ? -result : result;
+}
+
+auto float_to_half(float value) -> uint16_t {
+    uint16_t sign = std::signbit(value) ? 0x8000 : 0;
+    auto abs_value = std::abs(value);
+    if (std::isnan(value)) { return sign | 0x7e00; }
+    if (abs_value >= 65520.0f) { return sign | 0x7c00; }
+    if (abs_value < 0x1p-14f) {
+        return sign | static_cast<uint16_t>(std::lround(abs_value * 0x1p24f));
+    }
+    int exponent;
+    auto mantissa = std::frexp(abs_value, &exponent);
+    // A rounded up mantissa carries into the exponent.
+    auto bits = ((exponent + 14) << 10) + std::lround((mantissa * 2.0f - 1.0f) * 1024.0f);
+    return sign | static_cast<uint16_t>(bits);
+}
+
+} // namespace
+
+auto is_texture_image_format(rhi::ResourceFormat format) -> bool {
+    return image_format_info(format).num_channels > 0;
+}
+
+auto read_texture_image(
+    rhi::ResourceFormat format, std::byte const* data, uint32_t width, uint32_t height
+) -> TextureImage {
+    auto info = image_format_info(format);
+    auto texel_size = rhi::format_texel_size(format);
+    TextureImage image{width, height, std::vector<TextureTexel>(width * height, TextureTexel{0.0f, 0.0f, 0.0f, 1.0f})};
+    for (size_t i = 0; i < image.texels.size(); i++) {
+        auto texel_data = data + i * texel_size;
+        auto& texel = image.texels[i];
+        for (uint32_t c = 0; c < info.num_channels; c++) {
+            switch (info.channel_type) {
+                case ChannelType::unorm8:
+                    texel[c] = static_cast<uint8_t>(texel_data[c]) / 255.0f;
+                    break;
+                case ChannelType::sfloat16: {
+                    uint16_t value;
+                    std::memcpy(&value, texel_data + 2 * c, sizeof(value));
+                    texel[c] = half_to_float(value);
+                    break;
+                }
+                case ChannelType::sfloat32:
+                    std::memcpy(&texel[c], texel_data + 4 * c, sizeof(float));
+                    break;
+            }
+        }
+    }
+    return image;
+}
+
+auto write_texture_image(rhi::ResourceFormat format, TextureImage const& image, std::byte* data) -> void {
+    auto info = image_format_info(format);
+    auto texel_size = rhi::format_texel_size(format);
+    for (size_t i = 0; i < image.texels.size(); i++) {
+        auto texel_data = data + i * texel_size;
+        auto const& texel = image.texels[i];
+        for (uint32_t c = 0; c < info.num_channels; c++) {
+            switch (info.channel_type) {
+                case ChannelType::unorm8:
+                    texel_data[c] = static_cast<std::byte>(std::lround(std::clamp(texel[c], 0.0f, 1.0f) * 255.0f));
+                    break;
+                case ChannelType::sfloat16: {
+                    auto value = float_to_half(texel[c]);
+                    std::memcpy(texel_data + 2 * c, &value, sizeof(value));
+                    break;
+                }
+                case ChannelType::sfloat32:
+                    std::memcpy(texel_data + 4 * c, &texel[c], sizeof(float));
+                    break;
+            }
+        }
+    }
+}
+
+auto srgb_to_linear(float value) -> float {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+auto linear_to_srgb(float value) -> float {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+auto for_each_texture_task(size_t num_tasks, std::function<auto(size_t) -> void> func) -> void {
+    if (num_tasks > 1 && rt::g_thread_pool) {
+        rt::g_thread_pool->parallel_for(num_tasks, std::move(func));
+    } else {
+        for (size_t i = 0; i < num_tasks; i++) { func(i); }
+    }
+}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <functional>
+
+#include <bisemutum/rhi/resource.hpp>
+
+namespace bi {
+
+using TextureTexel = std::array<float, 4>;
+
+// One layer of a texture level with 4 float channels, used by texture processing on CPU.
+struct TextureImage final {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<TextureTexel> texels;
+
+    auto at(uint32_t x, uint32_t y) const -> TextureTexel const& { return texels[y * width + x]; }
+};
+
+// 8-bit unorm/srgb, 16-bit and 32-bit float formats with 1, 2 or 4 channels.
+auto is_texture_image_format(rhi::ResourceFormat format) -> bool;
+
+// Missing channels are 0 except alpha which is 1.
+auto read_texture_image(
+    rhi::ResourceFormat format, std::byte const* data, uint32_t width, uint32_t height
+) -> TextureImage;
+auto write_texture_image(rhi::ResourceFormat format, TextureImage const& image, std::byte* data) -> void;
+
+auto srgb_to_linear(float value) -> float;
+auto linear_to_srgb(float value) -> float;
+
+// Run tasks on the engine thread pool if there is one.
+auto for_each_texture_task(size_t num_tasks, std::function<auto(size_t) -> void> func) -> void;
+
+}
@@ -0,0 +1,156 @@
+#include <bisemutum/scene_basic/texture_mipmap.hpp>
+
+#include <cstring>
+#include <algorithm>
+
+#include <bisemutum/prelude/math.hpp>
+#include <bisemutum/runtime/logger.hpp>
+
+#include "texture_image.hpp"
+
+namespace bi {
+
+namespace {
+
+auto box_filter(TextureImage const& src, uint32_t width, uint32_t height) -> TextureImage {
+    TextureImage dst{width, height, std::vector<TextureTexel>(width * height)};
+    for (uint32_t y = 0; y < height; y++) {
+        auto src_y0 = static_cast<uint32_t>(uint64_t{y} * src.height / height);
+        auto src_y1 = std::max(src_y0 + 1, static_cast<uint32_t>(ceil_div<uint64_t>((y + 1ull) * src.height, height)));
+        for (uint32_t x = 0; x < width; x++) {
+            auto src_x0 = static_cast<uint32_t>(uint64_t{x} * src.width / width);
+            auto src_x1 = std::max(src_x0 + 1, static_cast<uint32_t>(ceil_div<uint64_t>((x + 1ull) * src.width, width)));
+            TextureTexel sum{};
+            for (auto sy = src_y0; sy < src_y1; sy++) {
+                for (auto sx = src_x0; sx < src_x1; sx++) {
+                    for (uint32_t c = 0; c < 4; c++) { sum[c] += src.at(sx, sy)[c]; }
+                }
+            }
+            auto weight = 1.0f / ((src_x1 - src_x0) * (src_y1 - src_y0));
+            for (uint32_t c = 0; c < 4; c++) { dst.texels[y * width + x][c] = sum[c] * weight; }
+        }
+    }
+    return dst;
+}
+
+auto alpha_coverage(TextureImage const& image, float alpha_cutoff, float alpha_scale) -> float {
+    size_t num_covered = 0;
+    for (auto const& texel : image.texels) {
+        if (texel[3] * alpha_scale >= alpha_cutoff) { ++num_covered; }
+    }
+    return static_cast<float>(num_covered) / image.texels.size();
+}
+
+// Castano, "Computing Alpha Mipmaps".
+auto preserve_alpha_coverage(TextureImage& image, float alpha_cutoff, float target_coverage) -> void {
+    float min_scale = 0.0f;
+    float max_scale = 4.0f;
+    for (int iter = 0; iter < 16; iter++) {
+        auto scale = 0.5f * (min_scale + max_scale);
+        if (alpha_coverage(image, alpha_cutoff, scale) < target_coverage) {
+            min_scale = scale;
+        } else {
+            max_scale = scale;
+        }
+    }
+    for (auto& texel : image.texels) {
+        texel[3] = std::min(texel[3] * max_scale, 1.0f);
+    }
+}
+
+} // namespace
+
+auto texture_level_extent(rhi::TextureDesc const& desc, uint32_t level) -> rhi::Extent3D {
+    return rhi::Extent3D{
+        .width = std::max(desc.extent.width >> level, 1u),
+        .height = std::max(desc.extent.height >> level, 1u),
+        .depth_or_layers = desc.dim == rhi::TextureDimension::d3
+            ? std::max(desc.extent.depth_or_layers >> level, 1u) : desc.extent.depth_or_layers,
+    };
+}
+
+auto texture_level_size(rhi::TextureDesc const& desc, uint32_t level) -> uint64_t {
+    auto extent = texture_level_extent(desc, level);
+    if (rhi::is_compressed_format(desc.format)) {
+        return uint64_t{1} * ceil_div(extent.width, 4u) * ceil_div(extent.height, 4u)
+            * extent.depth_or_layers * rhi::format_block_size(desc.format);
+    }
+    return uint64_t{1} * extent.width * extent.height * extent.depth_or_layers * rhi::format_texel_size(desc.format);
+}
+
+auto allocate_texture_levels(rhi::TextureDesc const& desc, uint32_t num_levels) -> TextureLevels {
+    TextureLevels levels{};
+    levels.desc = desc;
+    uint64_t size = 0;
+    for (uint32_t level = 0; level < num_levels; level++) {
+        size = aligned_size(size, texture_level_alignment);
+        levels.level_offsets.push_back(size);
+        size += texture_level_size(desc, level);
+    }
+    levels.data.resize(size);
+    return levels;
+}
+
+auto generate_mipmaps(
+    rhi::TextureDesc const& desc, CSpan<std::byte> data, MipmapSettings const& settings
+) -> Option<TextureLevels> {
+    if (!is_texture_image_format(desc.format)) {
+        log::error("general", "Mipmaps of format {} can't be generated on CPU.", static_cast<uint32_t>(desc.format));
+        return {};
+    }
+    if (desc.dim == rhi::TextureDimension::d3 && desc.levels > 1) {
+        log::error("general", "Mipmaps of 3D textures can't be generated on CPU.");
+        return {};
+    }
+    auto base_size = texture_level_size(desc, 0);
+    if (data.size() < base_size) {
+        log::error("general", "Texture data is smaller than its level 0.");
+        return {};
+    }
+
+    auto levels = allocate_texture_levels(desc, desc.levels);
+    std::memcpy(levels.data.data(), data.data(), base_size);
+    if (desc.levels == 1) { return levels; }
+
+    auto linear = settings.srgb_encoded || rhi::is_srgb_format(desc.format);
+    auto num_layers = desc.extent.depth_or_layers;
+    std::vector<TextureImage> base_images(num_layers);
+    std::vector<float> base_coverages(num_layers);
+    for_each_texture_task(num_layers, [&](size_t layer) {
+        auto& image = base_images[layer];
+        image = read_texture_image(
+            desc.format, data.data() + layer * (base_size / num_layers), desc.extent.width, desc.extent.height
+        );
+        if (linear) {
+            for (auto& texel : image.texels) {
+                for (uint32_t c = 0; c < 3; c++) { texel[c] = srgb_to_linear(texel[c]); }
+            }
+        }
+        if (settings.alpha_cutoff) {
+            base_coverages[layer] = alpha_coverage(image, settings.alpha_cutoff.value(), 1.0f);
+        }
+    });
+
+    for_each_texture_task((desc.levels - 1) * num_layers, [&](size_t task) {
+        auto level = static_cast<uint32_t>(task / num_layers) + 1;
+        auto layer = task % num_layers;
+        auto extent = texture_level_extent(desc, level);
+        auto image = box_filter(base_images[layer], extent.width, extent.height);
+        if (settings.alpha_cutoff) {
+            preserve_alpha_coverage(image, settings.alpha_cutoff.value(), base_coverages[layer]);
+        }
+        if (linear) {
+            for (auto& texel : image.texels) {
+                for (uint32_t c = 0; c < 3; c++) { texel[c] = linear_to_srgb(texel[c]); }
+            }
+        }
+        auto layer_size = texture_level_size(desc, level) / num_layers;
+        write_texture_image(
+            desc.format, image, levels.data.data() + levels.level_offsets[level] + layer * layer_size
+        );
+    });
+
+    return levels;
+}
+
+}
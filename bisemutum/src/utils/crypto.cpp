@@ -9,6 +9,8 @@ namespace bi::crypto {
 
 namespace {
 
+constexpr uint64_t fnv1a_64_prime = 0x100000001b3ull;
+
 static constexpr char lower_hex_map[17] = "0123456789abcdef";
 
 auto bytes_as_hex_string(CSpan<std::byte> data) -> std::string {
@@ -56,6 +58,28 @@ auto sha256(CSpan<std::byte> in_data) -> SHA256 {
     return res;
 }
 
+auto fnv1a_64(CSpan<std::byte> in_data, uint64_t hash) -> uint64_t {
+    for (auto byte : in_data) {
+        hash ^= static_cast<uint8_t>(byte);
+        hash *= fnv1a_64_prime;
+    }
+    return hash;
+}
+auto fnv1a_64(std::string_view in_data, uint64_t hash) -> uint64_t {
+    for (auto ch : in_data) {
+        hash ^= static_cast<uint8_t>(ch);
+        hash *= fnv1a_64_prime;
+    }
+    return hash;
+}
+auto fnv1a_64(uint64_t value, uint64_t hash) -> uint64_t {
+    for (size_t i = 0; i < sizeof(value); i++) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= fnv1a_64_prime;
+    }
+    return hash;
+}
+
 } // namespace bi::crypto
 
 auto std::hash<bi::crypto::MD5>::operator()(bi::crypto::MD5 const& v) const noexcept -> size_t {
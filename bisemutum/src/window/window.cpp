@@ -33,13 +33,19 @@ void glfw_resize_callback(GLFWwindow* glfw_window, int width, int height);
 
 struct Window::Impl final {
     ~Impl() {
+        if (headless) { return; }
         glfwDestroyWindow(window);
         glfwTerminate();
     }
 
-    auto init(Window* api_window, uint32_t width, uint32_t height, std::string_view title) -> void {
+    auto init(Window* api_window, uint32_t width, uint32_t height, std::string_view title, bool headless) -> void {
         this->api_window = api_window;
+        this->headless = headless;
         logic_size = {width, height};
+        if (headless) {
+            frame_size = logic_size;
+            return;
+        }
 
         glfwSetErrorCallback(glfw_error_callback);
 
@@ -90,6 +96,19 @@ struct Window::Impl final {
         }
     }
 
+    auto run_frames(uint64_t num_frames, std::function<auto() -> void> const& func) -> void {
+        frame_count = 0;
+        while (frame_count < num_frames) {
+            if (window) {
+                glfwPollEvents();
+            }
+
+            func();
+
+            ++frame_count;
+        }
+    }
+
     auto register_mouse_callback(Window& self, MouseCallback&& callback) -> MouseCallbackHandle {
         return MouseCallbackHandle{
             mouse_callbacks.insert(std::move(callback)),
@@ -118,15 +137,18 @@ struct Window::Impl final {
     }
 
     auto key_state(input::Keyboard key) const -> input::KeyState {
+        if (!window) { return input::KeyState::release; }
         return convert_glfw_key_state(glfwGetKey(window, static_cast<int>(key)));
     }
     auto mouse_state(input::Mouse mouse) const -> input::KeyState {
+        if (!window) { return input::KeyState::release; }
         auto button = mouse == input::Mouse::left ? GLFW_MOUSE_BUTTON_LEFT
             : mouse == input::Mouse::right ? GLFW_MOUSE_BUTTON_RIGHT
             : GLFW_MOUSE_BUTTON_MIDDLE;
         return convert_glfw_key_state(glfwGetMouseButton(window, button));
     }
     auto cursor_pos() const -> float2 {
+        if (!window) { return {0.0f, 0.0f}; }
         double xpos, ypos;
         glfwGetCursorPos(window, &xpos, &ypos);
         return {xpos, ypos};
@@ -138,6 +160,7 @@ struct Window::Impl final {
     WindowSize logic_size;
 
     GLFWwindow *window = nullptr;
+    bool headless = false;
 
     uint64_t frame_count = 0;
 
@@ -186,8 +209,12 @@ void glfw_resize_callback(GLFWwindow *glfw_window, int width, int height) {
     }
 }
 
-Window::Window(uint32_t width, uint32_t height, std::string_view title) {
-    impl()->init(this, width, height, title);
+Window::Window(uint32_t width, uint32_t height, std::string_view title, bool headless) {
+    impl()->init(this, width, height, title, headless);
+}
+
+auto Window::is_headless() const -> bool {
+    return impl()->headless;
 }
 
 auto Window::frame_size() const -> WindowSize { return impl()->frame_size; }
@@ -212,6 +239,10 @@ auto Window::main_loop(const std::function<void()> &func) -> void {
     impl()->main_loop(func);
 }
 
+auto Window::run_frames(uint64_t num_frames, std::function<auto() -> void> const& func) -> void {
+    impl()->run_frames(num_frames, func);
+}
+
 auto Window::raw_glfw_window() const -> GLFWwindow* {
     return impl()->window;
 }
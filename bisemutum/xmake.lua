@@ -1,6 +1,6 @@
 add_requires("fmt")
 add_requires("spdlog", {configs = {fmt_external = true}})
-add_requires("miniz", "glm", "entt", "magic_enum")
+add_requires("miniz", "zstd", "lz4", "glm", "entt", "magic_enum")
 add_requires("glfw", "directxshadercompiler", "crypto-algorithms")
 add_requires("nlohmann_json", "toml++", "assimp", "tinygltf", "mikktspace", "stb", "tinyexr")
 add_requires("imgui v1.89.9-docking", {configs = {glfw = true}})
@@ -19,19 +19,62 @@ end
 
 includes("thirdparty/xmake.lua")
 
-target("bisemutum-lib")
+-- Sources that need neither the engine nor graphics devices, shared with headless tools.
+bisemutum_core_files = {
+    "src/prelude/**.cpp",
+    "src/utils/**.cpp",
+    "src/platform/**.cpp",
+    "src/math/aabb_tree.cpp",
+    "src/math/bbox.cpp",
+    "src/math/math.cpp",
+    "src/rhi/defines.cpp",
+    "src/runtime/archive.cpp",
+    "src/runtime/asset_validation.cpp",
+    "src/runtime/logger_manager.cpp",
+    "src/runtime/thread_pool.cpp",
+    "src/runtime/vfs.cpp",
+    "src/graphics/mesh.cpp",
+    "src/graphics/mesh_optimization.cpp",
+    "src/graphics/meshlet.cpp",
+    "src/graphics/vertex_quantization.cpp",
+    "src/scene_basic/static_mesh_data.cpp",
+    "src/scene_basic/texture_asset_data.cpp",
+    "src/scene_basic/texture_compression.cpp",
+    "src/scene_basic/texture_image.cpp",
+    "src/scene_basic/texture_mipmap.cpp",
+}
+
+target("bisemutum-core")
     set_kind("static")
     add_includedirs("include", {public = true})
-    add_files("src/**.cpp", "src/**.c")
+    add_files(table.unpack(bisemutum_core_files))
     add_headerfiles("include/**.hpp")
-    add_headerfiles("src/**.hpp", "src/**.h", {install = false})
 
     add_deps("anyany", {public = true})
+
+    add_packages("fmt", "spdlog", "miniz", "glm", "entt", "magic_enum", {public = true})
+    add_defines("MAGIC_ENUM_RANGE_MAX=8192")
+    add_packages("zstd", "lz4", "crypto-algorithms")
+    add_packages("nlohmann_json", "toml++", "stb")
+
+    if is_plat("windows") then
+        add_defines("NOMINMAX")
+    end
+
+target("bisemutum-lib")
+    set_kind("static")
+    add_files("src/**.cpp", "src/**.c")
+    remove_files("src/cooker/**.cpp")
+    remove_files(table.unpack(bisemutum_core_files))
+    add_headerfiles("src/**.hpp", "src/**.h", {install = false})
+
+    add_deps("bisemutum-core", {public = true})
     add_deps("pep-cprep")
     add_deps("imgui-file-dialog", "imguizmo")
 
-    add_packages("fmt", "spdlog", "miniz", "glm", "entt", "magic_enum", "imgui", {public = true})
+    add_packages("imgui", {public = true})
     add_defines("MAGIC_ENUM_RANGE_MAX=8192")
+    add_packages("zstd", "lz4")
     add_packages("glfw", "directxshadercompiler", "crypto-algorithms")
     add_packages("nlohmann_json", "toml++", "assimp", "tinygltf", "mikktspace", "stb", "tinyexr")
 
@@ -61,6 +104,13 @@ target("bisemutum-lib")
         io.writefile(target:targetdir().."/bisemutum_path.txt", target:scriptdir())
     end)
 
+-- Asset cooking that doesn't bring up the engine or a graphics device.
+target("bisemutum-cooker")
+    set_kind("static")
+    add_files("src/cooker/**.cpp")
+    add_deps("bisemutum-core", {public = true})
+    add_packages("tinyexr", "stb")
+
 target("bisemutum-engine")
     set_kind("binary")
     add_files("bin/main.cpp")
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdio>
+
+namespace bi::test {
+
+inline int num_failures = 0;
+
+// Exit code of a test binary.
+inline auto result() -> int {
+    if (num_failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed.\n", num_failures);
+        return 1;
+    }
+    return 0;
+}
+
+}
+
+#define BI_CHECK(cond) do { \
+    if (!(cond)) { \
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        ++::bi::test::num_failures; \
+    } \
+} while (false)
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <bisemutum/graphics/mesh.hpp>
+#include <bisemutum/graphics/meshlet.hpp>
+
+#include "check.hpp"
+
+using namespace bi;
+
+namespace {
+
+constexpr uint32_t grid_size = 32;
+
+// A flat grid on the xz plane whose triangles face +y.
+auto make_grid_mesh() -> gfx::MeshData {
+    gfx::MeshData mesh{};
+    auto& positions = mesh.mutable_positions();
+    for (uint32_t z = 0; z <= grid_size; z++) {
+        for (uint32_t x = 0; x <= grid_size; x++) {
+            positions.push_back(float3{static_cast<float>(x), 0.0f, static_cast<float>(z)});
+        }
+    }
+    auto& indices = mesh.mutable_indices();
+    for (uint32_t z = 0; z < grid_size; z++) {
+        for (uint32_t x = 0; x < grid_size; x++) {
+            auto v00 = z * (grid_size + 1) + x;
+            auto v01 = v00 + grid_size + 1;
+            indices.insert(indices.end(), {v00, v01, v00 + 1});
+            indices.insert(indices.end(), {v00 + 1, v01, v01 + 1});
+        }
+    }
+    mesh.set_submehes({gfx::SubmeshDesc{.num_indices = mesh.num_indices()}});
+    return mesh;
+}
+
+auto sorted_triangles(std::vector<uint32_t> const& indices) -> std::vector<std::array<uint32_t, 3>> {
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        triangles.push_back({indices[i], indices[i + 1], indices[i + 2]});
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+auto check_build(gfx::MeshData const& mesh, std::vector<uint32_t> const& original_indices) -> void {
+    gfx::MeshletBuildSettings settings{};
+    BI_CHECK(mesh.has_meshlets());
+    auto meshlets = mesh.submesh_meshlets(0);
+    BI_CHECK(meshlets.size() >= grid_size * grid_size * 2 / settings.max_num_triangles);
+
+    // Triangles are only reordered, winding is kept.
+    BI_CHECK(sorted_triangles(mesh.indices()) == sorted_triangles(original_indices));
+
+    uint32_t next_index_offset = 0;
+    for (auto const& meshlet : meshlets) {
+        BI_CHECK(meshlet.index_offset == next_index_offset);
+        next_index_offset += meshlet.num_indices;
+        BI_CHECK(meshlet.num_indices % 3 == 0);
+        BI_CHECK(meshlet.num_indices / 3 <= settings.max_num_triangles);
+        BI_CHECK(meshlet.num_vertices <= settings.max_num_vertices);
+
+        std::vector<uint32_t> vertices{
+            mesh.indices().begin() + meshlet.index_offset,
+            mesh.indices().begin() + meshlet.index_offset + meshlet.num_indices,
+        };
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+        BI_CHECK(vertices.size() == meshlet.num_vertices);
+
+        float3 center{meshlet.bounding_sphere};
+        for (auto v : vertices) {
+            BI_CHECK(math::distance(center, mesh.positions()[v]) <= meshlet.bounding_sphere.w + 1e-4f);
+        }
+        // All triangles have the same normal.
+        BI_CHECK(math::distance(float3{meshlet.normal_cone}, float3{0.0f, 1.0f, 0.0f}) < 1e-4f);
+        BI_CHECK(meshlet.normal_cone.w < 1e-3f);
+    }
+    BI_CHECK(next_index_offset == mesh.num_indices());
+}
+
+auto count_visible(gfx::MeshData const& mesh, gfx::MeshletCullingParams const& params) -> size_t {
+    auto meshlets = mesh.submesh_meshlets(0);
+    return std::count_if(meshlets.begin(), meshlets.end(), [&params](gfx::Meshlet const& meshlet) {
+        return gfx::is_meshlet_visible(meshlet, params);
+    });
+}
+
+auto check_culling(gfx::MeshData const& mesh) -> void {
+    auto num_meshlets = mesh.submesh_meshlets(0).size();
+
+    BI_CHECK(count_visible(mesh, {}) == num_meshlets);
+
+    // Keeps 0 <= x <= 2, which touches only the meshlets covering the first columns.
+    std::array<float4, 2> column_planes{float4{1.0f, 0.0f, 0.0f, 0.0f}, float4{-1.0f, 0.0f, 0.0f, 2.0f}};
+    auto num_column_visible = count_visible(mesh, {.frustum_planes = column_planes});
+    BI_CHECK(num_column_visible > 0);
+    BI_CHECK(num_column_visible < num_meshlets);
+    for (auto const& meshlet : mesh.submesh_meshlets(0)) {
+        auto x = meshlet.bounding_sphere.x;
+        auto r = meshlet.bounding_sphere.w;
+        auto intersects = x + r >= 0.0f && x - r <= 2.0f;
+        BI_CHECK(gfx::is_meshlet_visible(meshlet, {.frustum_planes = column_planes}) == intersects);
+    }
+
+    // Keeps x >= 1000, the mesh is only visible after being moved there.
+    std::array<float4, 1> far_planes{float4{1.0f, 0.0f, 0.0f, -1000.0f}};
+    BI_CHECK(count_visible(mesh, {.frustum_planes = far_planes}) == 0);
+    float4x4 matrix_object_to_world{1.0f};
+    matrix_object_to_world[3] = float4{2000.0f, 0.0f, 0.0f, 1.0f};
+    BI_CHECK(count_visible(mesh, {
+        .frustum_planes = far_planes,
+        .matrix_object_to_world = matrix_object_to_world,
+    }) == num_meshlets);
+
+    auto grid_center = float3{grid_size * 0.5f, 0.0f, grid_size * 0.5f};
+    BI_CHECK(count_visible(mesh, {
+        .view_position = grid_center + float3{0.0f, 100.0f, 0.0f},
+        .back_face_sign = 1.0f,
+    }) == num_meshlets);
+    BI_CHECK(count_visible(mesh, {
+        .view_position = grid_center - float3{0.0f, 100.0f, 0.0f},
+        .back_face_sign = 1.0f,
+    }) == 0);
+    BI_CHECK(count_visible(mesh, {
+        .view_position = grid_center - float3{0.0f, 100.0f, 0.0f},
+        .back_face_sign = -1.0f,
+    }) == num_meshlets);
+    BI_CHECK(count_visible(mesh, {
+        .view_direction = float3{0.0f, 1.0f, 0.0f},
+        .orthographic = true,
+        .back_face_sign = 1.0f,
+    }) == 0);
+    BI_CHECK(count_visible(mesh, {
+        .view_direction = float3{0.0f, -1.0f, 0.0f},
+        .orthographic = true,
+        .back_face_sign = 1.0f,
+    }) == num_meshlets);
+}
+
+} // namespace
+
+auto main() -> int {
+    auto mesh = make_grid_mesh();
+    auto original_indices = mesh.indices();
+    gfx::build_meshlets(mesh);
+    check_build(mesh, original_indices);
+    check_culling(mesh);
+
+    // Changing geometry drops meshlets that no longer match it.
+    mesh.mutable_positions();
+    BI_CHECK(!mesh.has_meshlets());
+
+    return test::result();
+}
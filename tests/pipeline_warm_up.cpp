@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
+
+#include <bisemutum/engine/engine.hpp>
+#include <bisemutum/prelude/option.hpp>
+#include <bisemutum/graphics/graphics_manager.hpp>
+
+#include "check.hpp"
+
+using namespace bi;
+
+namespace {
+
+auto write_file(std::filesystem::path const& path, char const* content) -> void {
+    std::ofstream fout(path);
+    fout << content;
+}
+
+// A physical project, so that the pipeline manifest is kept between runs.
+auto create_project(std::filesystem::path const& dir) -> void {
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    write_file(dir / "project.toml", R"(
+        name = 'Pipeline Warm Up Test'
+        asset_metadata_file = '/project/asset_metadata.toml'
+        scene_file = '/project/scene.toml'
+        renderer = 'BasicRenderer'
+        [settings.graphics]
+        backend = 'null'
+    )");
+    write_file(dir / "scene.toml", R"(
+        [[objects]]
+        name = 'Camera'
+        [[objects.components]]
+        type = 'Transform'
+        [[objects.components]]
+        type = 'CameraComponent'
+        [objects.components.value]
+        render_target_format = 'rgba16_sfloat'
+    )");
+    write_file(dir / "asset_metadata.toml", "");
+}
+
+// Return the number of pipelines created by passes, or empty if the engine fails.
+auto run_frames(std::filesystem::path const& dir) -> Option<uint64_t> {
+    auto project_file = (dir / "project.toml").string();
+    auto report_file = (dir / "headless_report.json").string();
+    char const* args[] = {
+        "test-pipeline_warm_up", "-project", project_file.c_str(), "-headless", "-frames", "3",
+        "-report", report_file.c_str(),
+    };
+    if (!initialize_engine(std::size(args), const_cast<char**>(args))) { return {}; }
+    g_engine->execute();
+    auto num_created_pipelines = g_engine->graphics_manager()->num_created_pipelines();
+    if (!finalize_engine()) { return {}; }
+    return num_created_pipelines;
+}
+
+} // namespace
+
+// The first run records pipelines into the manifest, all of them should be warmed up in the second run.
+auto main() -> int {
+    auto dir = std::filesystem::temp_directory_path() / "bisemutum-test-pipeline_warm_up";
+    create_project(dir);
+
+    auto num_recorded = run_frames(dir);
+    BI_CHECK(num_recorded.has_value() && num_recorded.value() > 0);
+    auto num_missed = run_frames(dir);
+    BI_CHECK(num_missed.has_value() && num_missed.value() == 0);
+    if (num_missed.has_value() && num_missed.value() > 0) {
+        std::fprintf(stderr, "%llu pipeline(s) are not warmed up.\n", static_cast<unsigned long long>(num_missed.value()));
+    }
+
+    std::filesystem::remove_all(dir);
+    return test::result();
+}
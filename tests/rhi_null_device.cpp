@@ -0,0 +1,81 @@
+#include <cstring>
+
+#include <bisemutum/rhi/device.hpp>
+#include <bisemutum/rhi/null_device.hpp>
+
+#include "check.hpp"
+
+using namespace bi;
+
+int main() {
+    auto device = rhi::Device::create(rhi::DeviceDesc{.backend = rhi::Backend::null});
+    BI_CHECK(device->get_backend() == rhi::Backend::null);
+    BI_CHECK(rhi::null_device_statistics(device.ref()).has_value());
+
+    constexpr uint64_t size = 256;
+    auto upload_buffer = device->create_buffer(rhi::BufferDesc{
+        .size = size,
+        .memory_property = rhi::BufferMemoryProperty::cpu_to_gpu,
+    });
+    auto gpu_buffer = device->create_buffer(rhi::BufferDesc{
+        .size = size,
+        .usages = rhi::BufferUsage::storage_read_write,
+    });
+    auto readback_buffer = device->create_buffer(rhi::BufferDesc{
+        .size = size,
+        .memory_property = rhi::BufferMemoryProperty::gpu_to_cpu,
+    });
+
+    auto upload_data = upload_buffer->typed_map<uint8_t>();
+    for (uint64_t i = 0; i < size; i++) {
+        upload_data[i] = static_cast<uint8_t>(i * 7 + 1);
+    }
+    upload_buffer->unmap();
+
+    auto queue = device->get_queue(rhi::QueueType::graphics);
+    auto cmd_pool = device->create_command_pool(rhi::CommandPoolDesc{.queue = queue});
+    auto fence = device->create_fence();
+    {
+        auto cmd_encoder = cmd_pool->get_command_encoder();
+        cmd_encoder->copy_buffer_to_buffer(upload_buffer.ref(), gpu_buffer.ref(), {});
+        rhi::BufferBarrier barrier{
+            .buffer = gpu_buffer.ref(),
+            .src_access_type = rhi::ResourceAccessType::transfer_write,
+            .dst_access_type = rhi::ResourceAccessType::transfer_read,
+        };
+        cmd_encoder->resource_barriers({&barrier, 1}, {});
+        {
+            auto compute_encoder = cmd_encoder->begin_compute_pass({.label = "test"});
+            compute_encoder->dispatch(4, 2, 1);
+            compute_encoder->dispatch(1, 1, 1);
+        }
+        cmd_encoder->copy_buffer_to_buffer(gpu_buffer.ref(), readback_buffer.ref(), {});
+        queue->submit_command_buffer({cmd_encoder->finish()}, {}, {}, fence.ref());
+    }
+    fence->wait();
+
+    auto readback_data = readback_buffer->typed_map<uint8_t>();
+    auto data_matched = true;
+    for (uint64_t i = 0; i < size; i++) {
+        data_matched = data_matched && readback_data[i] == static_cast<uint8_t>(i * 7 + 1);
+    }
+    readback_buffer->unmap();
+    BI_CHECK(data_matched);
+
+    auto stats = rhi::null_device_statistics(device.ref()).value();
+    BI_CHECK(stats.buffers_created == 3);
+    BI_CHECK(stats.submitted_command_buffers == 1);
+    BI_CHECK(stats.bytes_uploaded == size);
+    BI_CHECK(stats.bytes_copied == size * 2);
+    BI_CHECK(stats.buffer_barriers == 1);
+    BI_CHECK(stats.compute_passes == 1);
+    BI_CHECK(stats.dispatches == 2);
+    BI_CHECK(stats.draws == 0);
+
+    rhi::reset_null_device_statistics(device.ref());
+    stats = rhi::null_device_statistics(device.ref()).value();
+    BI_CHECK(stats.submitted_command_buffers == 0);
+    BI_CHECK(stats.bytes_copied == 0);
+
+    return test::result();
+}
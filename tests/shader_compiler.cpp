@@ -0,0 +1,59 @@
+#include <algorithm>
+
+#include <bisemutum/engine/engine.hpp>
+#include <bisemutum/graphics/graphics_manager.hpp>
+#include <bisemutum/graphics/shader_compiler.hpp>
+#include <bisemutum/rhi/null_device.hpp>
+
+#include "check.hpp"
+
+using namespace bi;
+
+namespace {
+
+auto same_binary(
+    Ref<rhi::Device> device, gfx::ShaderCompilationResult const& lhs, gfx::ShaderCompilationResult const& rhs
+) -> bool {
+    if (!lhs || !rhs) { return false; }
+    auto lhs_binary = rhi::null_shader_module_binary(device, lhs.value()).value();
+    auto rhs_binary = rhi::null_shader_module_binary(device, rhs.value()).value();
+    return lhs_binary.size() > 0
+        && std::equal(lhs_binary.begin(), lhs_binary.end(), rhs_binary.begin(), rhs_binary.end());
+}
+
+} // namespace
+
+// Shaders of the basic renderer are compiled by a few headless frames of the in-memory project.
+// The same requests are compiled again one by one and in parallel by new compilers,
+// which compile everything since binary infos are not saved until the engine is finalized.
+auto main() -> int {
+    char const* args[] = {"test-shader_compiler", "-graphics-api", "null", "-headless", "-frames", "2"};
+    if (!initialize_engine(std::size(args), const_cast<char**>(args))) { return 1; }
+    g_engine->execute();
+
+    auto device = g_engine->graphics_manager()->device();
+    auto requests = g_engine->graphics_manager()->shader_compiler()->compiled_requests();
+    BI_CHECK(!requests.empty());
+    {
+        gfx::ShaderCompiler sync_compiler{};
+        sync_compiler.initialize(device);
+        gfx::ShaderCompiler async_compiler{};
+        async_compiler.initialize(device);
+
+        std::vector<gfx::ShaderCompilationResult> sync_results{};
+        for (auto const& request : requests) {
+            sync_results.push_back(sync_compiler.compile_shader(
+                request.source_path, request.entry, request.shader_stage, request.environment
+            ));
+        }
+        auto async_results = async_compiler.compile_shader_async(requests).get();
+
+        BI_CHECK(async_results.size() == requests.size());
+        for (size_t i = 0; i < std::min(sync_results.size(), async_results.size()); i++) {
+            BI_CHECK(same_binary(device, sync_results[i], async_results[i]));
+        }
+    }
+
+    BI_CHECK(finalize_engine());
+    return test::result();
+}
@@ -0,0 +1,115 @@
+#include <cmath>
+#include <random>
+
+#include <bisemutum/graphics/vertex_quantization.hpp>
+
+#include "check.hpp"
+
+using namespace bi;
+
+namespace {
+
+// Octahedral encoding with 16-bit snorm components, the worst error is about 0.004 degrees.
+constexpr float max_direction_error = 1e-4f;
+
+auto random_direction(std::mt19937& rng) -> float3 {
+    std::normal_distribution<float> dist{};
+    float3 v{};
+    do {
+        v = float3{dist(rng), dist(rng), dist(rng)};
+    } while (math::length(v) < 1e-3f);
+    return math::normalize(v);
+}
+
+auto check_positions(std::mt19937& rng) -> void {
+    BoundingBox bbox{};
+    bbox.p_min = float3{-12.5f, 0.0f, 3.0f};
+    bbox.p_max = float3{40.0f, 0.0f, 1003.0f};
+    auto quantization = gfx::position_quantization_of(bbox);
+    // Rounding to the nearest of 65536 steps.
+    auto max_error = math::max(bbox.p_max - bbox.p_min, float3{0.0f}) / 65535.0f * 0.5f + 1e-4f;
+
+    std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+    float3 worst_error{0.0f};
+    for (int i = 0; i < 10000; i++) {
+        auto t = float3{dist(rng), dist(rng), dist(rng)};
+        auto position = bbox.p_min + t * (bbox.p_max - bbox.p_min);
+        auto decoded = gfx::dequantize_position(gfx::quantize_position(position, quantization), quantization);
+        worst_error = math::max(worst_error, math::abs(decoded - position));
+    }
+    BI_CHECK(worst_error.x <= max_error.x);
+    // The flat axis is kept exactly.
+    BI_CHECK(worst_error.y <= max_error.y);
+    BI_CHECK(worst_error.z <= max_error.z);
+
+    auto corner = gfx::dequantize_position(gfx::quantize_position(bbox.p_max, quantization), quantization);
+    BI_CHECK(math::length(corner - bbox.p_max) <= math::length(max_error));
+}
+
+auto check_normals(std::mt19937& rng) -> void {
+    auto worst_error = 0.0f;
+    auto check_one = [&worst_error](float3 const& normal) {
+        auto decoded = gfx::dequantize_normal(gfx::quantize_normal(normal));
+        worst_error = std::max(worst_error, math::length(decoded - normal));
+    };
+    for (int i = 0; i < 100000; i++) {
+        check_one(random_direction(rng));
+    }
+    // Axes and the folded edges of the octahedron.
+    for (auto const& normal : {
+        float3{1.0f, 0.0f, 0.0f}, float3{-1.0f, 0.0f, 0.0f}, float3{0.0f, 1.0f, 0.0f},
+        float3{0.0f, -1.0f, 0.0f}, float3{0.0f, 0.0f, 1.0f}, float3{0.0f, 0.0f, -1.0f},
+        math::normalize(float3{1.0f, 1.0f, -1.0f}), math::normalize(float3{-1.0f, 1.0f, -1.0f}),
+        math::normalize(float3{1.0f, -1.0f, -1.0f}), math::normalize(float3{-1.0f, -1.0f, -1.0f}),
+    }) {
+        check_one(normal);
+    }
+    BI_CHECK(worst_error <= max_direction_error);
+
+    auto degenerated = gfx::dequantize_normal(gfx::quantize_normal(float3{0.0f}));
+    BI_CHECK(std::isfinite(degenerated.x) && std::isfinite(degenerated.y) && std::isfinite(degenerated.z));
+}
+
+auto check_tangents(std::mt19937& rng) -> void {
+    auto worst_error = 0.0f;
+    auto handedness_matched = true;
+    for (int i = 0; i < 100000; i++) {
+        auto direction = random_direction(rng);
+        auto handedness = i % 2 == 0 ? 1.0f : -1.0f;
+        auto decoded = gfx::dequantize_tangent(gfx::quantize_tangent(float4{direction, handedness}));
+        worst_error = std::max(worst_error, math::length(float3{decoded.x, decoded.y, decoded.z} - direction));
+        handedness_matched = handedness_matched && decoded.w == handedness;
+    }
+    BI_CHECK(worst_error <= max_direction_error);
+    BI_CHECK(handedness_matched);
+
+    // Handedness is only a sign.
+    BI_CHECK(gfx::dequantize_tangent(gfx::quantize_tangent(float4{1.0f, 0.0f, 0.0f, 0.0f})).w == 1.0f);
+    BI_CHECK(gfx::dequantize_tangent(gfx::quantize_tangent(float4{1.0f, 0.0f, 0.0f, -0.5f})).w == -1.0f);
+}
+
+auto check_texcoords(std::mt19937& rng) -> void {
+    std::uniform_real_distribution<float> dist{-4.0f, 4.0f};
+    auto worst_relative_error = 0.0f;
+    for (int i = 0; i < 10000; i++) {
+        float2 texcoord{dist(rng), dist(rng)};
+        auto decoded = gfx::dequantize_texcoord(gfx::quantize_texcoord(texcoord));
+        for (int c = 0; c < 2; c++) {
+            auto error = std::abs(decoded[c] - texcoord[c]) / std::max(std::abs(texcoord[c]), 1.0f);
+            worst_relative_error = std::max(worst_relative_error, error);
+        }
+    }
+    // Half floats have 11 significant bits.
+    BI_CHECK(worst_relative_error <= 1.0f / 2048.0f);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng{20240501};
+    check_positions(rng);
+    check_normals(rng);
+    check_tangents(rng);
+    check_texcoords(rng);
+    return test::result();
+}
@@ -0,0 +1,34 @@
+target("test-rhi_null_device")
+    set_kind("binary")
+    set_group("tests")
+    add_files("rhi_null_device.cpp")
+    add_deps("bisemutum-lib")
+    add_tests("default")
+
+target("test-vertex_quantization")
+    set_kind("binary")
+    set_group("tests")
+    add_files("vertex_quantization.cpp")
+    add_deps("bisemutum-core")
+    add_tests("default")
+
+target("test-meshlet")
+    set_kind("binary")
+    set_group("tests")
+    add_files("meshlet.cpp")
+    add_deps("bisemutum-core")
+    add_tests("default")
+
+target("test-shader_compiler")
+    set_kind("binary")
+    set_group("tests")
+    add_files("shader_compiler.cpp")
+    add_deps("bisemutum-lib")
+    add_tests("default")
+
+target("test-pipeline_warm_up")
+    set_kind("binary")
+    set_group("tests")
+    add_files("pipeline_warm_up.cpp")
+    add_deps("bisemutum-lib")
+    add_tests("default")
@@ -0,0 +1,141 @@
+#include <iostream>
+#include <chrono>
+#include <limits>
+
+#include <fmt/format.h>
+#include <magic_enum.hpp>
+
+#include <bisemutum/engine/engine.hpp>
+#include <bisemutum/runtime/vfs.hpp>
+#include <bisemutum/runtime/thread_pool.hpp>
+#include <bisemutum/prelude/byte_stream.hpp>
+#include <bisemutum/scene_basic/static_mesh.hpp>
+#include <bisemutum/scene_basic/texture_asset_data.hpp>
+
+namespace {
+
+// Uncompressed data of assets, i.e. what is passed to `compress_data()`. Other files are used as is.
+auto read_payload(std::filesystem::path const& path) -> std::vector<std::byte> {
+    bi::rt::PhysicalFile file{path, false};
+    auto filename = path.filename().string();
+    bi::WriteByteStream bs{};
+    if (filename.ends_with(".static_mesh.biasset")) {
+        auto asset = bi::StaticMesh::load(file);
+        if (auto mesh = aa::any_cast<bi::StaticMesh>(&asset); mesh) {
+            mesh->get_mesh_data().save_to_byte_stream(bs);
+        }
+    } else if (filename.ends_with(".texture.biasset")) {
+        // Streamable textures only load their tail levels, so levels are read from the file directly.
+        if (auto data = bi::read_texture_asset_data(file); data) {
+            bs.write(data.value().levels.data);
+        }
+    } else {
+        return file.read_binary_data();
+    }
+    return {bs.data().begin(), bs.data().end()};
+}
+
+auto elapsed_seconds(std::chrono::steady_clock::time_point from) -> double {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - from).count();
+}
+
+} // namespace
+
+// Measure ratio and throughput of compression codecs of `WriteByteStream::compress_data()`,
+// on the example assets by default.
+auto do_benchmark_compression(int argc, char** argv) -> bool {
+    std::vector<std::filesystem::path> input_paths{};
+    int num_iterations = 5;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg{argv[i]};
+        if (arg == "--iterations" && i + 1 < argc) {
+            num_iterations = std::max(std::stoi(argv[++i]), 1);
+        } else {
+            input_paths.emplace_back(arg);
+        }
+    }
+    if (input_paths.empty()) {
+        input_paths = {"./examples/scene_basic/meshes", "./bisemutum/assets/textures"};
+    }
+    auto parallel_for = bi::g_engine->thread_pool()->parallel_for_fn();
+
+    std::vector<std::vector<std::byte>> payloads{};
+    uint64_t total_size = 0;
+    auto add_file = [&](std::filesystem::path const& path) {
+        auto payload = read_payload(path);
+        if (payload.empty()) { return; }
+        total_size += payload.size();
+        payloads.push_back(std::move(payload));
+    };
+    for (auto const& path : input_paths) {
+        if (std::filesystem::is_directory(path)) {
+            for (auto const& entry : std::filesystem::recursive_directory_iterator{path}) {
+                if (entry.is_regular_file()) { add_file(entry.path()); }
+            }
+        } else if (std::filesystem::is_regular_file(path)) {
+            add_file(path);
+        }
+    }
+    if (payloads.empty()) {
+        std::cerr << "No input files." << std::endl;
+        return false;
+    }
+    std::cout << fmt::format(
+        "{} files, {:.2f} MB in total, {} iterations\n", payloads.size(), total_size / 1e6, num_iterations
+    );
+    std::cout << fmt::format(
+        "{:<8}{:>12}{:>10}{:>16}{:>18}\n", "codec", "size (MB)", "ratio", "compress MB/s", "decompress MB/s"
+    );
+
+    auto succeeded = true;
+    for (auto codec : {bi::CompressionCodec::miniz, bi::CompressionCodec::zstd, bi::CompressionCodec::lz4}) {
+        uint64_t compressed_size = 0;
+        auto best_compress_time = std::numeric_limits<double>::max();
+        auto best_decompress_time = std::numeric_limits<double>::max();
+        for (int iteration = 0; iteration < num_iterations; iteration++) {
+            std::vector<bi::WriteByteStream> compressed(payloads.size());
+            auto start_time = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < payloads.size(); i++) {
+                compressed[i].write_raw(payloads[i].data(), payloads[i].size());
+                compressed[i].compress_data(0, codec, parallel_for);
+            }
+            best_compress_time = std::min(best_compress_time, elapsed_seconds(start_time));
+
+            start_time = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < payloads.size(); i++) {
+                bi::ReadByteStream bs{compressed[i].data()};
+                bi::ReadByteStream uncompressed_bs{};
+                bs.read_compressed_part(uncompressed_bs, parallel_for);
+                if (uncompressed_bs.size() != payloads[i].size()) { succeeded = false; }
+            }
+            best_decompress_time = std::min(best_decompress_time, elapsed_seconds(start_time));
+
+            compressed_size = 0;
+            for (auto const& bs : compressed) { compressed_size += bs.data().size(); }
+        }
+        std::cout << fmt::format(
+            "{:<8}{:>12.2f}{:>10.3f}{:>16.1f}{:>18.1f}\n",
+            magic_enum::enum_name(codec), compressed_size / 1e6,
+            static_cast<double>(total_size) / compressed_size,
+            total_size / 1e6 / best_compress_time, total_size / 1e6 / best_decompress_time
+        );
+    }
+    if (!succeeded) {
+        std::cerr << "Some data is not decompressed correctly." << std::endl;
+    }
+    return succeeded;
+}
+
+int main(int argc, char** argv) {
+    auto dummy_project_path = std::string{"./tools/dummy_project/project.toml"};
+    std::array<char*, 2> dummy_args{
+        argv[0],
+        dummy_project_path.data(),
+    };
+    if (!bi::initialize_engine(dummy_args.size(), dummy_args.data())) { return -1; }
+
+    auto succeeded = do_benchmark_compression(argc, argv);
+
+    if (!bi::finalize_engine()) { return -2; }
+    return succeeded ? 0 : -3;
+}
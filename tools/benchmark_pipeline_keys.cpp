@@ -0,0 +1,99 @@
+#include <iostream>
+#include <chrono>
+#include <limits>
+#include <filesystem>
+
+#include <fmt/format.h>
+
+#include <bisemutum/engine/engine.hpp>
+#include <bisemutum/runtime/world.hpp>
+#include <bisemutum/runtime/scene.hpp>
+#include <bisemutum/runtime/scene_object.hpp>
+#include <bisemutum/scene_basic/static_mesh.hpp>
+#include <bisemutum/scene_basic/mesh_renderer.hpp>
+
+namespace {
+
+auto elapsed_seconds(std::chrono::steady_clock::time_point from) -> double {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - from).count();
+}
+
+// Average milliseconds of the best of `num_iterations` headless runs.
+auto measure_frame_ms(int num_iterations, uint64_t num_frames) -> double {
+    auto best_time = std::numeric_limits<double>::max();
+    for (int iteration = 0; iteration < num_iterations; iteration++) {
+        auto start_time = std::chrono::steady_clock::now();
+        bi::g_engine->execute();
+        best_time = std::min(best_time, elapsed_seconds(start_time));
+    }
+    return best_time * 1e3 / num_frames;
+}
+
+} // namespace
+
+// Measure CPU cost of drawables on the null backend, where it is mostly pipeline lookups of passes
+// (`GraphicsManager::compile_pipeline_for_drawable()`) and command recording.
+// Mesh objects of the example scene are cloned in place, so clones are visible and share pipelines of their sources.
+auto do_benchmark_pipeline_keys(int argc, char** argv, uint64_t num_frames) -> bool {
+    size_t num_drawables = 10000;
+    int num_iterations = 3;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg{argv[i]};
+        if (arg == "--drawables" && i + 1 < argc) {
+            num_drawables = std::max(std::stoull(argv[++i]), 1ull);
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            num_iterations = std::max(std::stoi(argv[++i]), 1);
+        }
+    }
+
+    // Load assets and create pipelines of the original scene.
+    bi::g_engine->execute();
+    auto base_frame_ms = measure_frame_ms(num_iterations, num_frames);
+
+    auto scene = bi::g_engine->world()->current_scene();
+    std::vector<bi::Ref<bi::rt::SceneObject>> mesh_objects{};
+    scene->for_each_object([&mesh_objects](bi::Ref<bi::rt::SceneObject> object) {
+        if (object->has_components<bi::StaticMeshComponent, bi::MeshRendererComponent>()) {
+            mesh_objects.push_back(object);
+        }
+    });
+    if (mesh_objects.empty()) {
+        std::cerr << "No mesh objects in the scene." << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < num_drawables; i++) {
+        mesh_objects[i % mesh_objects.size()]->clone(false);
+    }
+
+    bi::g_engine->execute();
+    auto frame_ms = measure_frame_ms(num_iterations, num_frames);
+
+    std::cout << fmt::format(
+        "{} cloned drawables, {} frames, {} iterations\n", num_drawables, num_frames, num_iterations
+    );
+    std::cout << fmt::format("{:<28}{:>12}\n", "", "ms / frame");
+    std::cout << fmt::format("{:<28}{:>12.3f}\n", "original scene", base_frame_ms);
+    std::cout << fmt::format("{:<28}{:>12.3f}\n", "with cloned drawables", frame_ms);
+    std::cout << fmt::format(
+        "{:<28}{:>12.3f}\n", "per 10k drawables", (frame_ms - base_frame_ms) * 10000.0 / num_drawables
+    );
+    return true;
+}
+
+int main(int argc, char** argv) {
+    auto num_frames = std::string{"20"};
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string_view{argv[i]} == "--frames") { num_frames = argv[i + 1]; }
+    }
+    auto report_path = (std::filesystem::temp_directory_path() / "bisemutum-benchmark_pipeline_keys.json").string();
+    char const* args[] = {
+        argv[0], "-project", "./examples/scene_basic/project.toml", "-graphics-api", "null",
+        "-headless", "-frames", num_frames.c_str(), "-report", report_path.c_str(),
+    };
+    if (!bi::initialize_engine(std::size(args), const_cast<char**>(args))) { return -1; }
+
+    auto succeeded = do_benchmark_pipeline_keys(argc, argv, std::max(std::stoull(num_frames), 1ull));
+
+    if (!bi::finalize_engine()) { return -2; }
+    return succeeded ? 0 : -3;
+}
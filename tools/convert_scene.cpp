@@ -0,0 +1,51 @@
+#include <iostream>
+
+#include <bisemutum/engine/engine.hpp>
+#include <bisemutum/runtime/vfs.hpp>
+#include <bisemutum/runtime/world.hpp>
+#include <bisemutum/runtime/world_partition.hpp>
+
+// Convert a scene between TOML and binary format, e.g. `scene.toml` <-> `scene.biscene`,
+// or partition it into streamed cells when the destination is a `.biworld` manifest.
+auto do_convert_scene(int argc, char** argv) -> bool {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <src scene file> <dst scene file> [cell size]" << std::endl;
+        return false;
+    }
+
+    std::filesystem::path src_path{argv[1]};
+    std::filesystem::path dst_path{argv[2]};
+    if (!std::filesystem::is_regular_file(src_path)) {
+        std::cerr << "Scene file '" << src_path.string() << "' not found." << std::endl;
+        return false;
+    }
+
+    bi::rt::PhysicalFile src_file(src_path, false);
+    if (dst_path.extension() == bi::rt::world_partition_extension) {
+        bi::rt::WorldPartitionSettings settings{};
+        if (argc > 3) {
+            settings.cell_size = std::stof(argv[3]);
+        }
+        auto dst_dir = std::filesystem::absolute(dst_path).parent_path();
+        bi::g_engine->file_system()->mount("/partition/", bi::rt::PhysicalSubFileSystem{dst_dir});
+        auto manifest_path = "/partition/" + dst_path.filename().string();
+        return bi::rt::build_world_partition(src_file, settings, manifest_path);
+    }
+
+    bi::rt::PhysicalFile dst_file(dst_path, true);
+    return bi::g_engine->world()->convert_scene_file(src_file, dst_file);
+}
+
+int main(int argc, char** argv) {
+    auto dummy_project_path = std::string{"./tools/dummy_project/project.toml"};
+    std::array<char*, 2> dummy_args{
+        argv[0],
+        dummy_project_path.data(),
+    };
+    if (!bi::initialize_engine(dummy_args.size(), dummy_args.data())) { return -1; }
+
+    auto succeeded = do_convert_scene(argc, argv);
+
+    if (!bi::finalize_engine()) { return -2; }
+    return succeeded ? 0 : -3;
+}
@@ -0,0 +1,32 @@
+#include <iostream>
+
+#include <bisemutum/cooker/cooker.hpp>
+
+// Cook assets listed in a cook manifest without the engine, so that it also runs on machines without GPUs.
+auto do_cook_assets(int argc, char** argv) -> bool {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <cook manifest> [--force] [--threads <count>]" << std::endl;
+        return false;
+    }
+
+    std::filesystem::path manifest_path{argv[1]};
+    bi::cook::CookSettings settings{};
+    for (int i = 2; i < argc; i++) {
+        std::string_view arg{argv[i]};
+        if (arg == "--force") {
+            settings.force = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            settings.num_threads = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Unknown argument '" << arg << "'" << std::endl;
+            return false;
+        }
+    }
+
+    auto statistics = bi::cook::cook(manifest_path, settings);
+    return statistics && statistics.value().num_failed == 0;
+}
+
+int main(int argc, char** argv) {
+    return do_cook_assets(argc, argv) ? 0 : -3;
+}
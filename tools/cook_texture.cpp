@@ -0,0 +1,53 @@
+#include <iostream>
+
+#include <magic_enum.hpp>
+
+#include <bisemutum/runtime/vfs.hpp>
+#include <bisemutum/scene_basic/texture_asset_data.hpp>
+#include <bisemutum/scene_basic/texture_compression.hpp>
+
+// Block-compress an existing texture asset, in place if no output path is given.
+auto do_cook_texture(int argc, char** argv) -> bool {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <texture asset> <albedo|normal|mask|hdr> [output asset]" << std::endl;
+        return false;
+    }
+
+    std::filesystem::path src_path{argv[1]};
+    auto semantic = magic_enum::enum_cast<bi::TextureSemantic>(argv[2]);
+    if (!semantic) {
+        std::cerr << "Unknown texture semantic '" << argv[2] << "'" << std::endl;
+        return false;
+    }
+    std::filesystem::path dst_path = argc > 3 ? std::filesystem::path{argv[3]} : src_path;
+
+    bi::rt::PhysicalFile src_file{src_path, false};
+    auto texture = bi::read_texture_asset_data(src_file);
+    if (!texture) { return false; }
+    auto& levels = texture.value().levels;
+
+    auto src_size = levels.data.size();
+    if (!bi::rhi::is_compressed_format(levels.desc.format)) {
+        if (levels.desc.dim != bi::rhi::TextureDimension::d3 && levels.level_offsets.size() < levels.desc.levels) {
+            auto mipmapped = bi::generate_mipmaps(levels.desc, levels.data);
+            if (!mipmapped) { return false; }
+            levels = std::move(mipmapped).value();
+        }
+        auto compressed = bi::compress_texture(levels.desc, levels.data, levels.level_offsets, *semantic);
+        if (!compressed) { return false; }
+        levels = std::move(compressed).value();
+        // Block-compressed textures can't be written by shaders.
+        levels.desc.usages = {bi::rhi::TextureUsage::sampled};
+    }
+    std::cout << src_path.string() << ": " << src_size << " -> " << levels.data.size() << " bytes, "
+        << magic_enum::enum_name(levels.desc.format) << std::endl;
+
+    // Release the mapping of the source before it's overwritten in place.
+    src_file = bi::rt::PhysicalFile{src_path, false};
+    bi::rt::PhysicalFile dst_file{dst_path, true};
+    return bi::write_texture_asset_data(dst_file, texture.value());
+}
+
+int main(int argc, char** argv) {
+    return do_cook_texture(argc, argv) ? 0 : -3;
+}
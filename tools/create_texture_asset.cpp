@@ -1,11 +1,9 @@
 #include <iostream>
 
-#include <bisemutum/engine/engine.hpp>
 #include <bisemutum/runtime/vfs.hpp>
-#include <bisemutum/graphics/graphics_manager.hpp>
-#include <bisemutum/scene_basic/texture.hpp>
+#include <bisemutum/scene_basic/texture_asset_data.hpp>
 
-auto do_create_texture_asset(int argc, char** argv) -> void {
+auto do_create_texture_asset(int argc, char** argv) -> bool {
     std::filesystem::path output_path{"./texture.texture.biasset"};
     if (argc > 1) {
         output_path = argv[1];
@@ -13,26 +11,25 @@ auto do_create_texture_asset(int argc, char** argv) -> void {
 
     bi::rt::PhysicalFile file(output_path, true);
 
-    bi::TextureAsset texture{};
-    texture.sampler = bi::g_engine->graphics_manager()->get_sampler(bi::rhi::SamplerDesc{
+    bi::rhi::SamplerDesc sampler{
         .mag_filter = bi::rhi::SamplerFilterMode::linear,
         .min_filter = bi::rhi::SamplerFilterMode::linear,
         .address_mode_u = bi::rhi::SamplerAddressMode::clamp_to_edge,
         .address_mode_v = bi::rhi::SamplerAddressMode::clamp_to_edge,
         .address_mode_w = bi::rhi::SamplerAddressMode::clamp_to_edge,
-    });
+    };
 
     uint32_t width = 1;
     uint32_t height = 1;
     uint32_t depth = 1;
-    texture.texture_data = {
+    std::vector<std::byte> texture_data{
         static_cast<std::byte>(255),
         static_cast<std::byte>(255),
         static_cast<std::byte>(255),
         static_cast<std::byte>(255),
     };
 
-    texture.texture = bi::rhi::TextureDesc{
+    bi::rhi::TextureDesc desc{
         .extent = {width, height, depth},
         .levels = 1,
         .format = bi::rhi::ResourceFormat::rgba8_unorm,
@@ -40,19 +37,10 @@ auto do_create_texture_asset(int argc, char** argv) -> void {
         .usages = {bi::rhi::TextureUsage::sampled},
     };
 
-    texture.save(file);
+    std::vector<uint64_t> level_offsets{0};
+    return bi::write_texture_asset_data(file, sampler, desc, level_offsets, texture_data);
 }
 
 int main(int argc, char** argv) {
-    auto dummy_project_path = std::string{"./tools/dummy_project/project.toml"};
-    std::array<char*, 2> dummy_args{
-        argv[0],
-        dummy_project_path.data(),
-    };
-    if (!bi::initialize_engine(dummy_args.size(), dummy_args.data())) { return -1; }
-
-    do_create_texture_asset(argc, argv);
-
-    if (!bi::finalize_engine()) { return -2; }
-    return 0;
+    return do_create_texture_asset(argc, argv) ? 0 : -3;
 }
@@ -0,0 +1,25 @@
+#include <iostream>
+
+#include <bisemutum/runtime/archive.hpp>
+
+// Pack a directory, e.g. a project directory, into a single `.bipack` file that can be mounted with
+// `ArchiveSubFileSystem`. Packed projects can be run directly with `-project <pack file>`.
+// The engine is not needed, logs go to the default logger.
+auto do_pack_archive(int argc, char** argv) -> bool {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <src directory> <dst pack file> [--store]" << std::endl;
+        return false;
+    }
+
+    std::filesystem::path src_dir{argv[1]};
+    std::filesystem::path dst_path{argv[2]};
+    bi::rt::ArchiveBuildSettings settings{};
+    if (argc > 3 && std::string_view{argv[3]} == "--store") {
+        settings.compress = false;
+    }
+    return bi::rt::build_archive(src_dir, dst_path, settings);
+}
+
+int main(int argc, char** argv) {
+    return do_pack_archive(argc, argv) ? 0 : -3;
+}
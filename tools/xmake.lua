@@ -2,3 +2,33 @@ target("tool-create_texture_asset")
     set_kind("binary")
     add_files("create_texture_asset.cpp")
     add_deps("bisemutum-lib")
+
+target("tool-pack_archive")
+    set_kind("binary")
+    add_files("pack_archive.cpp")
+    add_deps("bisemutum-lib")
+
+target("tool-convert_scene")
+    set_kind("binary")
+    add_files("convert_scene.cpp")
+    add_deps("bisemutum-lib")
+
+target("tool-benchmark_compression")
+    set_kind("binary")
+    add_files("benchmark_compression.cpp")
+    add_deps("bisemutum-lib")
+
+target("tool-benchmark_pipeline_keys")
+    set_kind("binary")
+    add_files("benchmark_pipeline_keys.cpp")
+    add_deps("bisemutum-lib")
+
+target("tool-cook_texture")
+    set_kind("binary")
+    add_files("cook_texture.cpp")
+    add_deps("bisemutum-lib")
+
+target("tool-cook_assets")
+    set_kind("binary")
+    add_files("cook_assets.cpp")
+    add_deps("bisemutum-cooker")
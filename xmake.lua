@@ -5,3 +5,5 @@ set_languages("cxx20")
 includes("bisemutum/xmake.lua")
 
 includes("tools/xmake.lua")
+
+includes("tests/xmake.lua")